@@ -0,0 +1,60 @@
+//===--- ConformanceCheck.swift -------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// This test measures swift_conformsToProtocol through `is` checks on values
+// whose dynamic type is hidden behind Any: a conforming struct, a
+// conforming class, a subclass inheriting the conformance, and two
+// non-conforming types that force a full (failing) scan.
+import TestsUtils
+
+protocol Checkable {
+  func check() -> Int
+}
+
+struct CheckedStruct: Checkable {
+  func check() -> Int { return 1 }
+}
+
+class CheckedClass: Checkable {
+  func check() -> Int { return 2 }
+}
+
+class CheckedSubclass: CheckedClass {
+  override func check() -> Int { return 3 }
+}
+
+class PlainClass {
+  func ignore() {}
+}
+
+@inline(never)
+func makeValues() -> [Any] {
+  return [CheckedStruct(), CheckedClass(), CheckedSubclass(),
+          PlainClass(), "not checkable"]
+}
+
+@inline(never)
+public func run_ConformanceCheck(_ N: Int) {
+  let values = makeValues()
+  var conforming = 0
+  for _ in 1...N {
+    for _ in 0..<20_000 {
+      for value in values {
+        if value is Checkable {
+          conforming += 1
+        }
+      }
+    }
+  }
+  CheckResults(conforming == N * 20_000 * 3,
+               "IncorrectResults in run_ConformanceCheck: \(conforming).")
+}
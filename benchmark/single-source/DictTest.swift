@@ -112,38 +112,60 @@ public func run_Dictionary(scale: Int) {
       "entries", "for", "some", "sets", "of", "keys"
   ]
 
+  // In a --sweep run, pad the word list with distinct synthetic keys so
+  // the dictionary grows to the requested working-set size.
+  var words = Input
+  let workingSetSize = scaledWorkingSetSize(words.count)
+  if workingSetSize > words.count {
+    for i in words.count..<workingSetSize {
+      words.append("word\(i)")
+    }
+  }
+  // The text has 270 distinct words; every synthetic key is distinct too.
+  let expectedDistinct = 270 + (words.count - Input.count)
+
   var Dict: Dictionary<String, Bool> = [:]
   let N = 5*scale
 
   // Check performance of filling the dictionary:
   for _ in 1...N {
     Dict = [:]
-    for word in Input {
+    for word in words {
       Dict[word] = true
     }
   }
-  CheckResults(Dict.count == 270,
-               "IncorrectResults in DictTest: \(Dict.count) != 270.")
+  CheckResults(Dict.count == expectedDistinct,
+               "IncorrectResults in DictTest: \(Dict.count) != \(expectedDistinct).")
 
   // Check performance of searching in the dictionary:
   // Fill the dictionary with words from the first half of the text
   Dict = [:]
-  for i in 0 ..< Input.count/2 {
-    let word = Input[i]
+  for i in 0 ..< words.count/2 {
+    let word = words[i]
     Dict[word] = true
   }
 
+  // 541 words of the unpadded text come from its first half; count the
+  // padded expectation with a single extra pass when sweeping.
+  var expectedHits = 541
+  if words.count != Input.count {
+    expectedHits = 0
+    for word in words where Dict[word] != nil {
+      expectedHits += 1
+    }
+  }
+
   // Count number of words from the first half in the entire text
   var count = 0
   for _ in 1...N {
-    for word in Input {
+    for word in words {
       if Dict[word] != nil {
         count += 1
       }
     }
   }
-  CheckResults(count == N*541,
-               "IncorrectResults in DictTest: \(count) != \(N*541).")
+  CheckResults(count == N*expectedHits,
+               "IncorrectResults in DictTest: \(count) != \(N*expectedHits).")
 }
 
 class Box<T : Hashable> : Hashable {
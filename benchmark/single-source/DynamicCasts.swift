@@ -0,0 +1,65 @@
+//===--- DynamicCasts.swift -----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// This test measures the common paths of swift_dynamicCast: class downcasts
+// that succeed and fail, and unboxing Any to concrete value types.
+import TestsUtils
+
+class CastBase {
+  func f() -> Int { return 0 }
+}
+
+class CastDerived: CastBase {
+  override func f() -> Int { return 1 }
+}
+
+class CastOther: CastBase {
+  override func f() -> Int { return 2 }
+}
+
+@inline(never)
+func makeObjects() -> [CastBase] {
+  return [CastBase(), CastDerived(), CastOther()]
+}
+
+@inline(never)
+func makeBoxedValues() -> [Any] {
+  return [17, "seventeen", 17.0]
+}
+
+@inline(never)
+public func run_DynamicCasts(_ N: Int) {
+  let objects = makeObjects()
+  let boxed = makeBoxedValues()
+  var hits = 0
+  for _ in 1...N {
+    for _ in 0..<20_000 {
+      for object in objects {
+        // One success and two failures per pass over the array.
+        if let derived = object as? CastDerived {
+          hits += derived.f()
+        }
+      }
+      for value in boxed {
+        // One success and two failures of each unboxing cast.
+        if let number = value as? Int {
+          hits += number
+        }
+        if let text = value as? String {
+          hits += text.utf8.count
+        }
+      }
+    }
+  }
+  CheckResults(hits == N * 20_000 * (1 + 17 + 9),
+               "IncorrectResults in run_DynamicCasts: \(hits).")
+}
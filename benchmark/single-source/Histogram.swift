@@ -111,5 +111,18 @@ let samples: [rrggbb_t] = [
 
 @inline(never)
 public func run_Histogram(_ N: Int) {
+  // In a --sweep run, replace the small fixed sample set with a
+  // pseudo-random stream of the requested length so the histogram's
+  // working set scales from cache-resident to DRAM-resident.
+  if let size = benchmarkWorkingSetSize {
+    SRand()
+    var scaledSamples = [rrggbb_t]()
+    scaledSamples.reserveCapacity(size)
+    for _ in 0..<size {
+      scaledSamples.append(rrggbb_t(truncatingBitPattern: Random()))
+    }
+    output_sorted_sparse_rgb_histogram(scaledSamples, N)
+    return
+  }
   output_sorted_sparse_rgb_histogram(samples, N)
 }
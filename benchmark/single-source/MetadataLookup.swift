@@ -0,0 +1,45 @@
+//===--- MetadataLookup.swift ---------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// This test measures the cache-hit path of swift_getGenericMetadata: boxing
+// a generic value into Any requires the metadata of Box<T>, which after the
+// first instantiation per T is a lookup in the runtime's metadata cache.
+// (The miss path instantiates once per type per process, so it cannot be
+// looped; TypeFlood covers metadata allocation pressure instead.)
+import TestsUtils
+
+struct Box<T> {
+  var value: T
+}
+
+@inline(never)
+func boxUp<T>(_ value: T) -> Any {
+  return Box(value: value)
+}
+
+@inline(never)
+public func run_MetadataLookup(_ N: Int) {
+  var boxes = 0
+  for _ in 1...N {
+    for i in 0..<10_000 {
+      // Alternate between several generic arguments so the benchmark walks
+      // the cache rather than hammering one entry.
+      _ = boxUp(i)
+      _ = boxUp(Double(i))
+      _ = boxUp((i, i))
+      _ = boxUp("constant")
+      boxes += 4
+    }
+  }
+  CheckResults(boxes == N * 40_000,
+               "IncorrectResults in run_MetadataLookup: \(boxes).")
+}
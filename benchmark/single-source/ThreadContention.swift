@@ -0,0 +1,146 @@
+//===--- ThreadContention.swift -------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Contention benchmarks: several threads hammering shared structures, to
+// track regressions in the reference-counting atomics and the library's
+// uniqueness checks.  The worker-thread count comes from TestsUtils so
+// the driver's --threads sweep can scale it.
+
+import Darwin
+import TestsUtils
+
+final class ThreadBody {
+  let body: () -> Void
+  init(_ body: @escaping () -> Void) { self.body = body }
+}
+
+/// Runs `body` on `numThreads` freshly created threads and joins them all.
+func runOnThreads(_ numThreads: Int, _ body: @escaping (Int) -> Void) {
+  var threads = [pthread_t?](repeating: nil, count: numThreads)
+  for t in 0..<numThreads {
+    let context = Unmanaged.passRetained(ThreadBody { body(t) }).toOpaque()
+    let rc = pthread_create(&threads[t], nil, { context in
+      Unmanaged<ThreadBody>.fromOpaque(context).takeRetainedValue().body()
+      return nil
+    }, context)
+    CheckResults(rc == 0, "pthread_create failed in ThreadContention")
+  }
+  for t in 0..<numThreads {
+    pthread_join(threads[t]!, nil)
+  }
+}
+
+@inline(never)
+public func run_ThreadContentionArrayCOW(_ N: Int) {
+  let numThreads = benchmarkNumThreads
+  let shared = [Int](repeating: 1, count: 512)
+  // Per-thread result slots, so the workers never write shared memory.
+  let checks = UnsafeMutablePointer<Int>.allocate(capacity: numThreads)
+  for _ in 1...N {
+    runOnThreads(numThreads) { t in
+      var local = 0
+      for _ in 0..<1_000 {
+        // Copying and mutating forces a COW copy while the shared
+        // buffer's refcount is being touched from every thread.
+        var copy = shared
+        copy[t] += 1
+        local += copy[t]
+      }
+      checks[t] = local
+    }
+  }
+  var total = 0
+  for t in 0..<numThreads {
+    total += checks[t]
+  }
+  checks.deallocate(capacity: numThreads)
+  CheckResults(total == numThreads * 1_000 * 2,
+               "IncorrectResults in ThreadContentionArrayCOW: " +
+               "\(total) != \(numThreads * 1_000 * 2).")
+}
+
+final class GraphNode {
+  let payload: Int
+  let next: GraphNode?
+  init(payload: Int, next: GraphNode?) {
+    self.payload = payload
+    self.next = next
+  }
+}
+
+@inline(never)
+public func run_ThreadContentionRetainRelease(_ N: Int) {
+  let numThreads = benchmarkNumThreads
+  // A small shared graph; every traversal retains and releases each node
+  // from every thread at once.
+  var head: GraphNode? = nil
+  for i in 0..<64 {
+    head = GraphNode(payload: i, next: head)
+  }
+  let graph = head!
+  let checks = UnsafeMutablePointer<Int>.allocate(capacity: numThreads)
+  for _ in 1...N {
+    runOnThreads(numThreads) { t in
+      var local = 0
+      for _ in 0..<1_000 {
+        var cursor: GraphNode? = graph
+        while let node = cursor {
+          local += node.payload
+          cursor = node.next
+        }
+      }
+      checks[t] = local
+    }
+  }
+  var total = 0
+  for t in 0..<numThreads {
+    total += checks[t]
+  }
+  checks.deallocate(capacity: numThreads)
+  // Each traversal sums 0 through 63.
+  let expected = numThreads * 1_000 * (63 * 64 / 2)
+  CheckResults(total == expected,
+               "IncorrectResults in ThreadContentionRetainRelease: " +
+               "\(total) != \(expected).")
+}
+
+@inline(never)
+public func run_ThreadContentionDictionaryRead(_ N: Int) {
+  let numThreads = benchmarkNumThreads
+  var dict = Dictionary<Int, Int>(minimumCapacity: 1_024)
+  for i in 0..<1_024 {
+    dict[i] = i
+  }
+  let shared = dict
+  let checks = UnsafeMutablePointer<Int>.allocate(capacity: numThreads)
+  for _ in 1...N {
+    runOnThreads(numThreads) { t in
+      var local = 0
+      for _ in 0..<10 {
+        for i in 0..<1_024 {
+          if shared[i] != nil {
+            local += 1
+          }
+        }
+      }
+      checks[t] = local
+    }
+  }
+  var total = 0
+  for t in 0..<numThreads {
+    total += checks[t]
+  }
+  checks.deallocate(capacity: numThreads)
+  CheckResults(total == numThreads * 10 * 1_024,
+               "IncorrectResults in ThreadContentionDictionaryRead: " +
+               "\(total) != \(numThreads * 10 * 1_024).")
+}
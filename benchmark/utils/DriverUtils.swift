@@ -20,8 +20,19 @@ struct BenchResults {
   var mean: UInt64 = 0
   var sd: UInt64 = 0
   var median: UInt64 = 0
+  /// The 95% confidence interval of the median, when running adaptively.
+  /// This is reported on a separate comment line so the column format stays
+  /// compatible with existing consumers.
+  var medianCI: (UInt64, UInt64)? = nil
+  /// Steady-state heap allocations per iteration and peak live heap
+  /// bytes, when the runtime was built with allocation tracing.  Also
+  /// reported on comment lines.
+  var allocsPerIter: UInt64? = nil
+  var peakLiveBytes: UInt64? = nil
   init() {}
-  init(delim: String, sampleCount: UInt64, min: UInt64, max: UInt64, mean: UInt64, sd: UInt64, median: UInt64) {
+  init(delim: String, sampleCount: UInt64, min: UInt64, max: UInt64,
+       mean: UInt64, sd: UInt64, median: UInt64,
+       medianCI: (UInt64, UInt64)? = nil) {
     self.delim = delim
     self.sampleCount = sampleCount
     self.min = min
@@ -29,6 +40,7 @@ struct BenchResults {
     self.mean = mean
     self.sd = sd
     self.median = median
+    self.medianCI = medianCI
 
     // Sanity the bounds of our results
     precondition(self.min <= self.max, "min should always be <= max")
@@ -85,9 +97,37 @@ struct TestConfig {
   /// iterations.
   var fixedNumIters: UInt = 0
 
-  /// The number of samples we should take of each test.
+  /// The number of samples we should take of each test.  In adaptive mode
+  /// this is the minimum number of samples.
   var numSamples: Int = 1
 
+  /// When non-nil, keep sampling each test until the 95% confidence
+  /// interval of the median is within this fraction of the median (or the
+  /// sample budget runs out), and reject outlier samples before reporting.
+  var ciThreshold: Double? = nil
+
+  /// The sample budget for adaptive mode.
+  var maxSamples: Int = 30
+
+  /// Should each individual sample be printed (as a comment line)?
+  var printSamples: Bool = false
+
+  /// When non-empty, rerun each test at each of these working-set sizes
+  /// (in elements) instead of once at the benchmark's default size.  Only
+  /// benchmarks that consult the TestsUtils working-set knob react to it;
+  /// the rest just repeat their normal measurement.
+  var sweepSizes = [Int]()
+
+  /// When non-empty, rerun each test at each of these worker-thread
+  /// counts.  Only the contention benchmarks that consult the TestsUtils
+  /// thread-count knob react to it.
+  var threadSweep = [Int]()
+
+  /// When non-nil, fail the run (exit nonzero) if any test's steady-state
+  /// allocations per iteration exceed this limit.  Requires a runtime
+  /// built with allocation tracing; otherwise the gate passes vacuously.
+  var maxAllocsPerIter: UInt64? = nil
+
   /// Is verbose output enabled?
   var verbose: Bool = false
 
@@ -104,6 +144,8 @@ struct TestConfig {
   mutating func processArguments() -> TestAction {
     let validOptions = [
       "--iter-scale", "--num-samples", "--num-iters",
+      "--adaptive", "--max-samples", "--print-samples", "--sweep",
+      "--threads", "--max-allocs-per-iter",
       "--verbose", "--delim", "--run-all", "--list", "--sleep"
     ]
     let maybeBenchArgs: Arguments? = parseArgs(validOptions)
@@ -131,6 +173,64 @@ struct TestConfig {
       numSamples = Int(x)!
     }
 
+    if let x = benchArgs.optionalArgsMap["--adaptive"] {
+      if x.isEmpty {
+        // Tight enough to trust 1% regressions.
+        ciThreshold = 0.01
+      } else if let pct = Double(x) {
+        ciThreshold = pct / 100.0
+      } else {
+        return .Fail("--adaptive requires a numeric percent value")
+      }
+    }
+
+    if let x = benchArgs.optionalArgsMap["--max-samples"] {
+      if x.isEmpty { return .Fail("--max-samples requires a value") }
+      maxSamples = Int(x)!
+    }
+
+    if let _ = benchArgs.optionalArgsMap["--print-samples"] {
+      printSamples = true
+    }
+
+    if let x = benchArgs.optionalArgsMap["--sweep"] {
+      if x.isEmpty {
+        // Element counts spanning roughly L1, L2, LLC and DRAM residency.
+        sweepSizes = [1 << 10, 1 << 13, 1 << 16, 1 << 19, 1 << 22]
+      } else {
+        for s in x.characters.split(separator: ",").map(String.init) {
+          let v: Int? = Int(s)
+          if v == nil || v! <= 0 {
+            return .Fail("--sweep requires a comma-separated list of sizes")
+          }
+          sweepSizes.append(v!)
+        }
+      }
+    }
+
+    if let x = benchArgs.optionalArgsMap["--threads"] {
+      if x.isEmpty {
+        threadSweep = [1, 2, 4, 8]
+      } else {
+        for s in x.characters.split(separator: ",").map(String.init) {
+          let v: Int? = Int(s)
+          if v == nil || v! <= 0 {
+            return .Fail("--threads requires a comma-separated list of counts")
+          }
+          threadSweep.append(v!)
+        }
+      }
+    }
+
+    if let x = benchArgs.optionalArgsMap["--max-allocs-per-iter"] {
+      if x.isEmpty { return .Fail("--max-allocs-per-iter requires a value") }
+      let v: UInt64? = UInt64(x)
+      if v == nil {
+        return .Fail("--max-allocs-per-iter requires a non-negative value")
+      }
+      maxAllocsPerIter = v!
+    }
+
     if let _ = benchArgs.optionalArgsMap["--verbose"] {
       verbose = true
       print("Verbose")
@@ -217,6 +317,48 @@ func internalMedian(_ inputs: [UInt64]) -> UInt64 {
   return inputs.sorted()[inputs.count / 2]
 }
 
+/// Drop samples outside Tukey's fences (1.5 IQR beyond the quartiles).
+/// These are almost always scheduling or thermal artifacts, and rejecting
+/// them is what lets the adaptive mode converge on noisy machines.
+func internalRejectOutliers(_ inputs: [UInt64]) -> [UInt64] {
+  if inputs.count < 5 {
+    return inputs
+  }
+  let sorted = inputs.sorted()
+  let q1 = Double(sorted[sorted.count / 4])
+  let q3 = Double(sorted[(3 * sorted.count) / 4])
+  let iqr = q3 - q1
+  let lo = q1 - 1.5 * iqr
+  let hi = q3 + 1.5 * iqr
+  let kept = inputs.filter { Double($0) >= lo && Double($0) <= hi }
+  return kept.isEmpty ? inputs : kept
+}
+
+/// A nonparametric 95% confidence interval for the median, using the
+/// normal approximation to the binomial for the order-statistic ranks.
+func internalMedianCI(_ inputs: [UInt64]) -> (UInt64, UInt64) {
+  let sorted = inputs.sorted()
+  let n = sorted.count
+  if n < 2 {
+    let only = sorted.first ?? 0
+    return (only, only)
+  }
+  let halfWidth = 1.96 * Double(n).squareRoot() / 2.0
+  let mid = Double(n) / 2.0
+  let lo = Swift.max(0, Int(floor(mid - halfWidth)))
+  let hi = Swift.min(n - 1, Int(ceil(mid + halfWidth)))
+  return (sorted[lo], sorted[hi])
+}
+
+/// Forwards the requested working-set size to TestsUtils.  DriverUtils and
+/// TestsUtils are built as independent modules, so the driver cannot import
+/// the knob directly; the generated main.swift wires this up instead.
+public var setWorkingSetSize: ((Int?) -> Void)? = nil
+
+/// Forwards the requested worker-thread count to TestsUtils, wired up by
+/// the generated main.swift for the same reason as setWorkingSetSize.
+public var setNumThreads: ((Int) -> Void)? = nil
+
 #if SWIFT_RUNTIME_ENABLE_LEAK_CHECKER
 
 @_silgen_name("swift_leaks_startTrackingObjects")
@@ -226,8 +368,21 @@ func stopTrackingObjects(_: UnsafeMutableRawPointer) -> Int
 
 #endif
 
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+
+@_silgen_name("swift_allocationTrace_totalAllocations")
+func totalAllocations() -> Int
+@_silgen_name("swift_allocationTrace_liveBytes")
+func liveBytes() -> Int
+
+#endif
+
 class SampleRunner {
   var info = mach_timebase_info_data_t(numer: 0, denom: 0)
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+  /// Heap allocations made during the last call to run().
+  var lastSampleAllocs: UInt64 = 0
+#endif
   init() {
     mach_timebase_info(&info)
   }
@@ -236,11 +391,17 @@ class SampleRunner {
 #if SWIFT_RUNTIME_ENABLE_LEAK_CHECKER
     var str = name
     startTrackingObjects(UnsafeMutableRawPointer(str._core.startASCII))
+#endif
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+    let allocsBefore = totalAllocations()
 #endif
     let start_ticks = mach_absolute_time()
     fn(Int(num_iters))
     // Stop the timer.
     let end_ticks = mach_absolute_time()
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+    lastSampleAllocs = UInt64(totalAllocations() - allocsBefore)
+#endif
 #if SWIFT_RUNTIME_ENABLE_LEAK_CHECKER
     stopTrackingObjects(UnsafeMutableRawPointer(str._core.startASCII))
 #endif
@@ -254,14 +415,24 @@ class SampleRunner {
 /// Invoke the benchmark entry point and return the run time in milliseconds.
 func runBench(_ name: String, _ fn: (Int) -> Void, _ c: TestConfig) -> BenchResults {
 
-  var samples = [UInt64](repeating: 0, count: c.numSamples)
+  var samples = [UInt64]()
 
   if c.verbose {
-    print("Running \(name) for \(c.numSamples) samples.")
+    if let threshold = c.ciThreshold {
+      print("Running \(name) adaptively (CI \(threshold * 100)%," +
+            " at most \(c.maxSamples) samples).")
+    } else {
+      print("Running \(name) for \(c.numSamples) samples.")
+    }
   }
 
   let sampler = SampleRunner()
-  for s in 0..<c.numSamples {
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+  var minAllocsPerIter: UInt64? = nil
+  var peakLiveBytes: UInt64 = 0
+#endif
+  var s = 0
+  while true {
     let time_per_sample: UInt64 = 1_000_000_000 * UInt64(c.iterationScale)
 
     var scale : UInt
@@ -284,24 +455,76 @@ func runBench(_ name: String, _ fn: (Int) -> Void, _ c: TestConfig) -> BenchResu
       scale = 1
     }
     // save result in microseconds or k-ticks
-    samples[s] = elapsed_time / UInt64(scale) / 1000
+    samples.append(elapsed_time / UInt64(scale) / 1000)
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+    // The minimum over samples is the steady state: warm-up allocations
+    // (caches, lazily instantiated metadata) only inflate early samples.
+    let allocsPerIter = sampler.lastSampleAllocs / UInt64(scale)
+    if minAllocsPerIter == nil || allocsPerIter < minAllocsPerIter! {
+      minAllocsPerIter = allocsPerIter
+    }
+    let live = UInt64(liveBytes())
+    if live > peakLiveBytes {
+      peakLiveBytes = live
+    }
+#endif
     if c.verbose {
       print("    Sample \(s),\(samples[s])")
+    } else if c.printSamples {
+      print("#\(c.delim)\(name)\(c.delim)SAMPLE\(c.delim)\(s)\(c.delim)\(samples[s])")
+    }
+    s += 1
+
+    if let threshold = c.ciThreshold {
+      // Keep sampling until the confidence interval of the median is
+      // narrow enough relative to the median, or the budget runs out.
+      if s < Swift.max(c.numSamples, 5) { continue }
+      if s >= c.maxSamples { break }
+      let kept = internalRejectOutliers(samples)
+      let median = internalMedian(kept)
+      let (lo, hi) = internalMedianCI(kept)
+      if median > 0 && Double(hi - lo) / Double(median) <= threshold {
+        break
+      }
+    } else if s >= c.numSamples {
+      break
     }
   }
 
+  // In adaptive mode the reported statistics exclude outlier samples.
+  var medianCI: (UInt64, UInt64)? = nil
+  if c.ciThreshold != nil {
+    samples = internalRejectOutliers(samples)
+    medianCI = internalMedianCI(samples)
+  }
+
   let (mean, sd) = internalMeanSD(samples)
 
   // Return our benchmark results.
-  return BenchResults(delim: c.delim, sampleCount: UInt64(samples.count),
-                      min: samples.min()!, max: samples.max()!,
-                      mean: mean, sd: sd, median: internalMedian(samples))
+  var results = BenchResults(delim: c.delim, sampleCount: UInt64(samples.count),
+                             min: samples.min()!, max: samples.max()!,
+                             mean: mean, sd: sd, median: internalMedian(samples),
+                             medianCI: medianCI)
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+  results.allocsPerIter = minAllocsPerIter
+  results.peakLiveBytes = peakLiveBytes
+#endif
+  return results
 }
 
 func printRunInfo(_ c: TestConfig) {
   if c.verbose {
     print("--- CONFIG ---")
     print("NumSamples: \(c.numSamples)")
+    if let threshold = c.ciThreshold {
+      print("Adaptive: CI \(threshold * 100)%, MaxSamples \(c.maxSamples)")
+    }
+    if !c.sweepSizes.isEmpty {
+      print("Sweep Sizes: \(c.sweepSizes)")
+    }
+    if !c.threadSweep.isEmpty {
+      print("Thread Sweep: \(c.threadSweep)")
+    }
     print("Verbose: \(c.verbose)")
     print("IterScale: \(c.iterationScale)")
     if c.fixedNumIters != 0 {
@@ -320,7 +543,9 @@ func printRunInfo(_ c: TestConfig) {
   }
 }
 
-func runBenchmarks(_ c: TestConfig) {
+/// Returns false when the allocation gate (--max-allocs-per-iter) failed.
+func runBenchmarks(_ c: TestConfig) -> Bool {
+  var allocGatePassed = true
   let units = "us"
   print("#\(c.delim)TEST\(c.delim)SAMPLES\(c.delim)MIN(\(units))\(c.delim)MAX(\(units))\(c.delim)MEAN(\(units))\(c.delim)SD(\(units))\(c.delim)MEDIAN(\(units))")
   var SumBenchResults = BenchResults()
@@ -333,22 +558,63 @@ func runBenchmarks(_ c: TestConfig) {
     let BenchIndex = t.index
     let BenchName = t.name
     let BenchFunc = t.f
-    let results = runBench(BenchName, BenchFunc, c)
-    print("\(BenchIndex)\(c.delim)\(BenchName)\(c.delim)\(results.description)")
-    fflush(stdout)
-
-    SumBenchResults.min += results.min
-    SumBenchResults.max += results.max
-    SumBenchResults.mean += results.mean
-    SumBenchResults.sampleCount += 1
-    // Don't accumulate SD and Median, as simple sum isn't valid for them.
-    // TODO: Compute SD and Median for total results as well.
-    // SumBenchResults.sd += results.sd
-    // SumBenchResults.median += results.median
+
+    // With no sweep, this is a single run at the benchmark's default size.
+    let sizes: [Int?] = c.sweepSizes.isEmpty ? [nil] : c.sweepSizes.map { $0 }
+    let threadCounts: [Int?] =
+      c.threadSweep.isEmpty ? [nil] : c.threadSweep.map { $0 }
+    for size in sizes {
+     for numThreads in threadCounts {
+      var rowName = BenchName
+      if let size = size {
+        setWorkingSetSize?(size)
+        rowName = "\(BenchName)/\(size)"
+      }
+      if let numThreads = numThreads {
+        setNumThreads?(numThreads)
+        rowName += "/t\(numThreads)"
+      }
+      let results = runBench(BenchName, BenchFunc, c)
+      print("\(BenchIndex)\(c.delim)\(rowName)\(c.delim)\(results.description)")
+      if let ci = results.medianCI {
+        // A comment line, so existing column parsers are unaffected.
+        print("#\(c.delim)\(rowName)\(c.delim)MEDIAN_CI(us)\(c.delim)\(ci.0)\(c.delim)\(ci.1)")
+      }
+      if let size = size {
+        // Time per element makes the cache cliffs visible at a glance.
+        let nsPerElement = Double(results.median) * 1000.0 / Double(size)
+        print("#\(c.delim)\(rowName)\(c.delim)NS_PER_ELEMENT\(c.delim)\(nsPerElement)")
+      }
+      if let allocs = results.allocsPerIter {
+        print("#\(c.delim)\(rowName)\(c.delim)ALLOCS_PER_ITER\(c.delim)\(allocs)")
+        if let limit = c.maxAllocsPerIter, allocs > limit {
+          print("#\(c.delim)\(rowName)\(c.delim)ALLOC_GATE_FAILED\(c.delim)\(allocs) > \(limit)")
+          allocGatePassed = false
+        }
+      }
+      if let peak = results.peakLiveBytes {
+        print("#\(c.delim)\(rowName)\(c.delim)PEAK_LIVE_BYTES\(c.delim)\(peak)")
+      }
+      fflush(stdout)
+
+      SumBenchResults.min += results.min
+      SumBenchResults.max += results.max
+      SumBenchResults.mean += results.mean
+      SumBenchResults.sampleCount += 1
+      // Don't accumulate SD and Median, as simple sum isn't valid for them.
+      // TODO: Compute SD and Median for total results as well.
+      // SumBenchResults.sd += results.sd
+      // SumBenchResults.median += results.median
+     }
+    }
+    if !c.sweepSizes.isEmpty {
+      setWorkingSetSize?(nil)
+    }
   }
 
   print("")
   print("Totals\(c.delim)\(SumBenchResults.description)")
+  return allocGatePassed
 }
 
 public func main() {
@@ -367,9 +633,12 @@ public func main() {
     case .Run:
       config.findTestsToRun()
       printRunInfo(config)
-      runBenchmarks(config)
+      let passed = runBenchmarks(config)
       if let x = config.afterRunSleep {
         sleep(UInt32(x))
       }
+      if !passed {
+        exit(1)
+      }
   }
 }
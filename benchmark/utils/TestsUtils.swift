@@ -45,6 +45,25 @@ public func Random() -> Int64 {
   return lfsrRandomGenerator.randInt()
 }
 
+/// The working-set size (in elements) requested by the driver's --sweep
+/// mode, or nil to use each benchmark's historical default size.
+///
+/// Size-aware benchmarks consult this (usually via scaledWorkingSetSize)
+/// when building their data so a sweep can walk the working set from
+/// cache-resident to DRAM-resident.
+public var benchmarkWorkingSetSize: Int? = nil
+
+/// Returns the element count a size-aware benchmark should use, given the
+/// size it has historically used.  Outside of a sweep this is the identity.
+public func scaledWorkingSetSize(_ defaultSize: Int) -> Int {
+  return benchmarkWorkingSetSize ?? defaultSize
+}
+
+/// The number of worker threads a contention benchmark should spawn.
+/// Set by the driver's --threads sweep; the default keeps the contention
+/// tests meaningful in an ordinary single-configuration run.
+public var benchmarkNumThreads: Int = 4
+
 public func CheckResults(_ res: Bool, _ message: String = "") {
   if res {
     return
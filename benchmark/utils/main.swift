@@ -38,6 +38,7 @@ import Calculator
 import CaptureProp
 import Chars
 import ClassArrayGetter
+import ConformanceCheck
 import DeadArray
 import DictTest
 import DictTest2
@@ -46,6 +47,7 @@ import DictionaryBridge
 import DictionaryLiteral
 import DictionaryRemove
 import DictionarySwap
+import DynamicCasts
 import ErrorHandling
 import Fibonacci
 import GlobalClass
@@ -58,6 +60,7 @@ import Join
 import LinkedList
 import MapReduce
 import Memset
+import MetadataLookup
 import MonteCarloE
 import MonteCarloPi
 import NSDictionaryCastToSwift
@@ -80,6 +83,7 @@ import RC4
 import RGBHistogram
 import RangeAssignment
 import RecursiveOwnedParameter
+import RetainRelease
 import SetTests
 import SevenBoom
 import Sim2DArray
@@ -94,6 +98,7 @@ import StringInterpolation
 import StringTests
 import StringWalk
 import SuperChars
+import ThreadContention
 import TwoSum
 import TypeFlood
 import UTF8Decode
@@ -123,6 +128,7 @@ precommitTests = [
   "CaptureProp": run_CaptureProp,
   "Chars": run_Chars,
   "ClassArrayGetter": run_ClassArrayGetter,
+  "ConformanceCheck": run_ConformanceCheck,
   "DeadArray": run_DeadArray,
   "Dictionary": run_Dictionary,
   "DictionaryOfObjects": run_DictionaryOfObjects,
@@ -136,6 +142,7 @@ precommitTests = [
   "DictionaryRemoveOfObjects": run_DictionaryRemoveOfObjects,
   "DictionarySwap": run_DictionarySwap,
   "DictionarySwapOfObjects": run_DictionarySwapOfObjects,
+  "DynamicCasts": run_DynamicCasts,
   "ErrorHandling": run_ErrorHandling,
   "GlobalClass": run_GlobalClass,
   "Hanoi": run_Hanoi,
@@ -147,6 +154,7 @@ precommitTests = [
   "LinkedList": run_LinkedList,
   "MapReduce": run_MapReduce,
   "Memset": run_Memset,
+  "MetadataLookup": run_MetadataLookup,
   "MonteCarloE": run_MonteCarloE,
   "MonteCarloPi": run_MonteCarloPi,
   "NSDictionaryCastToSwift": run_NSDictionaryCastToSwift,
@@ -204,6 +212,7 @@ precommitTests = [
   "RGBHistogramOfObjects": run_RGBHistogramOfObjects,
   "RangeAssignment": run_RangeAssignment,
   "RecursiveOwnedParameter": run_RecursiveOwnedParameter,
+  "RetainRelease": run_RetainRelease,
   "SetExclusiveOr": run_SetExclusiveOr,
   "SetIntersect": run_SetIntersect,
   "SetIsSubsetOf": run_SetIsSubsetOf,
@@ -231,6 +240,9 @@ precommitTests = [
   "StringWalk": run_StringWalk,
   "StringWithCString": run_StringWithCString,
   "SuperChars": run_SuperChars,
+  "ThreadContentionArrayCOW": run_ThreadContentionArrayCOW,
+  "ThreadContentionDictionaryRead": run_ThreadContentionDictionaryRead,
+  "ThreadContentionRetainRelease": run_ThreadContentionRetainRelease,
   "TwoSum": run_TwoSum,
   "TypeFlood": run_TypeFlood,
   "UTF8Decode": run_UTF8Decode,
@@ -243,5 +255,9 @@ otherTests = [
   "Fibonacci": run_Fibonacci,
 ]
 
+// Let --sweep scale working sets: DriverUtils cannot import TestsUtils, so
+// the knob is forwarded through a function value installed here.
+setWorkingSetSize = { benchmarkWorkingSetSize = $0 }
+setNumThreads = { benchmarkNumThreads = $0 }
 
 main()
@@ -48,6 +48,7 @@ namespace clang {
 }
 
 namespace swift {
+  class AbstractStorageDecl;
   class ASTContext;
   enum class Associativity : unsigned char;
   class BoundGenericType;
@@ -104,6 +105,24 @@ enum class AllocationArena {
   ConstraintSolver
 };
 
+/// \brief The broad kind of AST entity an ASTContext allocation is for.
+///
+/// Used to attribute arena memory to specific AST shapes when dumping
+/// statistics; allocations made through paths that do not identify
+/// themselves are accounted as Other.
+enum class AllocationKind : uint8_t {
+  Type,
+  Decl,
+  Expr,
+  Stmt,
+  Pattern,
+  TypeRepr,
+  Substitution,
+  Other
+};
+
+enum { NumAllocationKinds = unsigned(AllocationKind::Other) + 1 };
+
 /// Lists the set of "known" Foundation entities that are used in the
 /// compiler.
 ///
@@ -235,6 +254,15 @@ public:
   llvm::DenseMap<std::pair<GenericSignature*, ModuleDecl*>,
                  CanGenericSignature> ManglingSignatures;
 
+  /// Cache of declaration USRs, which the indexer and SourceKit request
+  /// repeatedly for the same declarations. The strings live in this
+  /// context's arena; an empty entry records that USR generation failed.
+  llvm::DenseMap<const ValueDecl *, StringRef> DeclUSRs;
+
+  /// Cache of accessor USRs, keyed by storage declaration and accessor kind.
+  llvm::DenseMap<std::pair<const AbstractStorageDecl *, unsigned>, StringRef>
+    AccessorUSRs;
+
 private:
   /// \brief The current generation number, which reflects the number of
   /// times that external modules have been loaded.
@@ -249,15 +277,55 @@ public:
   llvm::BumpPtrAllocator &
   getAllocator(AllocationArena arena = AllocationArena::Permanent) const;
 
+  /// \brief Running count and byte total for one AllocationKind.
+  struct AllocationAccount {
+    size_t Count = 0;
+    size_t Bytes = 0;
+  };
+
+private:
+  /// \brief Per-kind accounting of Allocate calls, indexed by AllocationKind.
+  ///
+  /// Mutable because allocation is permitted from const contexts.
+  mutable AllocationAccount AllocationAccounts[NumAllocationKinds];
+
+  /// \brief The highest value getTotalMemory() has been observed to reach.
+  ///
+  /// Updated by noteMemoryHighWater(), which is called when a
+  /// constraint-solver arena is torn down, since that is the only point at
+  /// which arena memory is released.
+  mutable size_t PeakTotalMemory = 0;
+
+public:
+  /// Retrieve the allocation accounting gathered so far for \p kind.
+  const AllocationAccount &getAllocationAccount(AllocationKind kind) const {
+    return AllocationAccounts[unsigned(kind)];
+  }
+
+  /// Record the current total memory usage if it exceeds the recorded peak.
+  void noteMemoryHighWater() const;
+
+  /// Retrieve the peak total memory usage observed so far, in bytes.
+  size_t getPeakTotalMemory() const;
+
+  /// Print per-kind allocation counts and byte totals, along with current
+  /// and peak total memory usage, to \p os.
+  void printAllocationStatistics(llvm::raw_ostream &os) const;
+
   /// Allocate - Allocate memory from the ASTContext bump pointer.
   void *Allocate(unsigned long bytes, unsigned alignment,
-                 AllocationArena arena = AllocationArena::Permanent) const {
+                 AllocationArena arena = AllocationArena::Permanent,
+                 AllocationKind kind = AllocationKind::Other) const {
     if (bytes == 0)
       return nullptr;
 
+    auto &account = AllocationAccounts[unsigned(kind)];
+    account.Count += 1;
+    account.Bytes += bytes;
+
     if (LangOpts.UseMalloc)
       return AlignedAlloc(bytes, alignment);
-    
+
     return getAllocator(arena).Allocate(bytes, alignment);
   }
 
@@ -298,8 +366,9 @@ public:
 
   template <typename T, typename It>
   T *AllocateCopy(It start, It end,
-                  AllocationArena arena = AllocationArena::Permanent) const {
-    T *res = (T*)Allocate(sizeof(T)*(end-start), alignof(T), arena);
+                  AllocationArena arena = AllocationArena::Permanent,
+                  AllocationKind kind = AllocationKind::Other) const {
+    T *res = (T*)Allocate(sizeof(T)*(end-start), alignof(T), arena, kind);
     for (unsigned i = 0; start != end; ++start, ++i)
       new (res+i) T(*start);
     return res;
@@ -313,8 +382,10 @@ public:
 
   template<typename T>
   MutableArrayRef<T> AllocateCopy(ArrayRef<T> array,
-      AllocationArena arena = AllocationArena::Permanent) const {
-    return MutableArrayRef<T>(AllocateCopy<T>(array.begin(),array.end(), arena),
+      AllocationArena arena = AllocationArena::Permanent,
+      AllocationKind kind = AllocationKind::Other) const {
+    return MutableArrayRef<T>(AllocateCopy<T>(array.begin(), array.end(),
+                                              arena, kind),
                               array.size());
   }
 
@@ -705,6 +776,27 @@ public:
   /// \returns the previous generation number.
   unsigned bumpGeneration() { return CurrentGeneration++; }
 
+  /// A single result of a cached visible-member lookup: the declaration and
+  /// the raw DeclVisibilityKind it was reported with.
+  using CachedVisibleMember = std::pair<ValueDecl *, unsigned>;
+
+  /// \brief Retrieve the cached results of a visible-member lookup on
+  /// \p baseTy as seen from \p currDC, or null if there is no entry from
+  /// the current generation.
+  ///
+  /// Code completion performs the same qualified lookups repeatedly within
+  /// one session. Entries recorded before the last generation bump are
+  /// ignored, since newly loaded modules can add extensions to \p baseTy.
+  const std::vector<CachedVisibleMember> *
+  getCachedVisibleMembers(TypeBase *baseTy, const DeclContext *currDC,
+                          unsigned lookupFlags) const;
+
+  /// \brief Record the results of a visible-member lookup for the current
+  /// generation.
+  void cacheVisibleMembers(TypeBase *baseTy, const DeclContext *currDC,
+                           unsigned lookupFlags,
+                           std::vector<CachedVisibleMember> &&members);
+
   /// \brief Produce a "normal" conformance for a nominal type.
   NormalProtocolConformance *
   getConformance(Type conformingType,
@@ -853,11 +945,24 @@ public:
   ArchetypeBuilder *getOrCreateArchetypeBuilder(CanGenericSignature sig,
                                                 ModuleDecl *mod);
 
-  /// Set the stored archetype builder for the given canonical generic
-  /// signature and module.
-  void setArchetypeBuilder(CanGenericSignature sig,
-                           ModuleDecl *mod,
-                           std::unique_ptr<ArchetypeBuilder> builder);
+  /// Retrieve the memoized result of a prior Type::subst call on the given
+  /// type within the given module, if there is one.
+  ///
+  /// \param substitutions The substitution map flattened into
+  /// (canonical original type, replacement type) pairs, sorted by the
+  /// original type pointer.
+  Optional<Type> getCachedTypeSubstitution(
+                   TypeBase *type, ModuleDecl *mod, SubstOptions options,
+                   ArrayRef<std::pair<TypeBase *, TypeBase *>> substitutions);
+
+  /// Memoize the result of a Type::subst call, so that repeated
+  /// substitutions of the same type with the same substitution map need
+  /// not recompute it. The substitution pairs are copied into the
+  /// permanent arena.
+  void setCachedTypeSubstitution(
+         TypeBase *type, ModuleDecl *mod, SubstOptions options,
+         ArrayRef<std::pair<TypeBase *, TypeBase *>> substitutions,
+         Type result);
 
   /// Retrieve the inherited name set for the given class.
   const InheritedNameSet *getAllPropertyNames(ClassDecl *classDecl,
@@ -21,6 +21,8 @@
 #include "swift/AST/TypeLoc.h"
 #include "swift/AST/DeclNameLoc.h"
 #include "swift/Basic/DiagnosticConsumer.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Allocator.h"
 
 namespace swift {
   class Decl;
@@ -241,6 +243,8 @@ namespace swift {
   /// Diagnostic - This is a specific instance of a diagnostic along with all of
   /// the DiagnosticArguments that it requires. 
   class Diagnostic {
+    friend class DiagnosticEngine;
+
   public:
     typedef DiagnosticInfo::FixIt FixIt;
 
@@ -491,12 +495,22 @@ namespace swift {
     /// emitted once all transactions have closed.
     unsigned TransactionCount = 0;
 
+    /// \brief Arena that owns the text of string arguments held by tentative
+    /// diagnostics, so that callers need not keep their temporary strings
+    /// alive until the enclosing transaction commits.
+    llvm::BumpPtrAllocator TransactionAllocator;
+
+    /// \brief The set of strings that have been copied into
+    /// \c TransactionAllocator for the current batch of tentative diagnostics.
+    llvm::StringMap<char, llvm::BumpPtrAllocator &> TransactionStrings;
+
     friend class InFlightDiagnostic;
     friend class DiagnosticTransaction;
-    
+
   public:
     explicit DiagnosticEngine(SourceManager &SourceMgr)
-      : SourceMgr(SourceMgr), ActiveDiagnostic() {
+      : SourceMgr(SourceMgr), ActiveDiagnostic(),
+        TransactionStrings(TransactionAllocator) {
     }
 
     /// hadAnyError - return true if any *error* diagnostics have been emitted.
@@ -709,6 +723,10 @@ namespace swift {
     /// \brief Send all tentative diagnostics to all diagnostic consumers and
     /// delete them.
     void emitTentativeDiagnostics();
+
+    /// \brief Copy any argument text that \p diagnostic merely references into
+    /// \c TransactionAllocator before the diagnostic is saved tentatively.
+    void onTentativeDiagnosticFlush(Diagnostic &diagnostic);
   };
 
   /// \brief Represents a diagnostic transaction. While a transaction is
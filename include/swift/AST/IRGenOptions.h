@@ -151,6 +151,9 @@ public:
   /// Emit names of struct stored properties and enum cases.
   unsigned EnableReflectionNames : 1;
 
+  /// Print a per-type report of the sizes of emitted reflection metadata.
+  unsigned EnableReflectionSizeReport : 1;
+
   /// Should we try to build incrementally by not emitting an object file if it
   /// has the same IR hash as the module that we are preparing to emit?
   ///
@@ -177,6 +180,7 @@ public:
         PrintInlineTree(false), EmbedMode(IRGenEmbedMode::None),
         HasValueNamesSetting(false), ValueNames(false),
         EnableReflectionMetadata(true), EnableReflectionNames(true),
+        EnableReflectionSizeReport(false),
         UseIncrementalLLVMCodeGen(true), UseSwiftCall(false), CmdArgs(),
         SanitizeCoverage(llvm::SanitizerCoverageOptions()) {}
 
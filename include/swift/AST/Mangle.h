@@ -53,6 +53,12 @@ class Mangler {
   bool OptimizeProtocolNames;
 
 public:
+  /// Running totals across all Mangler instances in this process, recorded
+  /// into the unified stats output at the end of a frontend job.
+  static uint64_t NumMangledNames;
+  static uint64_t NumSubstitutionHits;
+  static uint64_t NumSubstitutionMisses;
+
   /// Finish the mangling of the symbol and return the mangled name.
   std::string finalize();
 
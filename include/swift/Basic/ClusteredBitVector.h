@@ -483,6 +483,56 @@ public:
     getChunksPtr()[i / ChunkSizeInBits] &= ~(ChunkType(1) << (i % ChunkSizeInBits));
   }
 
+  /// Set all the bits in the range [begin, end).  This works a whole
+  /// chunk at a time, so prefer it to a loop of setBit when marking a
+  /// contiguous range as occupied.
+  void setRange(size_t begin, size_t end) {
+    assert(begin <= end && end <= size());
+    if (begin == end) return;
+    if (isInlineAndAllClear()) {
+      reserve(LengthInBits);
+    }
+    auto chunks = getChunksPtr();
+    auto firstChunk = begin / ChunkSizeInBits;
+    auto lastChunk = (end - 1) / ChunkSizeInBits;
+    auto headMask = ~ChunkType(0) << (begin % ChunkSizeInBits);
+    auto tailMask =
+      ~ChunkType(0) >> (ChunkSizeInBits - 1 - ((end - 1) % ChunkSizeInBits));
+    if (firstChunk == lastChunk) {
+      chunks[firstChunk] |= (headMask & tailMask);
+      return;
+    }
+    chunks[firstChunk] |= headMask;
+    for (auto i = firstChunk + 1; i != lastChunk; ++i)
+      chunks[i] = ~ChunkType(0);
+    chunks[lastChunk] |= tailMask;
+  }
+
+  /// Clear all the bits in the range [begin, end), a whole chunk at
+  /// a time.
+  void clearRange(size_t begin, size_t end) {
+    assert(begin <= end && end <= size());
+    if (begin == end || isInlineAndAllClear()) return;
+    auto chunks = getChunksPtr();
+    auto firstChunk = begin / ChunkSizeInBits;
+    auto lastChunk = (end - 1) / ChunkSizeInBits;
+    auto headMask = ~ChunkType(0) << (begin % ChunkSizeInBits);
+    auto tailMask =
+      ~ChunkType(0) >> (ChunkSizeInBits - 1 - ((end - 1) % ChunkSizeInBits));
+    if (firstChunk == lastChunk) {
+      chunks[firstChunk] &= ~(headMask & tailMask);
+      return;
+    }
+    chunks[firstChunk] &= ~headMask;
+    for (auto i = firstChunk + 1; i != lastChunk; ++i)
+      chunks[i] = 0;
+    chunks[lastChunk] &= ~tailMask;
+  }
+
+  /// Return the sub-vector [begin, begin + numBits) of this vector.
+  /// The bits are copied a whole chunk at a time.
+  ClusteredBitVector slice(size_t begin, size_t numBits) const;
+
   /// Toggle bit i.
   void flipBit(size_t i) {
     assert(i < size());
@@ -161,23 +161,28 @@ private:
   typedef std::vector<NodePointer> NodeVector;
   NodeVector Children;
 
-  Node(Kind k)
+  Node(const Node &) = delete;
+  Node &operator=(const Node &) = delete;
+
+public:
+  /// A key restricting construction to NodeFactory while leaving the
+  /// constructors public so that std::make_shared can call them.
+  class FactoryKey {
+    FactoryKey() = default;
+    friend struct NodeFactory;
+  };
+
+  Node(FactoryKey, Kind k)
       : NodeKind(k), NodePayloadKind(PayloadKind::None) {
   }
-  Node(Kind k, std::string &&t)
+  Node(FactoryKey, Kind k, std::string &&t)
       : NodeKind(k), NodePayloadKind(PayloadKind::Text) {
     new (&TextPayload) std::string(std::move(t));
   }
-  Node(Kind k, IndexType index)
+  Node(FactoryKey, Kind k, IndexType index)
       : NodeKind(k), NodePayloadKind(PayloadKind::Index) {
     IndexPayload = index;
   }
-  Node(const Node &) = delete;
-  Node &operator=(const Node &) = delete;
-
-  friend struct NodeFactory;
-
-public:
   ~Node();
 
   Kind getKind() const { return NodeKind; }
@@ -275,6 +280,16 @@ demangleSymbolAsString(const std::string &mangledName,
                                 options);
 }
 
+/// \brief Demangle the given string as a Swift symbol, streaming the result
+/// into \p out.
+///
+/// Behaves like the std::string overloads, but writes the demangling (or,
+/// when the input is not a valid Swift mangled name, the mangled text itself)
+/// directly to the stream without materializing an intermediate string.
+/// Useful for callers that demangle many names into one buffer.
+void demangleSymbolAsString(llvm::StringRef mangledName, llvm::raw_ostream &out,
+                            const DemangleOptions &options = DemangleOptions());
+
 /// \brief Demangle the given string as a Swift type.
 ///
 /// Typical usage:
@@ -350,22 +365,30 @@ std::string mangleNode(const NodePointer &root);
 std::string nodeToString(NodePointer Root,
                          const DemangleOptions &Options = DemangleOptions());
 
+/// \brief Transform the node structure in a string, streaming the result into
+/// \p Out instead of materializing it.
+void nodeToString(NodePointer Root, llvm::raw_ostream &Out,
+                  const DemangleOptions &Options = DemangleOptions());
+
 struct NodeFactory {
+  // Nodes are created with std::make_shared so that the node and its
+  // reference count share a single allocation; with the node counts the
+  // demangler produces this halves the allocator traffic.
   static NodePointer create(Node::Kind K) {
-    return NodePointer(new Node(K));
+    return std::make_shared<Node>(Node::FactoryKey(), K);
   }
   static NodePointer create(Node::Kind K, Node::IndexType Index) {
-    return NodePointer(new Node(K, Index));
+    return std::make_shared<Node>(Node::FactoryKey(), K, Index);
   }
   static NodePointer create(Node::Kind K, llvm::StringRef Text) {
-    return NodePointer(new Node(K, Text));
+    return std::make_shared<Node>(Node::FactoryKey(), K, Text.str());
   }
   static NodePointer create(Node::Kind K, std::string &&Text) {
-    return NodePointer(new Node(K, std::move(Text)));
+    return std::make_shared<Node>(Node::FactoryKey(), K, std::move(Text));
   }
   template <size_t N>
   static NodePointer create(Node::Kind K, const char (&Text)[N]) {
-    return NodePointer(new Node(K, llvm::StringRef(Text)));
+    return std::make_shared<Node>(Node::FactoryKey(), K, std::string(Text));
   }
 };
 
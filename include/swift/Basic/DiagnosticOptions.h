@@ -36,6 +36,10 @@ public:
   /// without any filtering.
   bool FixitCodeForAllDiagnostics = false;
 
+  /// Collect the fixits from the whole compilation and apply the
+  /// non-overlapping ones to the source files in one batch afterwards.
+  bool ApplyFixitsInPlace = false;
+
   /// Suppress all warnings
   bool SuppressWarnings = false;
 
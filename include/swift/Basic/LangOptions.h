@@ -123,10 +123,24 @@ namespace swift {
     /// ID of the current process for the purposes of AST verification.
     unsigned ASTVerifierProcessId = 1U;
 
+    /// If greater than one, verify only a deterministic 1-in-N sample of
+    /// the declarations in each compilation. The sample is seeded by the
+    /// name of the file containing each declaration, so repeated builds of
+    /// the same project verify the same declarations while different files
+    /// contribute different samples.
+    unsigned ASTVerifierSamplePeriod = 0U;
+
     /// \brief The upper bound, in bytes, of temporary data that can be
     /// allocated by the constraint solver.
     unsigned SolverMemoryThreshold = 33554432; /* 32 * 1024 * 1024 */
 
+    /// \brief The upper bound on the number of solver scopes the constraint
+    /// solver may explore for a single expression, or 0 for no bound.
+    ///
+    /// When the bound is exceeded the expression is marked too complex, but
+    /// any solutions already found are still ranked and the best one applied.
+    unsigned SolverScopeThreshold = 0;
+
     /// \brief Perform all dynamic allocations using malloc/free instead of
     /// optimized custom allocator, so that memory debugging tools can be used.
     bool UseMalloc = false;
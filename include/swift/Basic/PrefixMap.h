@@ -51,9 +51,17 @@ template <class KeyElementType> class PrefixMapKeyPrinter;
 
 /// A map whose keys are sequences of comparable values, optimized for
 /// finding a mapped value for the longest matching initial subsequence.
+///
+/// By default, the inline key storage is sized so that the node header
+/// (three sibling/child pointers plus the key length and value flag)
+/// and the key data together fill one 64-byte cache line.  Keys longer
+/// than that are spread over a chain of nodes, so packing as much key
+/// data as possible next to the pointers keeps a lookup down to one
+/// line fill per node visited.
 template <class KeyElementType, class ValueType,
           size_t InlineKeyCapacity
-             = max<size_t>((sizeof(void*) - 1) / sizeof(KeyElementType), 1)>
+             = max<size_t>((64 - 3 * sizeof(void*) - 1)
+                             / sizeof(KeyElementType), 1)>
 class PrefixMap {
 public:
   using KeyType = ArrayRef<KeyElementType>;
@@ -0,0 +1,58 @@
+//===--- Statistic.h - Unified stats reporting ------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_BASIC_STATISTIC_H
+#define SWIFT_BASIC_STATISTIC_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Timer.h"
+
+#include <memory>
+
+namespace swift {
+
+/// A collection of always-on counters and timers for a single frontend job,
+/// written out as one JSON file per job so that build infrastructure can
+/// track compile time per file per commit.
+///
+/// Unlike \c SharedTimer and \c llvm::Statistic, which print human-readable
+/// text to stderr, this reporter is machine-readable and enabled in all
+/// build configurations. Subsystems record into the counters struct as the
+/// job passes through them; the file is written when the reporter is
+/// destroyed at the end of the job.
+class UnifiedStatsReporter {
+public:
+  struct AlwaysOnFrontendCounters {
+#define FRONTEND_STATISTIC(NAME) int64_t NAME;
+#include "swift/Basic/Statistics.def"
+  };
+
+  /// \p ProgramName identifies the tool (e.g. "swift-frontend"),
+  /// \p TargetName the primary input or module the job is producing, and
+  /// \p Directory the directory the JSON file is written into.
+  UnifiedStatsReporter(StringRef ProgramName,
+                       StringRef TargetName,
+                       StringRef Directory);
+  ~UnifiedStatsReporter();
+
+  AlwaysOnFrontendCounters &getFrontendCounters();
+
+private:
+  SmallString<128> Filename;
+  llvm::Timer Timer;
+  std::unique_ptr<AlwaysOnFrontendCounters> FrontendCounters;
+};
+
+} // end namespace swift
+
+#endif // SWIFT_BASIC_STATISTIC_H
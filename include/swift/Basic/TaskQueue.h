@@ -46,6 +46,11 @@ class TaskQueue {
   /// The number of tasks to execute in parallel.
   unsigned NumberOfParallelTasks;
 
+  /// The maximum total estimated memory usage of concurrently executing
+  /// tasks, in bytes. If 0, tasks are admitted without regard to their
+  /// estimated memory usage.
+  uint64_t MemoryBudget = 0;
+
 public:
   /// \brief Create a new TaskQueue instance.
   ///
@@ -55,6 +60,21 @@ public:
   TaskQueue(unsigned NumberOfParallelTasks = 0);
   virtual ~TaskQueue();
 
+  /// \brief Limit the total estimated memory usage of concurrently executing
+  /// tasks.
+  ///
+  /// When a budget is set, a queued task is only admitted once the estimated
+  /// memory usage of the currently executing tasks leaves room for its own
+  /// estimate. A task whose estimate exceeds the entire budget still runs,
+  /// but only by itself.
+  ///
+  /// \param Bytes the budget in bytes, or 0 to disable memory-aware
+  /// scheduling.
+  void setMemoryBudget(uint64_t Bytes) { MemoryBudget = Bytes; }
+
+  /// \returns the memory budget in bytes, or 0 if no budget is set.
+  uint64_t getMemoryBudget() const { return MemoryBudget; }
+
   // TODO: remove once -Wdocumentation stops warning for \param, \returns on
   // std::function (<rdar://problem/15665132>).
 #pragma clang diagnostic push
@@ -120,9 +140,13 @@ public:
   /// \param Env the environment which should be used for the task;
   /// must be null-terminated. If empty, inherits the parent's environment.
   /// \param Context an optional context which will be associated with the task
+  /// \param EstimatedMemoryUsage an estimate of the task's peak memory usage
+  /// in bytes, used for admission when a memory budget is set. 0 means
+  /// unknown; such tasks are admitted without regard to the budget.
   virtual void addTask(const char *ExecPath, ArrayRef<const char *> Args,
                        ArrayRef<const char *> Env = llvm::None,
-                       void *Context = nullptr);
+                       void *Context = nullptr,
+                       uint64_t EstimatedMemoryUsage = 0);
 
   /// \brief Synchronously executes the tasks in the TaskQueue.
   ///
@@ -168,7 +192,8 @@ public:
 
   virtual void addTask(const char *ExecPath, ArrayRef<const char *> Args,
                        ArrayRef<const char *> Env = llvm::None,
-                       void *Context = nullptr);
+                       void *Context = nullptr,
+                       uint64_t EstimatedMemoryUsage = 0);
 
   virtual bool
   execute(TaskBeganCallback Began = TaskBeganCallback(),
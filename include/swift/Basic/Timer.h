@@ -20,6 +20,12 @@
 namespace swift {
   /// A convenience class for declaring a timer that's part of the Swift
   /// compilation timers group.
+  ///
+  /// Timers nest: each phase of the frontend pipeline opens one for its
+  /// dynamic extent. Beyond the flat -debug-time-compilation aggregation,
+  /// the nested scopes can be recorded as trace events and written out in
+  /// chrome-tracing JSON (chrome://tracing, or any flamegraph viewer that
+  /// understands the format) via enableTracing()/writeTraceEvents().
   class SharedTimer {
     enum class State {
       Initial,
@@ -27,15 +33,28 @@ namespace swift {
       Enabled
     };
     static State CompilationTimersEnabled;
+    static bool TracingEnabled;
 
     Optional<llvm::NamedRegionTimer> Timer;
 
+    /// The scope's name and start time, captured only when tracing.
+    StringRef Name;
+    uint64_t StartNanos = 0;
+
   public:
-    explicit SharedTimer(StringRef name) {
+    explicit SharedTimer(StringRef name) : Name(name) {
       if (CompilationTimersEnabled == State::Enabled)
         Timer.emplace(name, StringRef("Swift compilation"));
       else
         CompilationTimersEnabled = State::Skipped;
+
+      if (TracingEnabled)
+        recordStart();
+    }
+
+    ~SharedTimer() {
+      if (TracingEnabled)
+        recordEnd();
     }
 
     /// Must be called before any SharedTimers have been created.
@@ -44,6 +63,20 @@ namespace swift {
              "a timer has already been created");
       CompilationTimersEnabled = State::Enabled;
     }
+
+    /// Record every subsequent timer scope as a trace event. Must be called
+    /// before any SharedTimers have been created.
+    static void enableTracing() {
+      TracingEnabled = true;
+    }
+
+    /// Write all trace events recorded so far, from all threads, as
+    /// chrome-tracing JSON.
+    static void writeTraceEvents(llvm::raw_ostream &os);
+
+  private:
+    void recordStart();
+    void recordEnd();
   };
 } // end namespace swift
 
@@ -175,6 +175,9 @@ public:
   ///        against it.
   /// \param expectedModTime The mtime of the header when the module was
   ///        compiled against it.
+  /// \param expectedContentHash A hash of the header's contents when the
+  ///        module was compiled against it, used to recognize a header that
+  ///        has been touched but not actually changed. Zero if unknown.
   /// \param cachedContents A buffer to use if the header has been modified
   ///        since the module was compiled.
   /// \param diagLoc A location to attach any diagnostics to if import fails.
@@ -183,8 +186,8 @@ public:
   ///
   /// \sa getImportedHeaderModule
   bool importHeader(StringRef header, ModuleDecl *adapter, off_t expectedSize,
-                    time_t expectedModTime, StringRef cachedContents,
-                    SourceLoc diagLoc);
+                    time_t expectedModTime, uint64_t expectedContentHash,
+                    StringRef cachedContents, SourceLoc diagLoc);
 
   /// Imports an Objective-C header file into the shared imported header module.
   ///
@@ -209,7 +212,16 @@ public:
   ModuleDecl *getImportedHeaderModule() const override;
 
   std::string getBridgingHeaderContents(StringRef headerPath, off_t &fileSize,
-                                        time_t &fileModTime);
+                                        time_t &fileModTime,
+                                        uint64_t &fileHash);
+
+  /// Compile the given Objective-C bridging header to a precompiled header,
+  /// using the importer's current invocation so the result can be consumed by
+  /// identically-configured jobs via ClangImporterOptions::BridgingHeaderPCH.
+  /// The emitted file embeds the Swift name lookup table for the header.
+  ///
+  /// \returns true if there was an error emitting the PCH.
+  bool emitBridgingPCH(StringRef headerPath, StringRef outputPCHPath);
 
   const clang::Module *getClangOwningModule(ClangNode Node) const;
   bool hasTypedef(const clang::Decl *typeDecl) const;
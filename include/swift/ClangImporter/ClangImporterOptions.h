@@ -24,6 +24,36 @@ public:
   /// The module cache path which the Clang importer should use.
   std::string ModuleCachePath;
 
+  /// The path to a precompiled form (PCH) of the Objective-C bridging header,
+  /// loaded into the importer's compiler instance instead of re-parsing the
+  /// textual header in every frontend job.  The PCH is validated against the
+  /// current invocation by Clang's signature checking, and its embedded Swift
+  /// name lookup table by the lookup-table extension's version hash.
+  std::string BridgingHeaderPCH;
+
+  /// The path of the textual Objective-C bridging header, when one was
+  /// requested with -import-objc-header.
+  std::string BridgingHeader;
+
+  /// A directory in which to keep automatically generated precompiled forms
+  /// of the bridging header, shared by all jobs with the same invocation.
+  ///
+  /// When set, the importer consumes a cached PCH for the bridging header if
+  /// one exists, and generates one after a successful textual import
+  /// otherwise.
+  std::string PrecompiledHeaderOutputDir;
+
+  /// When true, only validate Clang modules in the shared cache once per
+  /// build session instead of in every frontend job.
+  ///
+  /// Parallel frontend jobs otherwise stampede the cache, each re-statting
+  /// every input of every PCM they load.  Requires \c BuildSessionFilePath.
+  bool ValidateModulesOnce = false;
+
+  /// The file whose mtime defines the current build session, for
+  /// \c ValidateModulesOnce.
+  std::string BuildSessionFilePath;
+
   /// Extra arguments which should be passed to the Clang importer.
   std::vector<std::string> ExtraArgs;
 
@@ -95,6 +95,15 @@ private:
   /// A hash representing all the arguments that could trigger a full rebuild.
   std::string ArgsHash;
 
+  /// When non-empty, a directory in which the outputs of frontend jobs are
+  /// cached, keyed on a hash of the job's command line and input contents.
+  /// Jobs whose key is present in the cache are not executed.
+  std::string CompilationCachePath;
+
+  /// When non-zero, the estimated total memory usage (in bytes) of
+  /// concurrently running jobs is kept below this limit.
+  uint64_t MemoryBudget = 0;
+
   /// When the build was started.
   ///
   /// This should be as close as possible to when the driver was invoked, since
@@ -139,7 +148,20 @@ private:
   static const Job *unwrap(const std::unique_ptr<const Job> &p) {
     return p.get();
   }
-  
+
+public:
+  /// The signature of a callback that runs a '-frontend' invocation within
+  /// the current process, given the arguments that follow "-frontend".
+  ///
+  /// The driver library cannot call the frontend directly, so the tool that
+  /// owns this Compilation installs the callback.
+  using InProcessFrontendFn = int (*)(ArrayRef<const char *> Args);
+
+private:
+  /// When non-null and -driver-run-jobs-in-process is passed, used to run
+  /// eligible frontend jobs without spawning a new process.
+  InProcessFrontendFn RunFrontendInProcess = nullptr;
+
 public:
   Compilation(DiagnosticEngine &Diags, OutputLevel Level,
               std::unique_ptr<llvm::opt::InputArgList> InputArgs,
@@ -199,10 +221,23 @@ public:
     CompilationRecordPath = path;
   }
 
+  void setCompilationCachePath(StringRef path) {
+    assert(CompilationCachePath.empty() && "already set");
+    CompilationCachePath = path;
+  }
+
+  void setMemoryBudget(uint64_t bytes) {
+    MemoryBudget = bytes;
+  }
+
   void setLastBuildTime(llvm::sys::TimeValue time) {
     LastBuildTime = time;
   }
 
+  void setInProcessFrontendFn(InProcessFrontendFn fn) {
+    RunFrontendInProcess = fn;
+  }
+
   /// Requests the path to a file containing all input source files. This can
   /// be shared across jobs.
   ///
@@ -182,6 +182,8 @@ protected:
     return Marked.count(node);
   }
 
+  unsigned countDirectDependents(const void *node) const;
+
 public:
   llvm::iterator_range<StringSetIterator> getExternalDependencies() const {
     return llvm::make_range(StringSetIterator(ExternalDependencies.begin()),
@@ -312,6 +314,15 @@ public:
   bool isMarked(T node) const {
     return DependencyGraphImpl::isMarked(Traits::getAsVoidPointer(node));
   }
+
+  /// Returns the number of distinct nodes that directly depend on \p node.
+  ///
+  /// This is a cheap measure of how much downstream work rebuilding \p node
+  /// may unlock, suitable for prioritizing which nodes to process first.
+  unsigned countDirectDependents(T node) const {
+    return DependencyGraphImpl::countDirectDependents(
+        Traits::getAsVoidPointer(node));
+  }
 };
 
 } // end namespace swift
@@ -73,6 +73,10 @@ public:
   void setAdditionalOutputForType(types::ID type, StringRef OutputFilename);
   const std::string &getAdditionalOutputForType(types::ID type) const;
 
+  /// Returns true if the command produces any outputs besides its primary
+  /// outputs.
+  bool hasAdditionalOutputs() const { return !AdditionalOutputsMap.empty(); }
+
   const std::string &getAnyOutputForType(types::ID type) const;
 
   StringRef getBaseInput(int Index) const { return BaseInputs[Index]; }
@@ -326,13 +326,36 @@ class CompilerInstance {
 
   enum : unsigned { NO_SUCH_BUFFER = ~0U };
   unsigned MainBufferID = NO_SUCH_BUFFER;
-  unsigned PrimaryBufferID = NO_SUCH_BUFFER;
+
+  /// The buffer IDs of all primary inputs, in command-line order. Empty when
+  /// compiling the whole module.
+  SmallVector<unsigned, 2> PrimaryBufferIDs;
+
+  /// The primary source files, in the same order as \c PrimaryBufferIDs.
+  SmallVector<SourceFile *, 2> PrimarySourceFiles;
 
   SourceFile *PrimarySourceFile = nullptr;
 
   void createSILModule(bool WholeModule = false);
   void setPrimarySourceFile(SourceFile *SF);
 
+  /// Records \p BufferID as belonging to a primary input.
+  void recordPrimaryBufferID(unsigned BufferID) {
+    PrimaryBufferIDs.push_back(BufferID);
+  }
+
+  /// Returns true if \p BufferID is the buffer of one of the primary inputs.
+  bool isPrimaryBufferID(unsigned BufferID) const {
+    return std::find(PrimaryBufferIDs.begin(), PrimaryBufferIDs.end(),
+                     BufferID) != PrimaryBufferIDs.end();
+  }
+
+  /// Returns true if \p SF is one of the primary source files.
+  bool isPrimarySourceFile(SourceFile *SF) const {
+    return std::find(PrimarySourceFiles.begin(), PrimarySourceFiles.end(),
+                     SF) != PrimarySourceFiles.end();
+  }
+
 public:
   SourceManager &getSourceMgr() { return SourceMgr; }
 
@@ -400,9 +423,14 @@ public:
   }
 
   /// Gets the SourceFile which is the primary input for this CompilerInstance.
-  /// \returns the primary SourceFile, or nullptr if there is no primary input
+  /// \returns the primary SourceFile, or nullptr if there is no primary input;
+  /// if there are multiple primary inputs, the first of them
   SourceFile *getPrimarySourceFile() { return PrimarySourceFile; }
 
+  /// Gets all primary source files for this CompilerInstance. More than one
+  /// is only possible in batch mode.
+  ArrayRef<SourceFile *> getPrimarySourceFiles() { return PrimarySourceFiles; }
+
   /// \brief Returns true if there was an error during setup.
   bool setup(const CompilerInvocation &Invocation);
 
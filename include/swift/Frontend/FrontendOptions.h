@@ -74,6 +74,12 @@ public:
   /// be generated for the whole module.
   Optional<SelectedInput> PrimaryInput;
 
+  /// All inputs for which output should be generated, in command-line order.
+  ///
+  /// In batch mode there may be several of these; \c PrimaryInput is then the
+  /// first of them. Empty when compiling the whole module.
+  std::vector<SelectedInput> PrimaryInputs;
+
   /// The kind of input on which the frontend should operate.
   InputFileKind InputKind = InputFileKind::IFK_Swift;
 
@@ -102,6 +108,10 @@ public:
   /// The path to which we should emit an Objective-C header for the module.
   std::string ObjCHeaderOutputPath;
 
+  /// Whether to split the emitted Objective-C header into per-class
+  /// sub-headers, so that clients can include only what they use.
+  bool SplitObjCHeader = false;
+
   /// Path to a file which should contain serialized diagnostics for this
   /// frontend invocation.
   std::string SerializedDiagnosticsPath;
@@ -181,10 +191,27 @@ public:
   /// \sa swift::SharedTimer
   bool DebugTimeCompilation = false;
 
+  /// If non-empty, the path to which a chrome-tracing JSON record of the
+  /// time taken by each compilation phase should be written.
+  ///
+  /// \sa swift::SharedTimer
+  std::string TraceTimeCompilationPath;
+
+  /// The path to which we should output statistics files.
+  ///
+  /// \sa swift::UnifiedStatsReporter
+  std::string StatsOutputDir;
+
   /// Indicates whether function body parsing should be delayed
   /// until the end of all files.
   bool DelayedFunctionBodyParsing = false;
 
+  /// Indicates whether function bodies in non-primary files should be
+  /// skipped during parsing, with their source ranges recorded so they can
+  /// be re-parsed on demand. Only the primary files' bodies are type checked
+  /// and lowered, so for most of the module this parsing work is wasted.
+  bool LazyNonPrimaryFunctionBodies = false;
+
   /// Indicates whether or not an import statement can pick up a Swift source
   /// file (as opposed to a module file).
   bool EnableSourceImport = false;
@@ -27,8 +27,10 @@
 
 namespace swift {
 class CodeCompletionCallbacksFactory;
+class CompilerInvocation;
 class Decl;
 class DeclContext;
+class DiagnosticConsumer;
 class ModuleDecl;
 
 namespace ide {
@@ -866,6 +868,20 @@ CodeCompletionCallbacksFactory *
 makeCodeCompletionCallbacksFactory(CodeCompletionContext &CompletionContext,
                                    CodeCompletionConsumer &Consumer);
 
+/// \brief Run a single code completion request, feeding the results to
+/// \p Consumer.
+///
+/// \p Invocation must already have its code completion point set.  The
+/// completion context -- and, through it, the result cache -- may be shared
+/// across many calls, so batch clients only pay once per imported module
+/// for building its completion results.
+///
+/// \returns true if the compiler instance could not be set up.
+bool performCodeCompletion(CompilerInvocation &Invocation,
+                           CodeCompletionContext &CompletionContext,
+                           CodeCompletionConsumer &Consumer,
+                           DiagnosticConsumer *DiagConsumer = nullptr);
+
 /// Lookup the top-level code completions from \p module and store them in
 /// \p targetSink.
 ///
@@ -81,6 +81,28 @@ public:
 
 };
 
+/// \brief Caches the per-buffer analysis that formatting otherwise redoes
+/// from the start of the file on every request: the token stream and the
+/// byte offsets of line starts.
+///
+/// A client that formats as the user types can keep one cache per document
+/// and pass it to every reformat() call; the cache notices when the buffer
+/// contents change and rebuilds itself, so it is always safe to reuse.
+class FormatCache {
+public:
+  class Implementation;
+
+  FormatCache();
+  FormatCache(const FormatCache &) = delete;
+  FormatCache &operator=(const FormatCache &) = delete;
+  ~FormatCache();
+
+  Implementation &getImpl() { return Impl; }
+
+private:
+  Implementation &Impl;
+};
+
 //===----------------------------------------------------------------------===//
 // Reformat
 //===----------------------------------------------------------------------===//
@@ -94,6 +116,15 @@ std::pair<LineRange, std::string> reformat(LineRange Range,
                                            SourceManager &SM,
                                            SourceFile &SF);
 
+/// A variant of the above that reuses the token stream and line anchors
+/// stored in \p Cache while the buffer is unchanged, so repeated requests
+/// against the same buffer only pay for the AST walk around the target line.
+std::pair<LineRange, std::string> reformat(LineRange Range,
+                                           CodeFormatOptions Options,
+                                           SourceManager &SM,
+                                           SourceFile &SF,
+                                           FormatCache &Cache);
+
 } // namespace ide
 } // namespace swift
 
@@ -80,6 +80,8 @@ namespace swift {
   class SwiftARCContract : public llvm::FunctionPass {
     /// Swift RC Identity analysis.
     SwiftRCIdentity *RC;
+    /// Alias analysis.
+    llvm::AAResults *AA;
     virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override;
     virtual bool runOnFunction(llvm::Function &F) override;
   public:
@@ -53,6 +53,15 @@ public:
     return Lines;
   }
 
+  /// Returns the prefix of this LineList that makes up the comment's leading
+  /// paragraph: every line up to, but not including, the first blank line
+  /// that follows a non-blank line.
+  ///
+  /// The brief description of a doc comment is its leading paragraph, so
+  /// clients that only need the brief can parse this sublist instead of the
+  /// whole comment.
+  LineList subListToFirstBlankLine() const;
+
   /// Creates a LineList from a box selection of text.
   ///
   /// \param MC MarkupContext used for allocations
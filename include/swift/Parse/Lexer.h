@@ -21,8 +21,15 @@
 #include "swift/Basic/SourceManager.h"
 #include "swift/Parse/Token.h"
 #include "swift/AST/DiagnosticEngine.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 
+#include <vector>
+
+namespace llvm {
+  class MemoryBuffer;
+}
+
 namespace swift {
   class DiagnosticEngine;
   class InFlightDiagnostic;
@@ -204,6 +211,42 @@ public:
 
   unsigned getBufferID() const { return BufferID; }
 
+  /// \brief Serialize the token stream of the given buffer to \p OS in the
+  /// compact sidecar format understood by \c readTokenStreamCache.
+  ///
+  /// The stream is keyed on a hash of the buffer contents and the lexing
+  /// modes that affect it, so a stale or mismatched sidecar is detected and
+  /// rejected at rehydration time.
+  static void writeTokenStreamCache(const LangOptions &Options,
+                                    const SourceManager &SourceMgr,
+                                    unsigned BufferID, bool InSILMode,
+                                    CommentRetentionMode RetainComments,
+                                    llvm::raw_ostream &OS);
+
+  /// \brief Prime this lexer from a serialized token stream instead of
+  /// scanning the buffer.
+  ///
+  /// Returns false (leaving the lexer unchanged) if \p cacheBuffer was not
+  /// produced from identical source contents and lexing modes. On success,
+  /// the lexer replays the cached tokens -- including across state
+  /// save/restore -- and never rescans raw source. Since no scanning
+  /// happens, no lexical diagnostics are emitted either; rehydration is
+  /// meant for sources that have already been diagnosed, such as the
+  /// non-primary files of a module.
+  bool readTokenStreamCache(const llvm::MemoryBuffer &cacheBuffer);
+
+  /// \brief Lex \p BufferID into the trivia-free 8-byte-per-token encoding.
+  ///
+  /// Comments are skipped and no diagnostics are emitted.  If \p Offset and
+  /// \p EndOffset are both zero, the whole buffer is lexed; the trailing
+  /// element is always the eof token.  Expand individual entries with
+  /// \c PackedToken::unpack().
+  static std::vector<PackedToken> tokenizePacked(const LangOptions &LangOpts,
+                                                 const SourceManager &SM,
+                                                 unsigned BufferID,
+                                                 unsigned Offset = 0,
+                                                 unsigned EndOffset = 0);
+
   /// peekNextToken - Return the next token to be returned by Lex without
   /// actually lexing it.
   const Token &peekNextToken() const { return NextToken; }
@@ -375,6 +418,22 @@ public:
     return getStringLiteralSegments(Str, Segments, Diags);
   }
 
+  /// \brief Given a string literal token, run \p Body over each string/expr
+  /// segment of a potentially interpolated string, in source order, without
+  /// materializing a segment vector.
+  static void forEachStringLiteralSegment(
+      const Token &Str, DiagnosticEngine *Diags,
+      llvm::function_ref<void(StringSegment)> Body);
+
+  void forEachStringLiteralSegment(
+      const Token &Str, llvm::function_ref<void(StringSegment)> Body) {
+    return forEachStringLiteralSegment(Str, Diags, Body);
+  }
+
+  /// \brief Determine whether a string literal token contains any "\(...)"
+  /// interpolation segments, using a single memchr-driven scan of its body.
+  static bool stringLiteralContainsInterpolation(const Token &Str);
+
   static SourceLoc getSourceLoc(const char *Loc) {
     return SourceLoc(llvm::SMLoc::getFromPointer(Loc));
   }
@@ -413,7 +472,20 @@ private:
     return StringRef(Start, Length);
   }
 
+  /// @{
+  /// State for replaying a rehydrated token stream.
+
+  /// Tokens rehydrated by \c readTokenStreamCache. When non-empty, \c lexImpl
+  /// replays these instead of scanning the buffer.
+  std::vector<Token> CachedTokens;
+
+  /// Index into \c CachedTokens of the next token to replay.
+  unsigned NextCachedTokenIdx = 0;
+
+  /// @}
+
   void lexImpl();
+  void lexFromCachedTokens();
   InFlightDiagnostic diagnose(const char *Loc, Diagnostic Diag);
   
   template<typename ...DiagArgTypes, typename ...ArgTypes>
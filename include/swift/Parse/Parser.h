@@ -71,7 +71,7 @@ class Parser {
 
   bool IsInputIncomplete = false;
   SourceLoc DelayedDeclEnd;
-  std::vector<Token> SplitTokens;
+  SmallVector<Token, 2> SplitTokens;
 
 public:
   SourceManager &SourceMgr;
@@ -84,7 +84,8 @@ public:
   DeclContext *CurDeclContext;
   ASTContext &Context;
   CodeCompletionCallbacks *CodeCompletion = nullptr;
-  std::vector<std::pair<SourceLoc, std::vector<ParamDecl*>>> AnonClosureVars;
+  SmallVector<std::pair<SourceLoc, SmallVector<ParamDecl *, 4>>, 4>
+      AnonClosureVars;
 
   bool IsParsingInterfaceTokens = false;
   
@@ -151,7 +152,7 @@ public:
     return SF.isScriptMode();
   }
 
-  const std::vector<Token> &getSplitTokens() { return SplitTokens; }
+  ArrayRef<Token> getSplitTokens() { return SplitTokens; }
 
   void markSplitToken(tok Kind, StringRef Txt);
 
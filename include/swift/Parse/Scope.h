@@ -21,6 +21,7 @@
 #include "swift/AST/Identifier.h"
 #include "swift/Basic/TreeScopedHashTable.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/RecyclingAllocator.h"
 
 namespace swift {
   class ValueDecl;
@@ -34,8 +35,17 @@ class ScopeInfo {
   friend class Scope;
 public:
   typedef std::pair<unsigned, ValueDecl*> ValueScopeEntry;
-  
-  typedef TreeScopedHashTable<DeclName, ValueScopeEntry> ScopedHTTy;
+
+  /// Allocate scope entries out of a parser-lifetime bump arena, recycling
+  /// the nodes freed when a scope is popped.  Scopes are pushed and popped
+  /// constantly while parsing, so going through malloc for every entry shows
+  /// up in the parse hot loop.
+  typedef llvm::RecyclingAllocator<
+      llvm::BumpPtrAllocator, TreeScopedHashTableVal<DeclName, ValueScopeEntry>>
+      ScopedHTAllocatorTy;
+
+  typedef TreeScopedHashTable<DeclName, ValueScopeEntry, ScopedHTAllocatorTy>
+      ScopedHTTy;
   typedef ScopedHTTy::ScopeTy ScopedHTScopeTy;
   typedef ScopedHTTy::DetachedScopeTy ScopedHTDetachedScopeTy;
 
@@ -0,0 +1,78 @@
+//===--- StructureScanner.h - Top-level structure pre-scan ------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A fast pre-scan that splits a source buffer into chunks at top-level
+// declaration boundaries, using bracket matching only.  The chunks are
+// advisory: each one is expected to be independently parseable, so a huge
+// file can be carved up for parallel parsing, and an IDE client can reparse
+// just the chunk enclosing an edit or code-completion point.  Consumers must
+// tolerate a bad split (e.g. around a conditional-compilation block with
+// unbalanced braces) by falling back to parsing a wider range.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_PARSE_STRUCTURESCANNER_H
+#define SWIFT_PARSE_STRUCTURESCANNER_H
+
+#include "swift/Basic/LLVM.h"
+#include <vector>
+
+namespace swift {
+  class LangOptions;
+  class SourceManager;
+
+/// A maximal byte range of a source buffer between two top-level declaration
+/// boundaries, as discovered by \c scanTopLevelChunks().
+struct TopLevelChunk {
+  /// Byte offset of the chunk's start from the beginning of the buffer.
+  unsigned Offset;
+
+  /// Size of the chunk in bytes.
+  unsigned Length;
+
+  /// Whether the chunk contains any conditional-compilation directives.
+  /// Such a chunk may not be independently parseable if the directives
+  /// guard unbalanced braces, so consumers should treat it with suspicion.
+  bool HasConditionalDirectives;
+
+  unsigned getEndOffset() const { return Offset + Length; }
+
+  bool contains(unsigned ByteOffset) const {
+    return ByteOffset >= Offset && ByteOffset < getEndOffset();
+  }
+};
+
+/// Split the given buffer into chunks at top-level declaration boundaries.
+///
+/// The scan tokenizes the buffer (so braces inside string literals, comments
+/// and interpolations are handled correctly) and tracks bracket nesting; a
+/// chunk boundary is placed after each '}' that returns the nesting depth to
+/// zero, provided the following token starts a new line.  This catches the
+/// type, extension, and function declarations that dominate large generated
+/// files.  Top-level code between such declarations stays attached to the
+/// chunk that follows it.
+///
+/// The final chunk always extends to the end of the buffer, and the chunks
+/// cover every token in the buffer in source order.
+std::vector<TopLevelChunk> scanTopLevelChunks(const LangOptions &LangOpts,
+                                              const SourceManager &SM,
+                                              unsigned BufferID);
+
+/// Return the chunk of \p Chunks that contains \p ByteOffset, or the last
+/// chunk if the offset is at the very end of the buffer.  Returns nullptr if
+/// \p Chunks is empty or the offset lies before the first chunk.
+const TopLevelChunk *findEnclosingTopLevelChunk(
+    ArrayRef<TopLevelChunk> Chunks, unsigned ByteOffset);
+
+} // end namespace swift
+
+#endif // SWIFT_PARSE_STRUCTURESCANNER_H
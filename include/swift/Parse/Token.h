@@ -21,6 +21,7 @@
 #include "swift/Basic/LLVM.h"
 #include "swift/Config.h"
 #include "llvm/ADT/StringRef.h"
+#include <cstdint>
 
 namespace swift {
 
@@ -241,6 +242,12 @@ public:
     return CommentLength != 0;
   }
 
+  /// \brief The length, in bytes, of the comment block (including trailing
+  /// whitespace) that precedes this token.
+  unsigned getCommentLength() const {
+    return CommentLength;
+  }
+
   CharSourceRange getCommentRange() const {
     if (CommentLength == 0)
       return CharSourceRange(SourceLoc(llvm::SMLoc::getFromPointer(Text.begin())),
@@ -279,7 +286,59 @@ public:
     EscapedIdentifier = false;
   }
 };
-  
+
+/// PackedToken - A trivia-free 8-byte encoding of a token: its kind plus the
+/// offset and length of its text within the source buffer.  This is the
+/// "smaller form" that the \c Token documentation above alludes to; whole-file
+/// token streams are a quarter of the size in this encoding, which matters
+/// for million-token inputs.  Comment trivia is dropped, and a PackedToken
+/// can only describe text physically present in its buffer (never
+/// synthesized text).  See \c Lexer::tokenizePacked().
+class PackedToken {
+  uint32_t Offset;
+  uint32_t Length : 22;
+  uint32_t Kind : 8;
+  uint32_t AtStartOfLine : 1;
+  uint32_t EscapedIdentifier : 1;
+
+public:
+  /// The longest token text representable in the packed encoding.
+  enum : unsigned { MaxLength = (1u << 22) - 1 };
+
+  PackedToken(tok Kind, unsigned Offset, unsigned Length, bool AtStartOfLine,
+              bool EscapedIdentifier)
+      : Offset(Offset), Length(Length), Kind(static_cast<unsigned>(Kind)),
+        AtStartOfLine(AtStartOfLine), EscapedIdentifier(EscapedIdentifier) {
+    assert(Length <= MaxLength && "token text too long for packed encoding");
+  }
+
+  tok getKind() const { return static_cast<tok>(Kind); }
+  bool is(tok K) const { return getKind() == K; }
+  bool isNot(tok K) const { return getKind() != K; }
+
+  /// The offset of the token text from the start of its source buffer.
+  unsigned getOffset() const { return Offset; }
+  unsigned getLength() const { return Length; }
+  bool isAtStartOfLine() const { return AtStartOfLine; }
+  bool isEscapedIdentifier() const { return EscapedIdentifier; }
+
+  /// \brief Expand back into a full Token pointing into \p Buffer, which must
+  /// be the contents of the buffer this token was lexed from.  Comment
+  /// trivia is not recovered.
+  Token unpack(StringRef Buffer) const {
+    Token Tok;
+    Tok.setToken(getKind(), Buffer.substr(Offset, Length));
+    Tok.setAtStartOfLine(AtStartOfLine);
+    if (EscapedIdentifier)
+      Tok.setEscapedIdentifier(true);
+    return Tok;
+  }
+};
+
+static_assert(static_cast<unsigned>(tok::NUM_TOKENS) <= 256,
+              "too many token kinds for the packed encoding");
+static_assert(sizeof(PackedToken) == 8, "packed token grew past 8 bytes");
+
 } // end namespace swift
 
 
@@ -25,6 +25,16 @@ namespace swift {
   /// Returns true on error.
   bool printAsObjC(raw_ostream &out, ModuleDecl *M, StringRef bridgingHeader,
                    Accessibility minRequiredAccess);
+
+  /// Like \c printAsObjC, but additionally splits the printed interfaces
+  /// into one sub-header per top-level name, written next to \p outputPath
+  /// and updated only when their text changes. The umbrella header, which
+  /// imports every sub-header, is written to \p out.
+  ///
+  /// Returns true on error.
+  bool printAsObjCSplit(raw_ostream &out, StringRef outputPath, ModuleDecl *M,
+                        StringRef bridgingHeader,
+                        Accessibility minRequiredAccess);
 }
 
 #endif
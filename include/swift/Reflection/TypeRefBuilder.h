@@ -293,6 +293,26 @@ private:
 
   std::vector<ReflectionInfo> ReflectionInfos;
 
+  /// Decoded type references, keyed by mangled type name.  The same mangled
+  /// strings recur across field descriptors, and across images that share
+  /// dylibs when several binaries feed one builder, so both successful and
+  /// failed decodings are memoized for the lifetime of the builder.
+  std::unordered_map<std::string, const TypeRef *> DecodedTypeRefCache;
+
+  /// How many entries of ReflectionInfos have been folded into the descriptor
+  /// indexes below.  Images can be added at any time, so lookups re-index
+  /// lazily instead of scanning every section linearly per query.
+  size_t NumIndexedReflectionInfos = 0;
+  std::unordered_map<std::string, const FieldDescriptor *>
+      FieldDescriptorIndex;
+  std::unordered_map<std::string, const BuiltinTypeDescriptor *>
+      BuiltinTypeDescriptorIndex;
+  std::unordered_map<uintptr_t, const CaptureDescriptor *>
+      CaptureDescriptorIndex;
+
+  /// Fold any newly-added reflection infos into the descriptor indexes.
+  void updateDescriptorIndexes();
+
   const AssociatedTypeDescriptor *
   lookupAssociatedTypes(const std::string &MangledTypeName,
                         const DependentMemberTypeRef *DependentMember);
@@ -300,6 +320,10 @@ private:
 public:
   TypeConverter &getTypeConverter() { return TC; }
 
+  /// Demangle and decode a mangled type name into a type reference, caching
+  /// the result.
+  const TypeRef *decodeTypeRef(const std::string &MangledTypeName);
+
   const TypeRef *
   getDependentMemberTypeRef(const std::string &MangledTypeName,
                             const DependentMemberTypeRef *DependentMember);
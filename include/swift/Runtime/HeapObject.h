@@ -336,6 +336,21 @@ SWIFT_RUNTIME_EXPORT
 extern "C" void (*SWIFT_CC(RegisterPreservingCC)
                      _swift_release_n)(HeapObject *object, uint32_t n);
 
+/// Atomically retains every object in an array of object references.
+/// Null entries are skipped. Object headers are prefetched a few elements
+/// ahead of the reference-count updates so that a long run of retains over
+/// a cold array does not stall on one header cache miss after another.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+void swift_bulkRetain(HeapObject *const *objects, size_t count);
+
+/// Atomically releases every object in an array of object references,
+/// destroying any whose retain count reaches zero. Null entries are
+/// skipped. Object headers are prefetched as in swift_bulkRetain.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+void swift_bulkRelease(HeapObject *const *objects, size_t count);
+
 /// Sets the RC_DEALLOCATING_FLAG flag. This is done non-atomically.
 /// The strong reference count of \p object must be 1 and no other thread may
 /// retain the object during executing this function.
@@ -137,6 +137,11 @@ private:
   /// The function's global_init attribute.
   unsigned GlobalInitFlag : 1;
 
+  /// True if the optimizer has certified that the function's
+  /// @inout_aliasable arguments are never aliased during a call to it, so
+  /// IRGen may emit them as noalias parameters.
+  unsigned InoutsUnaliasedFlag : 1;
+
   /// The function's noinline attribute.
   unsigned InlineStrategy : 2;
 
@@ -510,6 +515,11 @@ public:
   bool isGlobalInit() const { return GlobalInitFlag; }
   void setGlobalInit(bool isGI) { GlobalInitFlag = isGI; }
 
+  /// Returns true if the optimizer has certified that the function's
+  /// @inout_aliasable arguments are never aliased during a call to it.
+  bool areInoutsUnaliased() const { return InoutsUnaliasedFlag; }
+  void setInoutsUnaliased(bool flag) { InoutsUnaliasedFlag = flag; }
+
   bool isKeepAsPublic() const { return KeepAsPublic; }
   void setKeepAsPublic(bool keep) { KeepAsPublic = keep; }
 
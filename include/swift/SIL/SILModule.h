@@ -102,6 +102,27 @@ private:
   /// Allocator that manages the memory of all the pieces of the SILModule.
   mutable llvm::BumpPtrAllocator BPA;
 
+  /// Recycles the memory of deleted instructions. Blocks are handed back to
+  /// subsequent instruction allocations of the same size class instead of
+  /// being returned to the system allocator, which reduces allocator churn
+  /// in instruction-heavy optimization passes. Declared before the function
+  /// lists so that it outlives the destruction of all instructions.
+  struct InstructionRecycler {
+    /// Size and alignment of the header in front of every recyclable
+    /// allocation; it records the block's size class and links free blocks.
+    enum : unsigned { BlockHeaderSize = 16 };
+
+    /// Number of size classes. Class N holds blocks with a payload of
+    /// N * 8 bytes; larger allocations bypass the free lists.
+    enum : unsigned { NumFreeLists = 64 };
+
+    /// Heads of the per-size-class free lists.
+    void *FreeLists[NumFreeLists] = {};
+
+    ~InstructionRecycler();
+  };
+  mutable InstructionRecycler InstRecycler;
+
   /// The swift Module associated with this SILModule.
   ModuleDecl *TheSwiftModule;
 
@@ -129,6 +150,12 @@ private:
   /// Lookup table for SIL vtables from class decls.
   llvm::DenseMap<const ClassDecl *, SILVTable *> VTableMap;
 
+  /// Method implementation lookups in vtables, cached by
+  /// SILVTable::getImplementation. Cleared whenever vtable entries are
+  /// removed.
+  llvm::DenseMap<std::pair<const SILVTable *, SILDeclRef>, SILFunction *>
+  VTableEntryCache;
+
   /// The list of SILVTables in the module.
   VTableListType vtables;
 
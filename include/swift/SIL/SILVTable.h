@@ -61,6 +61,11 @@ private:
   /// Private constructor. Create SILVTables by calling SILVTable::create.
   SILVTable(ClassDecl *c, ArrayRef<Pair> entries);
 
+  /// Drop all results cached by getImplementation from the module. Called
+  /// when entries are removed from the vtable, since cached lookups may
+  /// reference a removed implementation through an overridden method.
+  void invalidateEntryCache(SILModule &M);
+
 public:
   ~SILVTable();
 
@@ -81,7 +86,8 @@ public:
 
   /// Removes entries from the vtable.
   /// \p predicate Returns true if the passed entry should be removed.
-  template <typename Predicate> void removeEntries_if(Predicate predicate) {
+  template <typename Predicate>
+  void removeEntries_if(Predicate predicate, SILModule &M) {
     Pair *end = std::remove_if(Entries, Entries + NumEntries,
                                [&](Pair &entry) -> bool {
       if (predicate(entry)) {
@@ -90,7 +96,10 @@ public:
       }
       return false;
     });
-    NumEntries = end - Entries;
+    if (end != Entries + NumEntries) {
+      NumEntries = end - Entries;
+      invalidateEntryCache(M);
+    }
   }
                     
   /// Verify that the vtable is well-formed for the given class.
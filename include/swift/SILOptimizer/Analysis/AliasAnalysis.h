@@ -102,16 +102,35 @@ private:
   /// never change.
   llvm::DenseMap<TBAACacheKey, bool> TypesMayAliasCache;
 
+  using AliasCacheTy = llvm::DenseMap<AliasKeyTy, AliasResult>;
+
   /// AliasAnalysis value cache.
   ///
-  /// The alias() method uses this map to cache queries.
-  llvm::DenseMap<AliasKeyTy, AliasResult> AliasCache;
+  /// The alias() method uses this map to cache queries. The entries are
+  /// bucketed by the function which contains the queried values, so that
+  /// invalidating a single function does not flush the cached results of all
+  /// other functions.
+  llvm::DenseMap<SILFunction *, AliasCacheTy> AliasCaches;
+
+  /// The total number of entries in all buckets of AliasCaches.
+  unsigned AliasCacheSize;
 
   using MemoryBehavior = SILInstruction::MemoryBehavior;
+  using MemoryBehaviorCacheTy =
+      llvm::DenseMap<MemBehaviorKeyTy, MemoryBehavior>;
+
   /// MemoryBehavior value cache.
   ///
-  /// The computeMemoryBehavior() method uses this map to cache queries.
-  llvm::DenseMap<MemBehaviorKeyTy, MemoryBehavior> MemoryBehaviorCache;
+  /// The computeMemoryBehavior() method uses this map to cache queries. Like
+  /// AliasCaches it is bucketed by function.
+  llvm::DenseMap<SILFunction *, MemoryBehaviorCacheTy> MemoryBehaviorCaches;
+
+  /// The total number of entries in all buckets of MemoryBehaviorCaches.
+  unsigned MemoryBehaviorCacheSize;
+
+  /// Total number of alias() and computeMemoryBehavior() queries issued so
+  /// far. Used by the pass manager to attribute query counts to passes.
+  uint64_t QueryCount;
 
   /// The AliasAnalysis cache can't directly map a pair of ValueBase pointers
   /// to alias results because we'd like to be able to remove deleted pointers
@@ -151,7 +170,8 @@ private:
 
 public:
   AliasAnalysis(SILModule *M) :
-    SILAnalysis(AnalysisKind::Alias), Mod(M), SEA(nullptr), EA(nullptr) {}
+    SILAnalysis(AnalysisKind::Alias), Mod(M), SEA(nullptr), EA(nullptr),
+    AliasCacheSize(0), MemoryBehaviorCacheSize(0), QueryCount(0) {}
 
   static bool classof(const SILAnalysis *S) {
     return S->getKind() == AnalysisKind::Alias;
@@ -163,6 +183,10 @@ public:
   AliasResult alias(SILValue V1, SILValue V2, SILType TBAAType1 = SILType(),
                     SILType TBAAType2 = SILType());
 
+  /// Returns the total number of queries issued so far. The delta between
+  /// two reads attributes queries to the code executed in between.
+  uint64_t getQueryCount() const { return QueryCount; }
+
   /// Convenience method that returns true if V1 and V2 must alias.
   bool isMustAlias(SILValue V1, SILValue V2, SILType TBAAType1 = SILType(),
                    SILType TBAAType2 = SILType()) {
@@ -263,14 +287,39 @@ public:
   /// Encodes the memory behavior query as a MemBehaviorKeyTy.
   MemBehaviorKeyTy toMemoryBehaviorKey(SILValue V1, SILValue V2, RetainObserveKind K);
 
+  /// Returns the function which owns the values of a query. Queries whose
+  /// values are not contained in any function end up in the null bucket.
+  SILFunction *getCacheFunction(SILValue V1, SILValue V2);
+
   virtual void invalidate(SILAnalysis::InvalidationKind K) override {
-    AliasCache.clear();
-    MemoryBehaviorCache.clear();
+    AliasCaches.clear();
+    AliasCacheSize = 0;
+    MemoryBehaviorCaches.clear();
+    MemoryBehaviorCacheSize = 0;
   }
 
-  virtual void invalidate(SILFunction *,
+  /// Invalidate only the cached queries for the values of function \p F.
+  /// The cached results of all other functions stay valid.
+  virtual void invalidate(SILFunction *F,
                           SILAnalysis::InvalidationKind K) override {
-    invalidate(K);
+    invalidateFunctionBucket(F);
+    // Queries which could not be attributed to a function are invalidated
+    // conservatively.
+    invalidateFunctionBucket(nullptr);
+  }
+
+private:
+  void invalidateFunctionBucket(SILFunction *F) {
+    auto AliasIt = AliasCaches.find(F);
+    if (AliasIt != AliasCaches.end()) {
+      AliasCacheSize -= AliasIt->second.size();
+      AliasCaches.erase(AliasIt);
+    }
+    auto MBIt = MemoryBehaviorCaches.find(F);
+    if (MBIt != MemoryBehaviorCaches.end()) {
+      MemoryBehaviorCacheSize -= MBIt->second.size();
+      MemoryBehaviorCaches.erase(MBIt);
+    }
   }
 };
 
@@ -0,0 +1,60 @@
+//===--- ExclusivityAnalysis.h ----------------------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+#ifndef SWIFT_SILOPTIMIZER_ANALYSIS_EXCLUSIVITYANALYSIS_H
+#define SWIFT_SILOPTIMIZER_ANALYSIS_EXCLUSIVITYANALYSIS_H
+
+#include "swift/SILOptimizer/Analysis/Analysis.h"
+#include "llvm/ADT/DenseMap.h"
+
+namespace swift {
+
+/// This analysis certifies that a function's @inout_aliasable arguments are
+/// not aliased by any other memory access while the function executes.
+///
+/// IRGen only emits nocapture for indirect arguments, because a captured
+/// variable may legally overlap any other argument of the same call
+/// (including a strict @inout; see SIL.rst on aliasing requirements), which
+/// blocks LLVM from keeping the pointee in registers. The certification here
+/// is intra-procedural and conservative: it holds if a single aliasable
+/// argument is the only argument memory is ever accessed through, every other
+/// access goes through a function-local stack allocation, and the function
+/// makes no calls which could reach the captured variable through another
+/// path.
+class ExclusivityAnalysis : public SILAnalysis {
+  /// Memoized per-function certification results.
+  llvm::DenseMap<SILFunction *, bool> Cache;
+
+public:
+  ExclusivityAnalysis(SILModule *)
+      : SILAnalysis(AnalysisKind::Exclusivity) {}
+
+  static bool classof(const SILAnalysis *S) {
+    return S->getKind() == AnalysisKind::Exclusivity;
+  }
+
+  /// Returns true if \p F has at least one @inout_aliasable argument and all
+  /// of them are provably unaliased for the duration of any call to \p F.
+  bool areInoutsProvablyUnaliased(SILFunction *F);
+
+  virtual void invalidate(InvalidationKind K) override { Cache.clear(); }
+
+  virtual void invalidate(SILFunction *F, InvalidationKind K) override {
+    Cache.erase(F);
+  }
+
+protected:
+  bool compute(SILFunction *F);
+};
+
+} // end namespace swift
+
+#endif
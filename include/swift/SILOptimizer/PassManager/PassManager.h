@@ -15,6 +15,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include <vector>
@@ -82,9 +83,30 @@ class SILPassManager {
   /// worklist (e.g. caused by a bug in a specializing optimization).
   llvm::DenseMap<SILFunction *, int> DerivationLevels;
 
+  /// A cached copy of the bottom-up function order over the module's call
+  /// graph, used to populate the function pass worklist. Only valid while
+  /// \c FunctionOrderIsStale is false.
+  std::vector<SILFunction *> BottomUpFunctionOrderCache;
+
+  /// True if the call graph may have changed since the bottom-up function
+  /// order was last computed, i.e. whenever any invalidation occurred or a
+  /// function was added to the module.
+  bool FunctionOrderIsStale = true;
+
   /// Set to true when a pass invalidates an analysis.
   bool CurrentPassHasInvalidated = false;
 
+  /// Set to true when a pass invalidates the whole module rather than
+  /// individual functions.
+  bool CurrentPassInvalidatedWholeModule = false;
+
+  /// The functions invalidated by the currently running module pass. In
+  /// incremental verification mode only these are verified after the pass.
+  llvm::SmallPtrSet<SILFunction *, 16> ChangedFunctions;
+
+  /// Number of incremental verifications since the last full module sweep.
+  unsigned NumIncrementalVerifications = 0;
+
   /// True if we need to stop running passes and restart again on the
   /// same function.
   bool RestartPipeline = false;
@@ -132,6 +154,8 @@ public:
         AP->invalidate(K);
 
     CurrentPassHasInvalidated = true;
+    CurrentPassInvalidatedWholeModule = true;
+    invalidateFunctionOrder();
 
     // Assume that all functions have changed. Clear all masks of all functions.
     CompletedPassesMap.clear();
@@ -150,6 +174,9 @@ public:
   void notifyAnalysisOfFunction(SILFunction *F) {
     for (auto AP : Analysis)
       AP->notifyAnalysisOfFunction(F);
+
+    ChangedFunctions.insert(F);
+    invalidateFunctionOrder();
   }
 
   /// \brief Broadcast the invalidation of the function to all analysis.
@@ -161,6 +188,8 @@ public:
         AP->invalidate(F, K);
     
     CurrentPassHasInvalidated = true;
+    ChangedFunctions.insert(F);
+    invalidateFunctionOrder();
     // Any change let all passes run again.
     CompletedPassesMap[F].reset();
   }
@@ -176,10 +205,22 @@ public:
         AP->invalidateForDeadFunction(F, K);
     
     CurrentPassHasInvalidated = true;
+    // The function will be removed from the module; there is nothing left
+    // to verify.
+    ChangedFunctions.erase(F);
+    invalidateFunctionOrder();
     // Any change let all passes run again.
     CompletedPassesMap[F].reset();
   }
 
+  /// \brief Discard the cached bottom-up function order. Called whenever the
+  /// call graph may have changed; the order is recomputed on demand the next
+  /// time function passes run.
+  void invalidateFunctionOrder() {
+    FunctionOrderIsStale = true;
+    BottomUpFunctionOrderCache.clear();
+  }
+
   /// \brief Reset the state of the pass manager and remove all transformation
   /// owned by the pass manager. Analysis passes will be kept.
   void resetAndRemoveTransformations();
@@ -0,0 +1,49 @@
+//===--- OptimizationRemark.h - Remarks for SIL optimizations ---*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A simple facility for SIL optimization passes to emit structured remarks
+// about the decisions they make. The remarks are written as a stream of YAML
+// documents with source locations, so that the optimization behavior of two
+// compiler versions can be compared textually.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SILOPTIMIZER_UTILS_OPTIMIZATIONREMARK_H
+#define SWIFT_SILOPTIMIZER_UTILS_OPTIMIZATIONREMARK_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Twine.h"
+
+namespace swift {
+
+class SILInstruction;
+
+namespace OptRemark {
+
+/// Returns true if a remark file was requested on the command line. Passes
+/// can use this to avoid constructing expensive remark messages.
+bool isEnabled();
+
+/// Record that the pass \p PassName performed the optimization \p RemarkName
+/// at the source location of \p Where.
+void emitPassed(llvm::StringRef PassName, llvm::StringRef RemarkName,
+                SILInstruction *Where, const llvm::Twine &Message);
+
+/// Record that the pass \p PassName failed to perform the optimization
+/// \p RemarkName at the source location of \p Where.
+void emitMissed(llvm::StringRef PassName, llvm::StringRef RemarkName,
+                SILInstruction *Where, const llvm::Twine &Message);
+
+} // end namespace OptRemark
+} // end namespace swift
+
+#endif
@@ -29,6 +29,7 @@ namespace swift {
   class LazyResolver;
   class ExtensionDecl;
   class ProtocolDecl;
+  class SourceFile;
 
   /// \brief Typecheck a declaration parsed during code completion.
   ///
@@ -116,6 +117,17 @@ namespace swift {
   bool typeCheckAbstractFunctionBodyUntil(AbstractFunctionDecl *AFD,
                                           SourceLoc EndTypeCheckLoc);
 
+  /// \brief Typecheck only the slice of a freshly re-parsed file affected by
+  /// an edit within the given source range.
+  ///
+  /// If the edited range falls entirely inside a single function body, only
+  /// that body is re-checked; anything it references is validated lazily.
+  ///
+  /// \returns true if the slice was re-checked. Returns false if the edit is
+  /// not confined to one body -- it may have changed a declaration's
+  /// interface -- in which case the caller must type-check the whole file.
+  bool typeCheckDeclForEditedRange(SourceFile &SF, SourceRange EditedRange);
+
   /// \brief Typecheck top-level code parsed during code completion.
   ///
   /// \returns true on success, false on error.
@@ -25,6 +25,7 @@
 #include "swift/Basic/LLVM.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/Bitcode/BitstreamReader.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -131,6 +132,7 @@ private:
   struct {
     off_t fileSize;
     time_t fileModTime;
+    uint64_t fileHash;
     StringRef contents;
   } importedHeaderInfo = {};
 
@@ -279,6 +281,19 @@ private:
       llvm::OnDiskIterableChainedHashTable<LocalDeclTableInfo>;
 
   std::unique_ptr<SerializedDeclTable> TopLevelDecls;
+
+  /// Hashes of every key in \c TopLevelDecls, built lazily on first lookup.
+  ///
+  /// Most name lookups into a loaded module miss, and checking this set is
+  /// much cheaper than probing the on-disk table's buckets. Only used for
+  /// modules written before \c TopLevelFilter existed.
+  std::unique_ptr<llvm::DenseSet<uint32_t>> TopLevelDeclHashes;
+
+  /// Serialized Bloom filter over the names in \c TopLevelDecls, pointing
+  /// into the module buffer. Empty for modules written before the filter
+  /// record existed; \c TopLevelDeclHashes covers those.
+  StringRef TopLevelFilter;
+
   std::unique_ptr<SerializedDeclTable> OperatorDecls;
   std::unique_ptr<SerializedDeclTable> PrecedenceGroupDecls;
   std::unique_ptr<SerializedDeclTable> ExtensionDecls;
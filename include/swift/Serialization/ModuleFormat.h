@@ -53,7 +53,7 @@ const uint16_t VERSION_MAJOR = 0;
 /// in source control, you should also update the comment to briefly
 /// describe what change you made. The content of this comment isn't important;
 /// it just ensures a conflict if two people change the module format.
-const uint16_t VERSION_MINOR = 261; // Last change: remove AllArchetypes indexing
+const uint16_t VERSION_MINOR = 263; // Last change: top-level name filter
 
 using DeclID = PointerEmbeddedInt<unsigned, 31>;
 using DeclIDField = BCFixed<31>;
@@ -89,6 +89,7 @@ using CharOffsetField = BitOffsetField;
 
 using FileSizeField = BCVBR<16>;
 using FileModTimeField = BCVBR<16>;
+using FileHashField = BCVBR<16>;
 
 enum class StorageKind : uint8_t {
   Stored, StoredWithTrivialAccessors, StoredWithObservers,
@@ -509,6 +510,7 @@ namespace input_block {
     BCFixed<1>, // exported?
     FileSizeField, // file size (for validation)
     FileModTimeField, // file mtime (for validation)
+    FileHashField, // content hash (for validation when the mtime changes)
     BCBlob // file path
   >;
 
@@ -1448,6 +1450,10 @@ namespace index_block {
     NORMAL_CONFORMANCE_OFFSETS,
 
     PRECEDENCE_GROUPS,
+
+    /// A Bloom filter over the names in TOP_LEVEL_DECLS, consulted before
+    /// probing the on-disk hash table.
+    TOP_LEVEL_FILTER,
   };
 
   using OffsetsLayout = BCGenericRecordLayout<
@@ -1476,6 +1482,28 @@ namespace index_block {
     ENTRY_POINT,
     DeclIDField  // the ID of the main class; 0 if there was a main source file
   >;
+
+  using TopLevelFilterLayout = BCRecordLayout<
+    TOP_LEVEL_FILTER,
+    BCBlob  // bit array; see getTopLevelFilterBits
+  >;
+
+  /// Number of filter bits budgeted per top-level name. The writer rounds
+  /// the total filter size up to a power of two so readers can mask rather
+  /// than divide; with two probe bits per name this keeps the filter's
+  /// false-positive rate well under one percent.
+  const unsigned TopLevelFilterBitsPerName = 16;
+
+  /// Returns the two bit positions a name occupies in the top-level name
+  /// filter. \p hash is the name's \c llvm::HashString value (the same hash
+  /// the on-disk decl table uses), and \p numBits is the total size of the
+  /// filter, which must be a power of two.
+  inline std::pair<uint32_t, uint32_t>
+  getTopLevelFilterBits(uint32_t hash, uint64_t numBits) {
+    uint32_t mask = uint32_t(numBits - 1);
+    uint32_t rotated = (hash >> 16) | (hash << 16);
+    return { hash & mask, (rotated * 0x9e3779b9u) & mask };
+  }
 }
 
 /// \sa COMMENT_BLOCK_ID
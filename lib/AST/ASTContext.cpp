@@ -39,7 +39,10 @@
 #include "clang/Lex/HeaderSearch.h"
 #include "clang/Lex/Preprocessor.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSwitch.h"
 #include <algorithm>
@@ -47,6 +50,16 @@
 
 using namespace swift;
 
+#define DEBUG_TYPE "ASTContext"
+STATISTIC(NumArchetypeBuilderCacheHits,
+          "# of archetype builder cache hits");
+STATISTIC(NumArchetypeBuilderCacheMisses,
+          "# of archetype builder cache misses");
+STATISTIC(NumTypeSubstitutionCacheHits,
+          "# of type substitution cache hits");
+STATISTIC(NumTypeSubstitutionCacheMisses,
+          "# of type substitution cache misses");
+
 LazyResolver::~LazyResolver() = default;
 DelegatingLazyResolver::~DelegatingLazyResolver() = default;
 void ModuleLoader::anchor() {}
@@ -91,7 +104,26 @@ struct ASTContext::Implementation {
   /// The last resolver.
   LazyResolver *Resolver = nullptr;
 
-  llvm::StringMap<char, llvm::BumpPtrAllocator&> IdentifierTable;
+  /// One shard of the identifier interning table.
+  ///
+  /// Each shard owns its own allocator; entries are never freed or moved,
+  /// so the key pointers handed out via Identifier stay valid for the
+  /// lifetime of the ASTContext even while other threads insert.
+  struct IdentifierTableShard {
+    llvm::BumpPtrAllocator Allocator;
+    llvm::StringMap<char, llvm::BumpPtrAllocator&> Table;
+    llvm::sys::Mutex Mutex;
+
+    IdentifierTableShard() : Table(Allocator) {}
+  };
+
+  enum { NumIdentifierShards = 16 };
+
+  /// The identifier interning table, striped into independently locked
+  /// shards so that identifiers can be uniqued concurrently from parallel
+  /// frontend phases. Single-threaded compilations only pay for an
+  /// uncontended lock acquisition per lookup.
+  IdentifierTableShard IdentifierTable[NumIdentifierShards];
 
   /// The declaration of Swift.AssignmentPrecedence.
   PrecedenceGroupDecl *AssignmentPrecedence = nullptr;
@@ -276,6 +308,37 @@ struct ASTContext::Implementation {
   llvm::DenseMap<std::pair<GenericSignature *, ModuleDecl *>,
                  std::unique_ptr<ArchetypeBuilder>> ArchetypeBuilders;
 
+  /// An entry in the Type::subst memoization cache, keyed on the original
+  /// type, the module, the substitution options, and the flattened contents
+  /// of the substitution map.
+  struct TypeSubstitutionCacheEntry : public llvm::FoldingSetNode {
+    TypeBase *Original;
+    ModuleDecl *Mod;
+    unsigned Options;
+    ArrayRef<std::pair<TypeBase *, TypeBase *>> Substitutions;
+    Type Result;
+
+    static void Profile(llvm::FoldingSetNodeID &ID, TypeBase *original,
+                        ModuleDecl *mod, unsigned options,
+                        ArrayRef<std::pair<TypeBase *, TypeBase *>> subs) {
+      ID.AddPointer(original);
+      ID.AddPointer(mod);
+      ID.AddInteger(options);
+      ID.AddInteger(subs.size());
+      for (const auto &sub : subs) {
+        ID.AddPointer(sub.first);
+        ID.AddPointer(sub.second);
+      }
+    }
+
+    void Profile(llvm::FoldingSetNodeID &ID) {
+      Profile(ID, Original, Mod, Options, Substitutions);
+    }
+  };
+
+  /// \brief Memoized results of Type::subst.
+  llvm::FoldingSet<TypeSubstitutionCacheEntry> TypeSubstitutionCache;
+
   /// The set of property names that show up in the defining module of a
   /// class.
   llvm::DenseMap<std::pair<const ClassDecl *, char>,
@@ -373,6 +436,21 @@ struct ASTContext::Implementation {
   llvm::DenseMap<NominalTypeDecl *, ForeignRepresentationInfo>
     ForeignRepresentableCache;
 
+  /// An entry in the visible-member lookup cache, stamped with the
+  /// generation it was computed in.
+  struct VisibleMemberCacheEntry {
+    unsigned Generation;
+    std::vector<CachedVisibleMember> Members;
+  };
+
+  /// A cache of visible-member lookup results, used for code completion.
+  /// Keyed by base type, context of the lookup, and lookup flags; entries
+  /// from older generations are ignored.
+  llvm::DenseMap<
+      std::pair<std::pair<TypeBase *, const DeclContext *>, unsigned>,
+      VisibleMemberCacheEntry>
+    VisibleMemberCache;
+
   llvm::StringMap<OptionSet<SearchPathKind>> SearchPathsSet;
 
   /// \brief The permanent arena.
@@ -412,8 +490,7 @@ struct ASTContext::Implementation {
   }
 };
 
-ASTContext::Implementation::Implementation()
- : IdentifierTable(Allocator) {}
+ASTContext::Implementation::Implementation() {}
 ASTContext::Implementation::~Implementation() {
   for (auto &cleanup : Cleanups)
     cleanup();
@@ -431,6 +508,9 @@ ConstraintCheckerArenaRAII(ASTContext &self, llvm::BumpPtrAllocator &allocator,
 }
 
 ConstraintCheckerArenaRAII::~ConstraintCheckerArenaRAII() {
+  // This is the only point at which arena memory is released, so sample the
+  // high-water mark before the solver arena goes away.
+  Self.noteMemoryHighWater();
   Self.Impl.CurrentConstraintSolverArena.reset(
     (ASTContext::Implementation::ConstraintSolverArena *)Data);
 }
@@ -532,7 +612,13 @@ Identifier ASTContext::getIdentifier(StringRef Str) const {
   // Make sure null pointers stay null.
   if (Str.data() == nullptr) return Identifier(0);
 
-  auto I = Impl.IdentifierTable.insert(std::make_pair(Str, char())).first;
+  // Pick the shard by hash so concurrent callers mostly take different
+  // locks; the same string always maps to the same shard, which is what
+  // keeps interning canonical.
+  auto &Shard = Impl.IdentifierTable[llvm::HashString(Str) %
+                                     Implementation::NumIdentifierShards];
+  llvm::sys::ScopedLock Lock(Shard.Mutex);
+  auto I = Shard.Table.insert(std::make_pair(Str, char())).first;
   return Identifier(I->getKeyData());
 }
 
@@ -1301,7 +1387,9 @@ ASTContext::createTrivialSubstitutions(BoundGenericType *BGT,
   assert(Param->getArchetype() && "Not type-checked yet");
   (void) Param;
   Substitution Subst(BGT->getGenericArgs()[0], {});
-  auto Substitutions = AllocateCopy(llvm::makeArrayRef(Subst));
+  auto Substitutions = AllocateCopy(llvm::makeArrayRef(Subst),
+                                    AllocationArena::Permanent,
+                                    AllocationKind::Substitution);
   auto arena = getArena(BGT->getRecursiveProperties());
   Impl.getArena(arena).BoundGenericSubstitutions
     .insert(std::make_pair(std::make_pair(BGT, gpContext), Substitutions));
@@ -1380,6 +1468,26 @@ void ASTContext::loadExtensions(NominalTypeDecl *nominal,
   }
 }
 
+const std::vector<ASTContext::CachedVisibleMember> *
+ASTContext::getCachedVisibleMembers(TypeBase *baseTy,
+                                    const DeclContext *currDC,
+                                    unsigned lookupFlags) const {
+  auto known = Impl.VisibleMemberCache.find({{baseTy, currDC}, lookupFlags});
+  if (known == Impl.VisibleMemberCache.end() ||
+      known->second.Generation != CurrentGeneration)
+    return nullptr;
+  return &known->second.Members;
+}
+
+void ASTContext::cacheVisibleMembers(TypeBase *baseTy,
+                                     const DeclContext *currDC,
+                                     unsigned lookupFlags,
+                                     std::vector<CachedVisibleMember> &&members) {
+  auto &entry = Impl.VisibleMemberCache[{{baseTy, currDC}, lookupFlags}];
+  entry.Generation = CurrentGeneration;
+  entry.Members = std::move(members);
+}
+
 void ASTContext::loadObjCMethods(
        ClassDecl *classDecl,
        ObjCSelector selector,
@@ -1451,8 +1559,11 @@ ArchetypeBuilder *ASTContext::getOrCreateArchetypeBuilder(
   // Check whether we already have an archetype builder for this
   // signature and module.
   auto known = Impl.ArchetypeBuilders.find({sig, mod});
-  if (known != Impl.ArchetypeBuilders.end())
+  if (known != Impl.ArchetypeBuilders.end()) {
+    ++NumArchetypeBuilderCacheHits;
     return known->second.get();
+  }
+  ++NumArchetypeBuilderCacheMisses;
 
   // Create a new archetype builder with the given signature.
   auto builder = new ArchetypeBuilder(*mod, Diags);
@@ -1465,13 +1576,46 @@ ArchetypeBuilder *ASTContext::getOrCreateArchetypeBuilder(
   return builder;
 }
 
-void ASTContext::setArchetypeBuilder(CanGenericSignature sig,
-                                     ModuleDecl *mod,
-                                     std::unique_ptr<ArchetypeBuilder> builder) {
-  if (Impl.ArchetypeBuilders.find({sig, mod})
-        == Impl.ArchetypeBuilders.end()) {
-    Impl.ArchetypeBuilders[{sig, mod}] = move(builder);
+Optional<Type> ASTContext::getCachedTypeSubstitution(
+                 TypeBase *type, ModuleDecl *mod, SubstOptions options,
+                 ArrayRef<std::pair<TypeBase *, TypeBase *>> substitutions) {
+  llvm::FoldingSetNodeID id;
+  Implementation::TypeSubstitutionCacheEntry::Profile(id, type, mod,
+                                                      options.toRaw(),
+                                                      substitutions);
+  void *insertPos = nullptr;
+  if (auto entry
+        = Impl.TypeSubstitutionCache.FindNodeOrInsertPos(id, insertPos)) {
+    ++NumTypeSubstitutionCacheHits;
+    return entry->Result;
   }
+
+  ++NumTypeSubstitutionCacheMisses;
+  return None;
+}
+
+void ASTContext::setCachedTypeSubstitution(
+       TypeBase *type, ModuleDecl *mod, SubstOptions options,
+       ArrayRef<std::pair<TypeBase *, TypeBase *>> substitutions,
+       Type result) {
+  llvm::FoldingSetNodeID id;
+  Implementation::TypeSubstitutionCacheEntry::Profile(id, type, mod,
+                                                      options.toRaw(),
+                                                      substitutions);
+  void *insertPos = nullptr;
+  if (Impl.TypeSubstitutionCache.FindNodeOrInsertPos(id, insertPos))
+    return;
+
+  auto entry = new (*this, AllocationArena::Permanent)
+                 Implementation::TypeSubstitutionCacheEntry;
+  entry->Original = type;
+  entry->Mod = mod;
+  entry->Options = options.toRaw();
+  entry->Substitutions = AllocateCopy(substitutions,
+                                      AllocationArena::Permanent,
+                                      AllocationKind::Substitution);
+  entry->Result = result;
+  Impl.TypeSubstitutionCache.InsertNode(entry, insertPos);
 }
 
 Module *
@@ -1649,7 +1793,8 @@ ASTContext::getSpecializedConformance(Type type,
     return result;
 
   // Build a new specialized conformance.
-  substitutions = AllocateCopy(substitutions, arena);
+  substitutions = AllocateCopy(substitutions, arena,
+                               AllocationKind::Substitution);
   auto result
     = new (*this, arena) SpecializedProtocolConformance(type, generic,
                                                         substitutions);
@@ -1737,6 +1882,9 @@ size_t ASTContext::getTotalMemory() const {
     Impl.OpenedExistentialArchetypes.getMemorySize() +
     Impl.Permanent.getTotalMemory();
 
+  for (auto &Shard : Impl.IdentifierTable)
+    Size += Shard.Allocator.getTotalMemory();
+
     Size += getSolverMemory();
 
     return Size;
@@ -1744,14 +1892,47 @@ size_t ASTContext::getTotalMemory() const {
 
 size_t ASTContext::getSolverMemory() const {
   size_t Size = 0;
-  
+
   if (Impl.CurrentConstraintSolverArena) {
     Size += Impl.CurrentConstraintSolverArena->getTotalMemory();
   }
-  
+
   return Size;
 }
 
+void ASTContext::noteMemoryHighWater() const {
+  PeakTotalMemory = std::max(PeakTotalMemory, getTotalMemory());
+}
+
+size_t ASTContext::getPeakTotalMemory() const {
+  return std::max(PeakTotalMemory, getTotalMemory());
+}
+
+static StringRef getAllocationKindName(AllocationKind kind) {
+  switch (kind) {
+  case AllocationKind::Type: return "Type";
+  case AllocationKind::Decl: return "Decl";
+  case AllocationKind::Expr: return "Expr";
+  case AllocationKind::Stmt: return "Stmt";
+  case AllocationKind::Pattern: return "Pattern";
+  case AllocationKind::TypeRepr: return "TypeRepr";
+  case AllocationKind::Substitution: return "Substitution";
+  case AllocationKind::Other: return "Other";
+  }
+  llvm_unreachable("Unhandled AllocationKind in switch.");
+}
+
+void ASTContext::printAllocationStatistics(llvm::raw_ostream &os) const {
+  os << "=== ASTContext allocations ===\n";
+  for (unsigned i = 0; i != NumAllocationKinds; ++i) {
+    const auto &account = getAllocationAccount(AllocationKind(i));
+    os << "  " << getAllocationKindName(AllocationKind(i)) << ": "
+       << account.Count << " allocations, " << account.Bytes << " bytes\n";
+  }
+  os << "  total memory: " << getTotalMemory() << " bytes ("
+     << getPeakTotalMemory() << " peak)\n";
+}
+
 size_t ASTContext::Implementation::Arena::getTotalMemory() const {
   return sizeof(*this) +
     // TupleTypes ?
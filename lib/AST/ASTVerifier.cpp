@@ -2979,6 +2979,17 @@ struct ASTNodeBase {};
 void swift::verify(SourceFile &SF) {
 #if !(defined(NDEBUG) || defined(SWIFT_DISABLE_AST_VERIFIER))
   Verifier verifier(SF, &SF);
+
+  // In sampling mode, verify only the sampled subset of the file's
+  // top-level declarations instead of the whole file.
+  if (SF.getASTContext().LangOpts.ASTVerifierSamplePeriod > 1) {
+    for (Decl *D : SF.Decls) {
+      if (shouldVerify(D, SF.getASTContext()))
+        D->walk(verifier);
+    }
+    return;
+  }
+
   SF.walk(verifier);
 #endif
 }
@@ -2987,8 +2998,9 @@ bool swift::shouldVerify(const Decl *D, const ASTContext &Context) {
 #if !(defined(NDEBUG) || defined(SWIFT_DISABLE_AST_VERIFIER))
   unsigned ProcessCount = Context.LangOpts.ASTVerifierProcessCount;
   unsigned ProcessId = Context.LangOpts.ASTVerifierProcessId;
-  if (ProcessCount == 1) {
-    // No parallelism, verify all declarations.
+  unsigned SamplePeriod = Context.LangOpts.ASTVerifierSamplePeriod;
+  if (ProcessCount == 1 && SamplePeriod <= 1) {
+    // No parallelism or sampling, verify all declarations.
     return true;
   }
 
@@ -3003,7 +3015,21 @@ bool swift::shouldVerify(const Decl *D, const ASTContext &Context) {
   }
 
   size_t Hash = llvm::hash_value(VD->getNameStr());
-  return Hash % ProcessCount == ProcessId;
+  if (ProcessCount != 1 && Hash % ProcessCount != ProcessId)
+    return false;
+
+  if (SamplePeriod > 1) {
+    // Take a deterministic 1-in-N sample, seeded by the name of the file
+    // holding the declaration (or the module, for declarations without a
+    // source file) so the sample is stable across runs.
+    StringRef seedName = VD->getModuleContext()->getName().str();
+    if (const SourceFile *SF = VD->getDeclContext()->getParentSourceFile())
+      seedName = SF->getFilename();
+    return llvm::hash_combine(llvm::hash_value(seedName), Hash)
+             % SamplePeriod == 0;
+  }
+
+  return true;
 #else
   return false;
 #endif
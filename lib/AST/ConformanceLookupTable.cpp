@@ -360,22 +360,21 @@ void ConformanceLookupTable::updateLookupTable(NominalTypeDecl *nominal,
     // conformances.
     updateLookupTable(nominal, ConformanceStage::ExpandedImplied, resolver);
     
-    /// Determine whether any extensions were added that might require
-    /// us to compute conformances again.
-    bool anyChanged = false;
+    // Catch up with any newly-added contexts at this stage.
     forEachInStage(stage, nominal, resolver,
-                   [&](NominalTypeDecl *nominal) {
-                     anyChanged = true;
-                   },
-                   [&](ExtensionDecl *ext) {
-                     anyChanged = true;
-                   });
-                   
-    if (anyChanged) {
-      // Compute the conformances for each protocol.
+                   [&](NominalTypeDecl *nominal) { },
+                   [&](ExtensionDecl *ext) { });
+
+    // Compute the conformances for each protocol whose entry list has
+    // changed. A newly-loaded batch of extensions only marks the
+    // protocols it declares conformances to; the remaining cells are
+    // still resolved from the last time through this stage.
+    if (!UnresolvedProtocols.empty()) {
       bool anySuperseded = false;
-      for (const auto &entry : Conformances) {
-        if (resolveConformances(nominal, entry.first, resolver))
+      SmallVector<ProtocolDecl *, 4> unresolved(UnresolvedProtocols.begin(),
+                                                UnresolvedProtocols.end());
+      for (auto protocol : unresolved) {
+        if (resolveConformances(nominal, protocol, resolver))
           anySuperseded = true;
       }
 
@@ -474,6 +473,9 @@ bool ConformanceLookupTable::addProtocol(NominalTypeDecl *nominal,
   ConformanceEntry *entry = new (ctx) ConformanceEntry(loc, protocol, source);
   conformanceEntries.push_back(entry);
 
+  // This protocol's cell will need to be resolved (again).
+  UnresolvedProtocols.insert(protocol);
+
   // Record this as a conformance within the given declaration
   // context.
   AllConformances[dc].push_back(entry);
@@ -676,6 +678,10 @@ ConformanceLookupTable::Ordering ConformanceLookupTable::compareConformances(
 bool ConformanceLookupTable::resolveConformances(NominalTypeDecl *nominal,
                                                  ProtocolDecl *protocol,
                                                  LazyResolver *resolver) {
+  // This protocol's entries are about to be brought up to date; any
+  // entry added during resolution re-marks it.
+  UnresolvedProtocols.remove(protocol);
+
   // Find any entries that are superseded by other entries.
   ConformanceEntries &entries = Conformances[protocol];
   llvm::SmallPtrSet<DeclContext *, 4> knownConformances;
@@ -886,6 +892,7 @@ void ConformanceLookupTable::registerProtocolConformance(
 
   // Record that this type conforms to the given protocol.
   Conformances[protocol].push_back(entry);
+  UnresolvedProtocols.insert(protocol);
 
   // Record this as a conformance within the given declaration
   // context.
@@ -307,6 +307,15 @@ class ConformanceLookupTable {
   /// The conformance table.
   ConformanceTable Conformances;
 
+  /// The protocols whose entry lists have changed since they were last
+  /// resolved.
+  ///
+  /// Extension batches arrive incrementally (keyed off the ASTContext
+  /// generation via \c NominalTypeDecl::prepareExtensions), and each batch
+  /// only declares conformances to a few protocols. Resolution revisits
+  /// just these cells instead of rescanning the whole table.
+  llvm::SetVector<ProtocolDecl *> UnresolvedProtocols;
+
   typedef llvm::SmallVector<ProtocolDecl *, 2> ProtocolList;
 
   /// List of all of the protocols to which a given context declares
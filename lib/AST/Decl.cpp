@@ -73,7 +73,8 @@ const clang::Module *ClangNode::getClangModule() const {
 // Only allow allocation of Decls using the allocator in ASTContext.
 void *Decl::operator new(size_t Bytes, const ASTContext &C,
                          unsigned Alignment) {
-  return C.Allocate(Bytes, Alignment);
+  return C.Allocate(Bytes, Alignment, AllocationArena::Permanent,
+                    AllocationKind::Decl);
 }
 
 // Only allow allocation of Modules using the allocator in ASTContext.
@@ -569,6 +569,7 @@ void DiagnosticEngine::flushActiveDiagnostic() {
   if (TransactionCount == 0) {
     emitDiagnostic(*ActiveDiagnostic);
   } else {
+    onTentativeDiagnosticFlush(*ActiveDiagnostic);
     TentativeDiagnostics.emplace_back(std::move(*ActiveDiagnostic));
   }
   ActiveDiagnostic.reset();
@@ -579,6 +580,28 @@ void DiagnosticEngine::emitTentativeDiagnostics() {
     emitDiagnostic(diag);
   }
   TentativeDiagnostics.clear();
+
+  // All tentative diagnostics have been formatted and delivered, so the text
+  // the arena was keeping alive for them can be recycled.
+  TransactionStrings.clear();
+  TransactionAllocator.Reset();
+}
+
+void DiagnosticEngine::onTentativeDiagnosticFlush(Diagnostic &diagnostic) {
+  for (auto &argument : diagnostic.Args) {
+    if (argument.getKind() != DiagnosticArgumentKind::String)
+      continue;
+
+    auto content = argument.getAsString();
+    if (content.empty())
+      continue;
+
+    // The diagnostic will not be formatted until the enclosing transaction
+    // commits, which may be after the caller's string has been destroyed;
+    // retain a copy in the transaction arena and point the argument at it.
+    auto I = TransactionStrings.insert(std::make_pair(content, char())).first;
+    argument = DiagnosticArgument(I->getKey());
+  }
 }
 
 void DiagnosticEngine::emitDiagnostic(const Diagnostic &diagnostic) {
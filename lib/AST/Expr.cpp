@@ -50,7 +50,8 @@ StringRef swift::getFunctionRefKindStr(FunctionRefKind refKind) {
 // Only allow allocation of Stmts using the allocator in ASTContext.
 void *Expr::operator new(size_t Bytes, ASTContext &C,
                          unsigned Alignment) {
-  return C.Allocate(Bytes, Alignment);
+  return C.Allocate(Bytes, Alignment, AllocationArena::Permanent,
+                    AllocationKind::Expr);
 }
 
 StringRef Expr::getKindName(ExprKind K) {
@@ -202,14 +202,11 @@ GenericSignature::getCanonicalManglingSignature(ModuleDecl &M) const {
   }
   
   // Otherwise, we need to compute it.
-  // Dump the generic signature into an ArchetypeBuilder that will figure out
-  // the minimal set of requirements.
-  std::unique_ptr<ArchetypeBuilder> builder(new ArchetypeBuilder(M, 
-                                                                 Context.Diags));
-  
-  builder->addGenericSignature(canonical, /*adoptArchetypes*/ false,
-                               /*treatRequirementsAsExplicit*/ true);
-  
+  // Use the archetype builder shared through the ASTContext, which has
+  // already figured out the minimal set of requirements; structurally
+  // equal signatures thus build their requirement graph only once.
+  auto *builder = canonical->getArchetypeBuilder(M);
+
   // Sort out the requirements.
   struct DependentConstraints {
     CanType baseClass;
@@ -371,9 +368,10 @@ GenericSignature::getCanonicalManglingSignature(ModuleDecl &M) const {
   
   CanGenericSignature canSig(manglingSig);
   
-  // Cache the result.
+  // Cache the result.  The builder is owned by the ASTContext and stays
+  // registered under the canonical signature; if the minimized signature
+  // ever needs a builder of its own, it is created on demand.
   Context.ManglingSignatures.insert({{canonical, &M}, canSig});
-  Context.setArchetypeBuilder(canSig, &M, std::move(builder));
 
   return canSig;
 }
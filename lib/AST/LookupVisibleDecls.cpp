@@ -906,6 +906,25 @@ void swift::lookupVisibleDecls(VisibleDeclConsumer &Consumer,
   }
 }
 
+namespace {
+/// A consumer that records each found declaration for the per-ASTContext
+/// visible-member cache while forwarding it to the real consumer.
+class CacheFillingConsumer : public VisibleDeclConsumer {
+  VisibleDeclConsumer &TargetConsumer;
+
+public:
+  std::vector<ASTContext::CachedVisibleMember> Members;
+
+  CacheFillingConsumer(VisibleDeclConsumer &TargetConsumer)
+      : TargetConsumer(TargetConsumer) {}
+
+  void foundDecl(ValueDecl *VD, DeclVisibilityKind Reason) override {
+    Members.push_back({VD, static_cast<unsigned>(Reason)});
+    TargetConsumer.foundDecl(VD, Reason);
+  }
+};
+} // unnamed namespace
+
 void swift::lookupVisibleMemberDecls(VisibleDeclConsumer &Consumer, Type BaseTy,
                                      const DeclContext *CurrDC,
                                      LazyResolver *TypeResolver,
@@ -916,7 +935,34 @@ void swift::lookupVisibleMemberDecls(VisibleDeclConsumer &Consumer, Type BaseTy,
     ls = ls.withIncludedInstanceMembers();
   }
 
-  ::lookupVisibleMemberDecls(BaseTy, Consumer, CurrDC, ls,
+  // Cache qualified lookups per ASTContext: code completion queries the same
+  // base types over and over in one session. Results without a resolver can
+  // differ (extensions stay unresolved), so only resolved lookups are
+  // cached. Stale entries are rejected by their generation stamp, since a
+  // newly loaded module can add extensions to the base type.
+  ASTContext &Ctx = CurrDC->getASTContext();
+  TypeBase *keyTy = BaseTy->getCanonicalType().getPointer();
+  unsigned keyFlags = includeInstanceMembers ? 1 : 0;
+  if (TypeResolver) {
+    if (const auto *cached =
+            Ctx.getCachedVisibleMembers(keyTy, CurrDC, keyFlags)) {
+      for (const auto &member : *cached)
+        Consumer.foundDecl(member.first,
+                           static_cast<DeclVisibilityKind>(member.second));
+      return;
+    }
+  }
+
+  CacheFillingConsumer CachingConsumer(Consumer);
+  unsigned generation = Ctx.getCurrentGeneration();
+
+  ::lookupVisibleMemberDecls(BaseTy, CachingConsumer, CurrDC, ls,
                              DeclVisibilityKind::MemberOfCurrentNominal,
                              TypeResolver);
+
+  // If the lookup itself loaded new modules, the results may already be
+  // incomplete; don't record them.
+  if (TypeResolver && generation == Ctx.getCurrentGeneration())
+    Ctx.cacheVisibleMembers(keyTy, CurrDC, keyFlags,
+                            std::move(CachingConsumer.Members));
 }
@@ -69,8 +69,13 @@ static Demangle::OperatorKind TranslateOperator(OperatorFixity fixity) {
   llvm_unreachable("invalid operator fixity");
 }
 
+uint64_t Mangler::NumMangledNames = 0;
+uint64_t Mangler::NumSubstitutionHits = 0;
+uint64_t Mangler::NumSubstitutionMisses = 0;
+
 /// Finish the mangling of the symbol and return the mangled name.
 std::string Mangler::finalize() {
+  ++NumMangledNames;
   assert(Storage.size() && "Mangling an empty name");
   std::string result = std::string(Storage.data(), Storage.size());
   Storage.clear();
@@ -105,7 +110,11 @@ void Mangler::mangleIdentifier(Identifier ident, OperatorFixity fixity) {
 
 bool Mangler::tryMangleSubstitution(const void *ptr) {
   auto ir = Substitutions.find(ptr);
-  if (ir == Substitutions.end()) return false;
+  if (ir == Substitutions.end()) {
+    ++NumSubstitutionMisses;
+    return false;
+  }
+  ++NumSubstitutionHits;
 
   // substitution ::= 'S' integer? '_'
 
@@ -1019,6 +1019,12 @@ lookupOperatorDeclForName(Module *M, SourceLoc Loc, Identifier Name,
   return result;
 }
 
+// The file-local lookup memoizes what it finds through this file's imports,
+// but an operator declared in a sibling file of this module is only found by
+// the parent-module fallback below, which used to walk every file of the
+// module again on each lookup.  Cache that result in the file's operator map
+// as well, marked non-exported so lookups coming from other files don't
+// mistake it for one of this file's own (or re-exported) operators.
 #define LOOKUP_OPERATOR(Kind) \
 Kind##Decl * \
 Module::lookup##Kind(Identifier name, SourceLoc loc) { \
@@ -1041,6 +1047,8 @@ SourceFile::lookup##Kind(Identifier name, bool isCascading, SourceLoc loc) { \
   if (!result.getValue()) { \
     result = lookupOperatorDeclForName(getParentModule(), loc, name, \
                                        &SourceFile::Kind##s); \
+    if (result.hasValue() && result.getValue()) \
+      Kind##s[name] = { result.getValue(), false }; \
   } \
   return result.hasValue() ? result.getValue() : nullptr; \
 }
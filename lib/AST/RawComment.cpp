@@ -16,7 +16,6 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/AST/RawComment.h"
-#include "swift/AST/Comment.h"
 #include "swift/AST/ASTContext.h"
 #include "swift/AST/Decl.h"
 #include "swift/AST/Module.h"
@@ -210,18 +209,24 @@ static StringRef extractBriefComment(ASTContext &Context, RawComment RC,
   if (!D->canHaveComment())
     return StringRef();
 
+  // The brief is the comment's leading paragraph, so parse only the lines up
+  // to the first blank line instead of materializing the markup AST for the
+  // whole comment.  The arena lives only as long as this extraction.
   swift::markup::MarkupContext MC;
-  auto DC = getCascadingDocComment(MC, D);
-  if (!DC.hasValue())
+  swift::markup::LineList LL = MC.getLineList(RC).subListToFirstBlankLine();
+  auto *Doc = swift::markup::parseDocument(MC, LL);
+
+  auto Children = Doc->getChildren();
+  if (Children.empty())
     return StringRef();
 
-  auto Brief = DC.getValue()->getBrief();
-  if (!Brief.hasValue())
+  auto FirstParagraph = dyn_cast<swift::markup::Paragraph>(Children.front());
+  if (!FirstParagraph)
     return StringRef();
 
   SmallString<256> BriefStr("");
   llvm::raw_svector_ostream OS(BriefStr);
-  swift::markup::printInlinesUnder(Brief.getValue(), OS);
+  swift::markup::printInlinesUnder(FirstParagraph, OS);
   if (OS.str().empty())
     return StringRef();
 
@@ -30,7 +30,8 @@ using namespace swift;
 // Only allow allocation of Stmts using the allocator in ASTContext.
 void *Stmt::operator new(size_t Bytes, ASTContext &C,
                          unsigned Alignment) {
-  return C.Allocate(Bytes, Alignment);
+  return C.Allocate(Bytes, Alignment, AllocationArena::Permanent,
+                    AllocationKind::Stmt);
 }
 
 StringRef Stmt::getKindName(StmtKind K) {
@@ -49,7 +49,7 @@ SourceRange TypeLoc::getSourceRange() const {
 // Only allow allocation of Types using the allocator in ASTContext.
 void *TypeBase::operator new(size_t bytes, const ASTContext &ctx,
                              AllocationArena arena, unsigned alignment) {
-  return ctx.Allocate(bytes, alignment, arena);
+  return ctx.Allocate(bytes, alignment, arena, AllocationKind::Type);
 }
 
 bool CanType::isActuallyCanonicalOrNull() const {
@@ -2911,13 +2911,44 @@ Type DependentMemberType::substBaseType(Module *module,
 Type Type::subst(Module *module,
                  const TypeSubstitutionMap &substitutions,
                  SubstOptions options) const {
+  // If the type contains neither archetypes nor type parameters, there is
+  // nothing to substitute.
+  if (!getPointer()->hasArchetype() && !getPointer()->hasTypeParameter())
+    return *this;
+
+  // Check whether we have already computed this substitution. Results that
+  // involve type variables live in the constraint solver's arena, so they
+  // are never memoized, and neither are results computed under
+  // SubstFlags::IgnoreMissing: those may silently leave dependent members
+  // unresolved, and can change once the missing witnesses are resolved.
+  auto &ctx = module->getASTContext();
+  SmallVector<std::pair<TypeBase *, TypeBase *>, 4> flatSubstitutions;
+  bool cacheable = !options.contains(SubstFlags::IgnoreMissing) &&
+                   !getPointer()->hasTypeVariable();
+  if (cacheable) {
+    for (const auto &sub : substitutions) {
+      if (!sub.second || sub.second->hasTypeVariable()) {
+        cacheable = false;
+        break;
+      }
+      flatSubstitutions.push_back({sub.first, sub.second.getPointer()});
+    }
+  }
+  if (cacheable) {
+    std::sort(flatSubstitutions.begin(), flatSubstitutions.end());
+    if (auto cached = ctx.getCachedTypeSubstitution(getPointer(), module,
+                                                    options,
+                                                    flatSubstitutions))
+      return *cached;
+  }
+
   /// Return the original type or a null type, depending on the 'ignoreMissing'
   /// flag.
   auto failed = [&](Type t){
     return options.contains(SubstFlags::IgnoreMissing) ? t : Type();
   };
-  
-  return transform([&](Type type) -> Type {
+
+  Type result = transform([&](Type type) -> Type {
     assert((options.contains(SubstFlags::AllowLoweredTypes) ||
             !isa<SILFunctionType>(type.getPointer())) &&
            "should not be doing AST type-substitution on a lowered SIL type;"
@@ -2987,6 +3018,14 @@ Type Type::subst(Module *module,
       return r;
     return failed(type);
   });
+
+  // Memoize successful substitutions. Failures are deliberately not
+  // memoized: a dependent member lookup that fails now may succeed once
+  // the conformance's type witnesses have been resolved.
+  if (cacheable && result)
+    ctx.setCachedTypeSubstitution(getPointer(), module, options,
+                                  flatSubstitutions, result);
+  return result;
 }
 
 TypeSubstitutionMap TypeBase::getMemberSubstitutions(const DeclContext *dc) {
@@ -71,7 +71,8 @@ SourceRange TypeRepr::getSourceRange() const {
 /// Standard allocator for TypeReprs.
 void *TypeRepr::operator new(size_t Bytes, const ASTContext &C,
                              unsigned Alignment) {
-  return C.Allocate(Bytes, Alignment);
+  return C.Allocate(Bytes, Alignment, AllocationArena::Permanent,
+                    AllocationKind::TypeRepr);
 }
 
 Identifier ComponentIdentTypeRepr::getIdentifier() const {
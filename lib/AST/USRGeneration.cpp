@@ -46,7 +46,7 @@ bool ide::printDeclTypeUSR(const ValueDecl *D, raw_ostream &OS) {
   return false;
 }
 
-bool ide::printDeclUSR(const ValueDecl *D, raw_ostream &OS) {
+static bool printDeclUSRImpl(const ValueDecl *D, raw_ostream &OS) {
   using namespace Mangle;
 
   if (!isa<FuncDecl>(D) && !D->hasName())
@@ -142,8 +142,35 @@ bool ide::printDeclUSR(const ValueDecl *D, raw_ostream &OS) {
   return false;
 }
 
-bool ide::printAccessorUSR(const AbstractStorageDecl *D, AccessorKind AccKind,
-                           llvm::raw_ostream &OS) {
+bool ide::printDeclUSR(const ValueDecl *D, raw_ostream &OS) {
+  // Mangling the same declaration over and over dominates indexing time, so
+  // memoize the result per ASTContext. An empty entry means we already know
+  // the declaration has no USR.
+  auto &Ctx = D->getASTContext();
+  auto Known = Ctx.DeclUSRs.find(D);
+  if (Known != Ctx.DeclUSRs.end()) {
+    if (Known->second.empty())
+      return true;
+    OS << Known->second;
+    return false;
+  }
+
+  llvm::SmallString<128> Buf;
+  {
+    llvm::raw_svector_ostream BufOS(Buf);
+    if (printDeclUSRImpl(D, BufOS)) {
+      Ctx.DeclUSRs[D] = StringRef();
+      return true;
+    }
+  }
+  StringRef USR = Ctx.AllocateCopy(Buf.str());
+  Ctx.DeclUSRs[D] = USR;
+  OS << USR;
+  return false;
+}
+
+static bool printAccessorUSRImpl(const AbstractStorageDecl *D,
+                                 AccessorKind AccKind, llvm::raw_ostream &OS) {
   using namespace Mangle;
 
   // AccKind should always be either IsGetter or IsSetter here, based
@@ -166,6 +193,28 @@ bool ide::printAccessorUSR(const AbstractStorageDecl *D, AccessorKind AccKind,
   return false;
 }
 
+bool ide::printAccessorUSR(const AbstractStorageDecl *D, AccessorKind AccKind,
+                           llvm::raw_ostream &OS) {
+  auto &Ctx = D->getASTContext();
+  auto Key = std::make_pair(D, static_cast<unsigned>(AccKind));
+  auto Known = Ctx.AccessorUSRs.find(Key);
+  if (Known != Ctx.AccessorUSRs.end()) {
+    OS << Known->second;
+    return false;
+  }
+
+  llvm::SmallString<128> Buf;
+  {
+    llvm::raw_svector_ostream BufOS(Buf);
+    if (printAccessorUSRImpl(D, AccKind, BufOS))
+      return true;
+  }
+  StringRef USR = Ctx.AllocateCopy(Buf.str());
+  Ctx.AccessorUSRs[Key] = USR;
+  OS << USR;
+  return false;
+}
+
 bool ide::printExtensionUSR(const ExtensionDecl *ED, raw_ostream &OS) {
   if (ED->getExtendedType().isNull())
     return true;
@@ -22,15 +22,24 @@
 using namespace swift;
 
 ClusteredBitVector ClusteredBitVector::fromAPInt(const llvm::APInt &bits) {
-  // This is not a very efficient algorithm.
+  // This assumes that the chunk size is the same as APInt's.
+  static_assert(ChunkSizeInBits == llvm::APInt::APINT_BITS_PER_WORD,
+                "chunk size is not the same as APInt's word size");
+
   ClusteredBitVector result;
-  for (unsigned i = 0, e = bits.getBitWidth(); i != e; ++i) {
-    if (bits[i]) {
-      result.appendSetBits(1);
-    } else {
-      result.appendClearBits(1);
-    }
+  if (bits.getBitWidth() == 0)
+    return result;
+
+  // Stay in the inline-and-all-clear representation if no bits are set.
+  if (bits.isMinValue()) {
+    result.appendClearBits(bits.getBitWidth());
+    return result;
   }
+
+  // Otherwise, copy whole words at a time.  APInt zeroes the unused high
+  // bits of its last word, which is exactly the chunk invariant.
+  result.reserve(bits.getBitWidth());
+  result.appendReserved(bits.getBitWidth(), bits.getRawData());
   return result;
 }
 
@@ -172,6 +181,47 @@ void ClusteredBitVector::appendReserved(size_t numBits,
   });
 }
 
+ClusteredBitVector ClusteredBitVector::slice(size_t begin,
+                                             size_t numBits) const {
+  assert(begin + numBits <= size());
+
+  ClusteredBitVector result;
+  if (numBits == 0)
+    return result;
+
+  // A slice of an all-clear vector is all-clear.
+  if (isInlineAndAllClear()) {
+    result.appendClearBits(numBits);
+    return result;
+  }
+
+  result.reserve(numBits);
+
+  const ChunkType *chunks = getChunksPtr() + begin / ChunkSizeInBits;
+  auto offset = begin % ChunkSizeInBits;
+
+  // If the slice starts on a chunk boundary, we can copy chunks directly.
+  if (offset == 0) {
+    result.appendReserved(numBits, chunks);
+    return result;
+  }
+
+  // Otherwise, produce each chunk by splicing the two source chunks it
+  // straddles.  The generator is called for full chunks except possibly
+  // the last, so only read the second source chunk when the requested
+  // bits actually extend into it.
+  result.appendReserved(numBits, [&](size_t numBitsWanted) -> ChunkType {
+    auto chunk = chunks[0] >> offset;
+    if (numBitsWanted > ChunkSizeInBits - offset)
+      chunk |= chunks[1] << (ChunkSizeInBits - offset);
+    ++chunks;
+    if (numBitsWanted != ChunkSizeInBits)
+      chunk &= ((ChunkType(1) << numBitsWanted) - 1);
+    return chunk;
+  });
+  return result;
+}
+
 bool ClusteredBitVector::equalsSlowCase(const ClusteredBitVector &lhs,
                                         const ClusteredBitVector &rhs) {
   assert(lhs.size() == rhs.size());
@@ -21,6 +21,7 @@
 #include "swift/Basic/Punycode.h"
 #include "swift/Basic/UUID.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
 #include <functional>
 #include <vector>
 #include <cstdio>
@@ -2302,15 +2303,15 @@ swift::Demangle::demangleTypeAsNode(const char *MangledName,
 namespace {
 class NodePrinter {
 private:
-  DemanglerPrinter Printer;
+  llvm::raw_ostream &Printer;
   DemangleOptions Options;
-  
+
 public:
-  NodePrinter(DemangleOptions options) : Options(options) {}
-  
-  std::string printRoot(NodePointer root) {
+  NodePrinter(llvm::raw_ostream &Out, DemangleOptions options)
+      : Printer(Out), Options(options) {}
+
+  void printRoot(NodePointer root) {
     print(root);
-    return std::move(Printer).str();
   }
 
 private:  
@@ -3695,7 +3696,19 @@ std::string Demangle::nodeToString(NodePointer root,
   if (!root)
     return "";
 
-  return NodePrinter(options).printRoot(root);
+  std::string demangling;
+  llvm::raw_string_ostream stream(demangling);
+  NodePrinter(stream, options).printRoot(std::move(root));
+  stream.flush();
+  return demangling;
+}
+
+void Demangle::nodeToString(NodePointer root, llvm::raw_ostream &out,
+                            const DemangleOptions &options) {
+  if (!root)
+    return;
+
+  NodePrinter(out, options).printRoot(std::move(root));
 }
 
 std::string Demangle::demangleSymbolAsString(const char *MangledName,
@@ -3711,6 +3724,22 @@ std::string Demangle::demangleSymbolAsString(const char *MangledName,
   return demangling;
 }
 
+void Demangle::demangleSymbolAsString(StringRef MangledName,
+                                      llvm::raw_ostream &Out,
+                                      const DemangleOptions &Options) {
+  auto root = demangleSymbolAsNode(MangledName.data(), MangledName.size(),
+                                   Options);
+  if (!root) {
+    Out << MangledName;
+    return;
+  }
+
+  uint64_t start = Out.tell();
+  NodePrinter(Out, Options).printRoot(std::move(root));
+  if (Out.tell() == start)
+    Out << MangledName;
+}
+
 std::string Demangle::demangleTypeAsString(const char *MangledName,
                                            size_t MangledNameLength,
                                            const DemangleOptions &Options) {
@@ -23,6 +23,7 @@
 #include "swift/Basic/UUID.h"
 #include "swift/Strings.h"
 #include "llvm/ADT/StringRef.h"
+#include <unordered_map>
 #include <vector>
 #include <cstdio>
 #include <cstdlib>
@@ -128,10 +129,17 @@ void Demangle::mangleIdentifier(const char *data, size_t length,
   out = std::move(printer).str();
 }
 
+static size_t deepHash(Node *node,
+                       std::unordered_map<Node *, size_t> &hashCache);
+
 namespace {
   struct DeepHasher {
+    std::unordered_map<Node *, size_t> &hashCache;
     size_t value = 0;
 
+    explicit DeepHasher(std::unordered_map<Node *, size_t> &hashCache)
+        : hashCache(hashCache) {}
+
     void combine(size_t newValue) {
       value = 33 * value + newValue;
     }
@@ -147,16 +155,26 @@ namespace {
         }
       }
       for (const auto &child : *node) {
-        hash(child.get());
+        combine(deepHash(child.get(), hashCache));
       }
     }
   };
 }
 
-static size_t deepHash(Node *node) {
-  DeepHasher hasher;
+/// Hash the given subtree, memoizing the result per node.  Substitution
+/// candidates nest, so without memoization every enclosing candidate re-walks
+/// the subtrees of all of its descendants and hashing becomes quadratic in
+/// the tree depth.
+static size_t deepHash(Node *node,
+                       std::unordered_map<Node *, size_t> &hashCache) {
+  auto known = hashCache.find(node);
+  if (known != hashCache.end())
+    return known->second;
+
+  DeepHasher hasher(hashCache);
   hasher.hash(node);
-  return hasher.value;  
+  hashCache.insert({node, hasher.value});
+  return hasher.value;
 }
 
 static bool deepEquals(Node *lhs, Node *rhs) {
@@ -179,7 +197,7 @@ static bool deepEquals(Node *lhs, Node *rhs) {
   if (lhs->getNumChildren() != rhs->getNumChildren())
     return false;
 
-  for (auto li = lhs->begin(), ri = lhs->begin(), le = lhs->end();
+  for (auto li = lhs->begin(), ri = rhs->begin(), le = lhs->end();
        li != le; ++li, ++ri) {
     if (!deepEquals(li->get(), ri->get()))
       return false;
@@ -203,7 +221,7 @@ namespace {
     friend bool operator==(const SubstitutionEntry &lhs,
                            const SubstitutionEntry &rhs) {
       return (lhs.StoredHash == rhs.StoredHash &&
-              deepEquals(lhs.TheNode, lhs.TheNode));
+              deepEquals(lhs.TheNode, rhs.TheNode));
     }
   };
 
@@ -216,6 +234,11 @@ namespace {
 
     std::unordered_map<SubstitutionEntry, unsigned,
                        SubstitutionEntry::Hasher> Substitutions;
+
+    // Memoized deep hashes of the nodes considered for substitution.  The
+    // nodes are owned by the tree being mangled (or by TemporaryNodes), so
+    // the pointer keys stay valid for the lifetime of the remangler.
+    std::unordered_map<Node *, size_t> HashCache;
   public:
     Remangler(DemanglerPrinter &out) : Out(out) {}
 
@@ -381,7 +404,7 @@ bool Remangler::trySubstitution(Node *node, SubstitutionEntry &entry) {
 
   // Go ahead and initialize the substitution entry.
   entry.TheNode = node;
-  entry.StoredHash = deepHash(node);
+  entry.StoredHash = deepHash(node, HashCache);
 
   auto it = Substitutions.find(entry);
   if (it == Substitutions.end())
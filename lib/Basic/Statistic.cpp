@@ -0,0 +1,95 @@
+//===--- Statistic.cpp - Unified stats reporting --------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/Statistic.h"
+#include "swift/Basic/JSONSerialization.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace swift;
+
+namespace {
+/// The record written to disk: the always-on counters plus the process
+/// times for the whole job.
+struct JobStats {
+  UnifiedStatsReporter::AlwaysOnFrontendCounters &Counters;
+  double UserTime;
+  double WallTime;
+};
+} // end anonymous namespace
+
+namespace swift {
+namespace json {
+template <>
+struct ObjectTraits<JobStats> {
+  static void mapping(Output &out, JobStats &value) {
+#define FRONTEND_STATISTIC(NAME)                                               \
+    out.mapRequired(#NAME, value.Counters.NAME);
+#include "swift/Basic/Statistics.def"
+    out.mapRequired("JobUserTime", value.UserTime);
+    out.mapRequired("JobWallTime", value.WallTime);
+  }
+};
+} // end namespace json
+} // end namespace swift
+
+UnifiedStatsReporter::UnifiedStatsReporter(StringRef ProgramName,
+                                           StringRef TargetName,
+                                           StringRef Directory)
+  : Filename(Directory),
+    Timer("Total frontend job time"),
+    FrontendCounters(new AlwaysOnFrontendCounters()) {
+  // Make the filename unique per job so that parallel jobs sharing a stats
+  // directory do not clobber one another.
+  auto Now = llvm::sys::TimeValue::now();
+  llvm::sys::path::append(Filename,
+                          "stats-" + llvm::utostr(Now.seconds()) +
+                          "-" + ProgramName.str() +
+                          "-" + llvm::sys::path::filename(TargetName).str() +
+                          "-" + llvm::utostr(llvm::sys::Process::getProcessId()) +
+                          ".json");
+  Timer.startTimer();
+}
+
+UnifiedStatsReporter::AlwaysOnFrontendCounters &
+UnifiedStatsReporter::getFrontendCounters() {
+  return *FrontendCounters;
+}
+
+UnifiedStatsReporter::~UnifiedStatsReporter() {
+  Timer.stopTimer();
+
+  std::error_code EC =
+      llvm::sys::fs::create_directories(llvm::sys::path::parent_path(Filename));
+  if (EC) {
+    llvm::errs() << "Error creating directory for '" << Filename << "': "
+                 << EC.message() << '\n';
+    return;
+  }
+  llvm::raw_fd_ostream OS(Filename, EC, llvm::sys::fs::F_None);
+  if (EC) {
+    llvm::errs() << "Error opening stats file '" << Filename << "': "
+                 << EC.message() << '\n';
+    return;
+  }
+
+  auto Elapsed = Timer.getTotalTime();
+  JobStats Stats{*FrontendCounters, Elapsed.getUserTime(),
+                 Elapsed.getWallTime()};
+  json::Output JSONOut(OS);
+  JSONOut << Stats;
+  OS << '\n';
+}
@@ -42,7 +42,10 @@ DummyTaskQueue::DummyTaskQueue(unsigned NumberOfParallelTasks)
 DummyTaskQueue::~DummyTaskQueue() = default;
 
 void DummyTaskQueue::addTask(const char *ExecPath, ArrayRef<const char *> Args,
-                             ArrayRef<const char *> Env, void *Context) {
+                             ArrayRef<const char *> Env, void *Context,
+                             uint64_t EstimatedMemoryUsage) {
+  // Simulated tasks don't consume any memory, so the estimate is ignored.
+  (void)EstimatedMemoryUsage;
   QueuedTasks.emplace(
     std::unique_ptr<DummyTask>(new DummyTask(ExecPath, Args, Env, Context)));
 }
@@ -11,7 +11,76 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/Basic/Timer.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace swift;
 
 SharedTimer::State SharedTimer::CompilationTimersEnabled = State::Initial;
+bool SharedTimer::TracingEnabled = false;
+
+namespace {
+/// One completed timer scope. Nesting is implicit: the viewer stacks
+/// events on the same thread whose intervals contain one another.
+struct TraceEvent {
+  StringRef Name;
+  uint64_t ThreadID;
+  uint64_t StartNanos;
+  uint64_t DurationNanos;
+};
+
+std::mutex TraceEventsLock;
+std::vector<TraceEvent> TraceEvents;
+} // end anonymous namespace
+
+static uint64_t nowNanos() {
+  return llvm::sys::TimeValue::now().nanoseconds();
+}
+
+static uint64_t currentThreadID() {
+  return std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+void SharedTimer::recordStart() {
+  StartNanos = nowNanos();
+}
+
+void SharedTimer::recordEnd() {
+  if (StartNanos == 0)
+    return;
+  uint64_t end = nowNanos();
+  std::lock_guard<std::mutex> lock(TraceEventsLock);
+  TraceEvents.push_back({Name, currentThreadID(), StartNanos,
+                         end - StartNanos});
+}
+
+void SharedTimer::writeTraceEvents(llvm::raw_ostream &os) {
+  std::lock_guard<std::mutex> lock(TraceEventsLock);
+
+  // Report timestamps relative to the earliest event, in microseconds, as
+  // the tracing format expects.
+  uint64_t earliest = UINT64_MAX;
+  for (const TraceEvent &event : TraceEvents)
+    earliest = std::min(earliest, event.StartNanos);
+
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  for (const TraceEvent &event : TraceEvents) {
+    if (!first)
+      os << ',';
+    first = false;
+    os << "\n{\"ph\":\"X\",\"cat\":\"swift\",\"pid\":1"
+       << ",\"tid\":" << event.ThreadID
+       << ",\"name\":\"" << event.Name << "\""
+       << ",\"ts\":"
+       << llvm::format("%.3f", (event.StartNanos - earliest) / 1000.0)
+       << ",\"dur\":" << llvm::format("%.3f", event.DurationNanos / 1000.0)
+       << "}";
+  }
+  os << "\n]}\n";
+}
@@ -56,6 +56,8 @@
 #include "clang/Sema/Sema.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <memory>
@@ -480,6 +482,15 @@ getNormalInvocationArguments(std::vector<std::string> &invocationArgStrs,
     invocationArgStrs.back().append(moduleCachePath);
   }
 
+  // Limit module validation to once per build session, so that concurrent
+  // frontend jobs sharing a cache don't all re-stat every input of every
+  // cached module they load.
+  if (importerOpts.ValidateModulesOnce) {
+    invocationArgStrs.push_back("-fbuild-session-file=" +
+                                importerOpts.BuildSessionFilePath);
+    invocationArgStrs.push_back("-fmodules-validate-once-per-build-session");
+  }
+
   if (importerOpts.DetailedPreprocessingRecord) {
     invocationArgStrs.insert(invocationArgStrs.end(), {
       "-Xclang", "-detailed-preprocessing-record",
@@ -558,6 +569,15 @@ addCommonInvocationArguments(std::vector<std::string> &invocationArgStrs,
     invocationArgStrs.push_back(overrideResourceDir);
   }
 
+  // Consume a precompiled bridging header, if one was provided; this loads
+  // the header's AST when the compiler instance is set up rather than
+  // re-parsing its text on every import.
+  if (!importerOpts.BridgingHeaderPCH.empty() &&
+      importerOpts.Mode == ClangImporterOptions::Modes::Normal) {
+    invocationArgStrs.push_back("-include-pch");
+    invocationArgStrs.push_back(importerOpts.BridgingHeaderPCH);
+  }
+
   for (auto extraArg : importerOpts.ExtraArgs) {
     invocationArgStrs.push_back(extraArg);
   }
@@ -571,6 +591,33 @@ addCommonInvocationArguments(std::vector<std::string> &invocationArgStrs,
   invocationArgStrs.push_back(searchPathOpts.RuntimeLibraryImportPath);
 }
 
+/// Computes the cache path for a precompiled form of the bridging header,
+/// keyed on everything that affects its contents: the header itself, the
+/// target, the SDK, and any extra Clang arguments.
+static std::string getBridgingPCHCachePath(ASTContext &ctx,
+                                           const ClangImporterOptions &opts) {
+  auto buffer = llvm::MemoryBuffer::getFile(opts.BridgingHeader);
+  if (!buffer)
+    return {};
+
+  llvm::MD5 hash;
+  hash.update(opts.BridgingHeader);
+  hash.update(buffer.get()->getBuffer());
+  hash.update(ctx.LangOpts.Target.str());
+  hash.update(ctx.SearchPathOpts.SDKPath);
+  for (auto &arg : opts.ExtraArgs)
+    hash.update(arg);
+  llvm::MD5::MD5Result hashResult;
+  hash.final(hashResult);
+  SmallString<32> hashStr;
+  llvm::MD5::stringifyResult(hashResult, hashStr);
+
+  SmallString<128> path(opts.PrecompiledHeaderOutputDir);
+  llvm::sys::path::append(path,
+                          llvm::Twine("bridging-header-") + hashStr + ".pch");
+  return path.str();
+}
+
 std::unique_ptr<ClangImporter>
 ClangImporter::create(ASTContext &ctx,
                       const ClangImporterOptions &importerOpts,
@@ -580,6 +627,19 @@ ClangImporter::create(ASTContext &ctx,
     new ClangImporter(ctx, importerOpts, tracker)
   };
 
+  // If we're keeping precompiled forms of the bridging header in a cache
+  // directory, see whether one is already present for this invocation.
+  std::string bridgingPCHCachePath;
+  bool haveCachedBridgingPCH = false;
+  if (importerOpts.Mode == ClangImporterOptions::Modes::Normal &&
+      importerOpts.BridgingHeaderPCH.empty() &&
+      !importerOpts.BridgingHeader.empty() &&
+      !importerOpts.PrecompiledHeaderOutputDir.empty()) {
+    bridgingPCHCachePath = getBridgingPCHCachePath(ctx, importerOpts);
+    haveCachedBridgingPCH = !bridgingPCHCachePath.empty() &&
+                            llvm::sys::fs::exists(bridgingPCHCachePath);
+  }
+
   std::vector<std::string> invocationArgStrs;
 
   // Clang expects this to be like an actual command line. So we need to pass in
@@ -596,6 +656,13 @@ ClangImporter::create(ASTContext &ctx,
   }
   addCommonInvocationArguments(invocationArgStrs, ctx, importerOpts);
 
+  // Consume the cached precompiled bridging header, exactly as if it had
+  // been passed in explicitly.
+  if (haveCachedBridgingPCH) {
+    invocationArgStrs.push_back("-include-pch");
+    invocationArgStrs.push_back(bridgingPCHCachePath);
+  }
+
   if (importerOpts.DumpClangDiagnostics) {
     llvm::errs() << "clang '";
     interleave(invocationArgStrs,
@@ -772,6 +839,14 @@ ClangImporter::create(ASTContext &ctx,
     new (ctx) ClangModuleUnit(*importedHeaderModule, *importer, nullptr);
   importedHeaderModule->addFile(*importer->Impl.ImportedHeaderUnit);
 
+  // Remember how the bridging header cache played out. On a hit, the header's
+  // AST is already loaded and importBridgingHeader only needs to register
+  // ownership; on a miss, fill the cache after a successful textual import.
+  if (haveCachedBridgingPCH)
+    importer->Impl.BridgingHeaderFromPCH = importerOpts.BridgingHeader;
+  else if (!bridgingPCHCachePath.empty())
+    importer->Impl.PendingBridgingPCHPath = bridgingPCHCachePath;
+
   return importer;
 }
 
@@ -1010,8 +1085,21 @@ bool ClangImporter::Implementation::importHeader(
   return false;
 }
 
+/// Computes a hash of the bridging header's contents, for detecting headers
+/// that have been touched without actually being changed.
+static uint64_t hashHeaderFileContents(StringRef contents) {
+  llvm::MD5 hash;
+  hash.update(contents);
+  llvm::MD5::MD5Result hashResult;
+  hash.final(hashResult);
+  uint64_t truncatedResult;
+  memcpy(&truncatedResult, hashResult, sizeof(truncatedResult));
+  return truncatedResult;
+}
+
 bool ClangImporter::importHeader(StringRef header, Module *adapter,
                                  off_t expectedSize, time_t expectedModTime,
+                                 uint64_t expectedContentHash,
                                  StringRef cachedContents, SourceLoc diagLoc) {
   clang::FileManager &fileManager = Impl.Instance->getFileManager();
   const clang::FileEntry *headerFile = fileManager.getFile(header,
@@ -1021,6 +1109,20 @@ bool ClangImporter::importHeader(StringRef header, Module *adapter,
     return importBridgingHeader(header, adapter, diagLoc);
   }
 
+  // A touched-but-unchanged header (common after switching checkouts) fails
+  // the mtime check above even though the module is still valid against it.
+  // Fall back to comparing content hashes before giving up on the on-disk
+  // header.
+  if (headerFile && headerFile->getSize() == expectedSize &&
+      expectedContentHash != 0) {
+    auto buffer = fileManager.getBufferForFile(headerFile);
+    if (buffer &&
+        hashHeaderFileContents(buffer.get()->getBuffer())
+          == expectedContentHash) {
+      return importBridgingHeader(header, adapter, diagLoc);
+    }
+  }
+
   if (!cachedContents.empty() && cachedContents.back() == '\0')
     cachedContents = cachedContents.drop_back();
   std::unique_ptr<llvm::MemoryBuffer> sourceBuffer{
@@ -1033,6 +1135,22 @@ bool ClangImporter::importHeader(StringRef header, Module *adapter,
 bool ClangImporter::importBridgingHeader(StringRef header, Module *adapter,
                                          SourceLoc diagLoc,
                                          bool trackParsedSymbols) {
+  if (llvm::sys::path::extension(header).endswith(".pch")) {
+    // The precompiled header was already loaded when the importer's compiler
+    // instance consumed it via -include-pch, and its embedded Swift name
+    // lookup table was picked up by the SwiftNameLookupExtension reader.
+    // All that remains is to record the adapter module as an owner.
+    Impl.ImportedHeaderOwners.push_back(adapter);
+    return false;
+  }
+
+  // Likewise if this header's AST came from the PCH cache at setup.
+  if (!Impl.BridgingHeaderFromPCH.empty() &&
+      header == Impl.BridgingHeaderFromPCH) {
+    Impl.ImportedHeaderOwners.push_back(adapter);
+    return false;
+  }
+
   clang::FileManager &fileManager = Impl.Instance->getFileManager();
   const clang::FileEntry *headerFile = fileManager.getFile(header,
                                                            /*open=*/true);
@@ -1051,13 +1169,26 @@ bool ClangImporter::importBridgingHeader(StringRef header, Module *adapter,
       importLine, Implementation::bridgingHeaderBufferName)
   };
 
-  return Impl.importHeader(adapter, header, diagLoc, trackParsedSymbols,
-                           std::move(sourceBuffer));
+  bool hadError = Impl.importHeader(adapter, header, diagLoc,
+                                    trackParsedSymbols,
+                                    std::move(sourceBuffer));
+
+  // If the PCH cache missed for this header, fill it now that the header has
+  // imported cleanly, so subsequent jobs consume the precompiled form.
+  if (!hadError && !Impl.PendingBridgingPCHPath.empty()) {
+    if (!llvm::sys::fs::create_directories(
+            llvm::sys::path::parent_path(Impl.PendingBridgingPCHPath)))
+      (void)emitBridgingPCH(header, Impl.PendingBridgingPCHPath);
+    Impl.PendingBridgingPCHPath.clear();
+  }
+
+  return hadError;
 }
 
 std::string ClangImporter::getBridgingHeaderContents(StringRef headerPath,
                                                      off_t &fileSize,
-                                                     time_t &fileModTime) {
+                                                     time_t &fileModTime,
+                                                     uint64_t &fileHash) {
   llvm::IntrusiveRefCntPtr<clang::CompilerInvocation> invocation{
     new clang::CompilerInvocation(*Impl.Invocation)
   };
@@ -1099,9 +1230,49 @@ std::string ClangImporter::getBridgingHeaderContents(StringRef headerPath,
   const clang::FileEntry *fileInfo = fileManager.getFile(headerPath);
   fileSize = fileInfo->getSize();
   fileModTime = fileInfo->getModificationTime();
+  fileHash = 0;
+  if (auto buffer = fileManager.getBufferForFile(fileInfo))
+    fileHash = hashHeaderFileContents(buffer.get()->getBuffer());
   return result;
 }
 
+bool ClangImporter::emitBridgingPCH(StringRef headerPath,
+                                    StringRef outputPCHPath) {
+  llvm::IntrusiveRefCntPtr<clang::CompilerInvocation> invocation{
+    new clang::CompilerInvocation(*Impl.Invocation)
+  };
+  invocation->getFrontendOpts().DisableFree = false;
+  invocation->getFrontendOpts().Inputs.clear();
+  invocation->getFrontendOpts().Inputs.push_back(
+      clang::FrontendInputFile(headerPath, clang::IK_ObjC));
+  invocation->getFrontendOpts().OutputFile = outputPCHPath;
+  invocation->getFrontendOpts().ProgramAction = clang::frontend::GeneratePCH;
+  invocation->getPreprocessorOpts().resetNonModularOptions();
+
+  clang::CompilerInstance emitInstance(
+    Impl.Instance->getPCHContainerOperations());
+  emitInstance.setInvocation(&*invocation);
+  emitInstance.createDiagnostics(&Impl.Instance->getDiagnosticClient(),
+                                 /*ShouldOwnClient=*/false);
+
+  clang::FileManager &fileManager = Impl.Instance->getFileManager();
+  emitInstance.setFileManager(&fileManager);
+  emitInstance.createSourceManager(fileManager);
+  emitInstance.setTarget(&Impl.Instance->getTarget());
+
+  // The invocation copy carries the SwiftNameLookupExtension, so the header's
+  // Swift name lookup table is serialized into the PCH alongside the AST.
+  clang::GeneratePCHAction action;
+  emitInstance.ExecuteAction(action);
+
+  if (emitInstance.getDiagnostics().hasErrorOccurred()) {
+    Impl.SwiftContext.Diags.diagnose({}, diag::bridging_header_pch_error,
+                                     outputPCHPath, headerPath);
+    return true;
+  }
+  return false;
+}
+
 void ClangImporter::collectSubModuleNames(
     ArrayRef<std::pair<Identifier, SourceLoc>> path,
     std::vector<std::string> &names) {
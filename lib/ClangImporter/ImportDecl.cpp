@@ -7220,13 +7220,19 @@ ClangImporter::Implementation::loadAllMembers(Decl *D, uint64_t extra) {
     // Get ready to actually load the members.
     ImportingEntityRAII Importing(*this);
 
-    // Load the members.
-    for (auto entry : table->lookupGlobalsAsMembers(effectiveClangContext)) {
-      auto decl = entry.get<clang::NamedDecl *>();
-
-      // Only continue members in the same submodule as this extension.
-      if (decl->getImportedOwningModule() != submodule) continue;
+    // Group this nominal's globals-as-members entries by owning submodule the
+    // first time any of its extensions loads members, so that the (per
+    // submodule) extensions don't each rescan the full list.
+    auto &index = GlobalsAsMembersIndex[{table, nominal}];
+    if (index.empty()) {
+      for (auto entry : table->lookupGlobalsAsMembers(effectiveClangContext)) {
+        auto decl = entry.get<clang::NamedDecl *>();
+        index[decl->getImportedOwningModule()].push_back(decl);
+      }
+    }
 
+    // Load the members.
+    for (auto decl : index.lookup(submodule)) {
       // Import the member.
       auto member = importDecl(decl, false);
       if (!member) continue;
@@ -34,8 +34,13 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/TypeVisitor.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 
+#define DEBUG_TYPE "Clang type importing"
+STATISTIC(NumTypeImportCacheHits, "# of type imports served from the cache");
+STATISTIC(NumTypeImportCacheMisses, "# of type imports computed");
+
 using namespace swift;
 using namespace importer;
 
@@ -1307,6 +1312,26 @@ Type ClangImporter::Implementation::importType(clang::QualType type,
   if (type.isNull())
     return Type();
 
+  // Type import is deterministic given the type and these options for a
+  // fixed set of loaded modules, and the same types are imported over and
+  // over, so consult the cache first. Loading a module can change how a type
+  // bridges (its overlay may not have been available before), so the cache
+  // is discarded whenever the set of loaded modules grows.
+  if (SwiftContext.LoadedModules.size() != ImportedTypesCacheGeneration) {
+    ImportedTypesCache.clear();
+    ImportedTypesCacheGeneration = SwiftContext.LoadedModules.size();
+  }
+  unsigned rawOptions = unsigned(importKind) | (unsigned(optionality) << 8) |
+                        (unsigned(allowNSUIntegerAsInt) << 10) |
+                        (unsigned(canFullyBridgeTypes) << 11);
+  auto cacheKey = std::make_pair(type.getAsOpaquePtr(), rawOptions);
+  auto known = ImportedTypesCache.find(cacheKey);
+  if (known != ImportedTypesCache.end()) {
+    ++NumTypeImportCacheHits;
+    return known->second;
+  }
+  ++NumTypeImportCacheMisses;
+
   // The "built-in" Objective-C types id, Class, and SEL can actually be (and
   // are) defined within the library. Clang tracks the redefinition types
   // separately, so it can provide fallbacks in certain cases. For Swift, we
@@ -1346,11 +1371,15 @@ Type ClangImporter::Implementation::importType(clang::QualType type,
   auto importResult = converter.Visit(type);
 
   // Now fix up the type based on we're concretely using it.
-  return adjustTypeForConcreteImport(*this, type, importResult.AbstractType,
-                                     importKind, importResult.Hint,
-                                     allowNSUIntegerAsInt,
-                                     canFullyBridgeTypes,
-                                     optionality);
+  auto importedType = adjustTypeForConcreteImport(
+      *this, type, importResult.AbstractType, importKind, importResult.Hint,
+      allowNSUIntegerAsInt, canFullyBridgeTypes, optionality);
+
+  // Cache successful imports only; a failure may be transient (e.g. a
+  // bridged form that needs a module we haven't loaded yet).
+  if (importedType)
+    ImportedTypesCache[cacheKey] = importedType;
+  return importedType;
 }
 
 bool ClangImporter::Implementation::isNSString(const clang::Type *type) {
@@ -283,6 +283,18 @@ private:
   /// (through the Swift name lookup module file extension).
   llvm::StringMap<std::unique_ptr<SwiftLookupTable>> LookupTables;
 
+  /// Globals-as-members entries for a nominal type, indexed by the submodule
+  /// that owns them.
+  ///
+  /// Each submodule extending a nominal type gets its own extension, and each
+  /// extension used to rescan the nominal's full globals-as-members list just
+  /// to pick out its own submodule's entries. Grouping the list once per
+  /// (lookup table, nominal) pair keeps member loading linear.
+  llvm::DenseMap<std::pair<SwiftLookupTable *, NominalTypeDecl *>,
+                 llvm::DenseMap<const clang::Module *,
+                                SmallVector<clang::NamedDecl *, 4>>>
+      GlobalsAsMembersIndex;
+
   /// \brief A count of the number of load module operations.
   /// FIXME: Horrible, horrible hack for \c loadModule().
   unsigned ImportCounter = 0;
@@ -321,6 +333,18 @@ public:
   /// is a Swift 2 name vs. a Swift 3 name.
   llvm::DenseMap<std::pair<const clang::Decl *, char>, Decl *> ImportedDecls;
 
+  /// \brief Mapping from already-imported Clang types to their Swift
+  /// equivalents, keyed by the type and the import options that affect the
+  /// result.
+  ///
+  /// Cleared whenever a new module is loaded, since bridged forms can depend
+  /// on which overlays are available.
+  llvm::DenseMap<std::pair<const void *, unsigned>, Type> ImportedTypesCache;
+
+  /// The number of loaded modules at which \c ImportedTypesCache was last
+  /// valid.
+  unsigned ImportedTypesCacheGeneration = 0;
+
   /// \brief The set of "special" typedef-name declarations, which are
   /// mapped to specific Swift types.
   ///
@@ -582,6 +606,14 @@ public:
   /// These are used to look up Swift classes forward-declared with \@class.
   TinyPtrVector<Module *> ImportedHeaderOwners;
 
+  /// The textual bridging header whose AST was loaded from a cached PCH when
+  /// the compiler instance was set up, if any.
+  std::string BridgingHeaderFromPCH;
+
+  /// Where to write a precompiled form of the bridging header after it has
+  /// been imported successfully, if the PCH cache missed.
+  std::string PendingBridgingPCHPath;
+
   /// \brief Clang's objectAtIndexedSubscript: selector.
   clang::Selector objectAtIndexedSubscript;
 
@@ -24,6 +24,7 @@
 #include "swift/Driver/Driver.h"
 #include "swift/Driver/Job.h"
 #include "swift/Driver/ParseableOutput.h"
+#include "swift/Option/Options.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/StringExtras.h"
@@ -31,11 +32,23 @@
 #include "llvm/Option/Arg.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/YAMLParser.h"
 
+#include <chrono>
+#include <functional>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace swift;
 using namespace swift::sys;
 using namespace swift::driver;
@@ -255,6 +268,158 @@ static bool writeFilelistIfNecessary(const Job *job, DiagnosticEngine &diags) {
   return true;
 }
 
+/// Computes a key identifying \p Cmd's invocation and the contents of every
+/// input file in \p InputFilesWithTypes, suitable for indexing into a
+/// compilation cache.
+///
+/// The whole module's inputs enter the key, not just \p Cmd's own primary:
+/// the frontend reads the other files too (cross-file name lookup, type
+/// layout), so editing a sibling file must invalidate the cached object of
+/// an unedited primary.
+///
+/// \returns true on success. Fails if any of the inputs can't be read.
+static bool computeJobCacheKey(const Job *Cmd,
+                               ArrayRef<InputPair> InputFilesWithTypes,
+                               SmallString<32> &result) {
+  llvm::MD5 hash;
+  hash.update(StringRef(Cmd->getExecutable()));
+  hash.update(StringRef("\0", 1));
+
+  // The executable can be replaced in place between invocations, so its path
+  // alone does not identify its behavior; mix in its size and modification
+  // time as well.
+  llvm::sys::fs::file_status executableStatus;
+  if (llvm::sys::fs::status(Cmd->getExecutable(), executableStatus))
+    return false;
+  auto executableMTime = executableStatus.getLastModificationTime();
+  uint64_t executableStamp[3] = {
+    static_cast<uint64_t>(executableMTime.seconds()),
+    static_cast<uint64_t>(executableMTime.nanoseconds()),
+    executableStatus.getSize()
+  };
+  hash.update(StringRef(reinterpret_cast<const char *>(executableStamp),
+                        sizeof(executableStamp)));
+  for (const char *arg : Cmd->getArguments()) {
+    hash.update(StringRef(arg));
+    hash.update(StringRef("\0", 1));
+  }
+
+  // Jobs that consume outputs of other jobs rather than original source
+  // files are not cacheable.
+  for (const Action *A : Cmd->getSource().getInputs()) {
+    if (!isa<InputAction>(A))
+      return false;
+  }
+
+  for (const InputPair &input : InputFilesWithTypes) {
+    auto buffer = llvm::MemoryBuffer::getFile(input.second->getValue());
+    if (!buffer)
+      return false;
+    hash.update(buffer.get()->getBuffer());
+    hash.update(StringRef("\0", 1));
+  }
+
+  llvm::MD5::MD5Result hashResult;
+  hash.final(hashResult);
+  llvm::MD5::stringifyResult(hashResult, result);
+  return true;
+}
+
+/// Write a manifest next to \p LinkCmd's output listing the object files
+/// whose producing jobs ran during this build. A relinking-aware linker can
+/// consult it to patch the existing image instead of performing a full
+/// relink. The manifest lives at the linked output's path with
+/// ".changed-objects" appended; the toolchain points the linker at the same
+/// path when -driver-incremental-link is in effect.
+static void
+writeChangedObjectsManifest(const Job *LinkCmd,
+                            const llvm::SmallPtrSetImpl<const Job *>
+                              &ExecutedCommands) {
+  SmallString<128> path(LinkCmd->getOutput().getPrimaryOutputFilename());
+  path += ".changed-objects";
+
+  std::error_code error;
+  llvm::raw_fd_ostream out(path, error, llvm::sys::fs::F_None);
+  if (error)
+    return;
+
+  for (const Job *Input : LinkCmd->getInputs()) {
+    if (!ExecutedCommands.count(Input))
+      continue;
+    const CommandOutput &Output = Input->getOutput();
+    if (Output.getPrimaryOutputType() != types::TY_Object)
+      continue;
+    for (const std::string &object : Output.getPrimaryOutputFilenames())
+      out << object << '\n';
+  }
+}
+
+/// Produce a coarse estimate of \p Cmd's peak memory usage, in bytes, for
+/// memory-budget-aware scheduling. Returns 0 (unknown) for jobs other than
+/// compiles.
+///
+/// The estimate is a fixed baseline plus a multiple of the job's input source
+/// size, which tracks the observation that type checking and SILGen memory
+/// scale with the amount of code in the primary file. It is deliberately
+/// conservative; recording actual per-job RSS in the compilation record and
+/// feeding it back on the next build would give sharper estimates.
+static uint64_t estimateMemoryUsage(const Job *Cmd) {
+  if (!isa<CompileJobAction>(Cmd->getSource()))
+    return 0;
+
+  uint64_t totalInputSize = 0;
+  for (const Action *A : Cmd->getSource().getInputs()) {
+    if (const InputAction *IA = dyn_cast<InputAction>(A)) {
+      uint64_t size;
+      if (!llvm::sys::fs::file_size(IA->getInputArg().getValue(), size))
+        totalInputSize += size;
+    }
+  }
+
+  const uint64_t baseline = 100ULL << 20;
+  return baseline + totalInputSize * 50;
+}
+
+/// Ask the OS to start reading \p path into the page cache.
+///
+/// The driver cannot start the link before its last input object exists, but
+/// it can overlap the linker's file-open and symbol-table reads with the
+/// remaining compiles by prefetching each object as soon as the job that
+/// produces it finishes. By the time the link job is scheduled, its inputs
+/// are warm.
+static void prewarmFileForLink(StringRef path) {
+#if defined(__linux__) || defined(__APPLE__)
+  int fd = ::open(path.str().c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+#if defined(__linux__)
+  (void)::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#else
+  struct stat statbuf;
+  if (::fstat(fd, &statbuf) == 0) {
+    struct radvisory advice = {0, static_cast<int>(statbuf.st_size)};
+    (void)::fcntl(fd, F_RDADVISE, &advice);
+  }
+#endif
+  ::close(fd);
+#endif
+}
+
+static bool copyFileContents(const llvm::Twine &from, const llvm::Twine &to) {
+  auto buffer = llvm::MemoryBuffer::getFile(from.str());
+  if (!buffer)
+    return false;
+
+  std::error_code error;
+  llvm::raw_fd_ostream out(to.str(), error, llvm::sys::fs::F_None);
+  if (out.has_error() || error) {
+    out.clear_error();
+    return false;
+  }
+  out << buffer.get()->getBuffer();
+  return !out.has_error();
+}
+
 int Compilation::performJobsImpl() {
   // Create a TaskQueue for execution.
   std::unique_ptr<TaskQueue> TQ;
@@ -262,6 +427,7 @@ int Compilation::performJobsImpl() {
     TQ.reset(new DummyTaskQueue(NumberOfParallelCommands));
   else
     TQ.reset(new TaskQueue(NumberOfParallelCommands));
+  TQ->setMemoryBudget(MemoryBudget);
 
   PerformJobsState State;
 
@@ -289,6 +455,53 @@ int Compilation::performJobsImpl() {
     });
   };
 
+  llvm::SmallDenseMap<const Job *, std::string, 16> CacheKeys;
+
+  // Jobs whose outputs were found in the compilation cache. They are marked
+  // finished by drainCacheHitCommands below, which may in turn unblock (and
+  // find cached results for) further jobs.
+  SmallVector<const Job *, 16> CacheHitCommands;
+
+  // Jobs whose outputs were actually (re)produced during this build, either
+  // by running or by being copied out of the compilation cache. Used to
+  // build the changed-objects manifest for -driver-incremental-link.
+  llvm::SmallPtrSet<const Job *, 16> ExecutedCommands;
+
+  // Returns the directory holding cached outputs for \p Cmd, or an empty
+  // string if the job is not cacheable.
+  auto getCachedOutputDir = [&] (const Job *Cmd) -> std::string {
+    if (CompilationCachePath.empty())
+      return std::string();
+
+    // Only cache compile jobs that produce a single primary output. Other
+    // job kinds (linking, merging modules) consume outputs of earlier jobs
+    // that aren't stable across invocations.
+    if (!isa<CompileJobAction>(Cmd->getSource()))
+      return std::string();
+    if (Cmd->getOutput().getPrimaryOutputFilenames().size() != 1)
+      return std::string();
+    // A hit only copies the primary output back. Jobs with additional
+    // outputs (a partial swiftmodule/swiftdoc under -emit-module, a
+    // swiftdeps file under -incremental) would be left with those outputs
+    // missing or stale, so they do not participate.
+    if (Cmd->getOutput().hasAdditionalOutputs())
+      return std::string();
+
+    auto iter = CacheKeys.find(Cmd);
+    if (iter == CacheKeys.end()) {
+      SmallString<32> key;
+      if (!computeJobCacheKey(Cmd, getInputFiles(), key))
+        key.clear();
+      iter = CacheKeys.insert({Cmd, key.str().str()}).first;
+    }
+    if (iter->second.empty())
+      return std::string();
+
+    SmallString<128> dir(CompilationCachePath);
+    llvm::sys::path::append(dir, iter->second);
+    return dir.str().str();
+  };
+
   // Set up scheduleCommandIfNecessaryAndPossible.
   // This will only schedule the given command if it has not been scheduled
   // and if all of its inputs are in FinishedCommands.
@@ -302,6 +515,27 @@ int Compilation::performJobsImpl() {
       return;
     }
 
+    // If an identical invocation has already produced this job's output, use
+    // the cached copy instead of spawning the job.
+    std::string CacheDir = getCachedOutputDir(Cmd);
+    if (!CacheDir.empty()) {
+      SmallString<128> CachedOutput(StringRef(CacheDir));
+      llvm::sys::path::append(CachedOutput, "output");
+      if (copyFileContents(CachedOutput,
+                           Cmd->getOutput().getPrimaryOutputFilename())) {
+        State.ScheduledCommands.insert(Cmd);
+        ExecutedCommands.insert(Cmd);
+        CacheHitCommands.push_back(Cmd);
+        return;
+      }
+    }
+
+    // A link job is only dispatched once all of its inputs have finished, so
+    // this is the point at which the set of rebuilt objects is known.
+    if (isa<LinkJobAction>(Cmd->getSource()) &&
+        getArgs().hasArg(options::OPT_driver_incremental_link))
+      writeChangedObjectsManifest(Cmd, ExecutedCommands);
+
     // FIXME: Failing here should not take down the whole process.
     bool success = writeFilelistIfNecessary(Cmd, Diags);
     assert(success && "failed to write filelist");
@@ -311,7 +545,21 @@ int Compilation::performJobsImpl() {
            "not implemented for compilations with multiple jobs");
     State.ScheduledCommands.insert(Cmd);
     TQ->addTask(Cmd->getExecutable(), Cmd->getArguments(), llvm::None,
-                (void *)Cmd);
+                (void *)Cmd,
+                MemoryBudget != 0 ? estimateMemoryUsage(Cmd) : 0);
+  };
+
+  // Sort jobs that were discovered to be out of date so that the ones with
+  // the most direct dependents are scheduled first. When jobs are discovered
+  // mid-build, this keeps the TaskQueue topped up with work that unlocks the
+  // most downstream jobs, rather than letting the critical path drain the
+  // queue near the end of the build.
+  auto prioritizeByFanOut = [&] (SmallVectorImpl<const Job *> &Commands) {
+    std::stable_sort(Commands.begin(), Commands.end(),
+                     [&DepGraph](const Job *lhs, const Job *rhs) {
+      return DepGraph.countDirectDependents(lhs) >
+             DepGraph.countDirectDependents(rhs);
+    });
   };
 
   // When a task finishes, we need to reevaluate the other commands that
@@ -328,6 +576,19 @@ int Compilation::performJobsImpl() {
     }
   };
 
+  // Marks all pending cache hits as finished. Doing so may unblock jobs,
+  // which may themselves hit the cache and grow the list, so iterate by
+  // index until the list stops growing.
+  auto drainCacheHitCommands = [&] {
+    for (size_t i = 0; i != CacheHitCommands.size(); ++i) {
+      const Job *Cmd = CacheHitCommands[i];
+      if (Level == OutputLevel::Parseable)
+        parseable_output::emitSkippedMessage(llvm::errs(), *Cmd);
+      markFinished(Cmd);
+    }
+    CacheHitCommands.clear();
+  };
+
   // Schedule all jobs we can.
   for (const Job *Cmd : getJobs()) {
     if (!getIncrementalBuildEnabled()) {
@@ -415,6 +676,8 @@ int Compilation::performJobsImpl() {
       noteBuilding(externalCmd, "because of external dependencies");
     }
 
+    prioritizeByFanOut(AdditionalOutOfDateCommands);
+
     for (auto *AdditionalCmd : AdditionalOutOfDateCommands) {
       if (!DeferredCommands.count(AdditionalCmd))
         continue;
@@ -428,6 +691,21 @@ int Compilation::performJobsImpl() {
   llvm::SmallDenseMap<const Job *, std::unique_ptr<llvm::Timer>, 16>
     DriverTimers;
 
+  // Wall-time bookkeeping for the critical-path report printed with
+  // -driver-time-compilation.
+  llvm::SmallDenseMap<const Job *, std::chrono::steady_clock::time_point, 16>
+    JobStartTimes;
+  llvm::SmallDenseMap<const Job *, double, 16> JobDurations;
+
+  // Jobs whose outputs are consumed by a link job. Their outputs are
+  // prefetched as they are produced so the linker's reads overlap with the
+  // remaining compiles instead of extending the critical path.
+  llvm::SmallPtrSet<const Job *, 16> JobsFeedingLinker;
+  for (const Job *Cmd : getJobs())
+    if (isa<LinkJobAction>(Cmd->getSource()))
+      for (const Job *Input : Cmd->getInputs())
+        JobsFeedingLinker.insert(Input);
+
   // Set up a callback which will be called immediately after a task has
   // started. This callback may be used to provide output indicating that the
   // task began.
@@ -436,6 +714,8 @@ int Compilation::performJobsImpl() {
     const Job *BeganCmd = (const Job *)Context;
 
     if (ShowDriverTimeCompilation) {
+      JobStartTimes[BeganCmd] = std::chrono::steady_clock::now();
+
       llvm::SmallString<128> TimerName;
       llvm::raw_svector_ostream OS(TimerName);
 
@@ -479,6 +759,9 @@ int Compilation::performJobsImpl() {
 
     if (ShowDriverTimeCompilation) {
       DriverTimers[FinishedCmd]->stopTimer();
+      JobDurations[FinishedCmd] = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - JobStartTimes[FinishedCmd])
+        .count();
     }
 
     if (Level == OutputLevel::Parseable) {
@@ -591,16 +874,42 @@ int Compilation::performJobsImpl() {
           TaskFinishedResponse::StopExecution;
     }
 
+    // Store the output of the successful job in the compilation cache, so
+    // that future invocations with identical inputs can skip it entirely.
+    std::string CacheDir = getCachedOutputDir(FinishedCmd);
+    if (!CacheDir.empty() && !llvm::sys::fs::exists(CacheDir)) {
+      if (!llvm::sys::fs::create_directories(CacheDir)) {
+        SmallString<128> CachedOutput(StringRef(CacheDir));
+        llvm::sys::path::append(CachedOutput, "output");
+        // Failing to populate the cache is not an error; the output has
+        // already been produced in its normal location.
+        (void)copyFileContents(
+            FinishedCmd->getOutput().getPrimaryOutputFilename(), CachedOutput);
+      }
+    }
+
+    ExecutedCommands.insert(FinishedCmd);
+
+    // If this job's output feeds the linker, start pulling it into the page
+    // cache now, while other compiles are still running.
+    if (JobsFeedingLinker.count(FinishedCmd))
+      for (const std::string &Output :
+             FinishedCmd->getOutput().getPrimaryOutputFilenames())
+        prewarmFileForLink(Output);
+
     // When a task finishes, we need to reevaluate the other commands that
     // might have been blocked.
     markFinished(FinishedCmd);
 
+    prioritizeByFanOut(Dependents);
     for (const Job *Cmd : Dependents) {
       DeferredCommands.erase(Cmd);
       noteBuilding(Cmd, "because of dependencies discovered later");
       scheduleCommandIfNecessaryAndPossible(Cmd);
     }
 
+    drainCacheHitCommands();
+
     return TaskFinishedResponse::ContinueExecution;
   };
 
@@ -610,6 +919,9 @@ int Compilation::performJobsImpl() {
 
     if (ShowDriverTimeCompilation) {
       DriverTimers[SignalledCmd]->stopTimer();
+      JobDurations[SignalledCmd] = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - JobStartTimes[SignalledCmd])
+        .count();
     }
 
     if (Level == OutputLevel::Parseable) {
@@ -637,6 +949,10 @@ int Compilation::performJobsImpl() {
   };
 
   do {
+    // Finish any jobs that were satisfied from the compilation cache. This
+    // may schedule additional tasks.
+    drainCacheHitCommands();
+
     // Ask the TaskQueue to execute.
     TQ->execute(taskBegan, taskFinished, taskSignalled);
 
@@ -653,7 +969,85 @@ int Compilation::performJobsImpl() {
     }
 
     // ...which may allow us to go on and do later tasks.
-  } while (Result == 0 && TQ->hasRemainingTasks());
+  } while (Result == 0 &&
+           (TQ->hasRemainingTasks() || !CacheHitCommands.empty()));
+
+  if (ShowDriverTimeCompilation && !JobDurations.empty()) {
+    // Report the critical path: the most expensive chain of jobs linked by
+    // their input edges. This bounds how much adding parallelism can help;
+    // if the critical path dominates the total work, the build is limited by
+    // job granularity rather than by the number of concurrent tasks.
+    llvm::SmallDenseMap<const Job *, double, 16> PathCosts;
+    std::function<double(const Job *)> getPathCost =
+        [&](const Job *Cmd) -> double {
+      auto Known = PathCosts.find(Cmd);
+      if (Known != PathCosts.end())
+        return Known->second;
+
+      double Cost = 0;
+      auto Duration = JobDurations.find(Cmd);
+      if (Duration != JobDurations.end())
+        Cost = Duration->second;
+      double MaxInputCost = 0;
+      for (const Job *Input : Cmd->getInputs())
+        MaxInputCost = std::max(MaxInputCost, getPathCost(Input));
+      Cost += MaxInputCost;
+      PathCosts[Cmd] = Cost;
+      return Cost;
+    };
+
+    double TotalTime = 0;
+    for (auto &entry : JobDurations)
+      TotalTime += entry.second;
+
+    const Job *CriticalJob = nullptr;
+    double CriticalPathTime = 0;
+    for (const Job *Cmd : getJobs()) {
+      double Cost = getPathCost(Cmd);
+      if (Cost > CriticalPathTime) {
+        CriticalPathTime = Cost;
+        CriticalJob = Cmd;
+      }
+    }
+
+    auto describeJob = [](const Job *Cmd, llvm::raw_ostream &os) {
+      os << Cmd->getSource().getClassName();
+      for (const Action *A : Cmd->getSource().getInputs()) {
+        if (const InputAction *IA = dyn_cast<InputAction>(A))
+          os << " " << IA->getInputArg().getValue();
+      }
+    };
+
+    llvm::errs() << "===-------------------------------------------------"
+                    "----------------------===\n"
+                 << "                            Driver Critical Path\n"
+                 << "===-------------------------------------------------"
+                    "----------------------===\n";
+    llvm::errs() << llvm::format("  Total job time: %.4f seconds\n", TotalTime);
+    llvm::errs() << llvm::format("  Critical path: %.4f seconds\n",
+                                 CriticalPathTime);
+    for (const Job *Cmd = CriticalJob; Cmd; /*advance below*/) {
+      double Duration = 0;
+      auto Known = JobDurations.find(Cmd);
+      if (Known != JobDurations.end())
+        Duration = Known->second;
+      llvm::errs() << llvm::format("    %.4f  ", Duration);
+      describeJob(Cmd, llvm::errs());
+      llvm::errs() << "\n";
+
+      // Step to the most expensive input chain.
+      const Job *Next = nullptr;
+      double NextCost = 0;
+      for (const Job *Input : Cmd->getInputs()) {
+        double Cost = getPathCost(Input);
+        if (!Next || Cost > NextCost) {
+          Next = Input;
+          NextCost = Cost;
+        }
+      }
+      Cmd = Next;
+    }
+  }
 
   if (Result == 0) {
     assert(State.BlockingCommands.empty() &&
@@ -712,6 +1106,17 @@ int Compilation::performSingleCommand(const Job *Cmd) {
   if (Level == OutputLevel::Verbose)
     Cmd->printCommandLine(llvm::errs());
 
+  // If the tool that owns this driver can run frontend jobs in-process, do
+  // so; this avoids the cost of exec'ing and re-initializing a new process.
+  if (RunFrontendInProcess &&
+      getArgs().hasArg(options::OPT_driver_run_jobs_in_process) &&
+      Cmd->getExtraEnvironment().empty() &&
+      !Cmd->getArguments().empty() &&
+      StringRef(Cmd->getArguments().front()) == "-frontend") {
+    ArrayRef<const char *> FrontendArgs = Cmd->getArguments();
+    return RunFrontendInProcess(FrontendArgs.slice(1));
+  }
+
   SmallVector<const char *, 128> Argv;
   Argv.push_back(Cmd->getExecutable());
   Argv.append(Cmd->getArguments().begin(), Cmd->getArguments().end());
@@ -306,6 +306,28 @@ void DependencyGraphImpl::markExternal(SmallVectorImpl<const void *> &visited,
   }
 }
 
+unsigned DependencyGraphImpl::countDirectDependents(const void *node) const {
+  auto allProvided = Provides.find(node);
+  if (allProvided == Provides.end())
+    return 0;
+
+  SmallPtrSet<const void *, 16> dependents;
+  for (const auto &provided : allProvided->second) {
+    auto allDependents = Dependencies.find(provided.name);
+    if (allDependents == Dependencies.end())
+      continue;
+
+    for (const auto &dependent : allDependents->second.first) {
+      if (dependent.node == node)
+        continue;
+      if (!(provided.kindMask & dependent.kindMask))
+        continue;
+      dependents.insert(dependent.node);
+    }
+  }
+  return dependents.size();
+}
+
 void
 DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
                                     const void *node, MarkTracerImpl *tracer) {
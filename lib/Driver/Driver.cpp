@@ -521,6 +521,21 @@ std::unique_ptr<Compilation> Driver::buildCompilation(
   if (ShowIncrementalBuildDecisions)
     C->setShowsIncrementalBuildDecisions();
 
+  if (const Arg *A =
+          C->getArgs().getLastArg(options::OPT_driver_compilation_cache_path))
+    C->setCompilationCachePath(A->getValue());
+
+  if (const Arg *A =
+          C->getArgs().getLastArg(options::OPT_driver_memory_budget)) {
+    uint64_t BudgetMB = 0;
+    if (StringRef(A->getValue()).getAsInteger(10, BudgetMB)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(C->getArgs()), A->getValue());
+    } else {
+      C->setMemoryBudget(BudgetMB << 20);
+    }
+  }
+
   // This has to happen after building jobs, because otherwise we won't even
   // emit .swiftdeps files for the next build.
   if (rebuildEverything)
@@ -123,6 +123,9 @@ static void addCommonFrontendArgs(const ToolChain &TC,
   inputArgs.AddLastArg(arguments, options::OPT_import_underlying_module);
   inputArgs.AddLastArg(arguments, options::OPT_module_cache_path);
   inputArgs.AddLastArg(arguments, options::OPT_module_link_name);
+  inputArgs.AddLastArg(arguments, options::OPT_pch_output_dir);
+  inputArgs.AddLastArg(arguments, options::OPT_validate_clang_modules_once);
+  inputArgs.AddLastArg(arguments, options::OPT_clang_build_session_file);
   inputArgs.AddLastArg(arguments, options::OPT_nostdimport);
   inputArgs.AddLastArg(arguments, options::OPT_parse_stdlib);
   inputArgs.AddLastArg(arguments, options::OPT_resource_dir);
@@ -1053,6 +1056,16 @@ toolchains::Darwin::constructInvocation(const LinkJobAction &job,
   context.Args.AddAllArgs(Arguments, options::OPT_linker_option_Group);
   context.Args.AddAllArgs(Arguments, options::OPT_F);
 
+  if (context.Args.hasArg(options::OPT_driver_incremental_link)) {
+    // The driver writes a manifest of the objects it rebuilt next to the
+    // linked image; point a relinking-aware linker at it.
+    llvm::SmallString<128> manifestPath(
+        context.Output.getPrimaryOutputFilename());
+    manifestPath += ".changed-objects";
+    Arguments.push_back("-incremental_manifest");
+    Arguments.push_back(context.Args.MakeArgString(manifestPath));
+  }
+
   if (context.Args.hasArg(options::OPT_enable_app_extension)) {
     // Keep this string fixed in case the option used by the
     // compiler itself changes.
@@ -1345,6 +1358,17 @@ toolchains::GenericUnix::constructInvocation(const LinkJobAction &job,
   context.Args.AddAllArgs(Arguments, options::OPT_linker_option_Group);
   context.Args.AddAllArgs(Arguments, options::OPT_F);
 
+  if (context.Args.hasArg(options::OPT_driver_incremental_link)) {
+    // The driver writes a manifest of the objects it rebuilt next to the
+    // linked image; point a relinking-aware linker at it.
+    llvm::SmallString<128> manifestPath(
+        context.Output.getPrimaryOutputFilename());
+    manifestPath += ".changed-objects";
+    Arguments.push_back("-Xlinker");
+    Arguments.push_back(context.Args.MakeArgString(
+        "--incremental-manifest=" + manifestPath));
+  }
+
   if (!context.OI.SDKPath.empty()) {
     Arguments.push_back("--sysroot");
     Arguments.push_back(context.Args.MakeArgString(context.OI.SDKPath));
@@ -167,6 +167,8 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
   Opts.EmitSortedSIL |= Args.hasArg(OPT_emit_sorted_sil);
 
   Opts.DelayedFunctionBodyParsing |= Args.hasArg(OPT_delayed_function_body_parsing);
+  Opts.LazyNonPrimaryFunctionBodies |=
+      Args.hasArg(OPT_enable_lazy_nonprimary_bodies);
   Opts.EnableTesting |= Args.hasArg(OPT_enable_testing);
   Opts.EnableResilience |= Args.hasArg(OPT_enable_resilience);
 
@@ -174,6 +176,10 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
   Opts.PrintClangStats |= Args.hasArg(OPT_print_clang_stats);
   Opts.DebugTimeFunctionBodies |= Args.hasArg(OPT_debug_time_function_bodies);
   Opts.DebugTimeCompilation |= Args.hasArg(OPT_debug_time_compilation);
+  if (const Arg *A = Args.getLastArg(OPT_trace_time_compilation))
+    Opts.TraceTimeCompilationPath = A->getValue();
+  if (const Arg *A = Args.getLastArg(OPT_stats_output_dir))
+    Opts.StatsOutputDir = A->getValue();
 
   if (const Arg *A = Args.getLastArg(OPT_warn_long_function_bodies)) {
     unsigned attempt;
@@ -206,8 +212,10 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     unsigned primaryFileIndex = 0;
     if (readFileList(Diags, Opts.InputFilenames, A,
                      primaryFileArg, &primaryFileIndex)) {
-      if (primaryFileArg)
+      if (primaryFileArg) {
         Opts.PrimaryInput = SelectedInput(primaryFileIndex);
+        Opts.PrimaryInputs.push_back(SelectedInput(primaryFileIndex));
+      }
       assert(!Args.hasArg(OPT_INPUT) && "mixing -filelist with inputs");
     }
   } else {
@@ -217,7 +225,12 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
       if (A->getOption().matches(OPT_INPUT)) {
         Opts.InputFilenames.push_back(A->getValue());
       } else if (A->getOption().matches(OPT_primary_file)) {
-        Opts.PrimaryInput = SelectedInput(Opts.InputFilenames.size());
+        // In batch mode several primary files may be given; the first one is
+        // also recorded as "the" primary input for clients that only support
+        // a single primary.
+        if (!Opts.PrimaryInput.hasValue())
+          Opts.PrimaryInput = SelectedInput(Opts.InputFilenames.size());
+        Opts.PrimaryInputs.push_back(SelectedInput(Opts.InputFilenames.size()));
         Opts.InputFilenames.push_back(A->getValue());
       } else {
         llvm_unreachable("Unknown input-related argument!");
@@ -283,6 +296,22 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     return true;
   }
 
+  if (Opts.PrimaryInputs.size() > 1) {
+    // Batch mode compiles all of the primary files in one invocation,
+    // emitting one output per primary. Only the code-emission actions
+    // support it; everything else expects a single primary.
+    switch (Opts.RequestedAction) {
+    case FrontendOptions::EmitObject:
+    case FrontendOptions::EmitAssembly:
+    case FrontendOptions::EmitIR:
+    case FrontendOptions::EmitBC:
+      break;
+    default:
+      Diags.diagnose(SourceLoc(), diag::error_unsupported_batch_mode_action);
+      return true;
+    }
+  }
+
   bool TreatAsSIL = Args.hasArg(OPT_parse_sil);
   if (!TreatAsSIL && Opts.InputFilenames.size() == 1) {
     // If we have exactly one input filename, and its extension is "sil",
@@ -590,6 +619,7 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
                           OPT_emit_objc_header,
                           OPT_emit_objc_header_path,
                           "h", false);
+  Opts.SplitObjCHeader |= Args.hasArg(OPT_emit_objc_header_split);
 
   if (const Arg *A = Args.getLastArg(OPT_emit_fixits_path)) {
     Opts.FixitsOutputPath = A->getValue();
@@ -810,7 +840,18 @@ static bool ParseLangArgs(LangOptions &Opts, ArgList &Args,
     
     Opts.SolverMemoryThreshold = threshold;
   }
-  
+
+  if (const Arg *A = Args.getLastArg(OPT_solver_scope_threshold)) {
+    unsigned threshold;
+    if (StringRef(A->getValue()).getAsInteger(10, threshold)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+
+    Opts.SolverScopeThreshold = threshold;
+  }
+
   for (const Arg *A : make_range(Args.filtered_begin(OPT_D),
                                  Args.filtered_end())) {
     Opts.addCustomConditionalCompilationFlag(A->getValue());
@@ -880,6 +921,30 @@ static bool ParseClangImporterArgs(ClangImporterOptions &Opts,
     });
   }
 
+  // A precompiled bridging header is consumed directly by the importer's
+  // compiler instance; the textual import path in FrontendOptions then only
+  // establishes module ownership (see ClangImporter::importBridgingHeader).
+  if (const Arg *A = Args.getLastArg(OPT_import_objc_header)) {
+    StringRef importPath = A->getValue();
+    if (importPath.endswith(".pch"))
+      Opts.BridgingHeaderPCH = importPath;
+    else
+      Opts.BridgingHeader = importPath;
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_pch_output_dir))
+    Opts.PrecompiledHeaderOutputDir = A->getValue();
+
+  Opts.ValidateModulesOnce |= Args.hasArg(OPT_validate_clang_modules_once);
+  if (const Arg *A = Args.getLastArg(OPT_clang_build_session_file))
+    Opts.BuildSessionFilePath = A->getValue();
+  if (Opts.ValidateModulesOnce && Opts.BuildSessionFilePath.empty()) {
+    Diags.diagnose(SourceLoc(), diag::error_option_missing_required_argument,
+                   "-validate-clang-modules-once",
+                   "-clang-build-session-file");
+    return true;
+  }
+
   Opts.InferImportAsMember |= Args.hasArg(OPT_enable_infer_import_as_member);
   Opts.HonorSwiftNewtypeAttr |= Args.hasArg(OPT_enable_swift_newtype);
   Opts.DumpClangDiagnostics |= Args.hasArg(OPT_dump_clang_diagnostics);
@@ -953,6 +1018,7 @@ static bool ParseDiagnosticArgs(DiagnosticOptions &Opts, ArgList &Args,
     Args.hasArg(OPT_show_diagnostics_after_fatal);
   Opts.UseColor |= Args.hasArg(OPT_color_diagnostics);
   Opts.FixitCodeForAllDiagnostics |= Args.hasArg(OPT_fixit_all);
+  Opts.ApplyFixitsInPlace |= Args.hasArg(OPT_fixit_apply);
   Opts.SuppressWarnings |= Args.hasArg(OPT_suppress_warnings);
   Opts.WarningsAsErrors |= Args.hasArg(OPT_warnings_as_errors);
 
@@ -1282,6 +1348,10 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
     Opts.EnableReflectionNames = false;
   }
 
+  if (Args.hasArg(OPT_print_reflection_metadata_sizes)) {
+    Opts.EnableReflectionSizeReport = true;
+  }
+
   for (const auto &Lib : Args.getAllArgValues(options::OPT_autolink_library))
     Opts.LinkLibraries.push_back(LinkLibrary(Lib, LibraryKind::Library));
 
@@ -32,9 +32,48 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include <atomic>
+#include <thread>
 
 using namespace swift;
 
+using InputFileOrError = llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>;
+
+/// Read the given input files from disk concurrently.
+///
+/// Opening inputs one at a time leaves the frontend idle on I/O at startup;
+/// for whole-module builds with many inputs the reads are independent, so
+/// issue them from a pool of threads.  Only the reads run concurrently -- the
+/// caller registers the resulting buffers with the SourceManager (and emits
+/// any diagnostics) serially, in command-line order, keeping buffer IDs and
+/// diagnostic output deterministic.
+static void preloadInputFiles(ArrayRef<std::string> Filenames,
+                              std::vector<Optional<InputFileOrError>> &Buffers) {
+  Buffers.resize(Filenames.size());
+  unsigned NumThreads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                         Filenames.size());
+  if (NumThreads < 2)
+    return;
+
+  std::atomic<size_t> NextIdx(0);
+  auto Worker = [&] {
+    while (true) {
+      size_t Idx = NextIdx.fetch_add(1);
+      if (Idx >= Filenames.size())
+        return;
+      // Leave reading from stdin to the serial path.
+      if (Filenames[Idx] != "-")
+        Buffers[Idx] = llvm::MemoryBuffer::getFile(Filenames[Idx]);
+    }
+  };
+  std::vector<std::thread> Threads;
+  for (unsigned i = 1; i != NumThreads; ++i)
+    Threads.push_back(std::thread(Worker));
+  Worker();
+  for (std::thread &T : Threads)
+    T.join();
+}
+
 void CompilerInstance::createSILModule(bool WholeModule) {
   assert(MainModule && "main module not created yet");
   TheSILModule = SILModule::createEmptyModule(getMainModule(),
@@ -45,11 +84,12 @@ void CompilerInstance::createSILModule(bool WholeModule) {
 void CompilerInstance::setPrimarySourceFile(SourceFile *SF) {
   assert(SF);
   assert(MainModule && "main module not created yet");
-  assert(!PrimarySourceFile && "already has a primary source file");
-  assert(PrimaryBufferID == NO_SUCH_BUFFER || !SF->getBufferID().hasValue() ||
-         SF->getBufferID().getValue() == PrimaryBufferID);
-  PrimarySourceFile = SF;
-  PrimarySourceFile->setReferencedNameTracker(NameTracker);
+  assert(PrimaryBufferIDs.empty() || !SF->getBufferID().hasValue() ||
+         isPrimaryBufferID(SF->getBufferID().getValue()));
+  if (!PrimarySourceFile)
+    PrimarySourceFile = SF;
+  PrimarySourceFiles.push_back(SF);
+  SF->setReferencedNameTracker(NameTracker);
 }
 
 bool CompilerInstance::setup(const CompilerInvocation &Invok) {
@@ -130,8 +170,15 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
   if (SILMode)
     Invocation.getLangOptions().EnableAccessControl = false;
 
-  const Optional<SelectedInput> &PrimaryInput =
-    Invocation.getFrontendOptions().PrimaryInput;
+  const FrontendOptions &FrontendOpts = Invocation.getFrontendOptions();
+  auto isPrimaryInput = [&FrontendOpts](unsigned i,
+                                        SelectedInput::InputKind kind) {
+    return std::any_of(FrontendOpts.PrimaryInputs.begin(),
+                       FrontendOpts.PrimaryInputs.end(),
+                       [&](const SelectedInput &input) {
+      return input.Kind == kind && input.Index == i;
+    });
+  };
 
   // Add the memory buffers first, these will be associated with a filename
   // and they can replace the contents of an input filename.
@@ -150,11 +197,16 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
       if (SILMode)
         MainBufferID = BufferID;
 
-      if (PrimaryInput && PrimaryInput->isBuffer() && PrimaryInput->Index == i)
-        PrimaryBufferID = BufferID;
+      if (isPrimaryInput(i, SelectedInput::InputKind::Buffer))
+        recordPrimaryBufferID(BufferID);
     }
   }
 
+  // Issue all the input file reads up front, in parallel.  The loop below
+  // consumes the preloaded buffers in command-line order.
+  std::vector<Optional<InputFileOrError>> PreloadedBuffers;
+  preloadInputFiles(Invocation.getInputFilenames(), PreloadedBuffers);
+
   for (unsigned i = 0, e = Invocation.getInputFilenames().size(); i != e; ++i) {
     auto &File = Invocation.getInputFilenames()[i];
 
@@ -166,16 +218,17 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
       if (SILMode || (MainMode && filename(File) == "main.swift"))
         MainBufferID = ExistingBufferID.getValue();
 
-      if (PrimaryInput && PrimaryInput->isFilename() &&
-          PrimaryInput->Index == i)
-        PrimaryBufferID = ExistingBufferID.getValue();
+      if (isPrimaryInput(i, SelectedInput::InputKind::Filename))
+        recordPrimaryBufferID(ExistingBufferID.getValue());
 
       continue; // replaced by a memory buffer.
     }
 
-    // Open the input file.
-    using FileOrError = llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>;
-    FileOrError InputFileOrErr = llvm::MemoryBuffer::getFileOrSTDIN(File);
+    // Open the input file, preferring the buffer preloaded above.
+    using FileOrError = InputFileOrError;
+    FileOrError InputFileOrErr =
+        PreloadedBuffers[i] ? std::move(*PreloadedBuffers[i])
+                            : llvm::MemoryBuffer::getFileOrSTDIN(File);
     if (!InputFileOrErr) {
       Diagnostics.diagnose(SourceLoc(), diag::error_open_input_file,
                            File, InputFileOrErr.getError().message());
@@ -209,13 +262,15 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
     if (SILMode || (MainMode && filename(File) == "main.swift"))
       MainBufferID = BufferID;
 
-    if (PrimaryInput && PrimaryInput->isFilename() && PrimaryInput->Index == i)
-      PrimaryBufferID = BufferID;
+    if (isPrimaryInput(i, SelectedInput::InputKind::Filename))
+      recordPrimaryBufferID(BufferID);
   }
 
   // Set the primary file to the code-completion point if one exists.
-  if (CodeCompletionBufferID.hasValue())
-    PrimaryBufferID = *CodeCompletionBufferID;
+  if (CodeCompletionBufferID.hasValue()) {
+    PrimaryBufferIDs.clear();
+    recordPrimaryBufferID(*CodeCompletionBufferID);
+  }
 
   if (MainMode && MainBufferID == NO_SUCH_BUFFER && BufferIDs.size() == 1)
     MainBufferID = BufferIDs.front();
@@ -383,6 +438,22 @@ void CompilerInstance::performSema() {
     DelayedCB.reset(new AlwaysDelayedCallbacks);
   }
 
+  // When lazy non-primary bodies are enabled, function bodies in files we
+  // are not going to type check or lower are skipped over and their source
+  // ranges recorded, to be re-parsed only if something demands them.
+  std::unique_ptr<DelayedParsingCallbacks> NonPrimaryDelayedCB;
+  if (Invocation.getFrontendOptions().LazyNonPrimaryFunctionBodies &&
+      !Invocation.isCodeCompletion() && !PrimaryBufferIDs.empty())
+    NonPrimaryDelayedCB.reset(new AlwaysDelayedCallbacks);
+
+  // Returns the delayed-parsing callbacks to use for the given file.
+  auto delayedCBForFile =
+      [&](bool isPrimary) -> DelayedParsingCallbacks * {
+    if (!isPrimary && NonPrimaryDelayedCB)
+      return NonPrimaryDelayedCB.get();
+    return DelayedCB.get();
+  };
+
   PersistentParserState PersistentState;
 
   // Make sure the main file is the first file in the module. This may only be
@@ -401,7 +472,7 @@ void CompilerInstance::performSema() {
     MainModule->addFile(*MainFile);
     addAdditionalInitialImports(MainFile);
 
-    if (MainBufferID == PrimaryBufferID)
+    if (isPrimaryBufferID(MainBufferID))
       setPrimarySourceFile(MainFile);
   }
 
@@ -427,13 +498,12 @@ void CompilerInstance::performSema() {
     MainModule->addFile(*NextInput);
     addAdditionalInitialImports(NextInput);
 
-    if (BufferID == PrimaryBufferID)
+    if (isPrimaryBufferID(BufferID))
       setPrimarySourceFile(NextInput);
 
     auto &Diags = NextInput->getASTContext().Diags;
     auto DidSuppressWarnings = Diags.getSuppressWarnings();
-    auto IsPrimary
-      = PrimaryBufferID == NO_SUCH_BUFFER || BufferID == PrimaryBufferID;
+    auto IsPrimary = PrimaryBufferIDs.empty() || isPrimaryBufferID(BufferID);
     Diags.setSuppressWarnings(DidSuppressWarnings || !IsPrimary);
 
     bool Done;
@@ -441,7 +511,7 @@ void CompilerInstance::performSema() {
       // Parser may stop at some erroneous constructions like #else, #endif
       // or '}' in some cases, continue parsing until we are done
       parseIntoSourceFile(*NextInput, BufferID, &Done, nullptr,
-                          &PersistentState, DelayedCB.get());
+                          &PersistentState, delayedCBForFile(IsPrimary));
     } while (!Done);
 
     Diags.setSuppressWarnings(DidSuppressWarnings);
@@ -462,7 +532,7 @@ void CompilerInstance::performSema() {
 
   // Compute the options we want to use for type checking.
   OptionSet<TypeCheckingFlags> TypeCheckOptions;
-  if (PrimaryBufferID == NO_SUCH_BUFFER) {
+  if (PrimaryBufferIDs.empty()) {
     TypeCheckOptions |= TypeCheckingFlags::DelayWholeModuleChecking;
   }
   if (options.DebugTimeFunctionBodies) {
@@ -475,7 +545,7 @@ void CompilerInstance::performSema() {
   // Parse the main file last.
   if (MainBufferID != NO_SUCH_BUFFER) {
     bool mainIsPrimary =
-      (PrimaryBufferID == NO_SUCH_BUFFER || MainBufferID == PrimaryBufferID);
+      (PrimaryBufferIDs.empty() || isPrimaryBufferID(MainBufferID));
 
     SourceFile &MainFile =
       MainModule->getMainSourceFile(Invocation.getSourceFileKind());
@@ -494,7 +564,7 @@ void CompilerInstance::performSema() {
       // with 'sil' definitions.
       parseIntoSourceFile(MainFile, MainFile.getBufferID().getValue(), &Done,
                           TheSILModule ? &SILContext : nullptr,
-                          &PersistentState, DelayedCB.get());
+                          &PersistentState, delayedCBForFile(mainIsPrimary));
       if (mainIsPrimary) {
         performTypeChecking(MainFile, PersistentState.getTopLevelContext(),
                             TypeCheckOptions, CurTUElem,
@@ -515,7 +585,7 @@ void CompilerInstance::performSema() {
   // Type-check each top-level input besides the main source file.
   for (auto File : MainModule->getFiles())
     if (auto SF = dyn_cast<SourceFile>(File))
-      if (PrimaryBufferID == NO_SUCH_BUFFER || SF == PrimarySourceFile)
+      if (PrimaryBufferIDs.empty() || isPrimarySourceFile(SF))
         performTypeChecking(*SF, PersistentState.getTopLevelContext(),
                             TypeCheckOptions, /*curElem*/0,
                             options.WarnLongFunctionBodies);
@@ -531,7 +601,12 @@ void CompilerInstance::performSema() {
   }
 
   // Perform whole-module type checking.
-  if (TypeCheckOptions & TypeCheckingFlags::DelayWholeModuleChecking) {
+  //
+  // Skip this when doing code completion: these passes only emit cross-file
+  // ObjC conflict diagnostics, which a completion invocation discards, and
+  // they are re-run from scratch on every completion request.
+  if ((TypeCheckOptions & TypeCheckingFlags::DelayWholeModuleChecking) &&
+      !Invocation.isCodeCompletion()) {
     for (auto File : MainModule->getFiles())
       if (auto SF = dyn_cast<SourceFile>(File))
         performWholeModuleTypeChecking(*SF);
@@ -539,7 +614,7 @@ void CompilerInstance::performSema() {
 
   for (auto File : MainModule->getFiles())
     if (auto SF = dyn_cast<SourceFile>(File))
-      if (PrimaryBufferID == NO_SUCH_BUFFER || SF == PrimarySourceFile)
+      if (PrimaryBufferIDs.empty() || isPrimarySourceFile(SF))
         finishTypeChecking(*SF);
 }
 
@@ -17,6 +17,7 @@
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/Basic/LLVM.h"
 #include "swift/Basic/SourceManager.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -100,11 +101,24 @@ PrintingDiagnosticConsumer::handleDiagnostic(SourceManager &SM, SourceLoc Loc,
     FixIts.push_back(getRawFixIt(SM, F));
 
   // Display the diagnostic.
-  ColoredStream coloredErrs{Stream};
-  raw_ostream &out = ForceColors ? coloredErrs : Stream;
   const llvm::SourceMgr &rawSM = SM.getLLVMSourceMgr();
   auto Msg = SM.GetMessage(Loc, SMKind, Text, Ranges, FixIts);
-  rawSM.PrintMessage(out, Msg);
+  if (ForceColors) {
+    ColoredStream coloredErrs{Stream};
+    rawSM.PrintMessage(coloredErrs, Msg);
+  } else if (Stream.has_colors()) {
+    rawSM.PrintMessage(Stream, Msg);
+  } else {
+    // PrintMessage performs many small writes; when the underlying stream is
+    // unbuffered (like stderr), each of those is a separate syscall. Render
+    // the whole diagnostic first and hand it over in a single write.
+    SmallString<256> RenderedText;
+    {
+      llvm::raw_svector_ostream RenderedStream(RenderedText);
+      rawSM.PrintMessage(RenderedStream, Msg);
+    }
+    Stream << RenderedText;
+  }
 }
 
 llvm::SMDiagnostic
@@ -22,6 +22,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/SmallString.h"
@@ -105,8 +106,10 @@ struct SharedState : llvm::RefCountedBase<SharedState> {
   /// \brief A text buffer for rendering diagnostic text.
   llvm::SmallString<256> diagBuf;
 
-  /// \brief The collection of files used.
-  llvm::DenseMap<const char *, unsigned> Files;
+  /// \brief The path table: each unique file path is interned here and
+  /// emitted as a RECORD_FILENAME at most once; location records refer to
+  /// paths by their table index.
+  llvm::StringMap<unsigned> Files;
 
   typedef llvm::DenseMap<const void *, std::pair<unsigned, StringRef> >
   DiagFlagsTy;
@@ -201,10 +204,10 @@ namespace swift { namespace serialized_diagnostics {
 }}
 
 unsigned SerializedDiagnosticConsumer::getEmitFile(StringRef Filename) {
-  // NOTE: Using Filename.data() here relies on SourceMgr using
-  // const char* as buffer identifiers.  This is fast, but may
-  // be brittle.  We can always switch over to using a StringMap.
-  unsigned &entry = State->Files[Filename.data()];
+  // Intern by path contents rather than by buffer identifier pointer, so
+  // that the same path reaching us through different buffers still shares
+  // one entry in the path table.
+  unsigned &entry = State->Files[Filename];
   if (entry)
     return entry;
 
@@ -34,6 +34,7 @@
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/FileSystem.h"
 #include "swift/Basic/SourceManager.h"
+#include "swift/Basic/Statistic.h"
 #include "swift/Basic/Timer.h"
 #include "swift/Frontend/DiagnosticVerifier.h"
 #include "swift/Frontend/Frontend.h"
@@ -227,7 +228,8 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
 
   llvm::MapVector<const NominalTypeDecl *, bool> extendedNominals;
   llvm::SmallVector<const FuncDecl *, 8> memberOperatorDecls;
-  llvm::SmallVector<const ExtensionDecl *, 8> extensionsWithJustMembers;
+  llvm::SmallVector<const NominalTypeDecl *, 8> nominalsWithLocalMembers;
+  llvm::SmallVector<const ExtensionDecl *, 8> extensionsWithMembers;
 
   out << "provides-top-level:\n";
   for (const Decl *D : SF->Decls) {
@@ -252,14 +254,13 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
       bool justMembers = std::all_of(ED->getInherited().begin(),
                                      ED->getInherited().end(),
                                      extendedTypeIsPrivate);
-      if (justMembers) {
-        if (std::all_of(ED->getMembers().begin(), ED->getMembers().end(),
-                        declIsPrivate)) {
-          break;
-        } else {
-          extensionsWithJustMembers.push_back(ED);
-        }
-      }
+      bool hasVisibleMembers = !std::all_of(ED->getMembers().begin(),
+                                            ED->getMembers().end(),
+                                            declIsPrivate);
+      if (justMembers && !hasVisibleMembers)
+        break;
+      if (hasVisibleMembers)
+        extensionsWithMembers.push_back(ED);
       extendedNominals[NTD] |= !justMembers;
       findNominalsAndOperators(extendedNominals, memberOperatorDecls,
                                ED->getMembers());
@@ -289,6 +290,7 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
       }
       out << "- \"" << escape(NTD->getName()) << "\"\n";
       extendedNominals[NTD] |= true;
+      nominalsWithLocalMembers.push_back(NTD);
       findNominalsAndOperators(extendedNominals, memberOperatorDecls,
                                NTD->getMembers());
       break;
@@ -346,12 +348,16 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
     out << "\", \"\"]\n";
   }
 
-  // This is also part of "provides-member".
-  for (auto *ED : extensionsWithJustMembers) {
-    auto mangledName = mangleTypeAsContext(
-                                        ED->getExtendedType()->getAnyNominal());
+  // This is also part of "provides-member". Emit the individual visible
+  // members of each nominal declared in this file and of each extension that
+  // adds members, so that "depends-member" edges recorded by other files can
+  // be matched against the specific member they use, rather than conflating
+  // all members of a type behind the wildcard entry above.
+  auto printProvidedMembers = [&](const NominalTypeDecl *NTD,
+                                  DeclRange members) {
+    auto mangledName = mangleTypeAsContext(NTD);
 
-    for (auto *member : ED->getMembers()) {
+    for (auto *member : members) {
       auto *VD = dyn_cast<ValueDecl>(member);
       if (!VD || !VD->hasName() ||
           VD->getFormalAccess() <= Accessibility::FilePrivate) {
@@ -360,7 +366,12 @@ static bool emitReferenceDependencies(DiagnosticEngine &diags,
       out << "- [\"" << mangledName << "\", \""
           << escape(VD->getName()) << "\"]\n";
     }
-  }
+  };
+  for (auto *NTD : nominalsWithLocalMembers)
+    printProvidedMembers(NTD, NTD->getMembers());
+  for (auto *ED : extensionsWithMembers)
+    printProvidedMembers(ED->getExtendedType()->getAnyNominal(),
+                         ED->getMembers());
 
   if (SF->getASTContext().LangOpts.EnableObjCInterop) {
     // FIXME: This requires a traversal of the whole file to compute.
@@ -490,7 +501,8 @@ static bool writeSIL(SILModule &SM, Module *M, bool EmitVerboseSIL,
 }
 
 static bool printAsObjC(const std::string &outputPath, Module *M,
-                        StringRef bridgingHeader, bool moduleIsPublic) {
+                        StringRef bridgingHeader, bool moduleIsPublic,
+                        bool splitHeader) {
   using namespace llvm::sys;
 
   clang::CompilerInstance Clang;
@@ -516,7 +528,9 @@ static bool printAsObjC(const std::string &outputPath, Module *M,
 
   auto requiredAccess = moduleIsPublic ? Accessibility::Public
                                        : Accessibility::Internal;
-  bool hadError = printAsObjC(*out, M, bridgingHeader, requiredAccess);
+  bool hadError = splitHeader
+    ? printAsObjCSplit(*out, outputPath, M, bridgingHeader, requiredAccess)
+    : printAsObjC(*out, M, bridgingHeader, requiredAccess);
   out->flush();
 
   EC = swift::moveFileIfDifferent(tmpFilePath, outputPath);
@@ -550,6 +564,85 @@ static IRGenOutputKind getOutputKind(FrontendOptions::ActionType Action) {
 
 namespace {
 
+/// Returns true if the fixits attached to the given diagnostic are suitable
+/// for applying to source as code edits.
+static bool shouldFixDiagnostic(DiagnosticKind Kind,
+                                const DiagnosticInfo &Info, bool FixitAll) {
+  if (FixitAll)
+    return true;
+
+  // Do not add a semi or comma as it is wrong in most cases during migration
+  if (Info.ID == diag::statement_same_line_without_semi.ID ||
+      Info.ID == diag::declaration_same_line_without_semi.ID ||
+      Info.ID == diag::expected_separator.ID)
+    return false;
+  // The following interact badly with the swift migrator, they are undoing
+  // migration of arguments to preserve the no-label for first argument.
+  if (Info.ID == diag::witness_argument_name_mismatch.ID ||
+    Info.ID == diag::missing_argument_labels.ID ||
+    Info.ID == diag::override_argument_name_mismatch.ID)
+    return false;
+  // This also interacts badly with the swift migrator, it unnecessary adds
+  // @objc(selector) attributes triggered by the mismatched label changes.
+  if (Info.ID == diag::objc_witness_selector_mismatch.ID ||
+      Info.ID == diag::witness_non_objc.ID)
+    return false;
+  // This interacts badly with the migrator. For such code:
+  //   func test(p: Int, _: String) {}
+  //   test(0, "")
+  // the compiler bizarrely suggests to change order of arguments in the call
+  // site.
+  if (Info.ID == diag::argument_out_of_order_unnamed_unnamed.ID)
+    return false;
+  // The following interact badly with the swift migrator by removing @IB*
+  // attributes when there is some unrelated type issue.
+  if (Info.ID == diag::invalid_iboutlet.ID ||
+      Info.ID == diag::iboutlet_nonobjc_class.ID ||
+      Info.ID == diag::iboutlet_nonobjc_protocol.ID ||
+      Info.ID == diag::iboutlet_nonobject_type.ID ||
+      Info.ID == diag::iboutlet_only_mutable.ID ||
+      Info.ID == diag::invalid_ibdesignable_extension.ID ||
+      Info.ID == diag::invalid_ibinspectable.ID ||
+      Info.ID == diag::invalid_ibaction_decl.ID)
+    return false;
+  // Adding type(of:) interacts poorly with the swift migrator by
+  // invalidating some inits with type errors.
+  if (Info.ID == diag::init_not_instance_member.ID)
+    return false;
+  // Renaming enum cases interacts poorly with the swift migrator by
+  // reverting changes made by the mgirator.
+  if (Info.ID == diag::could_not_find_enum_case.ID)
+    return false;
+
+  if (Kind == DiagnosticKind::Error)
+    return true;
+
+  // Fixits from warnings/notes that should be applied.
+  if (Info.ID == diag::forced_downcast_coercion.ID ||
+      Info.ID == diag::forced_downcast_noop.ID ||
+      Info.ID == diag::variable_never_mutated.ID ||
+      Info.ID == diag::function_type_no_parens.ID ||
+      Info.ID == diag::convert_let_to_var.ID ||
+      Info.ID == diag::parameter_extraneous_double_up.ID ||
+      Info.ID == diag::attr_decl_attr_now_on_type.ID ||
+      Info.ID == diag::noescape_parameter.ID ||
+      Info.ID == diag::noescape_autoclosure.ID ||
+      Info.ID == diag::where_inside_brackets.ID ||
+      Info.ID == diag::selector_construction_suggest.ID ||
+      Info.ID == diag::selector_literal_deprecated_suggest.ID ||
+      Info.ID == diag::attr_noescape_deprecated.ID ||
+      Info.ID == diag::attr_autoclosure_escaping_deprecated.ID ||
+      Info.ID == diag::attr_warn_unused_result_removed.ID ||
+      Info.ID == diag::any_as_anyobject_fixit.ID ||
+      Info.ID == diag::deprecated_protocol_composition.ID ||
+      Info.ID == diag::deprecated_protocol_composition_single.ID ||
+      Info.ID == diag::deprecated_any_composition.ID ||
+      Info.ID == diag::deprecated_operator_body.ID)
+    return true;
+
+  return false;
+}
+
 /// If there is an error with fixits it writes the fixits as edits in json
 /// format.
 class JSONFixitWriter : public DiagnosticConsumer {
@@ -579,79 +672,7 @@ private:
   }
 
   bool shouldFix(DiagnosticKind Kind, const DiagnosticInfo &Info) {
-    if (FixitAll)
-      return true;
-
-    // Do not add a semi or comma as it is wrong in most cases during migration
-    if (Info.ID == diag::statement_same_line_without_semi.ID ||
-        Info.ID == diag::declaration_same_line_without_semi.ID ||
-        Info.ID == diag::expected_separator.ID)
-      return false;
-    // The following interact badly with the swift migrator, they are undoing
-    // migration of arguments to preserve the no-label for first argument.
-    if (Info.ID == diag::witness_argument_name_mismatch.ID ||
-      Info.ID == diag::missing_argument_labels.ID ||
-      Info.ID == diag::override_argument_name_mismatch.ID)
-      return false;
-    // This also interacts badly with the swift migrator, it unnecessary adds
-    // @objc(selector) attributes triggered by the mismatched label changes.
-    if (Info.ID == diag::objc_witness_selector_mismatch.ID ||
-        Info.ID == diag::witness_non_objc.ID)
-      return false;
-    // This interacts badly with the migrator. For such code:
-    //   func test(p: Int, _: String) {}
-    //   test(0, "")
-    // the compiler bizarrely suggests to change order of arguments in the call
-    // site.
-    if (Info.ID == diag::argument_out_of_order_unnamed_unnamed.ID)
-      return false;
-    // The following interact badly with the swift migrator by removing @IB*
-    // attributes when there is some unrelated type issue.
-    if (Info.ID == diag::invalid_iboutlet.ID ||
-        Info.ID == diag::iboutlet_nonobjc_class.ID ||
-        Info.ID == diag::iboutlet_nonobjc_protocol.ID ||
-        Info.ID == diag::iboutlet_nonobject_type.ID ||
-        Info.ID == diag::iboutlet_only_mutable.ID ||
-        Info.ID == diag::invalid_ibdesignable_extension.ID ||
-        Info.ID == diag::invalid_ibinspectable.ID ||
-        Info.ID == diag::invalid_ibaction_decl.ID)
-      return false;
-    // Adding type(of:) interacts poorly with the swift migrator by
-    // invalidating some inits with type errors.
-    if (Info.ID == diag::init_not_instance_member.ID)
-      return false;
-    // Renaming enum cases interacts poorly with the swift migrator by
-    // reverting changes made by the mgirator.
-    if (Info.ID == diag::could_not_find_enum_case.ID)
-      return false;
-
-    if (Kind == DiagnosticKind::Error)
-      return true;
-
-    // Fixits from warnings/notes that should be applied.
-    if (Info.ID == diag::forced_downcast_coercion.ID ||
-        Info.ID == diag::forced_downcast_noop.ID ||
-        Info.ID == diag::variable_never_mutated.ID ||
-        Info.ID == diag::function_type_no_parens.ID ||
-        Info.ID == diag::convert_let_to_var.ID ||
-        Info.ID == diag::parameter_extraneous_double_up.ID ||
-        Info.ID == diag::attr_decl_attr_now_on_type.ID ||
-        Info.ID == diag::noescape_parameter.ID ||
-        Info.ID == diag::noescape_autoclosure.ID ||
-        Info.ID == diag::where_inside_brackets.ID ||
-        Info.ID == diag::selector_construction_suggest.ID ||
-        Info.ID == diag::selector_literal_deprecated_suggest.ID ||
-        Info.ID == diag::attr_noescape_deprecated.ID ||
-        Info.ID == diag::attr_autoclosure_escaping_deprecated.ID ||
-        Info.ID == diag::attr_warn_unused_result_removed.ID ||
-        Info.ID == diag::any_as_anyobject_fixit.ID ||
-        Info.ID == diag::deprecated_protocol_composition.ID ||
-        Info.ID == diag::deprecated_protocol_composition_single.ID ||
-        Info.ID == diag::deprecated_any_composition.ID ||
-        Info.ID == diag::deprecated_operator_body.ID)
-      return true;
-
-    return false;
+    return shouldFixDiagnostic(Kind, Info, FixitAll);
   }
 
   void writeEdit(SourceManager &SM, CharSourceRange Range, StringRef Text,
@@ -677,6 +698,97 @@ private:
   }
 };
 
+/// Collects the fixits produced by one whole-module check and applies the
+/// non-overlapping ones to the source files in a single batch, instead of
+/// re-type-checking after each application.
+class BatchFixitApplier : public DiagnosticConsumer {
+  struct Edit {
+    unsigned BufferID;
+    unsigned Offset;
+    unsigned Length;
+    std::string Text;
+  };
+
+  SourceManager *SM = nullptr;
+  bool FixitAll;
+  std::vector<Edit> Edits;
+
+public:
+  explicit BatchFixitApplier(const DiagnosticOptions &DiagOpts)
+    : FixitAll(DiagOpts.FixitCodeForAllDiagnostics) {}
+
+  void handleDiagnostic(SourceManager &SM, SourceLoc Loc,
+                        DiagnosticKind Kind, StringRef Text,
+                        const DiagnosticInfo &Info) override {
+    if (!shouldFixDiagnostic(Kind, Info, FixitAll))
+      return;
+    this->SM = &SM;
+    for (const auto &Fix : Info.FixIts) {
+      SourceLoc FixLoc = Fix.getRange().getStart();
+      unsigned BufID = SM.findBufferContainingLoc(FixLoc);
+      Edits.push_back({BufID, SM.getLocOffsetInBuffer(FixLoc, BufID),
+                       Fix.getRange().getByteLength(), Fix.getText().str()});
+    }
+  }
+
+  /// Rewrite each edited file once, skipping duplicate edits and edits that
+  /// overlap an already-applied one. Returns true on error.
+  bool applyEdits(DiagnosticEngine &Diags) {
+    if (Edits.empty())
+      return false;
+
+    std::stable_sort(Edits.begin(), Edits.end(),
+                     [](const Edit &LHS, const Edit &RHS) {
+      if (LHS.BufferID != RHS.BufferID)
+        return LHS.BufferID < RHS.BufferID;
+      if (LHS.Offset != RHS.Offset)
+        return LHS.Offset < RHS.Offset;
+      return LHS.Length < RHS.Length;
+    });
+
+    bool hadError = false;
+    for (size_t i = 0, e = Edits.size(); i != e; ) {
+      unsigned BufID = Edits[i].BufferID;
+      StringRef buffer = SM->extractText(SM->getRangeForBuffer(BufID));
+
+      std::string rewritten;
+      rewritten.reserve(buffer.size());
+      size_t pos = 0;
+      const Edit *lastApplied = nullptr;
+      for (; i != e && Edits[i].BufferID == BufID; ++i) {
+        const Edit &edit = Edits[i];
+        if (lastApplied &&
+            (edit.Offset < pos ||
+             (edit.Offset == lastApplied->Offset &&
+              edit.Length == lastApplied->Length &&
+              edit.Text == lastApplied->Text)))
+          continue;
+        rewritten += buffer.slice(pos, edit.Offset);
+        rewritten += edit.Text;
+        pos = edit.Offset + edit.Length;
+        lastApplied = &edit;
+      }
+      rewritten += buffer.substr(pos);
+
+      if (rewritten == buffer)
+        continue;
+
+      StringRef path = SM->getIdentifierForBuffer(BufID);
+      std::error_code EC;
+      llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::F_None);
+      if (EC) {
+        Diags.diagnose(SourceLoc(), diag::cannot_open_file,
+                       path, EC.message());
+        hadError = true;
+        continue;
+      }
+      out << rewritten;
+      hadError |= out.has_error();
+    }
+    return hadError;
+  }
+};
+
 } // anonymous namespace
 
 // This is a separate function so that it shows up in stack traces.
@@ -693,13 +805,106 @@ static void debugFailWithCrash() {
   LLVM_BUILTIN_TRAP;
 }
 
+static void countStatsPostSema(UnifiedStatsReporter &Stats,
+                               CompilerInstance &Instance) {
+  auto &C = Stats.getFrontendCounters();
+  C.NumSourceBuffers =
+    Instance.getSourceMgr().getLLVMSourceMgr().getNumBuffers();
+  for (auto *File : Instance.getMainModule()->getFiles())
+    if (auto *SF = dyn_cast<SourceFile>(File))
+      C.NumDecls += SF->Decls.size();
+}
+
+static void countStatsPostSILGen(UnifiedStatsReporter &Stats,
+                                 SILModule &Module) {
+  // Accumulate, so that in batch mode the per-primary pipelines sum into one
+  // record for the job.
+  Stats.getFrontendCounters().NumSILGenFunctions +=
+    std::distance(Module.begin(), Module.end());
+}
+
+static void countStatsPostSILOpt(UnifiedStatsReporter &Stats,
+                                 SILModule &Module) {
+  Stats.getFrontendCounters().NumSILOptFunctions +=
+    std::distance(Module.begin(), Module.end());
+}
+
+/// Runs SILGen, the SIL pipelines, and IRGen for a single primary file of a
+/// batch-mode invocation, writing the result to \p OutputFilename.
+///
+/// \returns true on error
+static bool compileBatchPrimary(CompilerInstance &Instance,
+                                CompilerInvocation &Invocation,
+                                SourceFile *PrimaryFile,
+                                StringRef OutputFilename,
+                                FrontendOptions::ActionType Action,
+                                FrontendObserver *observer,
+                                UnifiedStatsReporter *Stats) {
+  const FrontendOptions &opts = Invocation.getFrontendOptions();
+
+  std::unique_ptr<SILModule> SM =
+    performSILGeneration(*PrimaryFile, Invocation.getSILOptions(),
+                         None, opts.SILSerializeAll);
+  if (observer) {
+    observer->performedSILGeneration(*SM);
+  }
+  if (Stats)
+    countStatsPostSILGen(*Stats, *SM);
+
+  if (!Invocation.getDiagnosticOptions().SkipDiagnosticPasses) {
+    if (runSILDiagnosticPasses(*SM))
+      return true;
+
+    if (observer) {
+      observer->performedSILDiagnostics(*SM);
+    }
+  }
+
+  if (Invocation.getSILOptions().LinkMode == SILOptions::LinkAll)
+    performSILLinking(SM.get(), true);
+
+  SM->verify();
+
+  if (Invocation.getSILOptions().Optimization > SILOptions::SILOptMode::None) {
+    StringRef CustomPipelinePath =
+      Invocation.getSILOptions().ExternalPassPipelineFilename;
+    if (!CustomPipelinePath.empty()) {
+      runSILOptimizationPassesWithFileSpecification(*SM, CustomPipelinePath);
+    } else {
+      runSILOptimizationPasses(*SM);
+    }
+  } else {
+    runSILPassesForOnone(*SM);
+  }
+
+  if (observer) {
+    observer->performedSILOptimization(*SM);
+  }
+  if (Stats)
+    countStatsPostSILOpt(*Stats, *SM);
+
+  SM->verify();
+
+  if (Instance.getASTContext().hadError())
+    return true;
+
+  performSILCleanup(SM.get());
+
+  IRGenOptions &IRGenOpts = Invocation.getIRGenOptions();
+  IRGenOpts.OutputKind = getOutputKind(Action);
+  performIRGeneration(IRGenOpts, *PrimaryFile, SM.get(), OutputFilename,
+                      llvm::getGlobalContext());
+  return false;
+}
+
 /// Performs the compile requested by the user.
 /// \returns true on error
 static bool performCompile(CompilerInstance &Instance,
                            CompilerInvocation &Invocation,
                            ArrayRef<const char *> Args,
                            int &ReturnValue,
-                           FrontendObserver *observer) {
+                           FrontendObserver *observer,
+                           UnifiedStatsReporter *Stats) {
   FrontendOptions opts = Invocation.getFrontendOptions();
   FrontendOptions::ActionType Action = opts.RequestedAction;
 
@@ -757,6 +962,8 @@ static bool performCompile(CompilerInstance &Instance,
   if (observer) {
     observer->performedSemanticAnalysis(Instance);
   }
+  if (Stats)
+    countStatsPostSema(*Stats, Instance);
 
   FrontendOptions::DebugCrashMode CrashMode = opts.CrashMode;
   if (CrashMode == FrontendOptions::DebugCrashMode::AssertAfterParse)
@@ -824,13 +1031,34 @@ static bool performCompile(CompilerInstance &Instance,
   if (Action == FrontendOptions::Parse) {
     if (!opts.ObjCHeaderOutputPath.empty())
       return printAsObjC(opts.ObjCHeaderOutputPath, Instance.getMainModule(),
-                         opts.ImplicitObjCHeaderPath, moduleIsPublic);
+                         opts.ImplicitObjCHeaderPath, moduleIsPublic,
+                         opts.SplitObjCHeader);
     return false;
   }
 
   assert(Action >= FrontendOptions::EmitSILGen &&
          "All actions not requiring SILGen must have been handled!");
 
+  // In batch mode, run the SIL and IRGen pipelines once per primary file,
+  // producing one output per primary. The expensive Sema work above has
+  // already been shared across the whole batch.
+  auto PrimaryFiles = Instance.getPrimarySourceFiles();
+  if (PrimaryFiles.size() > 1) {
+    if (opts.OutputFilenames.size() != PrimaryFiles.size()) {
+      Context.Diags.diagnose(SourceLoc(), diag::error_batch_mode_output_count,
+                             (unsigned)opts.OutputFilenames.size(),
+                             (unsigned)PrimaryFiles.size());
+      return true;
+    }
+    for (unsigned i = 0, e = PrimaryFiles.size(); i != e; ++i) {
+      if (compileBatchPrimary(Instance, Invocation, PrimaryFiles[i],
+                              opts.OutputFilenames[i], Action, observer,
+                              Stats))
+        return true;
+    }
+    return Context.hadError();
+  }
+
   std::unique_ptr<SILModule> SM = Instance.takeSILModule();
   if (!SM) {
     if (opts.PrimaryInput.hasValue() && opts.PrimaryInput.getValue().isFilename()) {
@@ -851,6 +1079,8 @@ static bool performCompile(CompilerInstance &Instance,
   if (observer) {
     observer->performedSILGeneration(*SM);
   }
+  if (Stats)
+    countStatsPostSILGen(*Stats, *SM);
 
   // We've been told to emit SIL after SILGen, so write it now.
   if (Action == FrontendOptions::EmitSILGen) {
@@ -919,6 +1149,8 @@ static bool performCompile(CompilerInstance &Instance,
   if (observer) {
     observer->performedSILOptimization(*SM);
   }
+  if (Stats)
+    countStatsPostSILOpt(*Stats, *SM);
 
   {
     SharedTimer timer("SIL verification (post-optimization)");
@@ -940,7 +1172,8 @@ static bool performCompile(CompilerInstance &Instance,
 
   if (!opts.ObjCHeaderOutputPath.empty()) {
     (void)printAsObjC(opts.ObjCHeaderOutputPath, Instance.getMainModule(),
-                      opts.ImplicitObjCHeaderPath, moduleIsPublic);
+                      opts.ImplicitObjCHeaderPath, moduleIsPublic,
+                      opts.SplitObjCHeader);
   }
 
   if (Action == FrontendOptions::EmitSIB) {
@@ -1214,16 +1447,42 @@ int swift::performFrontend(ArrayRef<const char *> Args,
     }
   }
 
+  std::unique_ptr<BatchFixitApplier> FixitApplier;
+  if (Invocation.getDiagnosticOptions().ApplyFixitsInPlace) {
+    FixitApplier.reset(
+      new BatchFixitApplier(Invocation.getDiagnosticOptions()));
+    Instance.addDiagnosticConsumer(FixitApplier.get());
+  }
+
   if (Invocation.getDiagnosticOptions().UseColor)
     PDC.forceColors();
 
   if (Invocation.getFrontendOptions().DebugTimeCompilation)
     SharedTimer::enableCompilationTimers();
 
+  if (!Invocation.getFrontendOptions().TraceTimeCompilationPath.empty())
+    SharedTimer::enableTracing();
+
   if (Invocation.getFrontendOptions().PrintStats) {
     llvm::EnableStatistics();
   }
 
+  std::unique_ptr<UnifiedStatsReporter> StatsReporter;
+  const std::string &StatsOutputDir =
+      Invocation.getFrontendOptions().StatsOutputDir;
+  if (!StatsOutputDir.empty()) {
+    const FrontendOptions &FEOpts = Invocation.getFrontendOptions();
+    // Name the record after the primary input when there is one, so that a
+    // multi-job build produces one record per file; otherwise after the
+    // module being produced.
+    StringRef TargetName = FEOpts.ModuleName;
+    if (FEOpts.PrimaryInput.hasValue() &&
+        FEOpts.PrimaryInput.getValue().isFilename())
+      TargetName = FEOpts.InputFilenames[FEOpts.PrimaryInput.getValue().Index];
+    StatsReporter.reset(new UnifiedStatsReporter("swift-frontend", TargetName,
+                                                 StatsOutputDir));
+  }
+
   if (Invocation.getDiagnosticOptions().VerifyDiagnostics) {
     enableDiagnosticVerifier(Instance.getSourceMgr());
   }
@@ -1245,14 +1504,38 @@ int swift::performFrontend(ArrayRef<const char *> Args,
 
   int ReturnValue = 0;
   bool HadError =
-    performCompile(Instance, Invocation, Args, ReturnValue, observer) ||
+    performCompile(Instance, Invocation, Args, ReturnValue, observer,
+                   StatsReporter.get()) ||
     Instance.getASTContext().hadError();
 
+  // Rewrite the source files in one pass; this runs even after errors,
+  // since errors are what carry most migration fixits.
+  if (FixitApplier)
+    HadError |= FixitApplier->applyEdits(Instance.getDiags());
+
   if (!HadError && !Invocation.getFrontendOptions().DumpAPIPath.empty()) {
     HadError = dumpAPI(Instance.getMainModule(),
                        Invocation.getFrontendOptions().DumpAPIPath);
   }
 
+  if (Invocation.getFrontendOptions().PrintStats)
+    Instance.getASTContext().printAllocationStatistics(llvm::errs());
+
+  const std::string &TracePath =
+      Invocation.getFrontendOptions().TraceTimeCompilationPath;
+  if (!TracePath.empty()) {
+    std::error_code EC;
+    std::unique_ptr<llvm::raw_fd_ostream> OS;
+    OS.reset(new llvm::raw_fd_ostream(TracePath, EC, llvm::sys::fs::F_None));
+    if (EC) {
+      Instance.getDiags().diagnose(SourceLoc(), diag::cannot_open_file,
+                                   TracePath, EC.message());
+      HadError = true;
+    } else {
+      SharedTimer::writeTraceEvents(*OS);
+    }
+  }
+
   if (Invocation.getDiagnosticOptions().VerifyDiagnostics) {
     HadError = verifyDiagnostics(Instance.getSourceMgr(),
                                  Instance.getInputBufferIDs());
@@ -1265,6 +1548,15 @@ int swift::performFrontend(ArrayRef<const char *> Args,
     }
   }
 
+  if (StatsReporter) {
+    // Mangling happens throughout the job; fold the mangler's running totals
+    // into the record now that compilation is finished.
+    auto &C = StatsReporter->getFrontendCounters();
+    C.NumMangledNames = Mangle::Mangler::NumMangledNames;
+    C.NumManglerSubstitutionHits = Mangle::Mangler::NumSubstitutionHits;
+    C.NumManglerSubstitutionMisses = Mangle::Mangler::NumSubstitutionMisses;
+  }
+
   return (HadError ? 1 : ReturnValue);
 }
 
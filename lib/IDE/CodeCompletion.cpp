@@ -23,6 +23,7 @@
 #include "swift/Basic/LLVM.h"
 #include "swift/ClangImporter/ClangImporter.h"
 #include "swift/ClangImporter/ClangModule.h"
+#include "swift/Frontend/Frontend.h"
 #include "swift/IDE/CodeCompletionCache.h"
 #include "swift/IDE/Utils.h"
 #include "swift/Parse/CodeCompletionCallbacks.h"
@@ -5515,3 +5516,26 @@ void SimpleCachingCodeCompletionConsumer::handleResultsAndModules(
 
   handleResults(context.takeResults());
 }
+
+bool swift::ide::performCodeCompletion(CompilerInvocation &Invocation,
+                                       CodeCompletionContext &CompletionContext,
+                                       CodeCompletionConsumer &Consumer,
+                                       DiagnosticConsumer *DiagConsumer) {
+  assert(Invocation.isCodeCompletion() &&
+         "invocation has no code completion point");
+
+  std::unique_ptr<CodeCompletionCallbacksFactory> CallbacksFactory(
+      makeCodeCompletionCallbacksFactory(CompletionContext, Consumer));
+  Invocation.setCodeCompletionFactory(CallbacksFactory.get());
+
+  // Don't leave a dangling pointer to the factory in the invocation.
+  SWIFT_DEFER { Invocation.setCodeCompletionFactory(nullptr); };
+
+  CompilerInstance CI;
+  if (DiagConsumer)
+    CI.addDiagnosticConsumer(DiagConsumer);
+  if (CI.setup(Invocation))
+    return true;
+  CI.performSema();
+  return false;
+}
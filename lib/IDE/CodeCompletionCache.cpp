@@ -90,10 +90,24 @@ CodeCompletionCache::~CodeCompletionCache() {}
 /// cached results. This isn't expected to change very often.
 static constexpr uint32_t onDiskCompletionCacheVersion = 0;
 
-static StringRef copyString(llvm::BumpPtrAllocator &Allocator, StringRef Str) {
-  char *Mem = Allocator.Allocate<char>(Str.size());
-  std::copy(Str.begin(), Str.end(), Mem);
-  return StringRef(Mem, Str.size());
+/// Binds the lifetime of a deserialization buffer to a result sink's
+/// allocator.
+///
+/// Deserialized results keep their strings as pointers into the
+/// (memory-mapped) buffer rather than copies in the allocator. Sinks that
+/// import these results retain the source sink's allocator, so tying the
+/// buffer to the allocator keeps the strings alive exactly as long as
+/// anything can refer to them.
+static void bindBufferToSink(CodeCompletionResultSink &sink,
+                             std::unique_ptr<llvm::MemoryBuffer> buffer) {
+  struct AllocatorWithBuffer {
+    llvm::BumpPtrAllocator Alloc;
+    std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  };
+  auto owner = std::make_shared<AllocatorWithBuffer>();
+  owner->Buffer = std::move(buffer);
+  sink.Allocator =
+      std::shared_ptr<llvm::BumpPtrAllocator>(owner, &owner->Alloc);
 }
 
 static ArrayRef<StringRef> copyStringArray(llvm::BumpPtrAllocator &Allocator,
@@ -161,13 +175,17 @@ static bool readCachedModule(llvm::MemoryBuffer *in,
   (void)stringCount; // so it is not seen as "unused" in release builds.
   
   // STRINGS
+  //
+  // String bytes stay in the (memory-mapped) buffer, which the caller hands
+  // over to \p V; repeated references to the same string share the mapped
+  // pages instead of each getting a copy in the sink's allocator.
   auto getString = [&](uint32_t index) -> StringRef {
     if (index == ~0u)
       return "";
 
     const char *p = strings + index;
     auto size = read32le(p);
-    return copyString(*V.Sink.Allocator, StringRef(p, size));
+    return StringRef(p, size);
   };
 
   // CHUNKS
@@ -424,13 +442,18 @@ static std::string getName(StringRef cacheDirectory,
 Optional<CodeCompletionCache::ValueRefCntPtr>
 OnDiskCodeCompletionCache::get(const Key &K) {
   // Try to find the cached file.
-  auto bufferOrErr = llvm::MemoryBuffer::getFile(getName(cacheDirectory, K));
+  auto bufferOrErr = llvm::MemoryBuffer::getFile(getName(cacheDirectory, K),
+                                                 /*FileSize=*/-1,
+                                                 /*RequiresNullTerminator=*/
+                                                 false);
   if (!bufferOrErr)
     return None;
 
   // Read the cached results, failing if they are out of date.
   auto V = CodeCompletionCache::createValue();
-  if (!readCachedModule(bufferOrErr.get().get(), K, *V))
+  auto *rawBuffer = bufferOrErr.get().get();
+  bindBufferToSink(V->Sink, std::move(bufferOrErr.get()));
+  if (!readCachedModule(rawBuffer, K, *V))
     return None;
 
   return V;
@@ -466,7 +489,9 @@ std::error_code OnDiskCodeCompletionCache::set(const Key &K, ValueRefCntPtr V) {
 Optional<CodeCompletionCache::ValueRefCntPtr>
 OnDiskCodeCompletionCache::getFromFile(StringRef filename) {
   // Try to find the cached file.
-  auto bufferOrErr = llvm::MemoryBuffer::getFile(filename);
+  auto bufferOrErr = llvm::MemoryBuffer::getFile(filename, /*FileSize=*/-1,
+                                                 /*RequiresNullTerminator=*/
+                                                 false);
   if (!bufferOrErr)
     return None;
 
@@ -475,7 +500,9 @@ OnDiskCodeCompletionCache::getFromFile(StringRef filename) {
 
   // Read the cached results.
   auto V = CodeCompletionCache::createValue();
-  if (!readCachedModule(bufferOrErr.get().get(), K, *V,
+  auto *rawBuffer = bufferOrErr.get().get();
+  bindBufferToSink(V->Sink, std::move(bufferOrErr.get()));
+  if (!readCachedModule(rawBuffer, K, *V,
                         /*allowOutOfDate*/ true))
     return None;
 
@@ -600,8 +600,7 @@ class FormatWalker : public SourceEntityWalker {
   swift::ASTWalker::ParentTy AtEnd;
   bool InDocCommentBlock = false;
   bool InCommentLine = false;
-  std::vector<Token> Tokens;
-  LangOptions Options;
+  std::vector<Token> &Tokens;
   TokenIt CurrentTokIt;
   unsigned TargetLine;
   SiblingCollector SCollector;
@@ -677,9 +676,8 @@ class FormatWalker : public SourceEntityWalker {
   }
 
 public:
-  explicit FormatWalker(SourceFile &SF, SourceManager &SM)
-  :SF(SF), SM(SM),
-  Tokens(tokenize(Options, SM, SF.getBufferID().getValue())),
+  FormatWalker(SourceFile &SF, SourceManager &SM, std::vector<Token> &Tokens)
+  :SF(SF), SM(SM), Tokens(Tokens),
   CurrentTokIt(Tokens.begin()),
   SCollector(SM, Tokens, TargetLocation) {}
 
@@ -801,6 +799,59 @@ public:
 
 } //anonymous namespace
 
+/// The per-buffer state that reformat() would otherwise recompute on every
+/// request: the token stream and the byte offset of the start of each line.
+/// The cache is keyed on the buffer's address and size, so handing it
+/// different contents transparently rebuilds it.
+class swift::ide::FormatCache::Implementation {
+  const char *BufferStart = nullptr;
+  size_t BufferSize = 0;
+  std::vector<Token> Tokens;
+  std::vector<size_t> LineOffsets;
+
+public:
+  void rebuildIfNeeded(SourceManager &SM, unsigned BufferID, StringRef Text) {
+    if (BufferStart == Text.data() && BufferSize == Text.size())
+      return;
+    BufferStart = Text.data();
+    BufferSize = Text.size();
+
+    LangOptions LangOpts;
+    Tokens = tokenize(LangOpts, SM, BufferID);
+
+    // Record the offset of the start of every line. These anchors let us
+    // jump straight to a line without rescanning the text.
+    LineOffsets.clear();
+    LineOffsets.push_back(0);
+    for (size_t i = 0, e = Text.size(); i != e; ++i) {
+      if (Text[i] == '\r' && i + 1 != e && Text[i + 1] == '\n')
+        ++i;
+      if (Text[i] == '\r' || Text[i] == '\n')
+        LineOffsets.push_back(i + 1);
+    }
+  }
+
+  std::vector<Token> &getTokens() { return Tokens; }
+
+  size_t getOffsetOfLine(unsigned LineIndex) const {
+    if (LineIndex == 0 || LineIndex > LineOffsets.size())
+      return 0;
+    return LineOffsets[LineIndex - 1];
+  }
+
+  size_t getOffsetOfTrimmedLine(unsigned LineIndex, StringRef Text) const {
+    size_t LineOffset = getOffsetOfLine(LineIndex);
+    size_t FirstNonWSOnLine = Text.find_first_not_of(" \t\v\f", LineOffset);
+    if (FirstNonWSOnLine != std::string::npos)
+      LineOffset = FirstNonWSOnLine;
+    return LineOffset;
+  }
+};
+
+swift::ide::FormatCache::FormatCache() : Impl(*new Implementation()) {}
+
+swift::ide::FormatCache::~FormatCache() { delete &Impl; }
+
 size_t swift::ide::getOffsetOfLine(unsigned LineIndex, StringRef Text) {
   //  SourceLoc start = SourceLoc(llvm::SMLoc::getFromPointer(Text.begin()));
   // FIXME: We should have a cached line map in EditableTextBuffer, for now
@@ -861,11 +912,22 @@ std::pair<LineRange, std::string> swift::ide::reformat(LineRange Range,
                                                        CodeFormatOptions Options,
                                                        SourceManager &SM,
                                                        SourceFile &SF) {
-  FormatWalker walker(SF, SM);
+  FormatCache Cache;
+  return reformat(Range, Options, SM, SF, Cache);
+}
+
+std::pair<LineRange, std::string> swift::ide::reformat(LineRange Range,
+                                                       CodeFormatOptions Options,
+                                                       SourceManager &SM,
+                                                       SourceFile &SF,
+                                                       FormatCache &Cache) {
   auto SourceBufferID = SF.getBufferID().getValue();
   StringRef Text = SM.getLLVMSourceMgr()
     .getMemoryBuffer(SourceBufferID)->getBuffer();
-  size_t Offset = getOffsetOfTrimmedLine(Range.startLine(), Text);
+  auto &Impl = Cache.getImpl();
+  Impl.rebuildIfNeeded(SM, SourceBufferID, Text);
+  FormatWalker walker(SF, SM, Impl.getTokens());
+  size_t Offset = Impl.getOffsetOfTrimmedLine(Range.startLine(), Text);
   SourceLoc Loc = SM.getLocForBufferStart(SourceBufferID)
     .getAdvancedLoc(Offset);
   FormatContext FC = walker.walkToLocation(Loc);
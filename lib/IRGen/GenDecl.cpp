@@ -57,7 +57,7 @@
 using namespace swift;
 using namespace irgen;
 
-static bool isTypeMetadataEmittedLazily(CanType type) {
+bool irgen::isTypeMetadataEmittedLazily(CanType type) {
   // All classes have eagerly-emitted metadata (at least for now).
   if (type.getClassOrBoundGenericClass()) return false;
 
@@ -70,9 +70,15 @@ static bool isTypeMetadataEmittedLazily(CanType type) {
   switch (getDeclLinkage(nom)) {
   case FormalLinkage::PublicUnique:
   case FormalLinkage::HiddenUnique:
-  case FormalLinkage::Private:
-    // Maybe this *should* be lazy for private types?
     return false;
+  case FormalLinkage::Private:
+    // Private value types can only be used type-erased from within this
+    // module, and every such use goes through getAddrOfTypeMetadata. So
+    // their metadata - and with it their value witness table - only needs
+    // to be emitted if a use actually occurs. Generic types still get
+    // their metadata pattern emitted eagerly.
+    return (isa<StructDecl>(nom) || isa<EnumDecl>(nom)) &&
+           !nom->isGenericContext();
   case FormalLinkage::PublicNonUnique:
   case FormalLinkage::HiddenNonUnique:
     return true;
@@ -1338,6 +1344,27 @@ getIRLinkage(IRGenModule &IGM, SILLinkage linkage, bool isFragile,
   llvm_unreachable("bad SIL linkage");
 }
 
+/// Place a link-once definition into a comdat group if the object format
+/// needs it. Mach-O folds duplicate weak definitions without comdats, but on
+/// ELF and COFF the copies of a shared symbol (metadata templates, generic
+/// specializations, value witness tables) that every referencing module emits
+/// only fold at link time when they are in a comdat.
+static void applyCOMDATIfNeeded(IRGenModule &IGM, llvm::GlobalObject *global,
+                                llvm::GlobalValue::LinkageTypes linkage) {
+  if (!llvm::GlobalValue::isLinkOnceODRLinkage(linkage) &&
+      !llvm::GlobalValue::isWeakODRLinkage(linkage))
+    return;
+
+  switch (IGM.TargetInfo.OutputObjectFormat) {
+  case llvm::Triple::ELF:
+  case llvm::Triple::COFF:
+    global->setComdat(IGM.Module.getOrInsertComdat(global->getName()));
+    break;
+  default:
+    break;
+  }
+}
+
 /// Given that we're going to define a global value but already have a
 /// forward-declaration of it, update its linkage.
 static void updateLinkageForDefinition(IRGenModule &IGM,
@@ -1352,6 +1379,8 @@ static void updateLinkageForDefinition(IRGenModule &IGM,
   global->setLinkage(std::get<0>(linkage));
   global->setVisibility(std::get<1>(linkage));
   global->setDLLStorageClass(std::get<2>(linkage));
+  if (auto *GO = dyn_cast<llvm::GlobalObject>(global))
+    applyCOMDATIfNeeded(IGM, GO, std::get<0>(linkage));
 
   // Everything externally visible is considered used in Swift.
   // That mostly means we need to be good at not marking things external.
@@ -1408,6 +1437,10 @@ llvm::Function *LinkInfo::createFunction(IRGenModule &IGM,
   fn->setVisibility(getVisibility());
   fn->setDLLStorageClass(getDLLStorage());
   fn->setCallingConv(cc);
+  // Declarations may not be placed in comdats; if this turns into a
+  // definition later, updateLinkageForDefinition takes care of it.
+  if (ForDefinition)
+    applyCOMDATIfNeeded(IGM, fn, getLinkage());
 
   if (insertBefore) {
     IGM.Module.getFunctionList().insert(insertBefore->getIterator(), fn);
@@ -1475,6 +1508,8 @@ llvm::GlobalVariable *LinkInfo::createVariable(IRGenModule &IGM,
   var->setVisibility(getVisibility());
   var->setDLLStorageClass(getDLLStorage());
   var->setAlignment(alignment.getValue());
+  if (ForDefinition)
+    applyCOMDATIfNeeded(IGM, var, getLinkage());
 
   // Everything externally visible is considered used in Swift.
   // That mostly means we need to be good at not marking things external.
@@ -1750,6 +1785,21 @@ llvm::Function *IRGenModule::getAddrOfSILFunction(SILFunction *f,
     attrs = attrs.addAttribute(fnType->getContext(),
                 llvm::AttributeSet::FunctionIndex, llvm::Attribute::ReadOnly);
   }
+  if (f->areInoutsUnaliased()) {
+    // The optimizer certified that a single @inout_aliasable parameter is
+    // the only argument this function accesses memory through, so it may be
+    // emitted as noalias after all. In the expanded signature both inout
+    // conventions carry nocapture without noalias; upgrading all of them is
+    // still sound because the certification guarantees every such parameter
+    // other than the aliasable one is never accessed at all, which makes
+    // noalias vacuous on them.
+    for (unsigned i = 1, e = fnType->getNumParams(); i <= e; ++i) {
+      if (attrs.hasAttribute(i, llvm::Attribute::NoCapture) &&
+          !attrs.hasAttribute(i, llvm::Attribute::NoAlias))
+        attrs = attrs.addAttribute(fnType->getContext(), i,
+                                   llvm::Attribute::NoAlias);
+    }
+  }
   fn = link.createFunction(*this, fnType, cc, attrs, insertBefore);
 
   // If we have an order number for this function, set it up as appropriate.
@@ -4770,6 +4770,33 @@ EnumImplStrategy::get(TypeConverter &TC, SILType type, EnumDecl *theEnum) {
   }
 
 
+  // Move cases marked @_hot to the front of their group so they get the
+  // lowest tag values, which are the cheapest to test and extract. The
+  // attribute lives in the AST, so every module that can see the enum
+  // computes the same layout. Resilient and C-compatible enums keep
+  // declaration order: their case numbering is part of their contract.
+  auto isHotElement = [](const Element &e) {
+    return e.decl->getAttrs().hasAttribute<HotAttr>();
+  };
+  if (!TC.IGM.isResilient(theEnum, ResilienceExpansion::Minimal) &&
+      !theEnum->hasClangNode() && !theEnum->isObjC() &&
+      (std::any_of(elementsWithPayload.begin(), elementsWithPayload.end(),
+                   isHotElement) ||
+       std::any_of(elementsWithNoPayload.begin(), elementsWithNoPayload.end(),
+                   isHotElement))) {
+    std::stable_partition(elementsWithPayload.begin(),
+                          elementsWithPayload.end(), isHotElement);
+    std::stable_partition(elementsWithNoPayload.begin(),
+                          elementsWithNoPayload.end(), isHotElement);
+    DEBUG(llvm::dbgs() << "Hot-case tag order for enum "
+                       << theEnum->getName().str() << ":";
+          for (auto &elt : elementsWithPayload)
+            llvm::dbgs() << ' ' << elt.decl->getName().str();
+          for (auto &elt : elementsWithNoPayload)
+            llvm::dbgs() << ' ' << elt.decl->getName().str();
+          llvm::dbgs() << '\n');
+  }
+
   // Resilient tag numbering decreases for payload tags, so reverse the
   // payload tags if this enum is resilient from any context.
   if (TC.IGM.isResilient(theEnum, ResilienceExpansion::Minimal))
@@ -5572,7 +5599,11 @@ const TypeInfo *TypeConverter::convertEnumType(TypeBase *key, CanType type,
 }
 
 void IRGenModule::emitEnumDecl(EnumDecl *theEnum) {
-  emitEnumMetadata(*this, theEnum);
+  // See the comment in emitStructDecl: metadata for private value types is
+  // only emitted when a use triggers it.
+  if (!isTypeMetadataEmittedLazily(
+          theEnum->getDeclaredType()->getCanonicalType()))
+    emitEnumMetadata(*this, theEnum);
   emitNestedTypeDecls(theEnum->getMembers());
   emitFieldMetadataRecord(theEnum);
 }
@@ -5834,10 +5865,7 @@ EnumPayload irgen::interleaveSpareBits(IRGenFunction &IGF,
 }
 
 static void setAlignmentBits(SpareBitVector &v, Alignment align) {
-  auto value = align.getValue() >> 1;
-  for (unsigned i = 0; value; ++i, value >>= 1) {
-    v.setBit(i);
-  }
+  v.setRange(0, llvm::Log2_32(align.getValue()));
 }
 
 const SpareBitVector &
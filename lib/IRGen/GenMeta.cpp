@@ -3671,11 +3671,17 @@ namespace {
     }
 
     bool canBeConstant() {
-      // TODO: the metadata global can actually be constant in a very
-      // special case: it's not a pattern, ObjC interoperation isn't
-      // required, there are no class fields, and there is nothing that
-      // needs to be runtime-adjusted.
-      return false;
+      // With ObjC interop, the ObjC runtime writes into the metadata when
+      // realizing the class, so it can never be constant.
+      if (IGM.ObjCInterop)
+        return false;
+
+      // Otherwise, the metadata is constant if nothing needs to be
+      // adjusted at runtime: the superclass and parent references were
+      // emitted as constants and the remaining initialization is
+      // idempotent (which, without ObjC interop, means it does nothing).
+      return !HasUnfilledSuperclass && !HasUnfilledParent &&
+             isFinishInitializationIdempotent();
     }
 
     void createMetadataAccessFunction() {
@@ -129,6 +129,11 @@ namespace irgen {
                                                      CanType type,
                                                      Size &addressPointOffset);
 
+  /// Returns true if the metadata (and value witness table) for the given
+  /// type is only emitted on first use instead of eagerly with its
+  /// declaration.
+  bool isTypeMetadataEmittedLazily(CanType type);
+
   /// Emit the metadata associated with the given struct declaration.
   void emitStructMetadata(IRGenModule &IGM, StructDecl *theStruct);
 
@@ -636,6 +636,17 @@ static llvm::FunctionType *getMsgSendSuperTy(IRGenModule &IGM,
 
 /// Prepare a call using ObjC method dispatch without applying the 'self' and
 /// '_cmd' arguments.
+///
+/// Note that we deliberately do not emit per-call-site (isa, IMP) inline
+/// caches for repeated AnyObject dispatch, tempting as it is for hot
+/// monomorphic sites.  The Objective-C runtime owns method resolution:
+/// categories can be loaded and methods replaced at any time, and the
+/// runtime invalidates its own per-class caches when that happens but has
+/// no way to reach caches baked into our text segment.  A raw isa-word
+/// compare is not a sufficient guard either, since on targets with
+/// non-pointer isa the word also carries mutable reference-counting state.
+/// objc_msgSend's per-class cache is the supported inline cache; a hit is
+/// already only a handful of instructions.
 CallEmission irgen::prepareObjCMethodRootCall(IRGenFunction &IGF,
                                               SILDeclRef method,
                                               CanSILFunctionType origFnType,
@@ -25,6 +25,7 @@
 #include "LoadableTypeInfo.h"
 #include "TypeInfo.h"
 #include "StructLayout.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/TrailingObjects.h"
 
 namespace swift {
@@ -126,15 +127,100 @@ public:
     return {this->template getTrailingObjects<FieldImpl>(), NumFields};
   }
 
-  /// The standard schema is just all the fields jumbled together.
-  void getSchema(ExplosionSchema &schema) const override {
+private:
+  /// The number of fields that need non-trivial copy or destroy work
+  /// before those operations are worth outlining into a per-type helper
+  /// function rather than being expanded inline at every use site.
+  enum : unsigned { MinFieldsForOutlinedValueOperations = 4 };
+
+  /// Whether copies and destroys of this record should be emitted as
+  /// calls to shared per-type helper functions. Large records with many
+  /// non-trivial fields expand into long retain/release sequences at
+  /// every use, which is a significant IR size and compile time problem;
+  /// small records are still cheaper inline.
+  bool shouldOutlineValueOperations(SILType T) const {
+    // The helper is named after the type's mangling, so we need a
+    // concrete nominal or bound generic type with a known layout.
+    if (!this->isFixedSize())
+      return false;
+    if (!T.getNominalOrBoundGenericNominal())
+      return false;
+    if (T.getSwiftRValueType()->hasArchetype())
+      return false;
+
+    unsigned numNonTrivialFields = 0;
     for (auto &field : getFields()) {
-      field.getTypeInfo().getSchema(schema);
+      if (field.isEmpty() || field.isPOD())
+        continue;
+      if (++numNonTrivialFields >= MinFieldsForOutlinedValueOperations)
+        return true;
+    }
+    return false;
+  }
+
+  /// Emit a call to a shared per-type helper performing the given
+  /// two-address operation out of line. The helper gets link-once
+  /// linkage, so at most one copy survives in the linkage unit.
+  void emitOutlinedBinaryOp(IRGenFunction &IGF, StringRef opName,
+                            Address dest, Address src, SILType T,
+                            llvm::function_ref<void(IRGenFunction &IGF,
+                                                    Address dest,
+                                                    Address src)> emitBody)
+      const {
+    IRGenModule &IGM = IGF.IGM;
+    llvm::SmallString<64> name("__swift_");
+    name += opName;
+    name += '_';
+    {
+      llvm::SmallString<32> mangling;
+      name += IGM.mangleType(T.getSwiftRValueType(), mangling);
     }
-  }
 
-  void assignWithCopy(IRGenFunction &IGF, Address dest,
-                      Address src, SILType T) const override {
+    auto ptrTy = this->getStorageType()->getPointerTo();
+    llvm::Type *argTys[] = { ptrTy, ptrTy };
+    auto align = this->getBestKnownAlignment();
+    auto fn = IGM.getOrCreateHelperFunction(name, IGM.VoidTy, argTys,
+                                            [&](IRGenFunction &IGF) {
+      auto it = IGF.CurFn->arg_begin();
+      Address dest(it++, align);
+      Address src(it++, align);
+      emitBody(IGF, dest, src);
+      IGF.Builder.CreateRetVoid();
+    });
+    IGF.Builder.CreateCall(fn, {dest.getAddress(), src.getAddress()});
+  }
+
+  /// Emit a call to a shared per-type helper performing the given
+  /// one-address operation out of line.
+  void emitOutlinedUnaryOp(IRGenFunction &IGF, StringRef opName,
+                           Address addr, SILType T,
+                           llvm::function_ref<void(IRGenFunction &IGF,
+                                                   Address addr)> emitBody)
+      const {
+    IRGenModule &IGM = IGF.IGM;
+    llvm::SmallString<64> name("__swift_");
+    name += opName;
+    name += '_';
+    {
+      llvm::SmallString<32> mangling;
+      name += IGM.mangleType(T.getSwiftRValueType(), mangling);
+    }
+
+    auto ptrTy = this->getStorageType()->getPointerTo();
+    llvm::Type *argTys[] = { ptrTy };
+    auto align = this->getBestKnownAlignment();
+    auto fn = IGM.getOrCreateHelperFunction(name, IGM.VoidTy, argTys,
+                                            [&](IRGenFunction &IGF) {
+      auto it = IGF.CurFn->arg_begin();
+      Address addr(it++, align);
+      emitBody(IGF, addr);
+      IGF.Builder.CreateRetVoid();
+    });
+    IGF.Builder.CreateCall(fn, {addr.getAddress()});
+  }
+
+  void emitAssignWithCopy(IRGenFunction &IGF, Address dest,
+                          Address src, SILType T) const {
     auto offsets = asImpl().getNonFixedOffsets(IGF, T);
     for (auto &field : getFields()) {
       if (field.isEmpty()) continue;
@@ -146,6 +232,49 @@ public:
     }
   }
 
+  void emitInitializeWithCopy(IRGenFunction &IGF, Address dest,
+                              Address src, SILType T) const {
+    auto offsets = asImpl().getNonFixedOffsets(IGF, T);
+    for (auto &field : getFields()) {
+      if (field.isEmpty()) continue;
+
+      Address destField = field.projectAddress(IGF, dest, offsets);
+      Address srcField = field.projectAddress(IGF, src, offsets);
+      field.getTypeInfo().initializeWithCopy(IGF, destField, srcField,
+                                             field.getType(IGF.IGM, T));
+    }
+  }
+
+  void emitDestroy(IRGenFunction &IGF, Address addr, SILType T) const {
+    auto offsets = asImpl().getNonFixedOffsets(IGF, T);
+    for (auto &field : getFields()) {
+      if (field.isPOD()) continue;
+
+      field.getTypeInfo().destroy(IGF, field.projectAddress(IGF, addr, offsets),
+                                  field.getType(IGF.IGM, T));
+    }
+  }
+
+public:
+  /// The standard schema is just all the fields jumbled together.
+  void getSchema(ExplosionSchema &schema) const override {
+    for (auto &field : getFields()) {
+      field.getTypeInfo().getSchema(schema);
+    }
+  }
+
+  void assignWithCopy(IRGenFunction &IGF, Address dest,
+                      Address src, SILType T) const override {
+    if (shouldOutlineValueOperations(T)) {
+      emitOutlinedBinaryOp(IGF, "assignWithCopy", dest, src, T,
+                           [&](IRGenFunction &IGF, Address dest, Address src) {
+        emitAssignWithCopy(IGF, dest, src, T);
+      });
+      return;
+    }
+    emitAssignWithCopy(IGF, dest, src, T);
+  }
+
   void assignWithTake(IRGenFunction &IGF, Address dest,
                       Address src, SILType T) const override {
     auto offsets = asImpl().getNonFixedOffsets(IGF, T);
@@ -169,15 +298,14 @@ public:
                LoadableTypeInfo::initializeWithCopy(IGF, dest, src, T);
     }
 
-    auto offsets = asImpl().getNonFixedOffsets(IGF, T);
-    for (auto &field : getFields()) {
-      if (field.isEmpty()) continue;
-
-      Address destField = field.projectAddress(IGF, dest, offsets);
-      Address srcField = field.projectAddress(IGF, src, offsets);
-      field.getTypeInfo().initializeWithCopy(IGF, destField, srcField,
-                                             field.getType(IGF.IGM, T));
+    if (shouldOutlineValueOperations(T)) {
+      emitOutlinedBinaryOp(IGF, "initWithCopy", dest, src, T,
+                           [&](IRGenFunction &IGF, Address dest, Address src) {
+        emitInitializeWithCopy(IGF, dest, src, T);
+      });
+      return;
     }
+    emitInitializeWithCopy(IGF, dest, src, T);
   }
   
   void initializeWithTake(IRGenFunction &IGF,
@@ -203,13 +331,14 @@ public:
   }
 
   void destroy(IRGenFunction &IGF, Address addr, SILType T) const override {
-    auto offsets = asImpl().getNonFixedOffsets(IGF, T);
-    for (auto &field : getFields()) {
-      if (field.isPOD()) continue;
-
-      field.getTypeInfo().destroy(IGF, field.projectAddress(IGF, addr, offsets),
-                                  field.getType(IGF.IGM, T));
+    if (shouldOutlineValueOperations(T)) {
+      emitOutlinedUnaryOp(IGF, "destroy", addr, T,
+                          [&](IRGenFunction &IGF, Address addr) {
+        emitDestroy(IGF, addr, T);
+      });
+      return;
     }
+    emitDestroy(IGF, addr, T);
   }
 };
 
@@ -22,6 +22,7 @@
 #include "swift/Reflection/MetadataSourceBuilder.h"
 #include "swift/Reflection/Records.h"
 #include "swift/SIL/SILModule.h"
+#include "llvm/Support/Format.h"
 
 #include "ConstantBuilder.h"
 #include "GenClass.h"
@@ -798,11 +799,44 @@ std::string IRGenModule::getReflectionTypeRefSectionName() {
   return getReflectionSectionName(*this, "typeref", "tyrf");
 }
 
+/// Search the already-emitted strings in \p cache for one which has \p Str
+/// as a proper suffix. Reflection strings are null-terminated and referenced
+/// by offset, so such a string can be addressed by pointing into the tail of
+/// the longer one; the longer string's terminator serves both.
+static llvm::Constant *getAddrOfSharedStringSuffix(
+    IRGenModule &IGM,
+    const llvm::StringMap<std::pair<llvm::GlobalVariable *, llvm::Constant *>>
+        &cache,
+    StringRef Str) {
+  for (auto &entry : cache) {
+    StringRef existing = entry.getKey();
+    // Entries which are themselves tails of another string have a null
+    // global; the string they point into already covers our suffix search.
+    if (!entry.getValue().first || !existing.endswith(Str) ||
+        existing.size() == Str.size())
+      continue;
+
+    auto *global = entry.getValue().first;
+    llvm::Constant *indices[] = {
+      llvm::ConstantInt::get(IGM.SizeTy, 0),
+      llvm::ConstantInt::get(IGM.SizeTy, existing.size() - Str.size())
+    };
+    return llvm::ConstantExpr::getInBoundsGetElementPtr(
+        global->getValueType(), global, indices);
+  }
+  return nullptr;
+}
+
 llvm::Constant *IRGenModule::getAddrOfFieldName(StringRef Name) {
   auto &entry = FieldNames[Name];
   if (entry.second)
     return entry.second;
 
+  if (auto addr = getAddrOfSharedStringSuffix(*this, FieldNames, Name)) {
+    entry = {nullptr, addr};
+    return addr;
+  }
+
   entry = createStringConstant(Name, /*willBeRelativelyAddressed*/ true,
                                getReflectionStringsSectionName());
   return entry.second;
@@ -813,6 +847,11 @@ llvm::Constant *IRGenModule::getAddrOfStringForTypeRef(StringRef Str) {
   if (entry.second)
     return entry.second;
 
+  if (auto addr = getAddrOfSharedStringSuffix(*this, StringsForTypeRef, Str)) {
+    entry = {nullptr, addr};
+    return addr;
+  }
+
   entry = createStringConstant(Str, /*willBeRelativelyAddressed*/ true,
                                getReflectionTypeRefSectionName());
   return entry.second;
@@ -852,11 +891,31 @@ IRGenModule::getAddrOfCaptureDescriptor(SILFunction &Caller,
   return llvm::ConstantExpr::getBitCast(var, CaptureDescriptorPtrTy);
 }
 
+/// Returns true if the given nominal type opted out of reflection metadata
+/// with the @_no_reflection_metadata attribute.
+static bool suppressesReflectionMetadata(const NominalTypeDecl *Decl) {
+  return Decl->getAttrs().hasAttribute<NoReflectionMetadataAttr>();
+}
+
+/// Records the size of an emitted reflection record for the
+/// -print-reflection-metadata-sizes report.
+static void recordReflectionRecordSize(IRGenModule &IGM, StringRef Label,
+                                       llvm::GlobalVariable *var) {
+  if (!var || !IGM.IRGen.Opts.EnableReflectionSizeReport)
+    return;
+  IGM.ReflectionMetadataSizes.push_back(
+      {Label.str(), IGM.DataLayout.getTypeAllocSize(var->getValueType())});
+}
+
 void IRGenModule::
 emitAssociatedTypeMetadataRecord(const ProtocolConformance *Conformance) {
   if (!IRGen.Opts.EnableReflectionMetadata)
     return;
 
+  if (auto Nominal = Conformance->getType()->getAnyNominal())
+    if (suppressesReflectionMetadata(Nominal))
+      return;
+
   SmallVector<std::pair<StringRef, CanType>, 2> AssociatedTypes;
 
   auto collectTypeWitness = [&](const AssociatedTypeDecl *AssocTy,
@@ -882,8 +941,17 @@ emitAssociatedTypeMetadataRecord(const ProtocolConformance *Conformance) {
 
   AssociatedTypeMetadataBuilder builder(*this, Conformance, AssociatedTypes);
   auto var = builder.emit();
-  if (var)
+  if (var) {
     addUsedGlobal(var);
+
+    SmallString<64> Label;
+    {
+      llvm::raw_svector_ostream OS(Label);
+      Conformance->getType().print(OS);
+      OS << " : " << Conformance->getProtocol()->getName();
+    }
+    recordReflectionRecordSize(*this, Label, var);
+  }
 }
 
 void IRGenModule::emitBuiltinReflectionMetadata() {
@@ -925,10 +993,15 @@ void IRGenModule::emitFieldMetadataRecord(const NominalTypeDecl *Decl) {
   if (!IRGen.Opts.EnableReflectionMetadata)
     return;
 
+  if (suppressesReflectionMetadata(Decl))
+    return;
+
   FieldTypeMetadataBuilder builder(*this, Decl);
   auto var = builder.emit();
-  if (var)
+  if (var) {
     addUsedGlobal(var);
+    recordReflectionRecordSize(*this, Decl->getNameStr(), var);
+  }
 }
 
 void IRGenModule::emitReflectionMetadataVersion() {
@@ -941,3 +1014,42 @@ void IRGenModule::emitReflectionMetadataVersion() {
   Version->setVisibility(llvm::GlobalValue::HiddenVisibility);
   addUsedGlobal(Version);
 }
+
+void IRGenModule::printReflectionMetadataSizeReport(llvm::raw_ostream &os) {
+  os << "Reflection metadata sizes for module '"
+     << getSwiftModule()->getName() << "':\n";
+
+  std::stable_sort(ReflectionMetadataSizes.begin(),
+                   ReflectionMetadataSizes.end(),
+                   [](const std::pair<std::string, uint64_t> &lhs,
+                      const std::pair<std::string, uint64_t> &rhs) {
+                     return lhs.second > rhs.second;
+                   });
+
+  uint64_t recordBytes = 0;
+  for (auto &entry : ReflectionMetadataSizes) {
+    os << "  " << llvm::format_decimal(entry.second, 8) << "  "
+       << entry.first << "\n";
+    recordBytes += entry.second;
+  }
+
+  // The string sections are shared between the records above, so they are
+  // only reported as totals.
+  uint64_t fieldNameBytes = 0;
+  uint64_t typeRefBytes = 0;
+  auto fieldNameSection = getReflectionStringsSectionName();
+  auto typeRefSection = getReflectionTypeRefSectionName();
+  for (auto &global : Module.globals()) {
+    if (!global.hasInitializer())
+      continue;
+    auto size = DataLayout.getTypeAllocSize(global.getValueType());
+    if (global.getSection() == fieldNameSection)
+      fieldNameBytes += size;
+    else if (global.getSection() == typeRefSection)
+      typeRefBytes += size;
+  }
+
+  os << "  type records: " << recordBytes << " bytes\n";
+  os << "  field name strings (shared): " << fieldNameBytes << " bytes\n";
+  os << "  type reference strings (shared): " << typeRefBytes << " bytes\n";
+}
@@ -827,7 +827,12 @@ irgen::getPhysicalStructMemberAccessStrategy(IRGenModule &IGM,
 }
 
 void IRGenModule::emitStructDecl(StructDecl *st) {
-  emitStructMetadata(*this, st);
+  // Lazily-emitted metadata is only generated when a use triggers it
+  // through getAddrOfTypeMetadata; unused private types then cost neither
+  // metadata nor a value witness table.
+  if (!isTypeMetadataEmittedLazily(
+          st->getDeclaredType()->getCanonicalType()))
+    emitStructMetadata(*this, st);
   emitNestedTypeDecls(st->getMembers());
   emitFieldMetadataRecord(st);
 }
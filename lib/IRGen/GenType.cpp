@@ -619,9 +619,7 @@ TypeConverter::createPrimitiveForAlignedPointer(llvm::PointerType *type,
                                                 Alignment align,
                                                 Alignment pointerAlignment) {
   SpareBitVector spareBits = IGM.TargetInfo.PointerSpareBits;
-  for (unsigned bit = 0; Alignment(1 << bit) != pointerAlignment; ++bit) {
-    spareBits.setBit(bit);
-  }
+  spareBits.setRange(0, llvm::Log2_32(pointerAlignment.getValue()));
 
   return new PrimitiveTypeInfo(type, size, std::move(spareBits), align);
 }
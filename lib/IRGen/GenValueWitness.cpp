@@ -965,6 +965,49 @@ static llvm::Constant *getDestroyStrongFunction(IRGenModule &IGM) {
   });
 }
 
+/// Return a function which takes a pointer, a count, and a metadata
+/// argument and releases an array of single refcounted pointers by
+/// calling the bulk release entrypoint on it.
+static llvm::Constant *getDestroyStrongArrayFunction(IRGenModule &IGM) {
+  llvm::Type *ptrPtrTy = IGM.RefCountedPtrTy->getPointerTo();
+  llvm::Type *argTys[] = { ptrPtrTy, IGM.SizeTy, IGM.WitnessTablePtrTy };
+  return IGM.getOrCreateHelperFunction("__swift_destroyArray_strong",
+                                       IGM.VoidTy, argTys,
+                                       [&](IRGenFunction &IGF) {
+    auto it = IGF.CurFn->arg_begin();
+    llvm::Value *array = &*(it++);
+    llvm::Value *count = &*(it++);
+    IGF.Builder.CreateCall(IGF.IGM.getNativeBulkReleaseFn(), {array, count});
+    IGF.Builder.CreateRetVoid();
+  });
+}
+
+/// Return a function which takes two pointers, a count, and a metadata
+/// argument and initializes an array of single refcounted pointers from
+/// another such array: it memcpys the references over and then bulk-retains
+/// them, rather than retaining them one load at a time.
+static llvm::Constant *getInitWithCopyStrongArrayFunction(IRGenModule &IGM) {
+  llvm::Type *ptrPtrTy = IGM.RefCountedPtrTy->getPointerTo();
+  llvm::Type *argTys[] = { ptrPtrTy, ptrPtrTy, IGM.SizeTy,
+                           IGM.WitnessTablePtrTy };
+  return IGM.getOrCreateHelperFunction("__swift_initWithCopyArray_strong",
+                                       ptrPtrTy, argTys,
+                                       [&](IRGenFunction &IGF) {
+    auto it = IGF.CurFn->arg_begin();
+    Address dest(&*(it++), IGM.getPointerAlignment());
+    Address src(&*(it++), IGM.getPointerAlignment());
+    llvm::Value *count = &*(it++);
+    llvm::Value *stride
+      = llvm::ConstantInt::get(IGM.SizeTy, IGM.getPointerSize().getValue());
+    llvm::Value *byteCount = IGF.Builder.CreateNUWMul(count, stride);
+    IGF.Builder.CreateMemCpy(dest.getAddress(), src.getAddress(), byteCount,
+                             IGM.getPointerAlignment().getValue());
+    IGF.Builder.CreateCall(IGF.IGM.getNativeBulkRetainFn(),
+                           {dest.getAddress(), count});
+    IGF.Builder.CreateRet(dest.getAddress());
+  });
+}
+
 /// Return a function which takes two pointer arguments, memcpys
 /// from the second to the first, and returns the first argument.
 static llvm::Constant *getMemCpyFunction(IRGenModule &IGM,
@@ -1123,9 +1166,9 @@ static llvm::Constant *getValueWitness(IRGenModule &IGM,
   case ValueWitness::DestroyArray:
     if (concreteTI.isPOD(ResilienceExpansion::Maximal)) {
       return asOpaquePtr(IGM, getNoOpVoidFunction(IGM));
+    } else if (concreteTI.isSingleSwiftRetainablePointer(ResilienceExpansion::Maximal)) {
+      return asOpaquePtr(IGM, getDestroyStrongArrayFunction(IGM));
     }
-    // TODO: A standard "destroy strong array" entrypoint for arrays of single
-    // refcounted pointer types.
     goto standard;
 
   case ValueWitness::InitializeBufferWithCopyOfBuffer:
@@ -1199,9 +1242,9 @@ static llvm::Constant *getValueWitness(IRGenModule &IGM,
   case ValueWitness::InitializeArrayWithCopy:
     if (concreteTI.isPOD(ResilienceExpansion::Maximal)) {
       return asOpaquePtr(IGM, getMemCpyArrayFunction(IGM, concreteTI));
+    } else if (concreteTI.isSingleSwiftRetainablePointer(ResilienceExpansion::Maximal)) {
+      return asOpaquePtr(IGM, getInitWithCopyStrongArrayFunction(IGM));
     }
-    // TODO: A standard "copy strong array" entrypoint for arrays of single
-    // refcounted pointer types.
     goto standard;
 
   case ValueWitness::AllocateBuffer:
@@ -1355,6 +1398,41 @@ static void addValueWitnessesForAbstractType(IRGenModule &IGM,
                     concreteLoweredType, concreteTI, witnesses);
 }
 
+/// Return a value witness table exported by the runtime (see KnownMetadata)
+/// that can be shared by the given type, or null if it needs its own table.
+///
+/// A type can use the table of a builtin integer type if it is trivially
+/// copyable and movable, has no extra inhabitants, and is stored at its
+/// natural alignment; the witnesses then degenerate to the same memcpy and
+/// no-op destroy the builtin table contains. Sharing the table avoids
+/// emitting a table plus up to a dozen witness functions for every small
+/// POD struct in the module.
+static llvm::Constant *getCommonValueWitnessTable(IRGenModule &IGM,
+                                                  CanType abstractType) {
+  CanType concreteFormalType = getFormalTypeInContext(abstractType);
+  auto concreteLoweredType = IGM.getLoweredType(concreteFormalType);
+  auto *fixedTI = dyn_cast<FixedTypeInfo>(
+      &IGM.getTypeInfo(concreteLoweredType));
+  if (!fixedTI)
+    return nullptr;
+
+  if (!fixedTI->isPOD(ResilienceExpansion::Maximal) ||
+      !fixedTI->isBitwiseTakable(ResilienceExpansion::Maximal) ||
+      fixedTI->getFixedExtraInhabitantCount(IGM) != 0)
+    return nullptr;
+
+  unsigned size = fixedTI->getFixedSize().getValue();
+  unsigned align = fixedTI->getFixedAlignment().getValue();
+
+  if (size != 0 && size == align &&
+      (size == 1 || size == 2 || size == 4 || size == 8 || size == 16 ||
+       size == 32))
+    return IGM.getAddrOfValueWitnessTable(
+        BuiltinIntegerType::get(size * 8, IGM.Context)->getCanonicalType());
+
+  return nullptr;
+}
+
 /// Emit a value-witness table for the given type, which is assumed to
 /// be non-dependent.
 llvm::Constant *irgen::emitValueWitnessTable(IRGenModule &IGM,
@@ -1363,6 +1441,13 @@ llvm::Constant *irgen::emitValueWitnessTable(IRGenModule &IGM,
   assert(!isa<BoundGenericType>(abstractType) &&
          "emitting VWT for generic instance");
 
+  // Reuse a common table from the runtime if the layout allows it. Builtin
+  // types are themselves the owners of those tables, so they always get the
+  // full emission below.
+  if (!isa<BuiltinType>(abstractType))
+    if (auto *commonTable = getCommonValueWitnessTable(IGM, abstractType))
+      return commonTable;
+
   SmallVector<llvm::Constant*, MaxNumValueWitnesses> witnesses;
   bool canBeConstant = false;
   addValueWitnessesForAbstractType(IGM, abstractType, witnesses, canBeConstant);
@@ -154,7 +154,10 @@ void swift::performLLVMOptimizations(IRGenOptions &Opts, llvm::Module *Module,
     PMBuilder.Inliner = llvm::createFunctionInliningPass(200);
     PMBuilder.SLPVectorize = true;
     PMBuilder.LoopVectorize = true;
-    PMBuilder.MergeFunctions = true;
+    // Function merging is handled by SwiftMergeFunctions (which also merges
+    // functions that only differ in constants); don't run LLVM's generic
+    // merge pass on the whole module a second time.
+    PMBuilder.MergeFunctions = false;
   } else {
     PMBuilder.OptLevel = 0;
     if (!Opts.DisableLLVMOptzns)
@@ -860,6 +863,10 @@ static void performParallelIRGeneration(IRGenOptions &Opts,
   // Bail out if there are any errors.
   if (Ctx.hadError()) return;
 
+  // Hand out the expensive modules first, so that one big source file at the
+  // end of the queue does not serialize the tail of the compilation.
+  irgen.sortQueueByCost();
+
   std::vector<std::thread> Threads;
   llvm::sys::Mutex DiagMutex;
 
@@ -1008,6 +1008,9 @@ void IRGenModule::cleanupClangCodeGenMetadata() {
 }
 
 bool IRGenModule::finalize() {
+  if (IRGen.Opts.EnableReflectionSizeReport)
+    printReflectionMetadataSizeReport(llvm::errs());
+
   const char *ModuleHashVarName = "llvm.swift_module_hash";
   if (IRGen.Opts.OutputKind == IRGenOutputKind::ObjectFile &&
       !Module.getGlobalVariable(ModuleHashVarName)) {
@@ -1086,6 +1089,27 @@ void IRGenerator::addGenModule(SourceFile *SF, IRGenModule *IGM) {
   Queue.push_back(IGM);
 }
 
+void IRGenerator::sortQueueByCost() {
+  // The queue is drained in order and each module runs on whichever thread
+  // gets to it first, so a large module fetched late keeps one thread busy
+  // long after the others have finished. Schedule the most expensive modules
+  // first. The LLVM instruction count is a good-enough proxy for the time the
+  // backend will spend on a module, and counting it is trivial next to
+  // running the passes themselves.
+  llvm::DenseMap<IRGenModule *, uint64_t> Costs;
+  for (IRGenModule *IGM : Queue) {
+    uint64_t NumInsts = 0;
+    for (llvm::Function &F : IGM->getModule()->getFunctionList())
+      for (llvm::BasicBlock &BB : F)
+        NumInsts += BB.size();
+    Costs[IGM] = NumInsts;
+  }
+  std::stable_sort(Queue.begin(), Queue.end(),
+                   [&](IRGenModule *LHS, IRGenModule *RHS) {
+    return Costs[LHS] > Costs[RHS];
+  });
+}
+
 IRGenModule *IRGenerator::getGenModule(DeclContext *ctxt) {
   if (GenModules.size() == 1 || !ctxt) {
     return getPrimaryIGM();
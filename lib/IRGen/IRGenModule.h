@@ -308,6 +308,11 @@ public:
     return it->second;
   }
   
+  /// In multi-threaded compilation order the queue so that the most expensive
+  /// modules are fetched first. Must be called before any thread starts
+  /// draining the queue.
+  void sortQueueByCost();
+
   /// In multi-threaded compilation fetch the next IRGenModule from the queue.
   IRGenModule *fetchFromQueue() {
     int idx = QueueIndex++;
@@ -736,6 +741,10 @@ public:
   /// reflection metadata.
   llvm::SetVector<const ProtocolDecl *> ImportedProtocols;
 
+  /// Sizes of the per-type reflection records emitted into this module,
+  /// collected for -print-reflection-metadata-sizes.
+  std::vector<std::pair<std::string, uint64_t>> ReflectionMetadataSizes;
+
   llvm::Constant *getAddrOfStringForTypeRef(StringRef Str);
   llvm::Constant *getAddrOfFieldName(StringRef Name);
   llvm::Constant *getAddrOfCaptureDescriptor(SILFunction &caller,
@@ -749,6 +758,7 @@ public:
   void emitFieldMetadataRecord(const NominalTypeDecl *Decl);
   void emitBuiltinReflectionMetadata();
   void emitReflectionMetadataVersion();
+  void printReflectionMetadataSizeReport(llvm::raw_ostream &os);
   std::string getBuiltinTypeMetadataSectionName();
   std::string getFieldTypeMetadataSectionName();
   std::string getAssociatedTypeMetadataSectionName();
@@ -22,6 +22,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/ADT/TinyPtrVector.h"
@@ -381,9 +382,15 @@ public:
 
   llvm::MapVector<SILBasicBlock *, LoweredBB> LoweredBBs;
   
-  // Destination basic blocks for condfail traps.
+  // Destination basic blocks for condfail traps and other cold blocks,
+  // moved to the end of the function after emission.
   llvm::SmallVector<llvm::BasicBlock *, 8> FailBBs;
 
+  // SIL blocks which can never reach a function exit; they are laid out
+  // after the rest of the function and branches into them are marked as
+  // unlikely.
+  llvm::SmallPtrSet<SILBasicBlock *, 8> ColdBlocks;
+
   SILFunction *CurSILFn;
   Address IndirectReturn;
 
@@ -1345,6 +1352,40 @@ void IRGenModule::emitSILFunction(SILFunction *f) {
   IRGenSILFunction(*this, f).emitSILFunction();
 }
 
+/// Find the blocks of \p F which can never reach a function exit. Every
+/// path from them ends in 'unreachable', so they are statically cold:
+/// error reporting, trap paths, and the like.
+static void findColdBlocks(SILFunction *F,
+                        llvm::SmallPtrSetImpl<SILBasicBlock *> &coldBlocks) {
+  // Walk backwards from the function exits.
+  llvm::SmallPtrSet<SILBasicBlock *, 16> canReachExit;
+  SmallVector<SILBasicBlock *, 8> workList;
+  for (SILBasicBlock &BB : *F) {
+    TermInst *term = BB.getTerminator();
+    if (isa<ReturnInst>(term) || isa<ThrowInst>(term)) {
+      canReachExit.insert(&BB);
+      workList.push_back(&BB);
+    }
+  }
+  while (!workList.empty()) {
+    SILBasicBlock *BB = workList.pop_back_val();
+    for (SILBasicBlock *pred : BB->getPreds()) {
+      if (canReachExit.insert(pred).second)
+        workList.push_back(pred);
+    }
+  }
+
+  // If even the entry cannot reach an exit, the whole function is cold and
+  // there is nothing to split.
+  if (!canReachExit.count(&*F->begin()))
+    return;
+
+  for (SILBasicBlock &BB : *F) {
+    if (!canReachExit.count(&BB))
+      coldBlocks.insert(&BB);
+  }
+}
+
 void IRGenSILFunction::emitSILFunction() {
   DEBUG(llvm::dbgs() << "emitting SIL function: ";
         CurSILFn->printName(llvm::dbgs());
@@ -1353,6 +1394,8 @@ void IRGenSILFunction::emitSILFunction() {
   
   assert(!CurSILFn->empty() && "function has no basic blocks?!");
 
+  findColdBlocks(CurSILFn, ColdBlocks);
+
   // Configure the dominance resolver.
   // TODO: consider re-using a dom analysis from the PassManager
   // TODO: consider using a cheaper analysis at -O0
@@ -1529,6 +1572,13 @@ void IRGenSILFunction::visitSILBasicBlock(SILBasicBlock *BB) {
   llvm::BasicBlock *llBB = getLoweredBB(BB).bb;
   Builder.SetInsertPoint(llBB);
 
+  // Lay out statically cold blocks after the rest of the function, like
+  // the cond_fail traps. Blocks consisting of nothing but a terminator
+  // (e.g. the unreachable default of a fully covered switch) are left in
+  // place; moving them buys nothing.
+  if (ColdBlocks.count(BB) && &*BB->begin() != BB->getTerminator())
+    FailBBs.push_back(llBB);
+
   bool InEntryBlock = BB->pred_empty();
   bool ArgsEmitted = false;
 
@@ -3008,7 +3058,19 @@ void IRGenSILFunction::visitCondBranchInst(swift::CondBranchInst *i) {
   addIncomingSILArgumentsToPHINodes(*this, trueBB, i->getTrueArgs());
   addIncomingSILArgumentsToPHINodes(*this, falseBB, i->getFalseArgs());
 
-  Builder.CreateCondBr(condValue, trueBB.bb, falseBB.bb);
+  auto *Br = Builder.CreateCondBr(condValue, trueBB.bb, falseBB.bb);
+
+  // If exactly one successor is statically cold, mark the branch as
+  // strongly biased towards the other side so that block placement keeps
+  // the hot path straight.
+  bool TrueIsCold = ColdBlocks.count(i->getTrueBB());
+  bool FalseIsCold = ColdBlocks.count(i->getFalseBB());
+  if (TrueIsCold != FalseIsCold) {
+    llvm::MDBuilder MDHelper(IGM.getLLVMContext());
+    Br->setMetadata(llvm::LLVMContext::MD_prof,
+                    MDHelper.createBranchWeights(TrueIsCold ? 1 : 2000,
+                                                 TrueIsCold ? 2000 : 1));
+  }
 }
 
 void IRGenSILFunction::visitRetainValueInst(swift::RetainValueInst *i) {
@@ -4730,57 +4792,54 @@ void IRGenSILFunction::visitClassMethodInst(swift::ClassMethodInst *i) {
   setLoweredExplosion(i, e);
 }
 
-static llvm::Constant *getConstantValue(IRGenModule &IGM, llvm::StructType *STy,
-                                        TupleInst *TI);
-
-/// Generate ConstantStruct for StructInst.
-static llvm::Constant *getConstantValue(IRGenModule &IGM, llvm::StructType *STy,
-                                        StructInst *SI) {
-  SmallVector<llvm::Constant*, 32> Elts;
-  assert(SI->getNumOperands() == STy->getNumElements() &&
-         "mismatch StructInst with its lowered StructType!");
-  for (unsigned i = 0, e = STy->getNumElements(); i != e; ++i) {
-    if (auto *Elem = dyn_cast<StructInst>(SI->getOperand(i)))
-      Elts.push_back(getConstantValue(IGM,
-                     cast<llvm::StructType>(STy->getElementType(i)), Elem));
-    else if (auto *Elem = dyn_cast<TupleInst>(SI->getOperand(i)))
-      Elts.push_back(getConstantValue(IGM,
-                     cast<llvm::StructType>(STy->getElementType(i)), Elem));
-    else if (auto *ILI = dyn_cast<IntegerLiteralInst>(SI->getOperand(i)))
-      Elts.push_back(getConstantInt(IGM, ILI));
-    else if (auto *FLI = dyn_cast<FloatLiteralInst>(SI->getOperand(i)))
-      Elts.push_back(getConstantFP(IGM, FLI));
-    else if (auto *SLI = dyn_cast<StringLiteralInst>(SI->getOperand(i)))
-      Elts.push_back(getAddrOfString(IGM, SLI->getValue(), SLI->getEncoding()));
-    else
-      llvm_unreachable("Unexpected SILInstruction in static initializer!");
+static llvm::Constant *getConstantAggregate(IRGenModule &IGM,
+                                            llvm::StructType *STy,
+                                            SILInstruction *I);
+
+/// Generate the constant for a single element of a static initializer.
+static llvm::Constant *getConstantValue(IRGenModule &IGM, llvm::Type *Ty,
+                                        SILValue operand) {
+  if (auto *SI = dyn_cast<StructInst>(operand))
+    return getConstantAggregate(IGM, cast<llvm::StructType>(Ty), SI);
+  if (auto *TI = dyn_cast<TupleInst>(operand))
+    return getConstantAggregate(IGM, cast<llvm::StructType>(Ty), TI);
+  if (auto *ILI = dyn_cast<IntegerLiteralInst>(operand))
+    return getConstantInt(IGM, ILI);
+  if (auto *FLI = dyn_cast<FloatLiteralInst>(operand))
+    return getConstantFP(IGM, FLI);
+  if (auto *SLI = dyn_cast<StringLiteralInst>(operand))
+    return getAddrOfString(IGM, SLI->getValue(), SLI->getEncoding());
+  if (auto *FRI = dyn_cast<FunctionRefInst>(operand)) {
+    auto *fn = IGM.getAddrOfSILFunction(FRI->getReferencedFunction(),
+                                        NotForDefinition);
+    return llvm::ConstantExpr::getBitCast(fn, Ty);
+  }
+  if (auto *BI = dyn_cast<BuiltinInst>(operand)) {
+    switch (BI->getBuiltinInfo().ID) {
+    case BuiltinValueKind::FPTrunc:
+      if (auto *FLI = dyn_cast<FloatLiteralInst>(BI->getArguments()[0]))
+        return llvm::ConstantExpr::getFPTrunc(getConstantFP(IGM, FLI), Ty);
+      break;
+    default:
+      break;
+    }
   }
-  return llvm::ConstantStruct::get(STy, Elts);
+  llvm_unreachable("Unexpected SILInstruction in static initializer!");
 }
 
-
-/// Generate ConstantStruct for StructInst.
-static llvm::Constant *getConstantValue(IRGenModule &IGM, llvm::StructType *STy,
-                                        TupleInst *TI) {
+/// Generate a ConstantStruct from the operands of a StructInst or TupleInst
+/// in a static initializer.
+static llvm::Constant *getConstantAggregate(IRGenModule &IGM,
+                                            llvm::StructType *STy,
+                                            SILInstruction *I) {
+  assert((isa<StructInst>(I) || isa<TupleInst>(I)) &&
+         "unexpected aggregate in static initializer!");
   SmallVector<llvm::Constant*, 32> Elts;
-  assert(TI->getNumOperands() == STy->getNumElements() &&
-         "mismatch StructInst with its lowered StructType!");
-  for (unsigned i = 0, e = STy->getNumElements(); i != e; ++i) {
-    if (auto *Elem = dyn_cast<StructInst>(TI->getOperand(i)))
-      Elts.push_back(getConstantValue(IGM,
-                     cast<llvm::StructType>(STy->getElementType(i)), Elem));
-    else if (auto *Elem = dyn_cast<TupleInst>(TI->getOperand(i)))
-      Elts.push_back(getConstantValue(IGM,
-                     cast<llvm::StructType>(STy->getElementType(i)), Elem));
-    else if (auto *ILI = dyn_cast<IntegerLiteralInst>(TI->getOperand(i)))
-      Elts.push_back(getConstantInt(IGM, ILI));
-    else if (auto *FLI = dyn_cast<FloatLiteralInst>(TI->getOperand(i)))
-      Elts.push_back(getConstantFP(IGM, FLI));
-    else if (auto *SLI = dyn_cast<StringLiteralInst>(TI->getOperand(i)))
-      Elts.push_back(getAddrOfString(IGM, SLI->getValue(), SLI->getEncoding()));
-    else
-      llvm_unreachable("Unexpected SILInstruction in static initializer!");
-  }
+  assert(I->getNumOperands() == STy->getNumElements() &&
+         "mismatch between aggregate and its lowered StructType!");
+  for (unsigned i = 0, e = STy->getNumElements(); i != e; ++i)
+    Elts.push_back(getConstantValue(IGM, STy->getElementType(i),
+                                    I->getOperand(i)));
   return llvm::ConstantStruct::get(STy, Elts);
 }
 
@@ -4802,15 +4861,14 @@ void IRGenModule::emitSILStaticInitializers() {
     auto *InitValue = Global.getValueOfStaticInitializer();
 
     // Set the IR global's initializer to the constant for this SIL
-    // struct.
-    if (auto *SI = dyn_cast<StructInst>(InitValue)) {
-      IRGlobal->setInitializer(getConstantValue(*this, STy, SI));
-      continue;
-    }
-
-    // Set the IR global's initializer to the constant for this SIL
-    // tuple.
-    auto *TI = cast<TupleInst>(InitValue);
-    IRGlobal->setInitializer(getConstantValue(*this, STy, TI));
+    // struct or tuple.
+    IRGlobal->setInitializer(getConstantAggregate(*this, STy, InitValue));
+
+    // A 'let' global with a static initializer is never stored to again:
+    // the "once" initializer was folded away when the static value was
+    // recognized. Emit it as a true LLVM constant so it lands in
+    // read-only, shareable pages.
+    if (Global.isLet())
+      IRGlobal->setConstant(true);
   }
 }
@@ -137,7 +137,14 @@ SwiftTargetInfo SwiftTargetInfo::get(IRGenModule &IGM) {
   // -1 as ABI for the "done" value.
   if (triple.isOSDarwin())
     target.OnceDonePredicateValue = -1L;
-  // TODO: Do we know this for Linux?
+  // On Linux, swift_once is implemented with std::call_once, which libstdc++
+  // lowers onto glibc's pthread_once; its token is atomically incremented
+  // from 0 to 1 to 2 during initialization, so 2 is the "done" value. The
+  // runtime already depends on this layout (see the FIXME in
+  // stdlib/public/runtime/Once.cpp), so the inline fast path adds no new
+  // assumption.
+  else if (triple.isOSLinux())
+    target.OnceDonePredicateValue = 2L;
   
   switch (triple.getArch()) {
   case llvm::Triple::x86_64:
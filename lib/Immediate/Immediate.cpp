@@ -27,15 +27,25 @@
 #include "swift/Frontend/Frontend.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/Basic/LLVM.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Config/config.h"
-#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LambdaResolver.h"
+#include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Mangler.h"
 #include "llvm/Linker/Linker.h"
-#include "llvm/Transforms/IPO.h"
-#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/Path.h"
 
 #if defined(_MSC_VER)
@@ -289,6 +299,99 @@ bool swift::immediate::IRGenImportedModules(
   return hadError;
 }
 
+namespace {
+
+/// An ORC-based JIT stack which compiles each function the first time it
+/// is called.
+///
+/// The module produced by IRGen is handed over whole, but every function
+/// body is hidden behind an indirect stub; calling a stub triggers codegen
+/// of just that function.  Script startup therefore only pays for the
+/// functions the main path actually executes, instead of the whole module.
+class LazyFunctionJIT {
+  using ObjectLayerT = llvm::orc::ObjectLinkingLayer<>;
+  using CompileLayerT = llvm::orc::IRCompileLayer<ObjectLayerT>;
+  using CODLayerT = llvm::orc::CompileOnDemandLayer<CompileLayerT>;
+
+  std::unique_ptr<llvm::TargetMachine> TM;
+  llvm::DataLayout DL;
+  ObjectLayerT ObjectLayer;
+  CompileLayerT CompileLayer;
+  std::unique_ptr<llvm::orc::JITCompileCallbackManager> CompileCallbackMgr;
+  CODLayerT CODLayer;
+
+public:
+  explicit LazyFunctionJIT(std::unique_ptr<llvm::TargetMachine> TM)
+      : TM(std::move(TM)), DL(this->TM->createDataLayout()),
+        CompileLayer(ObjectLayer, llvm::orc::SimpleCompiler(*this->TM)),
+        CompileCallbackMgr(llvm::orc::createLocalCompileCallbackManager(
+            this->TM->getTargetTriple(), 0)),
+        CODLayer(CompileLayer,
+                 [](llvm::Function &F) {
+                   // Compile single functions per stub invocation.
+                   return std::set<llvm::Function *>({&F});
+                 },
+                 *CompileCallbackMgr,
+                 llvm::orc::createLocalIndirectStubsManagerBuilder(
+                     this->TM->getTargetTriple())) {
+    // Make the symbols of the process image, including the runtime
+    // libraries loaded above, visible to the JIT'd code.
+    llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+  }
+
+  /// Does this target have the support required for lazy compilation
+  /// callbacks and indirect stubs?
+  static bool isSupportedTarget(const llvm::Triple &T) {
+    switch (T.getArch()) {
+    case llvm::Triple::x86:
+    case llvm::Triple::x86_64:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  void addModule(std::unique_ptr<llvm::Module> M) {
+    // Resolve symbols first within the JIT'd code, then against the
+    // process image.
+    auto Resolver = llvm::orc::createLambdaResolver(
+        [this](const std::string &Name) {
+          if (auto Sym = CODLayer.findSymbol(Name, false))
+            return Sym.toRuntimeDyldSymbol();
+          return llvm::RuntimeDyld::SymbolInfo(nullptr);
+        },
+        [](const std::string &Name) {
+          if (auto Addr =
+                llvm::RTDyldMemoryManager::getSymbolAddressInProcess(Name))
+            return llvm::RuntimeDyld::SymbolInfo(
+                Addr, llvm::JITSymbolFlags::Exported);
+          return llvm::RuntimeDyld::SymbolInfo(nullptr);
+        });
+
+    std::vector<std::unique_ptr<llvm::Module>> Ms;
+    Ms.push_back(std::move(M));
+    CODLayer.addModuleSet(std::move(Ms),
+                          llvm::make_unique<llvm::SectionMemoryManager>(),
+                          std::move(Resolver));
+  }
+
+  /// Look up the address of the given unmangled symbol, compiling it
+  /// if necessary.  Returns zero if the symbol is unknown.
+  uint64_t getSymbolAddress(StringRef name) {
+    std::string mangledName;
+    {
+      llvm::raw_string_ostream mangledNameStream(mangledName);
+      llvm::Mangler::getNameWithPrefix(mangledNameStream, name, DL);
+    }
+    auto Sym = CODLayer.findSymbol(mangledName, false);
+    if (!Sym)
+      return 0;
+    return Sym.getAddress();
+  }
+};
+
+} // end anonymous namespace
+
 int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
                           IRGenOptions &IRGenOpts, const SILOptions &SILOpts) {
   ASTContext &Context = CI.getASTContext();
@@ -337,12 +440,8 @@ int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
                            IRGenOpts, SILOpts))
     return -1;
 
-  llvm::PassManagerBuilder PMBuilder;
-  PMBuilder.OptLevel = 2;
-  PMBuilder.Inliner = llvm::createFunctionInliningPass(200);
-
-  // Build the ExecutionEngine.
-  llvm::EngineBuilder builder(std::move(ModuleOwner));
+  // Select a target machine.
+  llvm::EngineBuilder builder;
   std::string ErrorMsg;
   llvm::TargetOptions TargetOpt;
   std::string CPU;
@@ -354,28 +453,63 @@ int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
   builder.setMCPU(CPU);
   builder.setMAttrs(Features);
   builder.setErrorStr(&ErrorMsg);
-  builder.setEngineKind(llvm::EngineKind::JIT);
-  llvm::ExecutionEngine *EE = builder.create();
-  if (!EE) {
-    llvm::errs() << "Error loading JIT: " << ErrorMsg;
+  std::unique_ptr<llvm::TargetMachine> TM(builder.selectTarget());
+  if (!TM || !LazyFunctionJIT::isSupportedTarget(TM->getTargetTriple())) {
+    llvm::errs() << "Error loading JIT: "
+                 << (TM ? "unsupported target" : ErrorMsg.c_str()) << '\n';
     return -1;
   }
 
   DEBUG(llvm::dbgs() << "Module to be executed:\n";
         Module->dump());
 
-  EE->finalizeObject();
-  
+  // Capture the names of the entry points before handing the module over;
+  // building the stubs reorganizes the module's functions.
+  SmallVector<std::string, 8> InitFnNames;
+  for (auto InitFn : InitFns)
+    InitFnNames.push_back(InitFn->getName().str());
+  SmallVector<std::string, 8> CtorNames;
+  for (auto Ctor : llvm::orc::getConstructors(*Module)) {
+    if (Ctor.Func && !Ctor.Func->isDeclaration())
+      CtorNames.push_back(Ctor.Func->getName().str());
+  }
+
+  LazyFunctionJIT JIT(std::move(TM));
+  JIT.addModule(std::move(ModuleOwner));
+
+  // Build a C-style argument vector for the main-like entry points.
+  SmallVector<char *, 32> argv;
+  for (auto &arg : CmdLine)
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  argv.push_back(nullptr);
+  int argc = CmdLine.size();
+
+  using MainFnTy = int (*)(int, char **);
+
   // Run the generated program.
-  for (auto InitFn : InitFns) {
+  for (auto &InitFnName : InitFnNames) {
     DEBUG(llvm::dbgs() << "Running initialization function "
-            << InitFn->getName() << '\n');
-    EE->runFunctionAsMain(InitFn, CmdLine, 0);
+            << InitFnName << '\n');
+    auto InitFnAddr = JIT.getSymbolAddress(InitFnName);
+    if (!InitFnAddr) {
+      llvm::errs() << "Error loading JIT: initialization function "
+                   << InitFnName << " not found\n";
+      return -1;
+    }
+    ((MainFnTy)InitFnAddr)(argc, argv.data());
   }
 
   DEBUG(llvm::dbgs() << "Running static constructors\n");
-  EE->runStaticConstructorsDestructors(false);
+  for (auto &CtorName : CtorNames) {
+    if (auto CtorAddr = JIT.getSymbolAddress(CtorName))
+      ((void (*)())CtorAddr)();
+  }
+
   DEBUG(llvm::dbgs() << "Running main\n");
-  llvm::Function *EntryFn = Module->getFunction("main");
-  return EE->runFunctionAsMain(EntryFn, CmdLine, 0);
+  auto MainAddr = JIT.getSymbolAddress("main");
+  if (!MainAddr) {
+    llvm::errs() << "Error loading JIT: main not found\n";
+    return -1;
+  }
+  return ((MainFnTy)MainAddr)(argc, argv.data());
 }
@@ -867,32 +867,27 @@ private:
     if (CI.getASTContext().hadError())
       return false;
 
-    // LineModule will get destroy by the following link process.
-    // Make a copy of it to be able to correct produce DumpModule.
+    // Accumulate the line into the dump image before freezing it.
     std::unique_ptr<llvm::Module> SaveLineModule(CloneModule(LineModule.get()));
-    
-    if (!linkLLVMModules(Module, std::move(LineModule))) {
-      return false;
-    }
-
-    std::unique_ptr<llvm::Module> NewModule(CloneModule(Module));
-
-    Module->getFunction("main")->eraseFromParent();
-
-    stripPreviouslyGenerated(*NewModule);
-
     if (!linkLLVMModules(&DumpModule, std::move(SaveLineModule))) {
       return false;
     }
     llvm::Function *DumpModuleMain = DumpModule.getFunction("main");
     DumpModuleMain->setName("repl.line");
-    
-    if (IRGenImportedModules(CI, *NewModule, ImportedModules, InitFns,
+
+    // Code from previously-executed lines is already frozen into the
+    // compiled image held by the JIT.  Strip those definitions out of this
+    // line's module, leaving external declarations that resolve against
+    // that image, so the work per line stays proportional to the line
+    // itself rather than to the whole session.
+    stripPreviouslyGenerated(*LineModule);
+
+    if (IRGenImportedModules(CI, *LineModule, ImportedModules, InitFns,
                              IRGenOpts, SILOpts))
       return false;
-    
-    llvm::Module *TempModule = NewModule.get();
-    EE->addModule(std::move(NewModule));
+
+    llvm::Module *TempModule = LineModule.get();
+    EE->addModule(std::move(LineModule));
 
     EE->finalizeObject();
 
@@ -57,6 +57,10 @@ public:
                                       : SFOrMod.get<Module *>()->getFiles();
   }
 
+  SourceFile *getAsSourceFile() const {
+    return SFOrMod.dyn_cast<SourceFile *>();
+  }
+
   StringRef getFilename() const {
     if (SourceFile *SF = SFOrMod.dyn_cast<SourceFile *>())
       return SF->getFilename();
@@ -927,6 +931,18 @@ IndexSwiftASTWalker::hashFileReference(llvm::hash_code code,
   if (Filename.empty())
     return code;
 
+  // For a source file the contents are already in memory, so hash them
+  // directly: the key then changes exactly when the contents do, and survives
+  // modification-time-only churn from checkouts and build systems that would
+  // otherwise spuriously invalidate a consumer's stored index data.
+  if (SourceFile *SF = SFOrMod.getAsSourceFile()) {
+    if (auto BufID = SF->getBufferID()) {
+      auto Buf = SrcMgr.getLLVMSourceMgr().getMemoryBuffer(BufID.getValue());
+      code = hash_combine(code, Filename);
+      return hash_combine(code, llvm::hash_value(Buf->getBuffer()));
+    }
+  }
+
   // FIXME: FileManager for swift ?
 
   llvm::sys::fs::file_status Status;
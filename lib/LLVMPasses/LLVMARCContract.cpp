@@ -17,6 +17,8 @@
 #include "swift/Basic/Fallthrough.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/InitializePasses.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Transforms/Utils/SSAUpdater.h"
 
@@ -67,14 +69,18 @@ class SwiftARCContractImpl {
   /// Swift RC Identity.
   SwiftRCIdentity *RC;
 
+  /// Alias analysis, used to reason about calls that only access memory
+  /// through their arguments.
+  AAResults *AA;
+
   /// The function that we are processing.
   Function &F;
 
   /// The entry point builder that is used to construct ARC entry points.
   ARCEntryPointBuilder B;
 public:
-  SwiftARCContractImpl(Function &InF, SwiftRCIdentity *InRC)
-    : Changed(false), RC(InRC), F(InF), B(F) {}
+  SwiftARCContractImpl(Function &InF, SwiftRCIdentity *InRC, AAResults *InAA)
+    : Changed(false), RC(InRC), AA(InAA), F(InF), B(F) {}
 
   // The top level run routine of the pass.
   bool run();
@@ -85,6 +91,15 @@ private:
   /// call.
   void
   performRRNOptimization(DenseMap<Value *, LocalState> &PtrToLocalStateMap);
+
+  /// Perform the RRN Optimization for the retains/releases of a single
+  /// pointer.
+  void performRRNOptimization(LocalState &LocalEntry);
+
+  /// Perform the RRN Optimization for just the tracked pointers that \p CI,
+  /// a call that only accesses memory through its arguments, may reach.
+  void performRRNOptimizationForArgMemOnlyCall(
+      CallInst *CI, DenseMap<Value *, LocalState> &PtrToLocalStateMap);
 };
 
 } // end anonymous namespace
@@ -93,167 +108,192 @@ void SwiftARCContractImpl::
 performRRNOptimization(DenseMap<Value *, LocalState> &PtrToLocalStateMap) {
   // Go through all of our pointers and merge all of the retains with the
   // first retain we saw and all of the releases with the last release we saw.
-  llvm::Value *O = nullptr;
-  for (auto &P : PtrToLocalStateMap) {
-    auto &RetainList = P.second.RetainList;
-    if (RetainList.size() > 1) {
-      // Create the retainN call right by the first retain.
-      B.setInsertPoint(RetainList[0]);
-      O = RetainList[0]->getArgOperand(0);
-      auto *RI = RetainList[0];
-      for (auto R : RetainList) {
-        if (B.isAtomic(R)) {
-          RI = R;
-          break;
-        }
-      }
-      B.createRetainN(RC->getSwiftRCIdentityRoot(O), RetainList.size(), RI);
+  for (auto &P : PtrToLocalStateMap)
+    performRRNOptimization(P.second);
+}
 
-      // Replace all uses of the retain instructions with our new retainN and
-      // then delete them.
-      for (auto *Inst : RetainList) {
-        Inst->eraseFromParent();
-        NumRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+void SwiftARCContractImpl::performRRNOptimization(LocalState &LocalEntry) {
+  llvm::Value *O = nullptr;
+  auto &RetainList = LocalEntry.RetainList;
+  if (RetainList.size() > 1) {
+    // Create the retainN call right by the first retain.
+    B.setInsertPoint(RetainList[0]);
+    O = RetainList[0]->getArgOperand(0);
+    auto *RI = RetainList[0];
+    for (auto R : RetainList) {
+      if (B.isAtomic(R)) {
+        RI = R;
+        break;
       }
+    }
+    B.createRetainN(RC->getSwiftRCIdentityRoot(O), RetainList.size(), RI);
 
-      NumRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+    // Replace all uses of the retain instructions with our new retainN and
+    // then delete them.
+    for (auto *Inst : RetainList) {
+      Inst->eraseFromParent();
+      NumRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
     }
-    RetainList.clear();
-
-    auto &ReleaseList = P.second.ReleaseList;
-    if (ReleaseList.size() > 1) {
-      // Create the releaseN call right by the last release.
-      auto *OldCI = ReleaseList[ReleaseList.size() - 1];
-      B.setInsertPoint(OldCI);
-      O = OldCI->getArgOperand(0);
-      auto *RI = OldCI;
-      for (auto R : ReleaseList) {
-        if (B.isAtomic(R)) {
-          RI = R;
-          break;
-        }
-      }
-      B.createReleaseN(RC->getSwiftRCIdentityRoot(O), ReleaseList.size(), RI);
 
-      // Remove all old release instructions.
-      for (auto *Inst : ReleaseList) {
-        Inst->eraseFromParent();
-        NumRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+    NumRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+  }
+  RetainList.clear();
+
+  auto &ReleaseList = LocalEntry.ReleaseList;
+  if (ReleaseList.size() > 1) {
+    // Create the releaseN call right by the last release.
+    auto *OldCI = ReleaseList[ReleaseList.size() - 1];
+    B.setInsertPoint(OldCI);
+    O = OldCI->getArgOperand(0);
+    auto *RI = OldCI;
+    for (auto R : ReleaseList) {
+      if (B.isAtomic(R)) {
+        RI = R;
+        break;
       }
-
-      NumRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
     }
-    ReleaseList.clear();
-
-    auto &UnknownRetainList = P.second.UnknownRetainList;
-    if (UnknownRetainList.size() > 1) {
-      // Create the retainN call right by the first retain.
-      B.setInsertPoint(UnknownRetainList[0]);
-      O = UnknownRetainList[0]->getArgOperand(0);
-      auto *RI = UnknownRetainList[0];
-      for (auto R : UnknownRetainList) {
-        if (B.isAtomic(R)) {
-          RI = R;
-          break;
-        }
-      }
-      B.createUnknownRetainN(RC->getSwiftRCIdentityRoot(O),
-                             UnknownRetainList.size(), RI);
-
-      // Replace all uses of the retain instructions with our new retainN and
-      // then delete them.
-      for (auto *Inst : UnknownRetainList) {
-        Inst->eraseFromParent();
-        NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
-      }
+    B.createReleaseN(RC->getSwiftRCIdentityRoot(O), ReleaseList.size(), RI);
 
-      NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+    // Remove all old release instructions.
+    for (auto *Inst : ReleaseList) {
+      Inst->eraseFromParent();
+      NumRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
     }
-    UnknownRetainList.clear();
-
-    auto &UnknownReleaseList = P.second.UnknownReleaseList;
-    if (UnknownReleaseList.size() > 1) {
-      // Create the releaseN call right by the last release.
-      auto *OldCI = UnknownReleaseList[UnknownReleaseList.size() - 1];
-      B.setInsertPoint(OldCI);
-      O = OldCI->getArgOperand(0);
-      auto *RI = OldCI;
-      for (auto R : UnknownReleaseList) {
-        if (B.isAtomic(R)) {
-          RI = R;
-          break;
-        }
-      }
-      B.createUnknownReleaseN(RC->getSwiftRCIdentityRoot(O),
-                              UnknownReleaseList.size(), RI);
 
-      // Remove all old release instructions.
-      for (auto *Inst : UnknownReleaseList) {
-        Inst->eraseFromParent();
-        NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+    NumRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+  }
+  ReleaseList.clear();
+
+  auto &UnknownRetainList = LocalEntry.UnknownRetainList;
+  if (UnknownRetainList.size() > 1) {
+    // Create the retainN call right by the first retain.
+    B.setInsertPoint(UnknownRetainList[0]);
+    O = UnknownRetainList[0]->getArgOperand(0);
+    auto *RI = UnknownRetainList[0];
+    for (auto R : UnknownRetainList) {
+      if (B.isAtomic(R)) {
+        RI = R;
+        break;
       }
-
-      NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
     }
-    UnknownReleaseList.clear();
-
-    auto &BridgeRetainList = P.second.BridgeRetainList;
-    if (BridgeRetainList.size() > 1) {
-      // Create the releaseN call right by the first retain.
-      auto *OldCI = BridgeRetainList[0];
-      B.setInsertPoint(OldCI);
-      O = OldCI->getArgOperand(0);
-      auto *RI = OldCI;
-      for (auto R : BridgeRetainList) {
-        if (B.isAtomic(R)) {
-          RI = R;
-          break;
-        }
-      }
-      // Bridge retain may modify the input reference before forwarding it.
-      auto *I = B.createBridgeRetainN(RC->getSwiftRCIdentityRoot(O),
-                                      BridgeRetainList.size(), RI);
-
-      // Remove all old retain instructions.
-      for (auto *Inst : BridgeRetainList) {
-        Inst->replaceAllUsesWith(I);
-        Inst->eraseFromParent();
-        NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+    B.createUnknownRetainN(RC->getSwiftRCIdentityRoot(O),
+                           UnknownRetainList.size(), RI);
+
+    // Replace all uses of the retain instructions with our new retainN and
+    // then delete them.
+    for (auto *Inst : UnknownRetainList) {
+      Inst->eraseFromParent();
+      NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+    }
+
+    NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+  }
+  UnknownRetainList.clear();
+
+  auto &UnknownReleaseList = LocalEntry.UnknownReleaseList;
+  if (UnknownReleaseList.size() > 1) {
+    // Create the releaseN call right by the last release.
+    auto *OldCI = UnknownReleaseList[UnknownReleaseList.size() - 1];
+    B.setInsertPoint(OldCI);
+    O = OldCI->getArgOperand(0);
+    auto *RI = OldCI;
+    for (auto R : UnknownReleaseList) {
+      if (B.isAtomic(R)) {
+        RI = R;
+        break;
       }
+    }
+    B.createUnknownReleaseN(RC->getSwiftRCIdentityRoot(O),
+                            UnknownReleaseList.size(), RI);
 
-      NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+    // Remove all old release instructions.
+    for (auto *Inst : UnknownReleaseList) {
+      Inst->eraseFromParent();
+      NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
     }
-    BridgeRetainList.clear();
-
-    auto &BridgeReleaseList = P.second.BridgeReleaseList;
-    if (BridgeReleaseList.size() > 1) {
-      // Create the releaseN call right by the last release.
-      auto *OldCI = BridgeReleaseList[BridgeReleaseList.size() - 1];
-      B.setInsertPoint(OldCI);
-      O = OldCI->getArgOperand(0);
-      auto *RI = OldCI;
-      for (auto R : BridgeReleaseList) {
-        if (B.isAtomic(R)) {
-          RI = R;
-          break;
-        }
+
+    NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+  }
+  UnknownReleaseList.clear();
+
+  auto &BridgeRetainList = LocalEntry.BridgeRetainList;
+  if (BridgeRetainList.size() > 1) {
+    // Create the releaseN call right by the first retain.
+    auto *OldCI = BridgeRetainList[0];
+    B.setInsertPoint(OldCI);
+    O = OldCI->getArgOperand(0);
+    auto *RI = OldCI;
+    for (auto R : BridgeRetainList) {
+      if (B.isAtomic(R)) {
+        RI = R;
+        break;
       }
-      B.createBridgeReleaseN(RC->getSwiftRCIdentityRoot(O),
-                              BridgeReleaseList.size(), RI);
+    }
+    // Bridge retain may modify the input reference before forwarding it.
+    auto *I = B.createBridgeRetainN(RC->getSwiftRCIdentityRoot(O),
+                                    BridgeRetainList.size(), RI);
+
+    // Remove all old retain instructions.
+    for (auto *Inst : BridgeRetainList) {
+      Inst->replaceAllUsesWith(I);
+      Inst->eraseFromParent();
+      NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+    }
 
-      // Remove all old release instructions.
-      for (auto *Inst : BridgeReleaseList) {
-        Inst->eraseFromParent();
-        NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
+    NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+  }
+  BridgeRetainList.clear();
+
+  auto &BridgeReleaseList = LocalEntry.BridgeReleaseList;
+  if (BridgeReleaseList.size() > 1) {
+    // Create the releaseN call right by the last release.
+    auto *OldCI = BridgeReleaseList[BridgeReleaseList.size() - 1];
+    B.setInsertPoint(OldCI);
+    O = OldCI->getArgOperand(0);
+    auto *RI = OldCI;
+    for (auto R : BridgeReleaseList) {
+      if (B.isAtomic(R)) {
+        RI = R;
+        break;
       }
+    }
+    B.createBridgeReleaseN(RC->getSwiftRCIdentityRoot(O),
+                            BridgeReleaseList.size(), RI);
 
-      NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
+    // Remove all old release instructions.
+    for (auto *Inst : BridgeReleaseList) {
+      Inst->eraseFromParent();
+      NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN++;
     }
-    BridgeReleaseList.clear();
+
+    NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN--;
   }
+  BridgeReleaseList.clear();
 }
 
 
+void SwiftARCContractImpl::performRRNOptimizationForArgMemOnlyCall(
+    CallInst *CI, DenseMap<Value *, LocalState> &PtrToLocalStateMap) {
+  // \p CI can only access memory through its pointer arguments, so it can
+  // only manipulate or inspect the reference count of a tracked pointer that
+  // one of those arguments may alias. Merge the lists of just those
+  // pointers; for everything else the merging region stays open across the
+  // call.
+  for (auto &P : PtrToLocalStateMap) {
+    bool CallMayObservePtr = false;
+    for (Value *Arg : CI->arg_operands()) {
+      if (!Arg->getType()->isPointerTy())
+        continue;
+      if (AA->alias(MemoryLocation(Arg), MemoryLocation(P.first)) != NoAlias) {
+        CallMayObservePtr = true;
+        break;
+      }
+    }
+    if (CallMayObservePtr)
+      performRRNOptimization(P.second);
+  }
+}
+
 bool SwiftARCContractImpl::run() {
   // intra-BB retain/release merging.
   DenseMap<Value *, LocalState> PtrToLocalStateMap;
@@ -358,9 +398,20 @@ bool SwiftARCContractImpl::run() {
       // release, we would be introducing an additional copy.
       //
       // Thus if we see an unknown call we merge together all retains and
-      // releases before. This could be made more aggressive through
-      // appropriate alias analysis and usage of LLVM's function attributes to
-      // determine that a function does not touch globals.
+      // releases before.
+      //
+      // We make one attribute-based exception: a call that only accesses
+      // memory through its arguments cannot retain, release, or check the
+      // uniqueness of an object that none of its arguments alias, so it does
+      // not end the merging region for such an object. This keeps
+      // retain/release pairs mergeable across the C library calls (memcpy
+      // and friends) that bridging code interleaves with reference counting.
+      if (auto *CI = dyn_cast<CallInst>(&Inst)) {
+        if (CI->onlyAccessesArgMemory()) {
+          performRRNOptimizationForArgMemOnlyCall(CI, PtrToLocalStateMap);
+          continue;
+        }
+      }
       performRRNOptimization(PtrToLocalStateMap);
     }
 
@@ -374,7 +425,8 @@ bool SwiftARCContractImpl::run() {
 
 bool SwiftARCContract::runOnFunction(Function &F) {
   RC = &getAnalysis<SwiftRCIdentity>();
-  return SwiftARCContractImpl(F, RC).run();
+  AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
+  return SwiftARCContractImpl(F, RC, AA).run();
 }
 
 char SwiftARCContract::ID = 0;
@@ -382,6 +434,7 @@ INITIALIZE_PASS_BEGIN(SwiftARCContract,
                       "swift-arc-contract", "Swift ARC contraction",
                       false, false)
 INITIALIZE_PASS_DEPENDENCY(SwiftRCIdentity)
+INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
 INITIALIZE_PASS_END(SwiftARCContract,
                     "swift-arc-contract", "Swift ARC contraction",
                     false, false)
@@ -393,5 +446,6 @@ llvm::FunctionPass *swift::createSwiftARCContractPass() {
 
 void SwiftARCContract::getAnalysisUsage(llvm::AnalysisUsage &AU) const {
   AU.addRequired<SwiftRCIdentity>();
+  AU.addRequired<llvm::AAResultsWrapperPass>();
   AU.setPreservesCFG();
 }
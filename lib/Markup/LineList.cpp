@@ -42,6 +42,18 @@ std::string LineList::str() const {
   return Result;
 }
 
+LineList LineList::subListToFirstBlankLine() const {
+  size_t End = 0;
+  bool SeenContent = false;
+  for (size_t E = Lines.size(); End != E; ++End) {
+    bool IsBlank = Lines[End].Text.trim().empty();
+    if (IsBlank && SeenContent)
+      break;
+    SeenContent |= !IsBlank;
+  }
+  return LineList(Lines.slice(0, End));
+}
+
 size_t swift::markup::measureIndentation(StringRef Text) {
   size_t Col = 0;
   for (size_t i = 0, e = Text.size(); i != e; ++i) {
@@ -20,6 +20,8 @@
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/LangOptions.h"
 #include "swift/Basic/SourceManager.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/ADT/SmallString.h"
@@ -27,6 +29,11 @@
 #include "llvm/ADT/Twine.h"
 // FIXME: Figure out if this can be migrated to LLVM.
 #include "clang/Basic/CharInfo.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace swift;
 
@@ -306,8 +313,84 @@ static void diagnoseEmbeddedNul(DiagnosticEngine *Diags, const char *Ptr) {
       .fixItRemoveChars(NulLoc, NulEndLoc);
 }
 
+//===----------------------------------------------------------------------===//
+// Vectorized scanning fast paths
+//===----------------------------------------------------------------------===//
+//
+// The lexer spends much of its time advancing over long runs of bytes from a
+// single character class: identifier bodies, comment text, and whitespace.
+// The helpers below classify 16 bytes at a time when SSE2 is available and
+// stop at the first byte that needs the scalar code's attention. Any byte
+// with the high bit set stops the fast path, leaving all UTF-8 validation
+// and diagnostics to the existing slow paths. Without SSE2 they reduce to
+// the scalar tail loops.
+
+#if defined(__SSE2__)
+/// Returns a vector whose bytes are all-ones where the corresponding byte of
+/// \p chunk is in [lo, hi] and zero elsewhere. The comparison is unsigned,
+/// so bytes with the high bit set never match ranges below 0x80.
+static __m128i matchByteRange(__m128i chunk, uint8_t lo, uint8_t hi) {
+  __m128i biased = _mm_sub_epi8(chunk, _mm_set1_epi8(lo));
+  __m128i limited = _mm_min_epu8(biased, _mm_set1_epi8(hi - lo));
+  return _mm_cmpeq_epi8(limited, biased);
+}
+#endif
+
+/// Advances \p ptr over ASCII identifier-continuation bytes ([A-Za-z0-9_$])
+/// and returns the first byte that is not one, without moving past \p end.
+static const char *fastScanIdentifierBody(const char *ptr, const char *end) {
+#if defined(__SSE2__)
+  while (ptr + 16 <= end) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+    __m128i match = _mm_or_si128(
+        _mm_or_si128(matchByteRange(chunk, 'a', 'z'),
+                     matchByteRange(chunk, 'A', 'Z')),
+        _mm_or_si128(matchByteRange(chunk, '0', '9'),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')),
+                                  _mm_cmpeq_epi8(chunk,
+                                                 _mm_set1_epi8('$')))));
+    unsigned mask = _mm_movemask_epi8(match);
+    if (mask != 0xFFFF)
+      return ptr + llvm::countTrailingZeros(mask ^ 0xFFFFu);
+    ptr += 16;
+  }
+#endif
+  while (ptr != end &&
+         (isAlphanumeric(*ptr) || *ptr == '_' || *ptr == '$'))
+    ++ptr;
+  return ptr;
+}
+
+/// Advances \p ptr over plain comment text and returns the first byte that
+/// needs individual handling: '\n', '\r', a nul, or the start of a non-ASCII
+/// sequence. Does not move past \p end.
+static const char *fastScanToEndOfLine(const char *ptr, const char *end) {
+#if defined(__SSE2__)
+  while (ptr + 16 <= end) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+    // Plain comment bytes are 0x01-0x7F minus CR and LF.
+    __m128i match = _mm_andnot_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                     _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))),
+        matchByteRange(chunk, 0x01, 0x7F));
+    unsigned mask = _mm_movemask_epi8(match);
+    if (mask != 0xFFFF)
+      return ptr + llvm::countTrailingZeros(mask ^ 0xFFFFu);
+    ptr += 16;
+  }
+#endif
+  while (ptr != end) {
+    unsigned char c = *ptr;
+    if (c == 0 || c == '\n' || c == '\r' || c >= 0x80)
+      break;
+    ++ptr;
+  }
+  return ptr;
+}
+
 void Lexer::skipToEndOfLine() {
   while (1) {
+    CurPtr = fastScanToEndOfLine(CurPtr, BufferEnd);
     switch (*CurPtr++) {
     case '\n':
     case '\r':
@@ -569,7 +652,11 @@ void Lexer::lexIdentifier() {
   (void) didStart;
 
   // Lex [a-zA-Z_$0-9[[:XID_Continue:]]]*
-  while (advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd));
+  // Consume ASCII runs in bulk; only non-ASCII bytes take the
+  // codepoint-at-a-time path.
+  do {
+    CurPtr = fastScanIdentifierBody(CurPtr, BufferEnd);
+  } while (advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd));
 
   tok Kind = kindOfIdentifier(StringRef(TokStart, CurPtr-TokStart), InSILMode);
   return formToken(Kind, TokStart);
@@ -1538,10 +1625,29 @@ StringRef Lexer::getEncodedStringSegment(StringRef Bytes,
   return StringRef(TempString.begin(), TempString.size());
 }
 
-void Lexer::getStringLiteralSegments(
-              const Token &Str,
-              SmallVectorImpl<StringSegment> &Segments,
-              DiagnosticEngine *Diags) {
+bool Lexer::stringLiteralContainsInterpolation(const Token &Str) {
+  assert(Str.is(tok::string_literal));
+  StringRef Bytes = Str.getText().drop_front().drop_back();
+
+  // Note that it is always safe to read one over the end of "Bytes" because
+  // we know that there is a terminating " character.
+  const char *BytesPtr = Bytes.begin();
+  while (BytesPtr < Bytes.end()) {
+    const void *Backslash = memchr(BytesPtr, '\\', Bytes.end() - BytesPtr);
+    if (!Backslash)
+      return false;
+    BytesPtr = static_cast<const char *>(Backslash) + 1;
+    // The character after the backslash is part of the escape, so it cannot
+    // start another escape itself.
+    if (*BytesPtr++ == '(')
+      return true;
+  }
+  return false;
+}
+
+void Lexer::forEachStringLiteralSegment(
+              const Token &Str, DiagnosticEngine *Diags,
+              llvm::function_ref<void(StringSegment)> Body) {
   assert(Str.is(tok::string_literal));
   // Get the bytes behind the string literal, dropping the double quotes.
   StringRef Bytes = Str.getText().drop_front().drop_back();
@@ -1551,21 +1657,22 @@ void Lexer::getStringLiteralSegments(
   // range check subscripting on the StringRef.
   const char *SegmentStartPtr = Bytes.begin();
   const char *BytesPtr = SegmentStartPtr;
-  // FIXME: Use SSE to scan for '\'.
-  while (BytesPtr != Bytes.end()) {
-    char CurChar = *BytesPtr++;
-    if (CurChar != '\\')
-      continue;
+  // Hop between backslashes with memchr rather than walking a byte at a
+  // time; a literal without escapes is disposed of in a single scan.
+  while (BytesPtr < Bytes.end()) {
+    const void *Backslash = memchr(BytesPtr, '\\', Bytes.end() - BytesPtr);
+    if (!Backslash)
+      break;
+    BytesPtr = static_cast<const char *>(Backslash) + 1;
 
     if (*BytesPtr++ != '(')
       continue;
 
     // String interpolation.
 
-    // Push the current segment.
-    Segments.push_back(
-        StringSegment::getLiteral(getSourceLoc(SegmentStartPtr),
-                                  BytesPtr-SegmentStartPtr-2));
+    // Emit the current segment.
+    Body(StringSegment::getLiteral(getSourceLoc(SegmentStartPtr),
+                                   BytesPtr-SegmentStartPtr-2));
 
     // Find the closing ')'.
     const char *End = skipToEndOfInterpolatedExpression(BytesPtr,
@@ -1575,18 +1682,25 @@ void Lexer::getStringLiteralSegments(
            " not be returned as string literals");
     ++End;
 
-    // Add an expression segment.
-    Segments.push_back(
-        StringSegment::getExpr(getSourceLoc(BytesPtr-1), End-BytesPtr+1));
+    // Emit an expression segment.
+    Body(StringSegment::getExpr(getSourceLoc(BytesPtr-1), End-BytesPtr+1));
 
     // Reset the beginning of the segment to the string that remains to be
     // consumed.
     SegmentStartPtr = BytesPtr = End;
   }
 
-  Segments.push_back(
-      StringSegment::getLiteral(getSourceLoc(SegmentStartPtr),
-                                Bytes.end()-SegmentStartPtr));
+  Body(StringSegment::getLiteral(getSourceLoc(SegmentStartPtr),
+                                 Bytes.end()-SegmentStartPtr));
+}
+
+void Lexer::getStringLiteralSegments(
+              const Token &Str,
+              SmallVectorImpl<StringSegment> &Segments,
+              DiagnosticEngine *Diags) {
+  forEachStringLiteralSegment(Str, Diags, [&](StringSegment Segment) {
+    Segments.push_back(Segment);
+  });
 }
 
 
@@ -1598,6 +1712,9 @@ void Lexer::lexImpl() {
   assert(CurPtr >= BufferStart &&
          CurPtr <= BufferEnd && "Current pointer out of range!");
 
+  if (!CachedTokens.empty())
+    return lexFromCachedTokens();
+
   NextToken.setAtStartOfLine(CurPtr == BufferStart);
 
   // Remember where we started so that we can find the comment range.
@@ -1670,6 +1787,11 @@ Restart:
   case '\t':
   case '\f':
   case '\v':
+    // Consume the rest of a horizontal whitespace run here rather than
+    // re-entering the switch once per byte; indentation in machine-generated
+    // sources produces long runs.
+    while (*CurPtr == ' ' || *CurPtr == '\t')
+      ++CurPtr;
     goto Restart;  // Skip whitespace.
 
   case -1:
@@ -1996,3 +2118,212 @@ StringRef Lexer::getIndentationForLine(SourceManager &SM, SourceLoc Loc) {
 
   return StringRef(StartOfLine, EndOfIndentation - StartOfLine);
 }
+
+//===----------------------------------------------------------------------===//
+// Packed token streams
+//===----------------------------------------------------------------------===//
+
+std::vector<PackedToken> Lexer::tokenizePacked(const LangOptions &LangOpts,
+                                               const SourceManager &SM,
+                                               unsigned BufferID,
+                                               unsigned Offset,
+                                               unsigned EndOffset) {
+  if (Offset == 0 && EndOffset == 0)
+    EndOffset = SM.getRangeForBuffer(BufferID).getByteLength();
+
+  Lexer L(LangOpts, SM, BufferID, /*Diags=*/nullptr, /*InSILMode=*/false,
+          CommentRetentionMode::None, Offset, EndOffset);
+
+  std::vector<PackedToken> Tokens;
+  Token Tok;
+  do {
+    L.lex(Tok);
+    StringRef Text = Tok.getRawText();
+    assert(Text.size() <= PackedToken::MaxLength &&
+           "token text too long for packed encoding");
+    Tokens.push_back(PackedToken(Tok.getKind(), Text.begin() - L.BufferStart,
+                                 Text.size(), Tok.isAtStartOfLine(),
+                                 Tok.isEscapedIdentifier()));
+  } while (Tokens.back().isNot(tok::eof));
+  return Tokens;
+}
+
+//===----------------------------------------------------------------------===//
+// Token stream caching
+//===----------------------------------------------------------------------===//
+//
+// A token-stream sidecar holds a fixed header followed by one fixed-width
+// record per token, ending with the eof token. All multi-byte fields are
+// little-endian. The header carries a hash of the source contents and the
+// lexing modes that affect the stream, so rehydration can cheaply reject a
+// sidecar that does not match the buffer it is being applied to.
+
+namespace {
+const uint32_t TokenCacheMagic = 0x304B5453; // "STK0"
+
+enum : uint8_t {
+  TokenCacheFlag_AtStartOfLine = 1 << 0,
+  TokenCacheFlag_EscapedIdentifier = 1 << 1,
+};
+} // end anonymous namespace
+
+/// Hash the inputs that determine a buffer's token stream: the buffer
+/// contents and the lexing modes.
+static void hashTokenCacheKey(StringRef buffer, bool InSILMode,
+                              CommentRetentionMode RetainComments,
+                              llvm::MD5::MD5Result &result) {
+  llvm::MD5 hash;
+  hash.update(buffer);
+  uint8_t modes[2] = {static_cast<uint8_t>(InSILMode),
+                      static_cast<uint8_t>(RetainComments)};
+  hash.update(modes);
+  hash.final(result);
+}
+
+void Lexer::writeTokenStreamCache(const LangOptions &Options,
+                                  const SourceManager &SourceMgr,
+                                  unsigned BufferID, bool InSILMode,
+                                  CommentRetentionMode RetainComments,
+                                  llvm::raw_ostream &OS) {
+  Lexer L(Options, SourceMgr, BufferID, /*Diags=*/nullptr, InSILMode,
+          RetainComments);
+
+  std::vector<Token> Tokens;
+  do {
+    Tokens.emplace_back();
+    L.lex(Tokens.back());
+  } while (Tokens.back().isNot(tok::eof));
+
+  StringRef buffer(L.BufferStart, L.BufferEnd - L.BufferStart);
+  llvm::MD5::MD5Result hashResult;
+  hashTokenCacheKey(buffer, InSILMode, RetainComments, hashResult);
+
+  llvm::support::endian::Writer<llvm::support::little> writer(OS);
+  writer.write<uint32_t>(TokenCacheMagic);
+  writer.write<uint32_t>(static_cast<uint32_t>(buffer.size()));
+  OS.write(reinterpret_cast<const char *>(hashResult), sizeof(hashResult));
+  writer.write<uint32_t>(static_cast<uint32_t>(Tokens.size()));
+
+  for (const Token &Tok : Tokens) {
+    uint8_t flags = 0;
+    if (Tok.isAtStartOfLine())
+      flags |= TokenCacheFlag_AtStartOfLine;
+    if (Tok.isEscapedIdentifier())
+      flags |= TokenCacheFlag_EscapedIdentifier;
+
+    writer.write<uint16_t>(static_cast<uint16_t>(Tok.getKind()));
+    writer.write<uint8_t>(flags);
+    writer.write<uint32_t>(Tok.getCommentLength());
+    writer.write<uint32_t>(
+        static_cast<uint32_t>(Tok.getRawText().begin() - L.BufferStart));
+    writer.write<uint32_t>(static_cast<uint32_t>(Tok.getRawText().size()));
+  }
+}
+
+bool Lexer::readTokenStreamCache(const llvm::MemoryBuffer &cacheBuffer) {
+  assert(CachedTokens.empty() && "already rehydrated a token stream");
+
+  // Sub-lexers and code completion lexers have state the sidecar does not
+  // capture; they must scan normally.
+  if (ArtificialEOF || CodeCompletionPtr)
+    return false;
+
+  StringRef data = cacheBuffer.getBuffer();
+  const size_t headerSize = 4 + 4 + sizeof(llvm::MD5::MD5Result) + 4;
+  if (data.size() < headerSize)
+    return false;
+
+  using namespace llvm::support;
+  const char *ptr = data.data();
+  if (endian::read32le(ptr) != TokenCacheMagic)
+    return false;
+  ptr += 4;
+
+  uint32_t bufferSize = endian::read32le(ptr);
+  ptr += 4;
+  if (bufferSize != static_cast<uint32_t>(BufferEnd - BufferStart))
+    return false;
+
+  llvm::MD5::MD5Result expected;
+  hashTokenCacheKey(StringRef(BufferStart, bufferSize), InSILMode,
+                    RetainComments, expected);
+  if (memcmp(ptr, expected, sizeof(expected)) != 0)
+    return false;
+  ptr += sizeof(expected);
+
+  uint32_t count = endian::read32le(ptr);
+  ptr += 4;
+  const size_t recordSize = 2 + 1 + 4 + 4 + 4;
+  if (count == 0 || data.size() - headerSize < uint64_t(count) * recordSize)
+    return false;
+
+  std::vector<Token> tokens;
+  tokens.reserve(count);
+  for (uint32_t i = 0; i != count; ++i) {
+    uint16_t kind = endian::read16le(ptr);
+    ptr += 2;
+    uint8_t flags = static_cast<uint8_t>(*ptr);
+    ptr += 1;
+    uint32_t commentLength = endian::read32le(ptr);
+    ptr += 4;
+    uint32_t offset = endian::read32le(ptr);
+    ptr += 4;
+    uint32_t length = endian::read32le(ptr);
+    ptr += 4;
+
+    if (kind >= static_cast<uint16_t>(tok::NUM_TOKENS) ||
+        offset > bufferSize || length > bufferSize - offset)
+      return false;
+
+    tokens.emplace_back();
+    tokens.back().setToken(static_cast<tok>(kind),
+                           StringRef(BufferStart + offset, length),
+                           commentLength);
+    tokens.back().setAtStartOfLine(flags & TokenCacheFlag_AtStartOfLine);
+    if (flags & TokenCacheFlag_EscapedIdentifier)
+      tokens.back().setEscapedIdentifier(true);
+  }
+  if (tokens.back().isNot(tok::eof))
+    return false;
+
+  CachedTokens = std::move(tokens);
+
+  // The constructor already scanned the first token; replay it from the
+  // cache instead so NextToken and CurPtr stay consistent with the stream.
+  NextCachedTokenIdx = 0;
+  CurPtr = BufferStart;
+  lexFromCachedTokens();
+  return true;
+}
+
+void Lexer::lexFromCachedTokens() {
+  assert(!CachedTokens.empty() && "no token stream to replay");
+
+  // The scan range of a token starts at its attached comment, if any,
+  // matching getStateForBeginningOfToken.
+  auto scanStart = [](const Token &Tok) {
+    return Tok.getRawText().begin() - Tok.getCommentLength();
+  };
+
+  // The common case is sequential replay, but restoreState may have moved
+  // CurPtr anywhere in the buffer; resynchronize on the first token whose
+  // scan range starts at or after it.
+  unsigned idx = NextCachedTokenIdx;
+  bool sequential = idx < CachedTokens.size() &&
+      scanStart(CachedTokens[idx]) >= CurPtr &&
+      (idx == 0 || CachedTokens[idx - 1].getRawText().end() <= CurPtr);
+  if (!sequential) {
+    auto it = std::lower_bound(CachedTokens.begin(), CachedTokens.end(),
+                               CurPtr,
+                               [&](const Token &Tok, const char *ptr) {
+                                 return scanStart(Tok) < ptr;
+                               });
+    if (it == CachedTokens.end())
+      --it; // Position past every token; replay eof.
+    idx = it - CachedTokens.begin();
+  }
+
+  NextToken = CachedTokens[idx];
+  NextCachedTokenIdx = idx + 1;
+  CurPtr = NextToken.is(tok::eof) ? BufferEnd : NextToken.getRawText().end();
+}
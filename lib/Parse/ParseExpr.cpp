@@ -1657,17 +1657,20 @@ createStringLiteralExprFromSegment(ASTContext &Ctx,
 ///   expr-literal:
 ///     string_literal
 ParserResult<Expr> Parser::parseExprStringLiteral() {
-  SmallVector<Lexer::StringSegment, 1> Segments;
-  L->getStringLiteralSegments(Tok, Segments);
-  SourceLoc Loc = consumeToken();
-    
-  // The simple case: just a single literal segment.
-  if (Segments.size() == 1 &&
-      Segments.front().Kind == Lexer::StringSegment::Literal) {
+  // The simple case: no interpolation, so the whole body is a single literal
+  // segment.  Detect it with one scan and skip segment collection entirely.
+  if (!Lexer::stringLiteralContainsInterpolation(Tok)) {
+    auto Segment = Lexer::StringSegment::getLiteral(
+        Tok.getLoc().getAdvancedLoc(1), Tok.getLength() - 2);
+    SourceLoc Loc = consumeToken();
     return makeParserResult(
-        createStringLiteralExprFromSegment(Context, L, Segments.front(), Loc));
+        createStringLiteralExprFromSegment(Context, L, Segment, Loc));
   }
 
+  SmallVector<Lexer::StringSegment, 4> Segments;
+  L->getStringLiteralSegments(Tok, Segments);
+  SourceLoc Loc = consumeToken();
+
   ParserStatus Status;
   SmallVector<Expr*, 4> Exprs;
   bool First = true;
@@ -49,6 +49,11 @@ namespace swift {
     /// A map from textual .sil scope number to SILDebugScopes.
     llvm::DenseMap<unsigned, SILDebugScope *> ScopeSlots;
 
+    /// Index from a function name to the SIL globals whose static
+    /// initializer references that name, so that completing a function
+    /// definition does not have to scan every global in the module.
+    llvm::StringMap<std::vector<SILGlobalVariable *>> GlobalInitializerRefs;
+
     /// Did we parse a sil_stage for this module?
     bool DidParseSILStage = false;
     
@@ -696,6 +701,7 @@ static bool parseSILOptional(bool &Result, SILParser &SP, StringRef Expected) {
 
 static bool parseDeclSILOptional(bool *isTransparent, bool *isFragile,
                                  IsThunk_t *isThunk, bool *isGlobalInit,
+                                 bool *isInoutsUnaliased,
                                  Inline_t *inlineStrategy, bool *isLet,
                                  SmallVectorImpl<std::string> *Semantics,
                                  SmallVectorImpl<ParsedSpecAttr> *SpecAttrs,
@@ -721,6 +727,8 @@ static bool parseDeclSILOptional(bool *isTransparent, bool *isFragile,
       *isThunk = IsReabstractionThunk;
     else if (isGlobalInit && SP.P.Tok.getText() == "global_init")
       *isGlobalInit = true;
+    else if (isInoutsUnaliased && SP.P.Tok.getText() == "inouts_unaliased")
+      *isInoutsUnaliased = true;
     else if (inlineStrategy && SP.P.Tok.getText() == "noinline")
       *inlineStrategy = NoInline;
     else if (inlineStrategy && SP.P.Tok.getText() == "always_inline")
@@ -3940,6 +3948,7 @@ bool Parser::parseDeclSIL() {
   bool isFragile = false;
   IsThunk_t isThunk = IsNotThunk;
   bool isGlobalInit = false;
+  bool isInoutsUnaliased = false;
   Inline_t inlineStrategy = InlineDefault;
   SmallVector<std::string, 1> Semantics;
   SmallVector<ParsedSpecAttr, 4> SpecAttrs;
@@ -3947,8 +3956,9 @@ bool Parser::parseDeclSIL() {
   EffectsKind MRK = EffectsKind::Unspecified;
   if (parseSILLinkage(FnLinkage, *this) ||
       parseDeclSILOptional(&isTransparent, &isFragile, &isThunk, &isGlobalInit,
-                           &inlineStrategy, nullptr, &Semantics, &SpecAttrs,
-                           &ClangDecl, &MRK, FunctionState) ||
+                           &isInoutsUnaliased, &inlineStrategy, nullptr,
+                           &Semantics, &SpecAttrs, &ClangDecl, &MRK,
+                           FunctionState) ||
       parseToken(tok::at_sign, diag::expected_sil_function_name) ||
       parseIdentifier(FnName, FnNameLoc, diag::expected_sil_function_name) ||
       parseToken(tok::colon, diag::expected_sil_type))
@@ -3975,6 +3985,7 @@ bool Parser::parseDeclSIL() {
     FunctionState.F->setFragile(IsFragile_t(isFragile));
     FunctionState.F->setThunk(IsThunk_t(isThunk));
     FunctionState.F->setGlobalInit(isGlobalInit);
+    FunctionState.F->setInoutsUnaliased(isInoutsUnaliased);
     FunctionState.F->setInlineStrategy(inlineStrategy);
     FunctionState.F->setEffectsKind(MRK);
     if (ClangDecl)
@@ -4051,12 +4062,13 @@ bool Parser::parseDeclSIL() {
   if (!FunctionState.P.Diags.hadAnyError())
     FunctionState.F->verify();
 
-  // Link the static initializer for global variables.
-  for (SILGlobalVariable &v : FunctionState.SILMod.getSILGlobals()) {
-    if (v.getInitializer())
-      if (FnName.str() == v.getInitializer()->getName())
-        v.setInitializer(FunctionState.F);
-  }
+  // Link the static initializer for global variables that reference this
+  // function by name.
+  auto GlobalRefs =
+      FunctionState.TUState.GlobalInitializerRefs.find(FnName.str());
+  if (GlobalRefs != FunctionState.TUState.GlobalInitializerRefs.end())
+    for (SILGlobalVariable *v : GlobalRefs->second)
+      v->setInitializer(FunctionState.F);
 
   return false;
 }
@@ -4108,7 +4120,7 @@ bool Parser::parseSILGlobal() {
   Scope S(this, ScopeKind::TopLevel);
   SILParser State(*this);
   if (parseSILLinkage(GlobalLinkage, *this) ||
-      parseDeclSILOptional(nullptr, &isFragile, nullptr, nullptr,
+      parseDeclSILOptional(nullptr, &isFragile, nullptr, nullptr, nullptr,
                            nullptr, &isLet, nullptr, nullptr, nullptr,
                            nullptr, State) ||
       parseToken(tok::at_sign, diag::expected_sil_value_name) ||
@@ -4147,6 +4159,7 @@ bool Parser::parseSILGlobal() {
     }
 
     GV->setInitializer(State.getGlobalNameForReference(Name, FnTy, Loc));
+    State.TUState.GlobalInitializerRefs[Name.str()].push_back(GV);
   }
   return false;
 }
@@ -4457,7 +4470,7 @@ bool Parser::parseSILWitnessTable() {
   parseSILLinkage(Linkage, *this);
   
   bool isFragile = false;
-  if (parseDeclSILOptional(nullptr, &isFragile, nullptr, nullptr,
+  if (parseDeclSILOptional(nullptr, &isFragile, nullptr, nullptr, nullptr,
                            nullptr, nullptr, nullptr, nullptr, nullptr,
                            nullptr, WitnessState))
     return true;
@@ -0,0 +1,125 @@
+//===--- StructureScanner.cpp - Top-level structure pre-scan --------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Parse/StructureScanner.h"
+#include "swift/Basic/SourceManager.h"
+#include "swift/Parse/Lexer.h"
+
+using namespace swift;
+
+std::vector<TopLevelChunk> swift::scanTopLevelChunks(
+    const LangOptions &LangOpts, const SourceManager &SM, unsigned BufferID) {
+  unsigned BufferLength = SM.getRangeForBuffer(BufferID).getByteLength();
+
+  // Tokenize rather than scanning raw bytes so that braces inside string
+  // literals, interpolations and comments cannot confuse the bracket
+  // matching.  No diagnostics: the buffer will be diagnosed when it is
+  // actually parsed.
+  Lexer L(LangOpts, SM, BufferID, /*Diags=*/nullptr, /*InSILMode=*/false,
+          CommentRetentionMode::None);
+
+  std::vector<TopLevelChunk> Chunks;
+  unsigned ChunkStart = 0;
+  bool ChunkHasDirectives = false;
+
+  // Total bracket nesting depth, counting all of (), [] and {}.  Stray
+  // closers never take it below zero, so garbage early in the buffer cannot
+  // skew the matching for the rest of the file.
+  unsigned BracketDepth = 0;
+
+  // Nesting depth of #if blocks.  Boundaries are suppressed inside them
+  // since the inactive branches may hold unbalanced braces.
+  unsigned PoundIfDepth = 0;
+
+  // Set when the previous token was a '}' that returned the bracket depth
+  // to zero outside any #if; the next line-starting token begins a chunk.
+  bool AtBoundary = false;
+
+  Token Tok;
+  do {
+    L.lex(Tok);
+
+    if (AtBoundary && Tok.isAtStartOfLine() && Tok.isNot(tok::eof)) {
+      unsigned BoundaryOffset = SM.getLocOffsetInBuffer(Tok.getLoc(), BufferID);
+      if (BoundaryOffset > ChunkStart) {
+        Chunks.push_back({ChunkStart, BoundaryOffset - ChunkStart,
+                          ChunkHasDirectives});
+        ChunkStart = BoundaryOffset;
+        ChunkHasDirectives = false;
+      }
+    }
+    AtBoundary = false;
+
+    switch (Tok.getKind()) {
+    case tok::l_paren:
+    case tok::l_square:
+    case tok::l_brace:
+      ++BracketDepth;
+      break;
+
+    case tok::r_paren:
+    case tok::r_square:
+      if (BracketDepth != 0)
+        --BracketDepth;
+      break;
+
+    case tok::r_brace:
+      if (BracketDepth != 0) {
+        --BracketDepth;
+        AtBoundary = (BracketDepth == 0 && PoundIfDepth == 0);
+      }
+      break;
+
+    case tok::pound_if:
+      ++PoundIfDepth;
+      ChunkHasDirectives = true;
+      break;
+
+    case tok::pound_endif:
+      if (PoundIfDepth != 0)
+        --PoundIfDepth;
+      ChunkHasDirectives = true;
+      break;
+
+    case tok::pound_else:
+    case tok::pound_elseif:
+      ChunkHasDirectives = true;
+      break;
+
+    default:
+      break;
+    }
+  } while (Tok.isNot(tok::eof));
+
+  // The final chunk runs to the end of the buffer.
+  if (BufferLength > ChunkStart || Chunks.empty())
+    Chunks.push_back({ChunkStart, BufferLength - ChunkStart,
+                      ChunkHasDirectives});
+
+  return Chunks;
+}
+
+const TopLevelChunk *swift::findEnclosingTopLevelChunk(
+    ArrayRef<TopLevelChunk> Chunks, unsigned ByteOffset) {
+  if (Chunks.empty() || ByteOffset < Chunks.front().Offset)
+    return nullptr;
+
+  // Binary search for the first chunk ending beyond the offset.
+  const TopLevelChunk *Chunk = std::lower_bound(
+      Chunks.begin(), Chunks.end(), ByteOffset,
+      [](const TopLevelChunk &C, unsigned Offset) {
+        return C.getEndOffset() <= Offset;
+      });
+  if (Chunk == Chunks.end())
+    return &Chunks.back();
+  return Chunk;
+}
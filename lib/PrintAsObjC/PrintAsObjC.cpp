@@ -19,6 +19,7 @@
 #include "swift/AST/PrettyStackTrace.h"
 #include "swift/AST/TypeVisitor.h"
 #include "swift/AST/Comment.h"
+#include "swift/AST/DiagnosticsCommon.h"
 #include "swift/Basic/StringExtras.h"
 #include "swift/Basic/Version.h"
 #include "swift/ClangImporter/ClangImporter.h"
@@ -33,6 +34,8 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -1692,6 +1695,25 @@ class ModuleWriter {
   std::vector<const Decl *> declsToWrite;
   DelayedMemberSet delayedMembers;
 
+  /// A contiguous range of the body buffer holding the printed interface of
+  /// one top-level declaration, along with the local types whose definitions
+  /// it required. Only populated in split-header mode.
+  struct HeaderSegment {
+    const Decl *D;
+    StringRef name;
+    size_t begin;
+    size_t end;
+    SmallVector<const TypeDecl *, 2> requirements;
+  };
+  std::vector<HeaderSegment> segments;
+
+  /// Whether to record per-declaration segments for split-header emission.
+  bool recordSegments = false;
+
+  /// The local types required (defined, not just forward-declared) by the
+  /// declaration currently being written.
+  llvm::SmallSetVector<const TypeDecl *, 4> pendingRequirements;
+
   using ImportModuleTy = PointerUnion<Module*, const clang::Module*>;
   SmallSetVector<ImportModuleTy, 8,
                  PointerLikeComparator<ImportModuleTy>> imports;
@@ -1745,13 +1767,24 @@ public:
     return seenTypes.lookup(D).first >= EmissionState::DefinitionRequested;
   }
 
+  /// In split-header mode, note that the declaration currently being
+  /// written needs the definition of the given local type.
+  void noteRequirement(const TypeDecl *D) {
+    if (recordSegments)
+      pendingRequirements.insert(D);
+  }
+
   bool tryRequire(const TypeDecl *D) {
     if (addImport(D)) {
       seenTypes[D] = { EmissionState::Defined, true };
       return true;
     }
     auto &state = seenTypes[D];
-    return state.first == EmissionState::Defined;
+    if (state.first == EmissionState::Defined) {
+      noteRequirement(D);
+      return true;
+    }
+    return false;
   }
 
   bool require(const TypeDecl *D) {
@@ -1768,6 +1801,7 @@ public:
       declsToWrite.push_back(D);
       return false;
     case EmissionState::Defined:
+      noteRequirement(D);
       return true;
     }
   }
@@ -2227,7 +2261,20 @@ public:
     }
   }
 
-  bool writeToStream(raw_ostream &out) {
+  /// Returns the name used to group the given top-level declaration into a
+  /// sub-header: the extended class for extensions, and the declaration's
+  /// own Objective-C name otherwise.
+  static StringRef getSegmentName(const Decl *D) {
+    if (auto ED = dyn_cast<ExtensionDecl>(D))
+      return getNameForObjC(ED->getExtendedType()->getClassOrBoundGenericClass());
+    if (isa<NominalTypeDecl>(D))
+      return getNameForObjC(cast<ValueDecl>(D));
+    return cast<ValueDecl>(D)->getName().str();
+  }
+
+  /// Print all included top-level declarations into the body buffer,
+  /// recording per-declaration segments if requested.
+  void emitBody() {
     SmallVector<Decl *, 64> decls;
     M.getTopLevelDecls(decls);
 
@@ -2317,6 +2364,7 @@ public:
     while (!declsToWrite.empty()) {
       const Decl *D = declsToWrite.back();
       bool success = true;
+      size_t segmentBegin = os.str().size();
 
       if (isa<ValueDecl>(D)) {
         if (auto CD = dyn_cast<ClassDecl>(D))
@@ -2341,6 +2389,19 @@ public:
         assert(declsToWrite.back() == D);
         os << "\n";
         declsToWrite.pop_back();
+
+        if (recordSegments) {
+          HeaderSegment segment;
+          segment.D = D;
+          segment.name = getSegmentName(D);
+          segment.begin = segmentBegin;
+          segment.end = os.str().size();
+          for (const TypeDecl *requirement : pendingRequirements)
+            if (requirement != D)
+              segment.requirements.push_back(requirement);
+          pendingRequirements.clear();
+          segments.push_back(segment);
+        }
       }
     }
 
@@ -2354,6 +2415,10 @@ public:
       }
       printer.printAdHocCategory(make_range(groupBegin, delayedMembers.end()));
     }
+  }
+
+  bool writeToStream(raw_ostream &out) {
+    emitBody();
 
     writePrologue(out);
     writeImports(out);
@@ -2364,6 +2429,179 @@ public:
       << "#pragma clang diagnostic pop\n";
     return false;
   }
+
+  /// Build an include-guard macro for the given sub-header file name.
+  static void appendGuardMacro(StringRef fileName, SmallVectorImpl<char> &out) {
+    for (char c : fileName) {
+      if (c >= 'a' && c <= 'z')
+        out.push_back(c - 'a' + 'A');
+      else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+        out.push_back(c);
+      else
+        out.push_back('_');
+    }
+  }
+
+  /// Write \p contents to \p path, leaving the file untouched (and its
+  /// modification time unchanged) if it already holds exactly \p contents.
+  bool writeFileIfChanged(StringRef path, StringRef contents) {
+    auto existing = llvm::MemoryBuffer::getFile(path);
+    if (existing && (*existing)->getBuffer() == contents)
+      return false;
+
+    std::error_code EC;
+    llvm::raw_fd_ostream fileOS(path, EC, llvm::sys::fs::F_None);
+    if (EC) {
+      M.getASTContext().Diags.diagnose(SourceLoc(),
+                                       diag::error_opening_output,
+                                       path, EC.message());
+      return true;
+    }
+    fileOS << contents;
+    return fileOS.has_error();
+  }
+
+  /// Like writeToStream, but splits the printed interfaces into one
+  /// sub-header per top-level name, written next to \p outputPath. The
+  /// umbrella header, which imports every sub-header, goes to \p out; its
+  /// text only changes when the set of exposed top-level names does.
+  bool writeSplitHeaders(raw_ostream &out, StringRef outputPath) {
+    recordSegments = true;
+    emitBody();
+
+    StringRef body = os.str();
+    size_t trailingBegin =
+      segments.empty() ? 0 : segments.back().end;
+
+    // Emit forward declarations for every local type the header defines;
+    // these are shared by all sub-headers so that pointer-only references
+    // across sub-headers never need a definition.
+    size_t forwardDeclsBegin = body.size();
+    for (const auto &segment : segments) {
+      if (auto CD = dyn_cast<ClassDecl>(segment.D)) {
+        os << "@class " << getNameForObjC(CD) << ";\n";
+      } else if (auto PD = dyn_cast<ProtocolDecl>(segment.D)) {
+        os << "@protocol " << getNameForObjC(PD) << ";\n";
+      } else if (auto ED = dyn_cast<EnumDecl>(segment.D)) {
+        os << "enum " << getNameForObjC(ED) << " : ";
+        printer.print(ED->getRawType(), OTK_None);
+        os << ";\n";
+      }
+    }
+    body = os.str();
+
+    // Group contiguous segments that share a name. The first run for each
+    // name becomes its sub-header; segments the dependency stack pushed
+    // out of line fall back to the umbrella, which imports everything.
+    struct HeaderGroup {
+      StringRef name;
+      SmallVector<const HeaderSegment *, 2> segments;
+    };
+    SmallVector<HeaderGroup, 16> groups;
+    SmallVector<const HeaderSegment *, 4> umbrellaSegments;
+    llvm::DenseMap<const TypeDecl *, unsigned> definitionGroups;
+    llvm::StringSet<> seenGroupNames;
+    for (const auto &segment : segments) {
+      if (!groups.empty() && groups.back().name == segment.name) {
+        groups.back().segments.push_back(&segment);
+      } else if (seenGroupNames.insert(segment.name).second) {
+        groups.push_back({segment.name, {&segment}});
+      } else {
+        umbrellaSegments.push_back(&segment);
+        continue;
+      }
+      if (auto TD = dyn_cast<TypeDecl>(segment.D))
+        definitionGroups[TD] = groups.size() - 1;
+    }
+
+    StringRef headerDir = llvm::sys::path::parent_path(outputPath);
+    StringRef headerStem = llvm::sys::path::stem(outputPath);
+    auto getSubHeaderName = [&](StringRef groupName) {
+      return (headerStem + "-" + groupName + ".h").str();
+    };
+    std::string prologueName = (headerStem + "-prologue.h").str();
+
+    auto beginSubHeader = [&](raw_ostream &subOS, StringRef fileName) {
+      SmallString<64> guard;
+      appendGuardMacro(fileName, guard);
+      subOS << "#ifndef " << guard << "\n"
+            << "#define " << guard << "\n";
+    };
+
+    // The prologue sub-header carries everything that was shared header
+    // text before: boilerplate macros, imports, and the forward
+    // declarations emitted above.
+    bool hadError = false;
+    {
+      std::string contents;
+      llvm::raw_string_ostream subOS(contents);
+      beginSubHeader(subOS, prologueName);
+      writePrologue(subOS);
+      writeImports(subOS);
+      subOS << body.substr(forwardDeclsBegin)
+            << "#pragma clang diagnostic pop\n"
+            << "#endif\n";
+
+      SmallString<128> path(headerDir);
+      llvm::sys::path::append(path, prologueName);
+      hadError |= writeFileIfChanged(path, subOS.str());
+    }
+
+    for (unsigned i = 0, e = groups.size(); i != e; ++i) {
+      const HeaderGroup &group = groups[i];
+      std::string contents;
+      llvm::raw_string_ostream subOS(contents);
+      std::string fileName = getSubHeaderName(group.name);
+      beginSubHeader(subOS, fileName);
+      subOS << "#import \"" << prologueName << "\"\n";
+
+      // Import the sub-headers of the local types this group's interfaces
+      // require as full definitions. These always precede this group in
+      // emission order, so the imports cannot cycle.
+      llvm::SmallSetVector<unsigned, 4> dependencies;
+      for (const HeaderSegment *segment : group.segments)
+        for (const TypeDecl *requirement : segment->requirements) {
+          auto known = definitionGroups.find(requirement);
+          if (known != definitionGroups.end() && known->second != i)
+            dependencies.insert(known->second);
+        }
+      SmallVector<unsigned, 4> orderedDeps(dependencies.begin(),
+                                           dependencies.end());
+      llvm::array_pod_sort(orderedDeps.begin(), orderedDeps.end());
+      for (unsigned dep : orderedDeps)
+        subOS << "#import \"" << getSubHeaderName(groups[dep].name) << "\"\n";
+
+      subOS <<
+          "#pragma clang diagnostic push\n"
+          "#pragma clang diagnostic ignored "
+            "\"-Wproperty-attribute-mismatch\"\n"
+          "#pragma clang diagnostic ignored \"-Wduplicate-method-arg\"\n";
+      for (const HeaderSegment *segment : group.segments)
+        subOS << body.slice(segment->begin, segment->end);
+      subOS << "#pragma clang diagnostic pop\n"
+            << "#endif\n";
+
+      SmallString<128> path(headerDir);
+      llvm::sys::path::append(path, fileName);
+      hadError |= writeFileIfChanged(path, subOS.str());
+    }
+
+    // The umbrella header imports every sub-header, preserving the
+    // behavior of a monolithic header for existing clients, and holds any
+    // out-of-line segments and ad hoc categories.
+    out << "#import \"" << prologueName << "\"\n";
+    for (const HeaderGroup &group : groups)
+      out << "#import \"" << getSubHeaderName(group.name) << "\"\n";
+    out <<
+        "#pragma clang diagnostic push\n"
+        "#pragma clang diagnostic ignored \"-Wproperty-attribute-mismatch\"\n"
+        "#pragma clang diagnostic ignored \"-Wduplicate-method-arg\"\n";
+    for (const HeaderSegment *segment : umbrellaSegments)
+      out << body.slice(segment->begin, segment->end);
+    out << body.slice(trailingBegin, forwardDeclsBegin)
+        << "#pragma clang diagnostic pop\n";
+    return hadError;
+  }
 };
 }
 
@@ -2373,3 +2611,11 @@ bool swift::printAsObjC(llvm::raw_ostream &os, Module *M,
   llvm::PrettyStackTraceString trace("While generating Objective-C header");
   return ModuleWriter(*M, bridgingHeader, minRequiredAccess).writeToStream(os);
 }
+
+bool swift::printAsObjCSplit(llvm::raw_ostream &os, StringRef outputPath,
+                             Module *M, StringRef bridgingHeader,
+                             Accessibility minRequiredAccess) {
+  llvm::PrettyStackTraceString trace("While generating Objective-C header");
+  return ModuleWriter(*M, bridgingHeader, minRequiredAccess)
+           .writeSplitHeaders(os, outputPath);
+}
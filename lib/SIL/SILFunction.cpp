@@ -97,6 +97,7 @@ SILFunction::SILFunction(SILModule &Module, SILLinkage Linkage,
     Thunk(isThunk),
     ClassVisibility(classVisibility),
     GlobalInitFlag(false),
+    InoutsUnaliasedFlag(false),
     InlineStrategy(inlineStrategy),
     Linkage(unsigned(Linkage)),
     KeepAsPublic(false),
@@ -27,6 +27,7 @@
 #include "clang/Analysis/DomainSpecific/CocoaConventions.h"
 #include "clang/AST/Attr.h"
 #include "clang/AST/DeclObjC.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 
@@ -1674,10 +1675,16 @@ TypeConverter::getDeclRefRepresentation(SILDeclRef c) {
   }
 }
 
+STATISTIC(NumConstantInfoQueries, "Number of constant info cache queries");
+STATISTIC(NumConstantInfoCacheHits, "Number of constant info cache hits");
+
 SILConstantInfo TypeConverter::getConstantInfo(SILDeclRef constant) {
+  ++NumConstantInfoQueries;
   auto found = ConstantTypes.find(constant);
-  if (found != ConstantTypes.end())
+  if (found != ConstantTypes.end()) {
+    ++NumConstantInfoCacheHits;
     return found->second;
+  }
 
   // First, get a function type for the constant.  This creates the
   // right type for a getter or setter.
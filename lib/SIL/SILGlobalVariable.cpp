@@ -126,12 +126,15 @@ static bool analyzeStaticInitializer(SILFunction *F, SILInstruction *&Val,
         }
       }
 
+      // References to other functions are emitted as constant function
+      // pointers.
       if (I.getKind() != ValueKind::ReturnInst &&
           I.getKind() != ValueKind::StructInst &&
           I.getKind() != ValueKind::TupleInst &&
           I.getKind() != ValueKind::DebugValueInst &&
           I.getKind() != ValueKind::IntegerLiteralInst &&
-          I.getKind() != ValueKind::FloatLiteralInst)
+          I.getKind() != ValueKind::FloatLiteralInst &&
+          I.getKind() != ValueKind::FunctionRefInst)
         return false;
     }
   }
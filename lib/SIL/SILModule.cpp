@@ -104,12 +104,67 @@ void *SILModule::allocate(unsigned Size, unsigned Align) const {
   return BPA.Allocate(Size, Align);
 }
 
+namespace {
+/// Header in front of every recyclable instruction allocation. The payload
+/// follows at a fixed offset of BlockHeaderSize bytes, so that recycling a
+/// block preserves the payload's alignment.
+struct InstAllocHeader {
+  /// Size class of the block, or 0 if the allocation is too large to be
+  /// recycled and is returned to the system allocator on deallocation.
+  size_t SizeClass;
+  /// Links free blocks of the same size class.
+  void *Next;
+};
+} // end anonymous namespace
+
+SILModule::InstructionRecycler::~InstructionRecycler() {
+  for (void *&List : FreeLists) {
+    while (List) {
+      auto *H = static_cast<InstAllocHeader *>(List);
+      List = H->Next;
+      AlignedFree(H);
+    }
+  }
+}
+
 void *SILModule::allocateInst(unsigned Size, unsigned Align) const {
-  return AlignedAlloc(Size, Align);
+  static_assert(sizeof(InstAllocHeader) <=
+                    InstructionRecycler::BlockHeaderSize,
+                "header must fit into the reserved block prefix");
+  assert(Align <= InstructionRecycler::BlockHeaderSize &&
+         "instruction alignment exceeds the block header size");
+  (void)Align;
+
+  // Try to recycle a block of the matching size class first.
+  unsigned Class = (Size + 7) / 8;
+  if (Class <= InstructionRecycler::NumFreeLists &&
+      InstRecycler.FreeLists[Class - 1]) {
+    auto *H = static_cast<InstAllocHeader *>(InstRecycler.FreeLists[Class - 1]);
+    InstRecycler.FreeLists[Class - 1] = H->Next;
+    return (char *)H + InstructionRecycler::BlockHeaderSize;
+  }
+
+  // Round recyclable allocations up to their size class, so that the block
+  // can serve any later allocation of the same class.
+  unsigned PayloadSize =
+      Class <= InstructionRecycler::NumFreeLists ? Class * 8 : Size;
+  void *Block =
+      AlignedAlloc(InstructionRecycler::BlockHeaderSize + PayloadSize,
+                   InstructionRecycler::BlockHeaderSize);
+  auto *H = static_cast<InstAllocHeader *>(Block);
+  H->SizeClass = Class <= InstructionRecycler::NumFreeLists ? Class : 0;
+  return (char *)Block + InstructionRecycler::BlockHeaderSize;
 }
 
 void SILModule::deallocateInst(SILInstruction *I) {
-  AlignedFree(I);
+  auto *H = reinterpret_cast<InstAllocHeader *>(
+      (char *)I - InstructionRecycler::BlockHeaderSize);
+  if (H->SizeClass == 0) {
+    AlignedFree(H);
+    return;
+  }
+  H->Next = InstRecycler.FreeLists[H->SizeClass - 1];
+  InstRecycler.FreeLists[H->SizeClass - 1] = H;
 }
 
 SILWitnessTable *
@@ -38,20 +38,41 @@ SILVTable *SILVTable::create(SILModule &M, ClassDecl *Class,
 
 SILFunction *
 SILVTable::getImplementation(SILModule &M, SILDeclRef method) const {
-  // FIXME: We should build a sidetable cache in the module. Linear lookup here
-  // is lame.
-  
+  // This is a hot query during devirtualization, and the scan below walks the
+  // whole override chain of the method for every entry, so cache the result
+  // (including misses) in the module. Entries are never added to a vtable
+  // after creation; the one removal point, removeEntries_if, invalidates the
+  // cache.
+  auto key = std::make_pair(this, method);
+  auto found = M.VTableEntryCache.find(key);
+  if (found != M.VTableEntryCache.end())
+    return found->second;
+
+  SILFunction *impl = nullptr;
   for (auto &entry : getEntries()) {
     // Check whether this mapping matches either the given decl directly or
     // one of its overridden decl.
     SILDeclRef m = method;
     do {
-      if (entry.first == m)
-        return entry.second;
+      if (entry.first == m) {
+        impl = entry.second;
+        break;
+      }
     } while ((m = m.getOverridden()));
+    if (impl)
+      break;
   }
-  
-  return nullptr;
+
+  M.VTableEntryCache[key] = impl;
+  return impl;
+}
+
+void SILVTable::invalidateEntryCache(SILModule &M) {
+  // A cached lookup can hit an entry through any method in its override
+  // chain, so there is no cheap way to tell which keys refer to removed
+  // entries. Removal is rare (dead function elimination); just drop the
+  // whole cache.
+  M.VTableEntryCache.clear();
 }
 
 SILVTable::SILVTable(ClassDecl *c, ArrayRef<Pair> entries)
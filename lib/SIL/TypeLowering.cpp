@@ -30,8 +30,12 @@
 #include "swift/SIL/SILModule.h"
 #include "swift/SIL/TypeLowering.h"
 #include "clang/AST/Type.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 
+STATISTIC(NumTypeLoweringQueries, "Number of type lowering cache queries");
+STATISTIC(NumTypeLoweringCacheHits, "Number of type lowering cache hits");
+
 using namespace swift;
 using namespace Lowering;
 
@@ -1291,12 +1295,14 @@ void *TypeLowering::operator new(size_t size, TypeConverter &tc,
 const TypeLowering *TypeConverter::find(TypeKey k) {
   if (!k.isCacheable()) return nullptr;
 
+  ++NumTypeLoweringQueries;
   auto &Types = k.isDependent() ? DependentTypes : IndependentTypes;
   auto ck = k.getCachingKey();
   auto found = Types.find(ck);
   if (found == Types.end())
     return nullptr;
 
+  ++NumTypeLoweringCacheHits;
   assert(found->second && "type recursion not caught in Sema");
   return found->second;
 }
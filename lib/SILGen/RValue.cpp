@@ -67,11 +67,11 @@ class ExplodeTupleValue
                           /*Args...=*/ ManagedValue>
 {
 public:
-  std::vector<ManagedValue> &values;
+  SmallVectorImpl<ManagedValue> &values;
   SILGenFunction &gen;
   SILLocation loc;
 
-  ExplodeTupleValue(std::vector<ManagedValue> &values,
+  ExplodeTupleValue(SmallVectorImpl<ManagedValue> &values,
                     SILGenFunction &gen, SILLocation loc)
     : values(values), gen(gen), loc(loc)
   {
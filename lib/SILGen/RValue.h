@@ -32,7 +32,10 @@ namespace Lowering {
 /// destructured. (In SILGen we don't try to explode structs, because doing so
 /// would require considering resilience, a job we want to delegate to IRGen).
 class RValue {
-  std::vector<ManagedValue> values;
+  // Most exploded rvalues are small (a scalar or a handful of tuple
+  // elements), so keep the elements inline to avoid a heap allocation in the
+  // per-expression lowering path.
+  SmallVector<ManagedValue, 4> values;
   CanType type;
   unsigned elementsToBeAdded;
   
@@ -46,7 +49,7 @@ class RValue {
   
   void makeUsed() {
     elementsToBeAdded = Used;
-    values = {};
+    values.clear();
   }
   
   /// Private constructor used by copy().
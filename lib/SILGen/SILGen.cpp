@@ -1239,6 +1239,13 @@ void SILGenModule::useConformance(ProtocolConformanceRef conformanceRef) {
   auto conformance = conformanceRef.getConcrete();
   auto root = conformance->getRootNormalConformance();
 
+  // We land here for every conformance in every substitution list of every
+  // apply, so repeated uses of the same root conformance are by far the
+  // common case. Once the root has been recorded as used there is nothing
+  // left to do; a used conformance can never become delayed afterwards.
+  if (usedConformances.count(root))
+    return;
+
   // If we already emitted this witness table, we don't need to track the fact
   // we need it.
   if (emittedWitnessTables.count(root))
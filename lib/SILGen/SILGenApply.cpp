@@ -5007,7 +5007,7 @@ ArgumentSource SILGenFunction::prepareAccessorBaseArg(SILLocation loc,
         return base.isLValue() || base.isPlusZeroRValueOrTrivial();
 
       // If the accessor wants the value directly, we definitely have to
-      // load.  TODO: don't load-and-retain if the value is passed at +0.
+      // load.
       case ParameterConvention::Direct_Owned:
       case ParameterConvention::Direct_Unowned:
       case ParameterConvention::Direct_Guaranteed:
@@ -5020,8 +5020,20 @@ ArgumentSource SILGenFunction::prepareAccessorBaseArg(SILLocation loc,
       // The load can only be a take if the base is a +1 rvalue.
       auto shouldTake = IsTake_t(base.hasCleanup());
 
+      // If the accessor wants self guaranteed and the base is a +0 rvalue,
+      // the borrowed memory stays valid across the call, so we can load
+      // without retaining. This is the direct analogue of the
+      // Indirect_In_Guaranteed case above, which passes the borrowed memory
+      // along as-is.
+      bool isGuaranteedValid =
+        selfParam.getConvention() == ParameterConvention::Direct_Guaranteed &&
+        base.isPlusZeroRValueOrTrivial();
+
       base = emitLoad(loc, base.forward(*this), getTypeLowering(baseLoweredType),
-                      SGFContext(), shouldTake);
+                      isGuaranteedValid
+                        ? SGFContext(SGFContext::AllowGuaranteedPlusZero)
+                        : SGFContext(),
+                      shouldTake, isGuaranteedValid);
 
     // Handle inout bases specially here.
     } else if (selfParam.isIndirectInOut()) {
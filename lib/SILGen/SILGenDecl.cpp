@@ -1947,6 +1947,14 @@ public:
 }
 
 void SILGenModule::emitDefaultWitnessTable(ProtocolDecl *protocol) {
+  // Default witness tables only exist to support evolution of resilient
+  // protocols. IRGen does not reference the table when building the protocol
+  // descriptor of a fixed-layout protocol (see emitProtocolDecl), so emitting
+  // one here — together with the default witness thunks it would point at —
+  // just produces SIL that the optimizer has to dead-strip again.
+  if (protocol->hasFixedLayout())
+    return;
+
   SILLinkage linkage =
       getSILLinkage(getDeclLinkage(protocol), ForDefinition);
 
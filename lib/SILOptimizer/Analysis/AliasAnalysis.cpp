@@ -24,12 +24,16 @@
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILModule.h"
 #include "swift/SIL/InstructionUtils.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace swift;
 
+STATISTIC(NumAliasQueries, "Number of alias queries");
+STATISTIC(NumAliasCacheHits, "Number of alias queries answered from the cache");
+
 
 // The AliasAnalysis Cache must not grow beyond this size.
 // We limit the size of the AA cache to 2**14 because we want to limit the
@@ -534,26 +538,40 @@ bool AliasAnalysis::typesMayAlias(SILType T1, SILType T2) {
 /// to disambiguate the two values.
 AliasResult AliasAnalysis::alias(SILValue V1, SILValue V2,
                                  SILType TBAAType1, SILType TBAAType2) {
+  ++NumAliasQueries;
+  ++QueryCount;
+
   AliasKeyTy Key = toAliasKey(V1, V2, TBAAType1, TBAAType2);
+  SILFunction *CacheFunc = getCacheFunction(V1, V2);
 
   // Check if we've already computed this result.
-  auto It = AliasCache.find(Key);
-  if (It != AliasCache.end()) {
-    return It->second;
+  {
+    auto &Cache = AliasCaches[CacheFunc];
+    auto It = Cache.find(Key);
+    if (It != Cache.end()) {
+      ++NumAliasCacheHits;
+      return It->second;
+    }
   }
 
-  // Flush the cache if the size of the cache is too large.
-  if (AliasCache.size() > AliasAnalysisMaxCacheSize) {
-    AliasCache.clear();
+  // Flush all buckets if the caches got too large. The indices stored in the
+  // keys are only meaningful relative to the current value enumerator, so all
+  // buckets must be cleared together with it.
+  if (AliasCacheSize > AliasAnalysisMaxCacheSize) {
+    AliasCaches.clear();
+    AliasCacheSize = 0;
     AliasValueBaseToIndex.clear();
 
     // Key is no longer valid as we cleared the AliasValueBaseToIndex.
     Key = toAliasKey(V1, V2, TBAAType1, TBAAType2);
   }
 
-  // Calculate the aliasing result and store it in the cache.
+  // Calculate the aliasing result and store it in the cache. Note that the
+  // bucket must be looked up again, because aliasInner may have added cache
+  // entries itself.
   auto Result = aliasInner(V1, V2, TBAAType1, TBAAType2);
-  AliasCache[Key] = Result;
+  AliasCaches[CacheFunc][Key] = Result;
+  ++AliasCacheSize;
   return Result;
 }
 
@@ -755,6 +773,22 @@ SILAnalysis *swift::createAliasAnalysis(SILModule *M) {
   return new AliasAnalysis(M);
 }
 
+/// Returns the function containing \p V, or null for values like SILUndef
+/// which are not contained in any function.
+static SILFunction *getFunctionOfValue(SILValue V) {
+  if (auto *Inst = dyn_cast<SILInstruction>(V))
+    return Inst->getFunction();
+  if (auto *Arg = dyn_cast<SILArgument>(V))
+    return Arg->getFunction();
+  return nullptr;
+}
+
+SILFunction *AliasAnalysis::getCacheFunction(SILValue V1, SILValue V2) {
+  if (SILFunction *F = getFunctionOfValue(V1))
+    return F;
+  return getFunctionOfValue(V2);
+}
+
 AliasKeyTy AliasAnalysis::toAliasKey(SILValue V1, SILValue V2,
                                      SILType Type1, SILType Type2) {
   size_t idx1 = AliasValueBaseToIndex.getIndex(V1);
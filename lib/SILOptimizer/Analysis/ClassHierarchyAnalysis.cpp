@@ -31,19 +31,36 @@ public:
   }
 
   virtual bool walkToDeclPre(Decl *D) {
-    auto *NTD = dyn_cast<NominalTypeDecl>(D);
-    if (!NTD)
+    if (auto *NTD = dyn_cast<NominalTypeDecl>(D)) {
+      auto Protocols = NTD->getAllProtocols();
+      // We are only interested in types implementing protocols.
+      if (!Protocols.empty()) {
+        for (auto &Protocol : Protocols) {
+          addImplementation(Protocol, NTD);
+        }
+      }
       return true;
-    auto Protocols = NTD->getAllProtocols();
-    // We are only interested in types implementing protocols.
-    if (!Protocols.empty()) {
-      for (auto &Protocol : Protocols) {
-        auto &K = ProtocolImplementationsCache[Protocol];
-        K.push_back(NTD);
+    }
+    // An extension can retroactively add a conformance to a type from a
+    // different module, whose declaration is never walked here. Record such
+    // conformances as well, so that the cache contains the full conformance
+    // closure of the module.
+    if (auto *ED = dyn_cast<ExtensionDecl>(D)) {
+      if (auto *ExtNTD = ED->getExtendedType()->getAnyNominal()) {
+        for (auto *Protocol : ED->getLocalProtocols()) {
+          addImplementation(Protocol, ExtNTD);
+        }
       }
     }
     return true;
   }
+
+private:
+  void addImplementation(ProtocolDecl *Protocol, NominalTypeDecl *NTD) {
+    auto &K = ProtocolImplementationsCache[Protocol];
+    if (std::find(K.begin(), K.end(), NTD) == K.end())
+      K.push_back(NTD);
+  }
 };
 }
 
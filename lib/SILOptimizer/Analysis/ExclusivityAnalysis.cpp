@@ -0,0 +1,144 @@
+//===--- ExclusivityAnalysis.cpp - Inout non-aliasing certification -------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "exclusivity-analysis"
+#include "swift/SILOptimizer/Analysis/ExclusivityAnalysis.h"
+#include "swift/SIL/InstructionUtils.h"
+#include "swift/SIL/SILArgument.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+/// Returns true if \p I is an access or projection through which an
+/// @inout_aliasable argument's address may flow without invalidating the
+/// non-aliasing certification. Everything else - in particular anything that
+/// could let the address escape, like address_to_pointer or storing it into a
+/// box - defeats it.
+static bool isRecognizedAccess(SILInstruction &I) {
+  switch (I.getKind()) {
+  case ValueKind::LoadInst:
+  case ValueKind::StoreInst:
+  // Note that only non-releasing forms of copy_addr get this far; a
+  // copy_addr that overwrites initialized memory can run a deinit and is
+  // rejected by the mayRelease() check in compute() below.
+  case ValueKind::CopyAddrInst:
+  case ValueKind::DebugValueAddrInst:
+  case ValueKind::StructElementAddrInst:
+  case ValueKind::TupleElementAddrInst:
+  case ValueKind::IndexAddrInst:
+  case ValueKind::InjectEnumAddrInst:
+  case ValueKind::InitEnumDataAddrInst:
+  case ValueKind::UncheckedTakeEnumDataAddrInst:
+  case ValueKind::SwitchEnumAddrInst:
+  case ValueKind::SelectEnumAddrInst:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool ExclusivityAnalysis::areInoutsProvablyUnaliased(SILFunction *F) {
+  auto Iter = Cache.find(F);
+  if (Iter != Cache.end())
+    return Iter->second;
+
+  bool Result = compute(F);
+  Cache[F] = Result;
+  return Result;
+}
+
+bool ExclusivityAnalysis::compute(SILFunction *F) {
+  if (F->empty())
+    return false;
+
+  // Without an @inout_aliasable argument there is nothing to certify; the
+  // strict conventions already carry a non-aliasing guarantee.
+  bool HasAliasableArg = false;
+  for (auto *Arg : F->begin()->getBBArgs()) {
+    if (Arg->getArgumentConvention() ==
+          SILArgumentConvention::Indirect_InoutAliasable)
+      HasAliasableArg = true;
+  }
+  if (!HasAliasableArg)
+    return false;
+
+  // The single @inout_aliasable argument that accesses were seen through.
+  SILArgument *AccessedAliasableArg = nullptr;
+
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      // Any call could reach the captured variable through its own context
+      // or a global, and that access would happen during this function's
+      // execution. A single call site therefore defeats the certification.
+      if (FullApplySite::isa(&I) || isa<PartialApplyInst>(&I))
+        return false;
+      // Releasing a reference (or deallocating one) can run a deinit, which
+      // is arbitrary code just like a call: it may write the captured
+      // variable through another reference to its box during this
+      // function's execution. This also rejects destroy_addr and
+      // copy_addr-overwrite of the argument itself.
+      if (I.mayRelease() || isa<DeallocRefInst>(&I))
+        return false;
+      if (auto *BI = dyn_cast<BuiltinInst>(&I)) {
+        if (BI->mayReadOrWriteMemory())
+          return false;
+        continue;
+      }
+
+      for (auto &Op : I.getAllOperands()) {
+        SILValue V = Op.get();
+        if (!V->getType().isAddress())
+          continue;
+
+        SILValue Root = getUnderlyingObject(V);
+        if (auto *Arg = dyn_cast<SILArgument>(Root)) {
+          if (!Arg->isFunctionArg())
+            return false;
+          // A captured variable may legally overlap any other argument of
+          // the same call: a strict @inout (calling a closure that captures
+          // x with &x is well-formed), an indirect parameter or result, or
+          // a second capture of the same variable. The certification
+          // therefore only survives if the aliasable argument is the sole
+          // argument memory is ever accessed through, and only via plain
+          // accesses and projections.
+          if (Arg->getArgumentConvention() !=
+                SILArgumentConvention::Indirect_InoutAliasable)
+            return false;
+          if (AccessedAliasableArg && AccessedAliasableArg != Arg)
+            return false;
+          if (!isRecognizedAccess(I))
+            return false;
+          AccessedAliasableArg = Arg;
+          continue;
+        }
+        // Function-local allocations are fresh memory and cannot overlap
+        // the captured variable.
+        if (isa<AllocationInst>(Root))
+          continue;
+        // Globals, class storage and raw-pointer conversions might overlap
+        // the captured variable; give up.
+        return false;
+      }
+    }
+  }
+
+  DEBUG(llvm::dbgs() << "  inouts of " << F->getName()
+                     << " are provably unaliased\n");
+  return true;
+}
+
+SILAnalysis *swift::createExclusivityAnalysis(SILModule *M) {
+  return new ExclusivityAnalysis(M);
+}
@@ -17,10 +17,15 @@
 #include "swift/SILOptimizer/Analysis/SideEffectAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ValueTracking.h"
 #include "swift/SIL/SILVisitor.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 
 using namespace swift;
 
+STATISTIC(NumMemBehaviorQueries, "Number of memory behavior queries");
+STATISTIC(NumMemBehaviorCacheHits,
+          "Number of memory behavior queries answered from the cache");
+
 // The MemoryBehavior Cache must not grow beyond this size.
 // We limit the size of the MB cache to 2**14 because we want to limit the
 // memory usage of this cache.
@@ -303,26 +308,41 @@ MemBehavior MemoryBehaviorVisitor::visitReleaseValueInst(ReleaseValueInst *SI) {
 MemBehavior
 AliasAnalysis::computeMemoryBehavior(SILInstruction *Inst, SILValue V,
                                      RetainObserveKind InspectionMode) {
+  ++NumMemBehaviorQueries;
+  ++QueryCount;
+
   MemBehaviorKeyTy Key = toMemoryBehaviorKey(SILValue(Inst), V,
                                              InspectionMode);
+  SILFunction *CacheFunc = getCacheFunction(SILValue(Inst), V);
+
   // Check if we've already computed this result.
-  auto It = MemoryBehaviorCache.find(Key);
-  if (It != MemoryBehaviorCache.end()) {
-    return It->second;
+  {
+    auto &Cache = MemoryBehaviorCaches[CacheFunc];
+    auto It = Cache.find(Key);
+    if (It != Cache.end()) {
+      ++NumMemBehaviorCacheHits;
+      return It->second;
+    }
   }
 
-  // Flush the cache if the size of the cache is too large.
-  if (MemoryBehaviorCache.size() > MemoryBehaviorAnalysisMaxCacheSize) {
-    MemoryBehaviorCache.clear();
+  // Flush all buckets if the caches got too large. The indices stored in the
+  // keys are only meaningful relative to the current value enumerator, so all
+  // buckets must be cleared together with it.
+  if (MemoryBehaviorCacheSize > MemoryBehaviorAnalysisMaxCacheSize) {
+    MemoryBehaviorCaches.clear();
+    MemoryBehaviorCacheSize = 0;
     MemoryBehaviorValueBaseToIndex.clear();
 
     // Key is no longer valid as we cleared the MemoryBehaviorValueBaseToIndex.
     Key = toMemoryBehaviorKey(SILValue(Inst), V, InspectionMode);
   }
 
-  // Calculate the aliasing result and store it in the cache.
+  // Calculate the aliasing result and store it in the cache. Note that the
+  // bucket must be looked up again, because the recursive computation may
+  // have added cache entries itself.
   auto Result = computeMemoryBehaviorInner(Inst, V, InspectionMode);
-  MemoryBehaviorCache[Key] = Result;
+  MemoryBehaviorCaches[CacheFunc][Key] = Result;
+  ++MemoryBehaviorCacheSize;
   return Result;
 }
 
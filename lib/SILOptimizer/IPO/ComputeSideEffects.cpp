@@ -0,0 +1,101 @@
+//===--- ComputeSideEffects.cpp - Stamp computed effects on functions -----===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "compute-side-effects"
+#include "swift/SILOptimizer/Analysis/SideEffectAnalysis.h"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumEffectsKindsStamped, "Number of @effects attributes stamped");
+
+namespace {
+
+/// Stamps side-effect information computed by the SideEffectAnalysis onto
+/// functions as @effects attributes.
+///
+/// The attribute is part of the serialized SILFunction record, so other
+/// modules which deserialize a function declaration get a precise effects
+/// summary without having to load the function body. Within the module it is
+/// a no-op: the analysis already knows everything the attribute says.
+class ComputeSideEffects : public SILModuleTransform {
+
+  void run() override {
+    auto *SEA = PM->getAnalysis<SideEffectAnalysis>();
+
+    for (SILFunction &F : *getModule()) {
+      // Don't override effects specified by the user (or by a previous run).
+      if (!F.isDefinition() || F.hasEffectsKind())
+        continue;
+
+      auto Kind = getComputedEffectsKind(SEA->getEffects(&F), &F);
+      if (Kind == EffectsKind::Unspecified)
+        continue;
+
+      DEBUG(llvm::dbgs() << "  stamp effects(" << (unsigned)Kind << ") on "
+                         << F.getName() << '\n');
+      F.setEffectsKind(Kind);
+      ++NumEffectsKindsStamped;
+    }
+  }
+
+  /// Returns the strongest @effects kind which is implied by the computed
+  /// effects \p FE, or EffectsKind::Unspecified if there is none.
+  ///
+  /// The mapping must be conservative with respect to what
+  /// SideEffectAnalysis::getDefinedEffects assumes for each kind: readnone
+  /// implies no effects at all, readonly implies at most reads.
+  EffectsKind
+  getComputedEffectsKind(const SideEffectAnalysis::FunctionEffects &FE,
+                         SILFunction *F) {
+    if (FE.mayAllocObjects() || FE.mayTrap() || FE.mayReadRC())
+      return EffectsKind::Unspecified;
+
+    bool Reads = false;
+    auto accumulate = [&](const SideEffectAnalysis::Effects &E) -> bool {
+      if (E.mayWrite() || E.mayRetain() || E.mayRelease())
+        return false;
+      Reads |= E.mayRead();
+      return true;
+    };
+
+    if (!accumulate(FE.getGlobalEffects()))
+      return EffectsKind::Unspecified;
+    for (auto &PE : FE.getParameterEffects()) {
+      if (!accumulate(PE))
+        return EffectsKind::Unspecified;
+    }
+
+    if (!Reads)
+      return EffectsKind::ReadNone;
+
+    // A readonly attribute is worthless if the function has owned parameters,
+    // because releasing them may call a deinit, which can do anything.
+    if (!F->hasOwnedParameters())
+      return EffectsKind::ReadOnly;
+
+    return EffectsKind::Unspecified;
+  }
+
+  StringRef getName() override { return "Compute Side Effects"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createComputeSideEffects() {
+  return new ComputeSideEffects();
+}
@@ -20,12 +20,36 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
 using namespace swift;
 
 STATISTIC(NumDeadFunc, "Number of dead functions eliminated");
 STATISTIC(NumEliminatedExternalDefs, "Number of external function definitions eliminated");
 
+// The two-phase app-wide dead function elimination scheme: every module
+// writes the external symbols it still references to a manifest
+// (-sil-emit-used-symbols). The build system aggregates the manifests of all
+// modules of the application and feeds the union back into the final build
+// (-sil-externally-used-symbols), where public functions which no other
+// module references may be removed like internal ones.
+static llvm::cl::opt<std::string> UsedSymbolsOutputPath(
+    "sil-emit-used-symbols", llvm::cl::init(""),
+    llvm::cl::desc("Write the names of all external functions which are still "
+                   "referenced after dead function elimination to the given "
+                   "file"));
+
+static llvm::cl::opt<std::string> ExternallyUsedSymbolsPath(
+    "sil-externally-used-symbols", llvm::cl::init(""),
+    llvm::cl::desc("Treat only the public functions named in the given file "
+                   "as referenced from outside the module; all other public "
+                   "functions may be removed if nothing in the module uses "
+                   "them"));
+
 namespace {
 
 /// This is a base class for passes that are based on function liveness
@@ -58,7 +82,7 @@ protected:
   llvm::SmallPtrSet<SILFunction *, 32> AliveFunctions;
 
   /// Checks is a function is alive, e.g. because it is visible externally.
-  bool isAnchorFunction(SILFunction *F) {
+  virtual bool isAnchorFunction(SILFunction *F) {
 
     // Remove internal functions that are not referenced by anything.
     if (isPossiblyUsedExternally(F->getLinkage(), Module->isWholeModule()))
@@ -290,6 +314,61 @@ namespace {
 
 class DeadFunctionElimination : FunctionLivenessComputation {
 
+  /// The symbols the rest of the application references, read from
+  /// -sil-externally-used-symbols.
+  llvm::StringSet<> ExternallyUsedSymbols;
+
+  /// True if a used-symbol manifest could be loaded. Only then public
+  /// functions which are not listed in it lose their anchor status.
+  bool HasUsedSymbolsManifest = false;
+
+  void loadUsedSymbolsManifest() {
+    auto FileOrErr = llvm::MemoryBuffer::getFile(ExternallyUsedSymbolsPath);
+    if (!FileOrErr) {
+      llvm::errs() << "warning: could not read used-symbol manifest '"
+                   << ExternallyUsedSymbolsPath << "'\n";
+      return;
+    }
+    for (llvm::line_iterator LineIt(**FileOrErr, /*SkipBlanks=*/true, '#');
+         !LineIt.is_at_eof(); ++LineIt) {
+      StringRef Name = LineIt->trim();
+      if (!Name.empty())
+        ExternallyUsedSymbols.insert(Name);
+    }
+    HasUsedSymbolsManifest = true;
+  }
+
+  /// With an application-wide manifest of used symbols, a public function
+  /// is only an anchor if some other module actually references it.
+  bool isAnchorFunction(SILFunction *F) override {
+    if (HasUsedSymbolsManifest && F->isDefinition() &&
+        F->getLinkage() == SILLinkage::Public &&
+        F->getRepresentation() != SILFunctionTypeRepresentation::ObjCMethod &&
+        !F->isKeepAsPublic() &&
+        !ExternallyUsedSymbols.count(F->getName())) {
+      DEBUG(llvm::dbgs() << "DFE: " << F->getName()
+                         << " is not in the used-symbol manifest\n");
+      return false;
+    }
+    return FunctionLivenessComputation::isAnchorFunction(F);
+  }
+
+  /// Write the names of all external functions which the module still
+  /// references. The build system aggregates these manifests app-wide.
+  void emitUsedSymbols() {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(UsedSymbolsOutputPath, EC, llvm::sys::fs::F_Text);
+    if (EC) {
+      llvm::errs() << "warning: could not write used-symbol manifest '"
+                   << UsedSymbolsOutputPath << "': " << EC.message() << '\n';
+      return;
+    }
+    for (SILFunction &F : *Module) {
+      if (!F.isDefinition())
+        OS << F.getName() << '\n';
+    }
+  }
+
   /// DeadFunctionElimination pass takes functions
   /// reachable via vtables and witness_tables into account
   /// when computing a function liveness information.
@@ -372,7 +451,7 @@ class DeadFunctionElimination : FunctionLivenessComputation {
           return true;
         }
         return false;
-      });
+      }, *Module);
     }
 
     auto &WitnessTables = Module->getWitnessTableList();
@@ -392,7 +471,10 @@ class DeadFunctionElimination : FunctionLivenessComputation {
 
 public:
   DeadFunctionElimination(SILModule *module)
-      : FunctionLivenessComputation(module) {}
+      : FunctionLivenessComputation(module) {
+    if (!ExternallyUsedSymbolsPath.empty())
+      loadUsedSymbolsManifest();
+  }
 
   /// The main entry point of the optimization.
   void eliminateFunctions(SILModuleTransform *DFEPass) {
@@ -420,6 +502,11 @@ public:
         Module->eraseFunction(F);
       }
     }
+
+    // After the dead functions are gone, the remaining declarations are
+    // exactly the external symbols this module still references.
+    if (!UsedSymbolsOutputPath.empty())
+      emitUsedSymbols();
   }
 };
 
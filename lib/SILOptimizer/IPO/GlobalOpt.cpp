@@ -76,9 +76,16 @@ class SILGlobalOpt {
   bool UnhandledOnceCallee = false;
   // Record number of times a globalinit_func is called by "once".
   llvm::DenseMap<SILFunction*, unsigned> InitializerCount;
+
+  // If true, only convert trivial initializers into static initial values and
+  // leave all loads and addressor calls alone. This mode is safe to run even
+  // at -Onone.
+  bool StaticInitializersOnly;
 public:
-  SILGlobalOpt(SILModule *M, DominanceAnalysis *DA): Module(M), DA(DA),
-                                                     ColdBlocks(DA) {}
+  SILGlobalOpt(SILModule *M, DominanceAnalysis *DA,
+               bool StaticInitializersOnly = false)
+      : Module(M), DA(DA), ColdBlocks(DA),
+        StaticInitializersOnly(StaticInitializersOnly) {}
 
   bool run();
 
@@ -697,7 +704,8 @@ void SILGlobalOpt::optimizeInitializer(SILFunction *AddrF,
         SILG->getName() << '\n');
 
   // Remove "once" call from the addressor.
-  if (!isAssignedOnlyOnceInInitializer(SILG) || !SILG->getDecl()) {
+  if (StaticInitializersOnly || !isAssignedOnlyOnceInInitializer(SILG) ||
+      !SILG->getDecl()) {
     removeToken(CallToOnce->getOperand(0));
     CallToOnce->eraseFromParent();
     SILG->setInitializer(InitF);
@@ -895,7 +903,8 @@ bool SILGlobalOpt::run() {
           if (!IsCold)
             collectGlobalInitCall(AI);
         } else if (GlobalAddrInst *GAI = dyn_cast<GlobalAddrInst>(&I)) {
-            collectGlobalAccess(GAI);
+            if (!StaticInitializersOnly)
+              collectGlobalAccess(GAI);
         }
     }
   }
@@ -903,7 +912,8 @@ bool SILGlobalOpt::run() {
   for (auto &InitCalls : GlobalInitCallMap) {
     // Optimize the addressors if possible.
     optimizeInitializer(InitCalls.first, InitCalls.second);
-    placeInitializers(InitCalls.first, InitCalls.second);
+    if (!StaticInitializersOnly)
+      placeInitializers(InitCalls.first, InitCalls.second);
   }
 
   for (auto &Init : GlobalVarStore) {
@@ -926,8 +936,29 @@ class SILGlobalOptPass : public SILModuleTransform
 
   StringRef getName() override { return "SIL Global Optimization"; }
 };
+
+/// A stripped-down flavor of SILGlobalOpt that only converts trivial
+/// globalinit functions into static initial values. It performs none of the
+/// load or addressor rewriting, so it can run at -Onone, where it removes the
+/// swift_once overhead from globals initialized with constant aggregates of
+/// literals.
+class SILStaticInitializerPromotionPass : public SILModuleTransform
+{
+  void run() override {
+    DominanceAnalysis *DA = PM->getAnalysis<DominanceAnalysis>();
+    if (SILGlobalOpt(getModule(), DA, /*StaticInitializersOnly*/ true).run()) {
+      invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
+    }
+  }
+
+  StringRef getName() override { return "SIL Static Initializer Promotion"; }
+};
 } // anonymous
 
 SILTransform *swift::createGlobalOpt() {
   return new SILGlobalOptPass();
 }
+
+SILTransform *swift::createStaticInitializerPromotion() {
+  return new SILStaticInitializerPromotionPass();
+}
@@ -31,13 +31,17 @@
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "swift/SILOptimizer/Utils/CFG.h"
 #include "swift/SILOptimizer/Utils/Local.h"
+#include "swift/SILOptimizer/Utils/OptimizationRemark.h"
 #include "swift/SILOptimizer/Utils/SILSSAUpdater.h"
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 using namespace swift;
 
+STATISTIC(NumMakeMutableRemoved, "Number of redundant make_mutable calls removed");
+
 #ifndef NDEBUG
 llvm::cl::opt<std::string>
 COWViewCFGFunction("view-cfg-before-cow-for", llvm::cl::init(""),
@@ -1540,6 +1544,11 @@ bool COWArrayOpt::run() {
           continue;
         }
 
+        if (OptRemark::isEnabled())
+          OptRemark::emitPassed("cowarray-opt", "HoistedMakeMutable",
+                                static_cast<ApplyInst *>(MakeMutableCall),
+                                "hoisted make_mutable check out of the loop");
+
         ArrayMakeMutableMap[CurrentArrayAddr] = MakeMutableCall;
         HasChanged = true;
         continue;
@@ -1550,12 +1559,53 @@ bool COWArrayOpt::run() {
 
       DEBUG(llvm::dbgs() << "    Removing make_mutable call: " << *MakeMutableCall);
       MakeMutableCall.removeCall();
+      ++NumMakeMutableRemoved;
       HasChanged = true;
     }
   }
   return HasChanged;
 }
 
+/// Remove make_mutable calls which are preceded by another make_mutable call
+/// on the same array in the same basic block, with no operation in between
+/// that may make the array non-uniquely referenced again. The uniqueness
+/// check of the second call is guaranteed to succeed.
+static bool removeRedundantMakeMutable(SILFunction *F) {
+  bool Changed = false;
+  llvm::SmallPtrSet<ValueBase *, 4> MutableArrays;
+  for (auto &BB : *F) {
+    MutableArrays.clear();
+    for (auto II = BB.begin(), IE = BB.end(); II != IE;) {
+      SILInstruction *Inst = &*II;
+      ++II;
+
+      ArraySemanticsCall SemCall(Inst);
+      if (SemCall && SemCall.getKind() == ArrayCallKind::kMakeMutable) {
+        if (!MutableArrays.insert(SemCall.getSelf()).second) {
+          DEBUG(llvm::dbgs() << "    Removing redundant make_mutable call: "
+                             << *Inst);
+          SemCall.removeCall();
+          ++NumMakeMutableRemoved;
+          Changed = true;
+        }
+        continue;
+      }
+
+      // Array operations which cannot capture the array value preserve
+      // uniqueness.
+      if (SemCall && !mayChangeArrayValueToNonUniqueState(SemCall))
+        continue;
+
+      // Anything else with side effects, including retains of the array
+      // value, stores and unknown calls, may revoke uniqueness of any of
+      // the arrays.
+      if (Inst->mayHaveSideEffects())
+        MutableArrays.clear();
+    }
+  }
+  return Changed;
+}
+
 namespace {
 
 class COWArrayOptPass : public SILFunctionTransform {
@@ -1567,9 +1617,15 @@ class COWArrayOptPass : public SILFunctionTransform {
     auto *LA = PM->getAnalysis<SILLoopAnalysis>();
     auto *RCIA =
       PM->getAnalysis<RCIdentityAnalysis>()->get(getFunction());
+    // First remove make_mutable calls whose uniqueness check is locally
+    // redundant, e.g. after inlining of array mutation helpers.
+    bool HasChanged = removeRedundantMakeMutable(getFunction());
+
     SILLoopInfo *LI = LA->get(getFunction());
     if (LI->empty()) {
       DEBUG(llvm::dbgs() << "  Skipping Function: No loops.\n");
+      if (HasChanged)
+        invalidateAnalysis(SILAnalysis::InvalidationKind::CallsAndInstructions);
       return;
     }
 
@@ -1590,7 +1646,6 @@ class COWArrayOptPass : public SILFunctionTransform {
     for (auto *L : *LI)
       pushChildren(L);
 
-    bool HasChanged = false;
     for (auto *L : Loops)
       HasChanged |= COWArrayOpt(RCIA, L, DA).run();
 
@@ -292,6 +292,11 @@ static bool hoistInstructions(SILLoop *Loop, DominanceInfo *DT,
         switch (semCall.getKind()) {
         case ArrayCallKind::kGetCount:
         case ArrayCallKind::kGetCapacity:
+        // The isNativeTypeChecked property is invariant as long as the array
+        // value is. Hoisting it out of get_element loops is what allows the
+        // bounds check optimization to hoist the subscript checks afterwards,
+        // leaving a check-free loop body.
+        case ArrayCallKind::kArrayPropsIsNativeTypeChecked:
           if (hasLoopInvariantOperands(Inst, Loop) &&
               semCall.canHoist(Preheader->getTerminator(), DT)) {
             Changed = true;
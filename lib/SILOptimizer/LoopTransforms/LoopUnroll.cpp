@@ -427,33 +427,44 @@ class LoopUnrolling : public SILFunctionTransform {
   StringRef getName() override { return "SIL Loop Unrolling"; }
 
   void run() override {
-    bool Changed = false;
-
     auto *Fun = getFunction();
-    SILLoopInfo *LoopInfo = PM->getAnalysis<SILLoopAnalysis>()->get(Fun);
-
-    // Collect innermost loops.
-    SmallVector<SILLoop *, 16> InnermostLoops;
-    for (auto *Loop : *LoopInfo) {
-      SmallVector<SILLoop *, 8> Worklist;
-      Worklist.push_back(Loop);
-
-      for (unsigned i = 0; i < Worklist.size(); ++i) {
-        auto *L = Worklist[i];
-        for (auto *SubLoop : *L)
-          Worklist.push_back(SubLoop);
-        if (L->getSubLoops().empty())
-          InnermostLoops.push_back(L);
+    auto *LA = PM->getAnalysis<SILLoopAnalysis>();
+
+    // Unrolling the innermost loop of a nest turns its parent into an
+    // innermost loop, which may then be unrollable as well. Iterate until no
+    // more loops can be unrolled; this fully flattens small constant
+    // trip count nests. Each round removes at least one loop, so this
+    // terminates.
+    bool ChangedThisRound;
+    do {
+      ChangedThisRound = false;
+      SILLoopInfo *LoopInfo = LA->get(Fun);
+
+      // Collect innermost loops.
+      SmallVector<SILLoop *, 16> InnermostLoops;
+      for (auto *Loop : *LoopInfo) {
+        SmallVector<SILLoop *, 8> Worklist;
+        Worklist.push_back(Loop);
+
+        for (unsigned i = 0; i < Worklist.size(); ++i) {
+          auto *L = Worklist[i];
+          for (auto *SubLoop : *L)
+            Worklist.push_back(SubLoop);
+          if (L->getSubLoops().empty())
+            InnermostLoops.push_back(L);
+        }
       }
-    }
 
-    // Try to unroll innermost loops.
-    for (auto *Loop : InnermostLoops)
-      Changed |= tryToUnrollLoop(Loop);
+      // Try to unroll innermost loops.
+      for (auto *Loop : InnermostLoops)
+        ChangedThisRound |= tryToUnrollLoop(Loop);
 
-    if (Changed) {
-      invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
-    }
+      if (ChangedThisRound) {
+        // The loop info has to be recomputed before the next round looks at
+        // the parent loops.
+        invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
+      }
+    } while (ChangedThisRound);
   }
 };
 
@@ -16,6 +16,7 @@
 #include "swift/Basic/DemangleWrappers.h"
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILModule.h"
+#include "swift/SILOptimizer/Analysis/AliasAnalysis.h"
 #include "swift/SILOptimizer/Analysis/BasicCalleeAnalysis.h"
 #include "swift/SILOptimizer/Analysis/FunctionOrder.h"
 #include "swift/SILOptimizer/PassManager/PrettyStackTrace.h"
@@ -25,6 +26,7 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/TimeValue.h"
@@ -41,10 +43,21 @@ llvm::cl::opt<bool> SILPrintPassName(
     "sil-print-pass-name", llvm::cl::init(false),
     llvm::cl::desc("Print the name of each SIL pass before it runs"));
 
+llvm::cl::opt<bool> SILPrintPassQueries(
+    "sil-print-pass-aa-queries", llvm::cl::init(false),
+    llvm::cl::desc("Print the number of alias analysis queries issued by "
+                   "each pass"));
+
 llvm::cl::opt<bool> SILPrintPassTime(
     "sil-print-pass-time", llvm::cl::init(false),
     llvm::cl::desc("Print the execution time of each SIL pass"));
 
+llvm::cl::opt<std::string> SILPassReport(
+    "sil-pass-report", llvm::cl::init(""),
+    llvm::cl::desc("Append a CSV record for each pass run to the given file: "
+                   "stage, pass, function, instructions before, instructions "
+                   "after, time in microseconds"));
+
 llvm::cl::opt<unsigned> SILNumOptPassesToRun(
     "sil-opt-pass-count", llvm::cl::init(UINT_MAX),
     llvm::cl::desc("Stop optimizing after <N> optimization passes"));
@@ -95,6 +108,16 @@ llvm::cl::opt<bool> SILDisableSkippingPasses(
     "sil-disable-skipping-passes", llvm::cl::init(false),
     llvm::cl::desc("Do not skip passes even if nothing was changed"));
 
+llvm::cl::opt<bool> SILVerifyIncremental(
+    "sil-verify-incremental", llvm::cl::init(false),
+    llvm::cl::desc("After module passes, only verify the functions changed "
+                   "by the pass, with periodic full module verifications"));
+
+llvm::cl::opt<unsigned> SILVerifyIncrementalPeriod(
+    "sil-verify-incremental-period", llvm::cl::init(10),
+    llvm::cl::desc("Number of incremental verifications between full module "
+                   "verifications"));
+
 static llvm::ManagedStatic<std::vector<unsigned>> DebugPassNumbers;
 
 namespace {
@@ -197,6 +220,41 @@ static void printModule(SILModule *Mod, bool EmitVerboseSIL) {
   }
 }
 
+/// Lazily open the file named by -sil-pass-report in append mode, so that
+/// reports from all pass managers (and all frontend jobs writing to the same
+/// file) accumulate into one place. Returns null if the file cannot be opened.
+static llvm::raw_ostream *getPassReportStream() {
+  static std::unique_ptr<llvm::raw_fd_ostream> ReportStream;
+  static bool Initialized = false;
+  if (!Initialized) {
+    Initialized = true;
+    std::error_code EC;
+    ReportStream.reset(new llvm::raw_fd_ostream(SILPassReport, EC,
+                                                llvm::sys::fs::F_Append));
+    if (EC) {
+      llvm::errs() << "while opening pass report file '" << SILPassReport
+                   << "': " << EC.message() << '\n';
+      ReportStream.reset();
+    }
+  }
+  return ReportStream.get();
+}
+
+static unsigned getInstructionCount(SILFunction *F) {
+  unsigned Count = 0;
+  for (auto &BB : *F)
+    for (auto I = BB.begin(), E = BB.end(); I != E; ++I)
+      ++Count;
+  return Count;
+}
+
+static unsigned getInstructionCount(SILModule *M) {
+  unsigned Count = 0;
+  for (auto &F : *M)
+    Count += getInstructionCount(&F);
+  return Count;
+}
+
 class DebugPrintEnabler {
 #ifndef NDEBUG
   bool OldDebugFlag;
@@ -315,19 +373,46 @@ void SILPassManager::runPassOnFunction(SILFunctionTransform *SFT,
     F->dump(getOptions().EmitVerboseSIL);
   }
 
+  // Count the instructions before starting the clock, so that the counting
+  // does not show up in the reported time.
+  unsigned NumInstsBefore =
+      SILPassReport.empty() ? 0 : getInstructionCount(F);
+
   llvm::sys::TimeValue StartTime = llvm::sys::TimeValue::now();
+  uint64_t StartQueries =
+      SILPrintPassQueries ? getAnalysis<AliasAnalysis>()->getQueryCount() : 0;
   Mod->registerDeleteNotificationHandler(SFT);
   if (breakBeforeRunning(F->getName(), SFT->getName()))
     LLVM_BUILTIN_DEBUGTRAP;
   SFT->run();
+  auto DeltaNanoseconds =
+      llvm::sys::TimeValue::now().nanoseconds() - StartTime.nanoseconds();
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
   Mod->removeDeleteNotificationHandler(SFT);
 
   if (SILPrintPassTime) {
-    auto Delta =
-        llvm::sys::TimeValue::now().nanoseconds() - StartTime.nanoseconds();
-    llvm::dbgs() << Delta << " (" << SFT->getName() << "," << F->getName()
-                 << ")\n";
+    llvm::dbgs() << DeltaNanoseconds << " (" << SFT->getName() << ","
+                 << F->getName() << ")\n";
+  }
+
+  if (!SILPassReport.empty()) {
+    if (auto *ReportOS = getPassReportStream()) {
+      // A pass that did not invalidate anything cannot have changed the
+      // instruction count, so don't bother recounting.
+      unsigned NumInstsAfter = CurrentPassHasInvalidated
+                                   ? getInstructionCount(F)
+                                   : NumInstsBefore;
+      *ReportOS << StageName << ',' << SFT->getName() << ',' << F->getName()
+                << ',' << NumInstsBefore << ',' << NumInstsAfter << ','
+                << DeltaNanoseconds / 1000 << '\n';
+    }
+  }
+
+  if (SILPrintPassQueries) {
+    uint64_t Delta =
+        getAnalysis<AliasAnalysis>()->getQueryCount() - StartQueries;
+    llvm::dbgs() << Delta << " AA queries (" << SFT->getName() << ","
+                 << F->getName() << ")\n";
   }
 
   // If this pass invalidated anything, print and verify.
@@ -356,14 +441,24 @@ void SILPassManager::runFunctionPasses(PassList FuncTransforms) {
   if (FuncTransforms.empty())
     return;
 
-  BasicCalleeAnalysis *BCA = getAnalysis<BasicCalleeAnalysis>();
-  BottomUpFunctionOrder BottomUpOrder(*Mod, BCA);
-  auto BottomUpFunctions = BottomUpOrder.getFunctions();
+  // Computing the bottom-up order requires finding the SCCs of the call
+  // graph, which walks every instruction in the module. If nothing was
+  // invalidated and no function was added since the last time the order was
+  // computed, the call graph cannot have changed, so reuse the cached order.
+  if (FunctionOrderIsStale) {
+    BasicCalleeAnalysis *BCA = getAnalysis<BasicCalleeAnalysis>();
+    BottomUpFunctionOrder BottomUpOrder(*Mod, BCA);
+    auto BottomUpFunctions = BottomUpOrder.getFunctions();
+    BottomUpFunctionOrderCache.assign(BottomUpFunctions.begin(),
+                                      BottomUpFunctions.end());
+    FunctionOrderIsStale = false;
+  }
 
   assert(FunctionWorklist.empty() && "Expected empty function worklist!");
 
-  FunctionWorklist.reserve(BottomUpFunctions.size());
-  for (auto I = BottomUpFunctions.rbegin(), E = BottomUpFunctions.rend();
+  FunctionWorklist.reserve(BottomUpFunctionOrderCache.size());
+  for (auto I = BottomUpFunctionOrderCache.rbegin(),
+            E = BottomUpFunctionOrderCache.rend();
        I != E; ++I) {
     auto &F = **I;
 
@@ -427,6 +522,8 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
   SMT->injectModule(Mod);
 
   CurrentPassHasInvalidated = false;
+  CurrentPassInvalidatedWholeModule = false;
+  ChangedFunctions.clear();
 
   if (SILPrintPassName)
     llvm::dbgs() << "#" << NumPassesRun << " Stage: " << StageName
@@ -439,17 +536,40 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
     printModule(Mod, Options.EmitVerboseSIL);
   }
 
+  unsigned NumInstsBefore =
+      SILPassReport.empty() ? 0 : getInstructionCount(Mod);
+
   llvm::sys::TimeValue StartTime = llvm::sys::TimeValue::now();
+  uint64_t StartQueries =
+      SILPrintPassQueries ? getAnalysis<AliasAnalysis>()->getQueryCount() : 0;
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
   Mod->registerDeleteNotificationHandler(SMT);
   SMT->run();
+  auto DeltaNanoseconds =
+      llvm::sys::TimeValue::now().nanoseconds() - StartTime.nanoseconds();
   Mod->removeDeleteNotificationHandler(SMT);
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
 
   if (SILPrintPassTime) {
-    auto Delta = llvm::sys::TimeValue::now().nanoseconds() -
-      StartTime.nanoseconds();
-    llvm::dbgs() << Delta << " (" << SMT->getName() << ",Module)\n";
+    llvm::dbgs() << DeltaNanoseconds << " (" << SMT->getName() << ",Module)\n";
+  }
+
+  if (!SILPassReport.empty()) {
+    if (auto *ReportOS = getPassReportStream()) {
+      unsigned NumInstsAfter = CurrentPassHasInvalidated
+                                   ? getInstructionCount(Mod)
+                                   : NumInstsBefore;
+      *ReportOS << StageName << ',' << SMT->getName() << ",<module>,"
+                << NumInstsBefore << ',' << NumInstsAfter << ','
+                << DeltaNanoseconds / 1000 << '\n';
+    }
+  }
+
+  if (SILPrintPassQueries) {
+    uint64_t Delta =
+        getAnalysis<AliasAnalysis>()->getQueryCount() - StartQueries;
+    llvm::dbgs() << Delta << " AA queries (" << SMT->getName()
+                 << ",Module)\n";
   }
 
   // If this pass invalidated anything, print and verify.
@@ -463,7 +583,17 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
 
   if (Options.VerifyAll &&
       (CurrentPassHasInvalidated || !SILVerifyWithoutInvalidation)) {
-    Mod->verify();
+    // In incremental mode it is enough to verify the functions the pass has
+    // changed. A periodic full sweep still catches anything which is only
+    // visible at the module level, e.g. dangling witness table entries.
+    if (SILVerifyIncremental && !CurrentPassInvalidatedWholeModule &&
+        ++NumIncrementalVerifications % SILVerifyIncrementalPeriod != 0) {
+      for (SILFunction &F : *Mod)
+        if (ChangedFunctions.count(&F))
+          F.verify();
+    } else {
+      Mod->verify();
+    }
     verifyAnalyses();
   }
 }
@@ -339,6 +339,10 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   // Do the second stack promotion on low-level SIL.
   PM.addStackPromotion();
 
+  // Relax reference counting on objects which provably never escape their
+  // allocating function and thus their thread.
+  PM.addNonAtomicRC();
+
   // Speculate virtual call targets.
   PM.addSpeculativeDevirtualization();
 
@@ -389,10 +393,23 @@ void swift::runSILOptimizationPasses(SILModule &Module) {
   PM.addDCE();
   PM.addSimplifyCFG();
 
+  // Move cold never-returning code, e.g. the construction of fatalError
+  // messages, out of the hot functions. Must be after all inlining.
+  PM.addColdPathOutlining();
+
   // Try to hoist all releases, including epilogue releases. This should be
   // after FSO.
   PM.addLateReleaseHoisting();
 
+  // Stamp the final side-effects onto the functions, so that they are
+  // serialized for clients in other modules.
+  PM.addComputeSideEffects();
+
+  // Certify functions whose @inout_aliasable arguments are provably
+  // unaliased, so IRGen can emit them as noalias parameters. Must run after
+  // all transformations which could introduce new calls or accesses.
+  PM.addCertifyExclusivity();
+
   PM.runOneIteration();
 
   PM.resetAndRemoveTransformations();
@@ -426,6 +443,16 @@ void swift::runSILPassesForOnone(SILModule &Module) {
   PM.run();
   PM.resetAndRemoveTransformations();
 
+  // Globals initialized with constant aggregates of literals don't need their
+  // lazy initialization machinery even at -Onone; give them a static initial
+  // value instead.
+  PM.addStaticInitializerPromotion();
+
+  // Large structs get fully copied into stack temporaries at every use in
+  // unoptimized code. Remove the copies whose temporary is provably never
+  // read; the pass is a cheap single scan, so it can afford to run here.
+  PM.addDeadTempCopyElimination();
+
   // Don't keep external functions from stdlib and other modules.
   // We don't want that our unoptimized version will be linked instead
   // of the optimized version from the stdlib.
@@ -28,16 +28,24 @@
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
 
 namespace swift {
 
 class AliasAnalysis;
+class ClassHierarchyAnalysis;
 
 /// This is the worklist management logic for SILCombine.
 class SILCombineWorklist {
   llvm::SmallVector<SILInstruction *, 256> Worklist;
   llvm::DenseMap<SILInstruction *, unsigned> WorklistMap;
 
+  /// Instructions which were added while the worklist was being processed.
+  /// Only instructions affected by a transformation can expose new combines,
+  /// so they seed the next iteration of the combiner, which then does not
+  /// have to rescan the whole function.
+  llvm::SetVector<SILInstruction *> DirtyInsts;
+
   void operator=(const SILCombineWorklist &RHS) = delete;
   SILCombineWorklist(const SILCombineWorklist &Worklist) = delete;
 public:
@@ -62,8 +70,21 @@ public:
   /// duplicates.
   void addInitialGroup(ArrayRef<SILInstruction *> List);
 
+  /// Returns the instructions recorded as changed while the worklist was
+  /// being processed.
+  ArrayRef<SILInstruction *> getDirtyInsts() const {
+    return DirtyInsts.getArrayRef();
+  }
+
+  /// Clear the record of changed instructions.
+  void clearDirtyInsts() { DirtyInsts.clear(); }
+
   // If I is in the worklist, remove it.
   void remove(SILInstruction *I) {
+    // The instruction may be deleted by the caller; it must not survive in
+    // the seeds for the next iteration.
+    DirtyInsts.remove(I);
+
     auto It = WorklistMap.find(I);
     if (It == WorklistMap.end())
       return; // Not in worklist.
@@ -107,6 +128,11 @@ class SILCombiner :
 
   AliasAnalysis *AA;
 
+  /// Knows about all protocol conformances in the module. Used to
+  /// devirtualize witness_method applies on existentials of internal
+  /// protocols with a single conforming type.
+  ClassHierarchyAnalysis *CHA;
+
   /// Worklist containing all of the instructions primed for simplification.
   SILCombineWorklist Worklist;
 
@@ -126,8 +152,10 @@ class SILCombiner :
   CastOptimizer CastOpt;
 
 public:
-  SILCombiner(SILBuilder &B, AliasAnalysis *AA, bool removeCondFails)
-      : AA(AA), Worklist(), MadeChange(false), RemoveCondFails(removeCondFails),
+  SILCombiner(SILBuilder &B, AliasAnalysis *AA, ClassHierarchyAnalysis *CHA,
+              bool removeCondFails)
+      : AA(AA), CHA(CHA), Worklist(), MadeChange(false),
+        RemoveCondFails(removeCondFails),
         Iteration(0), Builder(B),
         CastOpt(/* ReplaceInstUsesAction */
                 [&](SILInstruction *I, ValueBase * V) {
@@ -141,6 +169,7 @@ public:
   void clear() {
     Iteration = 0;
     Worklist.zap();
+    Worklist.clearDirtyInsts();
     MadeChange = false;
   }
 
@@ -264,6 +293,11 @@ private:
                                                          WitnessMethodInst *WMI);
   SILInstruction *propagateConcreteTypeOfInitExistential(FullApplySite AI);
 
+  /// Rewrite a witness_method apply on an existential whose protocol has
+  /// exactly one conforming type in the module to use the concrete type.
+  SILInstruction *propagateSoleConformingType(FullApplySite AI,
+                                              WitnessMethodInst *WMI);
+
   /// Perform one SILCombine iteration.
   bool doOneIteration(SILFunction &F, unsigned Iteration);
 
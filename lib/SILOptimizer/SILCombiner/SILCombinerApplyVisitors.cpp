@@ -20,6 +20,7 @@
 #include "swift/SILOptimizer/Analysis/AliasAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ARCAnalysis.h"
 #include "swift/SILOptimizer/Analysis/CFG.h"
+#include "swift/SILOptimizer/Analysis/ClassHierarchyAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ValueTracking.h"
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "llvm/ADT/SmallPtrSet.h"
@@ -540,8 +541,52 @@ void SILCombiner::eraseApply(FullApplySite FAS, const UserListTy &Users) {
   eraseInstFromFunction(*FAS.getInstruction());
 }
 
+/// Returns true if \p V is a call of a string.make function constructing an
+/// empty string literal.
+static bool isEmptyStringLiteralConstruction(SILValue V) {
+  auto *AI = dyn_cast<ApplyInst>(V);
+  if (!AI)
+    return false;
+
+  auto *Callee = AI->getReferencedFunction();
+  if (!Callee || !(Callee->hasSemanticsAttr("string.makeUTF8") ||
+                   Callee->hasSemanticsAttr("string.makeUTF16")))
+    return false;
+
+  auto *SLI = dyn_cast<StringLiteralInst>(AI->getOperand(1));
+  return SLI && SLI->getValue().empty();
+}
+
 SILInstruction *
 SILCombiner::optimizeConcatenationOfStringLiterals(ApplyInst *AI) {
+  // Concatenation with a string known to be empty is the other operand.
+  // String interpolation produces such concatenations for the empty
+  // literal segments between adjacent interpolated expressions.
+  auto *Fn = AI->getReferencedFunction();
+  if (Fn && Fn->hasSemanticsAttr("string.concat") &&
+      AI->getNumOperands() == 3) {
+    SILValue Lhs = AI->getArgument(0);
+    SILValue Rhs = AI->getArgument(1);
+    SILValue Empty, Result;
+    if (isEmptyStringLiteralConstruction(Lhs)) {
+      Empty = Lhs;
+      Result = Rhs;
+    } else if (isEmptyStringLiteralConstruction(Rhs)) {
+      Empty = Rhs;
+      Result = Lhs;
+    }
+    if (Empty) {
+      // The concatenation consumed both of its operands. The surviving
+      // operand takes over the result's ownership, but the empty string is
+      // no longer consumed and has to be released. This usually makes its
+      // construction dead so that it is removed as well.
+      Builder.setCurrentDebugScope(AI->getDebugScope());
+      Builder.createReleaseValue(AI->getLoc(), Empty, Atomicity::Atomic);
+      replaceInstUsesWith(*AI, Result);
+      return eraseInstFromFunction(*AI);
+    }
+  }
+
   // String literals concatenation optimizer.
   return tryToConcatenateStrings(AI, Builder);
 }
@@ -914,6 +959,156 @@ SILCombiner::propagateConcreteTypeOfInitExistential(FullApplySite AI,
   return propagateConcreteTypeOfInitExistential(AI, PD, PropagateIntoOperand);
 }
 
+/// Check if \p Protocol is implemented by exactly one non-generic type in the
+/// module and return that type. If an existential of such a protocol cannot
+/// cross the module boundary, the sole conforming type is the only dynamic
+/// type the existential can ever contain.
+static NominalTypeDecl *findSoleConformingType(ProtocolDecl *Protocol,
+                                               ClassHierarchyAnalysis *CHA,
+                                               SILModule &M) {
+  // An @objc protocol may be adopted by classes which are not visible to
+  // the compiler, e.g. at runtime.
+  if (Protocol->isObjC())
+    return nullptr;
+
+  // Without an associated context we cannot perform any
+  // access-based optimizations.
+  auto *DC = M.getAssociatedContext();
+  if (!DC)
+    return nullptr;
+
+  // Only handle protocols defined within the SILModule's associated context,
+  // because only for those the analysis has seen all conformances.
+  if (!Protocol->isChildContextOf(DC))
+    return nullptr;
+
+  if (!Protocol->hasAccessibility())
+    return nullptr;
+
+  // A conformance to a protocol which is visible outside of the current
+  // compilation can be declared by other files or modules.
+  switch (Protocol->getEffectiveAccess()) {
+  case Accessibility::Open:
+  case Accessibility::Public:
+    return nullptr;
+  case Accessibility::Internal:
+    if (!M.isWholeModule())
+      return nullptr;
+    break;
+  case Accessibility::FilePrivate:
+  case Accessibility::Private:
+    break;
+  }
+
+  if (!CHA->hasKnownImplementations(Protocol))
+    return nullptr;
+
+  auto &Impls = CHA->getProtocolImplementations(Protocol);
+  if (Impls.size() != 1)
+    return nullptr;
+
+  auto *NTD = Impls.front();
+  // An inheriting protocol is recorded as an implementation, but it is not
+  // a concrete type.
+  if (isa<ProtocolDecl>(NTD))
+    return nullptr;
+
+  // A generic conformer adopts the protocol at many concrete types.
+  if (NTD->isGenericContext())
+    return nullptr;
+
+  // A class conformer can be used via one of its subclasses as well.
+  if (auto *CD = dyn_cast<ClassDecl>(NTD)) {
+    if (CHA->hasKnownDirectSubclasses(CD))
+      return nullptr;
+    if (CD->checkObjCAncestry() != ObjCClassKind::NonObjC)
+      return nullptr;
+  }
+
+  return NTD;
+}
+
+/// Devirtualize a witness_method apply on an existential whose protocol has
+/// exactly one conforming type in the module. In this case the dynamic type
+/// behind the existential is statically known even if the init_existential
+/// is not visible from the apply.
+SILInstruction *
+SILCombiner::propagateSoleConformingType(FullApplySite AI,
+                                         WitnessMethodInst *WMI) {
+  // If the conformance is concrete, the devirtualizer can handle the call.
+  if (WMI->getConformance().isConcrete())
+    return nullptr;
+
+  // Don't specialize Apply instructions that return the Self type.
+  if (AI.getType().getSwiftRValueType() == WMI->getLookupType())
+    return nullptr;
+
+  // If we find arguments that are not the 'self' argument and are of the
+  // Self type then we abort the optimization.
+  for (auto Arg : AI.getArgumentsWithoutSelf()) {
+    if (Arg->getType().getSwiftRValueType() == WMI->getLookupType())
+      return nullptr;
+  }
+
+  auto &M = WMI->getModule();
+  auto *PD = WMI->getLookupProtocol();
+  auto *NTD = findSoleConformingType(PD, CHA, M);
+  if (!NTD)
+    return nullptr;
+
+  // Get the self argument.
+  SILValue Self;
+  if (auto *Apply = dyn_cast<ApplyInst>(AI)) {
+    if (Apply->hasSelfArgument())
+      Self = Apply->getSelfArgument();
+  } else if (auto *Apply = dyn_cast<TryApplyInst>(AI)) {
+    if (Apply->hasSelfArgument())
+      Self = Apply->getSelfArgument();
+  }
+  if (!Self)
+    return nullptr;
+
+  CanType ConcreteType = NTD->getDeclaredType()->getCanonicalType();
+
+  // Find the conformance of the sole type to the protocol.
+  auto Conformance =
+      M.getSwiftModule()->lookupConformance(ConcreteType, PD, nullptr);
+  if (!Conformance || !Conformance->isConcrete())
+    return nullptr;
+
+  // Unlike in propagateConcreteTypeOfInitExistential we do not see the value
+  // the existential was initialized with, so self must be the opening of an
+  // existential, which we cast to the sole conforming type.
+  CanType OpenedArchetype;
+  SILValue NewSelf;
+  Builder.setCurrentDebugScope(AI.getDebugScope());
+  if (auto *Open = dyn_cast<OpenExistentialAddrInst>(Self)) {
+    OpenedArchetype = Open->getType().getSwiftRValueType();
+    NewSelf = Builder.createUncheckedAddrCast(
+        AI.getLoc(), Open, SILType::getPrimitiveAddressType(ConcreteType));
+  } else if (auto *Open = dyn_cast<OpenExistentialRefInst>(Self)) {
+    OpenedArchetype = Open->getType().getSwiftRValueType();
+    NewSelf = Builder.createUncheckedRefCast(
+        AI.getLoc(), Open, SILType::getPrimitiveObjectType(ConcreteType));
+  } else {
+    return nullptr;
+  }
+
+  // Propagate the concrete type into the callee-operand, which is a
+  // witness_method instruction.
+  auto *NewWMI = Builder.createWitnessMethod(WMI->getLoc(), ConcreteType,
+                                             *Conformance, WMI->getMember(),
+                                             WMI->getType(),
+                                             WMI->isVolatile());
+  replaceInstUsesWith(*WMI, NewWMI);
+  eraseInstFromFunction(*WMI);
+
+  // Create a new apply instruction that uses the concrete type instead
+  // of the existential type.
+  return createApplyWithConcreteType(AI, NewSelf, Self, ConcreteType,
+                                     SILValue(), *Conformance,
+                                     OpenedArchetype);
+}
 
 SILInstruction *
 SILCombiner::propagateConcreteTypeOfInitExistential(FullApplySite AI) {
@@ -1166,7 +1361,11 @@ SILInstruction *SILCombiner::visitApplyInst(ApplyInst *AI) {
   // (apply (witness_method)) -> propagate information about
   // a concrete type from init_existential_addr or init_existential_ref.
   if (auto *WMI = dyn_cast<WitnessMethodInst>(AI->getCallee())) {
-    propagateConcreteTypeOfInitExistential(AI, WMI);
+    if (!propagateConcreteTypeOfInitExistential(AI, WMI)) {
+      // If no init_existential is visible, the dynamic type may still be
+      // statically known if the protocol has a sole conforming type.
+      propagateSoleConformingType(AI, WMI);
+    }
     return nullptr;
   }
 
@@ -1297,7 +1496,11 @@ SILInstruction *SILCombiner::visitTryApplyInst(TryApplyInst *AI) {
   // (apply (witness_method)) -> propagate information about
   // a concrete type from init_existential_addr or init_existential_ref.
   if (auto *WMI = dyn_cast<WitnessMethodInst>(AI->getCallee())) {
-    propagateConcreteTypeOfInitExistential(AI, WMI);
+    if (!propagateConcreteTypeOfInitExistential(AI, WMI)) {
+      // If no init_existential is visible, the dynamic type may still be
+      // statically known if the protocol has a sole conforming type.
+      propagateSoleConformingType(AI, WMI);
+    }
     return nullptr;
   }
 
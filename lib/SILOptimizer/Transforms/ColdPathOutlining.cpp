@@ -0,0 +1,263 @@
+//===--- ColdPathOutlining.cpp - Move cold code out of hot functions ------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Outlines cold basic blocks which end in unreachable - typically the code
+// which constructs the message for a fatalError or precondition failure -
+// into separate cold functions. Only a function_ref, an apply and the
+// unreachable remain on the cold path, which shrinks the hot function and
+// keeps the error-path code out of its instruction cache footprint.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "cold-path-outlining"
+#include "swift/SIL/SILArgument.h"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILCloner.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SIL/SILUndef.h"
+#include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumColdBlocksOutlined, "Number of cold blocks outlined");
+
+// Outlining a block smaller than this is not worth the call overhead and
+// the extra function in the module.
+static const unsigned MinOutlinedColdBlockSize = 4;
+
+//===----------------------------------------------------------------------===//
+//                            Cold Block Cloner
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// Clones a single cold basic block into a (still empty) cold sibling
+/// function, rewriting references to live-in values to the arguments of the
+/// sibling.
+class ColdBlockCloner : public SILClonerWithScopes<ColdBlockCloner> {
+  friend class SILVisitor<ColdBlockCloner>;
+  friend class SILCloner<ColdBlockCloner>;
+
+public:
+  ColdBlockCloner(SILFunction &To) : SILClonerWithScopes<ColdBlockCloner>(To) {}
+
+  void cloneColdBlock(SILBasicBlock *BB, ArrayRef<SILValue> LiveIns) {
+    SILFunction &NewF = getBuilder().getFunction();
+    SILBasicBlock *EntryBB = NewF.createBasicBlock();
+    for (SILValue LiveIn : LiveIns)
+      ValueMap[LiveIn] = SILValue(EntryBB->createBBArg(LiveIn->getType()));
+
+    getBuilder().setInsertionPoint(EntryBB);
+    for (auto &I : *BB)
+      visit(&I);
+  }
+};
+
+} // end anonymous namespace
+
+//===----------------------------------------------------------------------===//
+//                             Block Selection
+//===----------------------------------------------------------------------===//
+
+/// Collect the values which are defined outside of \p BB but used inside of
+/// it. Returns false if \p BB uses a value which cannot become an argument
+/// of an outlined function.
+static bool collectLiveIns(SILBasicBlock *BB,
+                           llvm::SmallSetVector<SILValue, 8> &LiveIns) {
+  for (auto &I : *BB) {
+    for (auto &Op : I.getAllOperands()) {
+      SILValue V = Op.get();
+      // Undefs are module-level values and don't need an argument.
+      if (isa<SILUndef>(V))
+        continue;
+      if (auto *DefI = dyn_cast<SILInstruction>(V)) {
+        if (DefI->getParent() == BB)
+          continue;
+      }
+      // We cannot pass an address of a stack location (or any other address)
+      // to a different function.
+      if (!V->getType().isObject())
+        return false;
+      // An archetype would require the outlined function to be generic; an
+      // opened existential cannot cross a function boundary at all.
+      if (V->getType().getSwiftRValueType()->hasArchetype())
+        return false;
+      LiveIns.insert(V);
+    }
+  }
+  return true;
+}
+
+/// Returns true if \p BB is a cold block which can and should be outlined.
+static bool isOutlinableColdBlock(SILBasicBlock *BB, ColdBlockInfo &ColdBlocks,
+                                  llvm::SmallSetVector<SILValue, 8> &LiveIns) {
+  // The entry block cannot be replaced by a call.
+  if (BB == &*BB->getParent()->begin())
+    return false;
+
+  // Restricting the transformation to blocks which never return means that
+  // no values, including memory locations, can be live out of the region, so
+  // outlining it only needs to pass the live-in values as arguments.
+  if (!isa<UnreachableInst>(BB->getTerminator()))
+    return false;
+
+  // Blocks with arguments would require rewriting all predecessor branches.
+  // The cold targets of a cond_br don't take arguments in practice.
+  if (!BB->bbarg_empty())
+    return false;
+
+  // An unreachable block is deleted by DCE, not outlined.
+  if (BB->pred_empty())
+    return false;
+
+  unsigned NumInsts = std::distance(BB->begin(), BB->end());
+  if (NumInsts < MinOutlinedColdBlockSize)
+    return false;
+
+  for (auto &I : *BB) {
+    if (!I.isTriviallyDuplicatable())
+      return false;
+  }
+
+  if (!collectLiveIns(BB, LiveIns))
+    return false;
+
+  return ColdBlocks.isCold(BB);
+}
+
+//===----------------------------------------------------------------------===//
+//                               Outlining
+//===----------------------------------------------------------------------===//
+
+/// Create the cold sibling function for \p BB and replace the body of \p BB
+/// with a call to it.
+static SILFunction *outlineColdBlock(SILBasicBlock *BB,
+                                     ArrayRef<SILValue> LiveIns) {
+  SILFunction *F = BB->getParent();
+  SILModule &M = F->getModule();
+  auto &Ctx = M.getASTContext();
+
+  // Each live-in value becomes a direct parameter. The callee never returns,
+  // so it does not matter for correctness whether a parameter is owned; pass
+  // non-trivial values as guaranteed to keep the caller side free of ARC
+  // traffic.
+  SmallVector<SILParameterInfo, 8> Params;
+  for (SILValue V : LiveIns) {
+    auto Conv = V->getType().isTrivial(M) ? ParameterConvention::Direct_Unowned
+                                          : ParameterConvention::Direct_Guaranteed;
+    Params.push_back(SILParameterInfo(V->getType().getSwiftRValueType(), Conv));
+  }
+  SILResultInfo VoidResult(Ctx.TheEmptyTupleType, ResultConvention::Unowned);
+  auto ExtInfo = SILFunctionType::ExtInfo(SILFunctionType::Representation::Thin,
+                                          /*pseudogeneric*/ false);
+  auto FnTy = SILFunctionType::get(nullptr, ExtInfo,
+                                   ParameterConvention::Direct_Unowned, Params,
+                                   VoidResult, None, Ctx);
+
+  // Name the sibling after the hot function.
+  llvm::SmallString<64> Name;
+  unsigned Idx = 0;
+  do {
+    Name = F->getName();
+    Name += ".cold.";
+    Name += llvm::utostr(Idx++);
+  } while (M.lookUpFunction(Name));
+
+  // Mark the sibling as noinline. The whole point of the exercise is that
+  // this code does not come back into the caller.
+  SILFunction *NewF = M.createFunction(
+      SILLinkage::Private, Name, FnTy, nullptr, F->getLocation(), IsBare,
+      IsNotTransparent, IsNotFragile, IsNotThunk, SILFunction::NotRelevant,
+      NoInline, EffectsKind::Unspecified, nullptr, F->getDebugScope(),
+      F->getDeclContext());
+
+  ColdBlockCloner Cloner(*NewF);
+  Cloner.cloneColdBlock(BB, LiveIns);
+
+  // Replace the body of the cold block with a call of the sibling. A value
+  // defined in a block terminated by unreachable cannot have uses elsewhere,
+  // so deleting back to front is safe.
+  SILLocation Loc = BB->getTerminator()->getLoc();
+  while (!BB->empty())
+    BB->back().eraseFromParent();
+
+  SILBuilder Builder(BB);
+  Builder.setCurrentDebugScope(F->getDebugScope());
+  auto *FRI = Builder.createFunctionRef(Loc, NewF);
+  Builder.createApply(Loc, FRI, SmallVector<SILValue, 8>(LiveIns.begin(),
+                                                         LiveIns.end()),
+                      /*isNonThrowing*/ false);
+  Builder.createUnreachable(Loc);
+
+  ++NumColdBlocksOutlined;
+  return NewF;
+}
+
+//===----------------------------------------------------------------------===//
+//                           Top Level Entry Point
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+class ColdPathOutlining : public SILFunctionTransform {
+
+  void run() override {
+    SILFunction *F = getFunction();
+    if (!F->shouldOptimize())
+      return;
+
+    // The outlined function is created with the location and scope of the
+    // original.
+    if (!F->hasLocation() || !F->getDebugScope())
+      return;
+
+    ColdBlockInfo ColdBlocks(PM->getAnalysis<DominanceAnalysis>());
+
+    // Select the blocks first; outlining invalidates the dominance info used
+    // by ColdBlockInfo.
+    llvm::SmallVector<std::pair<SILBasicBlock *, SmallVector<SILValue, 8>>, 4>
+        BlocksToOutline;
+    for (SILBasicBlock &BB : *F) {
+      llvm::SmallSetVector<SILValue, 8> LiveIns;
+      if (!isOutlinableColdBlock(&BB, ColdBlocks, LiveIns))
+        continue;
+      BlocksToOutline.push_back(
+          {&BB, SmallVector<SILValue, 8>(LiveIns.begin(), LiveIns.end())});
+    }
+    if (BlocksToOutline.empty())
+      return;
+
+    for (auto &Pair : BlocksToOutline) {
+      DEBUG(llvm::dbgs() << "*** outlining cold block of " << F->getName()
+                         << '\n');
+      SILFunction *NewF = outlineColdBlock(Pair.first, Pair.second);
+      notifyPassManagerOfFunction(NewF, F);
+    }
+    invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
+  }
+
+  StringRef getName() override { return "Cold Path Outlining"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createColdPathOutlining() {
+  return new ColdPathOutlining();
+}
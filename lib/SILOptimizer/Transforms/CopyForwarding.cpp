@@ -75,6 +75,7 @@ STATISTIC(NumCopyNRVO, "Number of copies removed via named return value opt.");
 STATISTIC(NumCopyForward, "Number of copies removed via forward propagation");
 STATISTIC(NumCopyBackward,
           "Number of copies removed via backward propagation");
+STATISTIC(NumDeadTempCopies, "Number of dead copies into temporaries removed");
 
 using namespace swift;
 
@@ -1217,3 +1218,94 @@ class CopyForwardingPass : public SILFunctionTransform
 SILTransform *swift::createCopyForwarding() {
   return new CopyForwardingPass();
 }
+
+//===----------------------------------------------------------------------===//
+//                     Dead Temporary Copy Elimination
+//===----------------------------------------------------------------------===//
+
+/// Return true if the given temporary is initialized by a single copy and
+/// never read afterwards: its only other uses are destroys of the copied
+/// value and the stack deallocation. \p Copy is set to the initializing copy.
+static bool isDeadTempCopy(AllocStackInst *ASI, CopyAddrInst *&Copy,
+                           SmallVectorImpl<DestroyAddrInst *> &Destroys) {
+  Copy = nullptr;
+  for (Operand *Use : ASI->getUses()) {
+    SILInstruction *UserInst = Use->getUser();
+    if (auto *CAI = dyn_cast<CopyAddrInst>(UserInst)) {
+      // A take would transfer ownership of the source into the temporary;
+      // handling that requires compensating destroys, so leave it to the
+      // full copy forwarding pass.
+      if (Copy || CAI->getDest() != ASI || !CAI->isInitializationOfDest() ||
+          CAI->isTakeOfSrc())
+        return false;
+      Copy = CAI;
+      continue;
+    }
+    if (auto *DAI = dyn_cast<DestroyAddrInst>(UserInst)) {
+      Destroys.push_back(DAI);
+      continue;
+    }
+    if (isa<DeallocStackInst>(UserInst))
+      continue;
+
+    // Any other use (including debug info for a named variable) may read the
+    // temporary; keep the copy.
+    return false;
+  }
+  return Copy != nullptr;
+}
+
+namespace {
+
+/// A minimal, always-on subset of copy forwarding for the -Onone pipeline.
+///
+/// SILGen materializes values into stack temporaries freely, and at -Onone
+/// nothing cleans those up, so every such materialization of a large struct
+/// costs a full memcpy in the debug build. This pass removes only the
+/// provably-dead ones: a temporary initialized by a single copy_addr and then
+/// merely destroyed. Unlike CopyForwardingPass it needs no dominance or
+/// post-order analysis and does a single scan over the function, which keeps
+/// it cheap enough for debug builds.
+class DeadTempCopyEliminationPass : public SILFunctionTransform {
+  void run() override {
+    // Collect the candidates first; erasing them invalidates instruction
+    // iterators.
+    llvm::SmallVector<AllocStackInst *, 8> Temps;
+    for (auto &BB : *getFunction())
+      for (auto &I : BB)
+        if (auto *ASI = dyn_cast<AllocStackInst>(&I))
+          Temps.push_back(ASI);
+
+    bool Changed = false;
+    for (AllocStackInst *ASI : Temps) {
+      CopyAddrInst *Copy;
+      SmallVector<DestroyAddrInst *, 2> Destroys;
+      if (!isDeadTempCopy(ASI, Copy, Destroys))
+        continue;
+
+      DEBUG(llvm::dbgs() << "  removing dead temp copy " << *Copy);
+      // The copy was not a take, so dropping the temporary together with
+      // its destroys leaves the source's ownership unchanged.
+      for (auto *DAI : Destroys)
+        DAI->eraseFromParent();
+      Copy->eraseFromParent();
+
+      // Only the stack deallocations are left; drop the temporary entirely.
+      while (!ASI->use_empty())
+        (*ASI->use_begin())->getUser()->eraseFromParent();
+      ASI->eraseFromParent();
+      ++NumDeadTempCopies;
+      Changed = true;
+    }
+
+    if (Changed)
+      invalidateAnalysis(SILAnalysis::InvalidationKind::CallsAndInstructions);
+  }
+
+  StringRef getName() override { return "Dead Temporary Copy Elimination"; }
+};
+} // anonymous
+
+SILTransform *swift::createDeadTempCopyElimination() {
+  return new DeadTempCopyEliminationPass();
+}
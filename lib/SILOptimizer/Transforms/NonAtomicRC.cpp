@@ -0,0 +1,87 @@
+//===--- NonAtomicRC.cpp - Mark confined RC operations non-atomic ---------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// An object which never escapes the function that allocates it can only be
+// referenced by the thread executing that function, so its reference counting
+// operations don't need atomic memory ordering. This pass uses escape
+// analysis - the same information stack promotion relies on - to find such
+// objects and marks their reference counting instructions [nonatomic], which
+// IRGen lowers to the non-atomic runtime entry points.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "non-atomic-rc"
+
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SILOptimizer/Analysis/EscapeAnalysis.h"
+#include "swift/SILOptimizer/Analysis/RCIdentityAnalysis.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+
+STATISTIC(NumNonAtomicRC, "Number of RC operations made non-atomic");
+
+using namespace swift;
+
+namespace {
+
+class NonAtomicRC : public SILFunctionTransform {
+
+  /// The entry point to the transformation.
+  void run() override {
+    SILFunction *F = getFunction();
+
+    auto *EA = PM->getAnalysis<EscapeAnalysis>();
+    auto *ConGraph = EA->getConnectionGraph(F);
+    if (!ConGraph)
+      return;
+    auto *RCIA = PM->getAnalysis<RCIdentityAnalysis>()->get(F);
+
+    bool Changed = false;
+    for (auto &BB : *F) {
+      for (auto &I : BB) {
+        auto *RCI = dyn_cast<RefCountingInst>(&I);
+        if (!RCI || RCI->isNonAtomic())
+          continue;
+
+        // Only allocations made by this function can be known to be
+        // confined to its thread.
+        SILValue Root = RCIA->getRCIdentityRoot(RCI->getOperand(0));
+        auto *ARI = dyn_cast<AllocRefInst>(Root);
+        if (!ARI)
+          continue;
+
+        auto *Node = ConGraph->getNodeOrNull(ARI, EA);
+        if (!Node || Node->escapes())
+          continue;
+
+        RCI->setNonAtomic();
+        ++NumNonAtomicRC;
+        Changed = true;
+      }
+    }
+
+    if (Changed) {
+      invalidateAnalysis(SILAnalysis::InvalidationKind::Instructions);
+    }
+  }
+
+  StringRef getName() override { return "NonAtomicRC"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createNonAtomicRC() {
+  return new NonAtomicRC();
+}
@@ -25,13 +25,17 @@
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "swift/SILOptimizer/Utils/ConstantFolding.h"
+#include "swift/SILOptimizer/Utils/OptimizationRemark.h"
 #include "swift/SILOptimizer/Utils/SILInliner.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringMap.h"
 #include <functional>
 
 
@@ -43,6 +47,66 @@ llvm::cl::opt<bool> PrintShortestPathInfo(
     "print-shortest-path-info", llvm::cl::init(false),
     llvm::cl::desc("Print shortest-path information for inlining"));
 
+llvm::cl::opt<std::string> SILInlineProfileFile(
+    "sil-inline-profile-file", llvm::cl::init(""),
+    llvm::cl::desc("Weight inlining decisions with the sample counts in the "
+                   "given file, which contains one '<mangled-name> <count>' "
+                   "pair per line"));
+
+//===----------------------------------------------------------------------===//
+//                               InlineProfile
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// Sample counts read from -sil-inline-profile-file, keyed by mangled
+/// function name.
+class InlineProfile {
+  llvm::StringMap<uint64_t> Counts;
+  uint64_t MaxCount = 0;
+
+public:
+  InlineProfile(StringRef Path) {
+    auto FileOrErr = llvm::MemoryBuffer::getFile(Path);
+    if (!FileOrErr) {
+      llvm::errs() << "warning: could not read inline profile '" << Path
+                   << "'\n";
+      return;
+    }
+    for (llvm::line_iterator LineIt(**FileOrErr, /*SkipBlanks=*/true, '#');
+         !LineIt.is_at_eof(); ++LineIt) {
+      StringRef Name, CountStr;
+      std::tie(Name, CountStr) = LineIt->trim().rsplit(' ');
+      uint64_t Count = 0;
+      if (Name.empty() || CountStr.trim().getAsInteger(10, Count))
+        continue;
+      uint64_t &Entry = Counts[Name];
+      Entry += Count;
+      MaxCount = std::max(MaxCount, Entry);
+    }
+  }
+
+  /// Returns the sample count recorded for \p F, or 0 if there is none.
+  uint64_t getCount(SILFunction *F) const {
+    return Counts.lookup(F->getName());
+  }
+
+  /// Returns the largest sample count in the profile.
+  uint64_t getMaxCount() const { return MaxCount; }
+};
+
+} // namespace
+
+/// Returns the profile specified with -sil-inline-profile-file, or null if
+/// none was given.
+static InlineProfile *getInlineProfile() {
+  if (SILInlineProfileFile.empty())
+    return nullptr;
+
+  static InlineProfile Profile(SILInlineProfileFile);
+  return &Profile;
+}
+
 //===----------------------------------------------------------------------===//
 //                               ConstantTracker
 //===----------------------------------------------------------------------===//
@@ -1105,6 +1169,13 @@ SILFunction *SILPerformanceInliner::getEligibleFunction(FullApplySite AI) {
     }
   }
 
+  // If the candidate is still an external declaration at this point, try to
+  // deserialize its body on demand instead of relying on the linker pass
+  // having pulled it in already.
+  if (Callee->isExternalDeclaration()) {
+    Callee->getModule().linkFunction(Callee, SILModule::LinkingMode::LinkNormal);
+  }
+
   // We can't inline external declarations.
   if (Callee->empty() || Callee->isExternalDeclaration()) {
     return nullptr;
@@ -1200,6 +1271,20 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
   if (Opts.Optimization == SILOptions::SILOptMode::OptimizeUnchecked)
     BaseBenefit *= 2;
 
+  // If a sample profile is available, increase the base benefit for callees
+  // which are hot at run time, so that call sites which only look cold
+  // statically are still inlined.
+  if (InlineProfile *Profile = getInlineProfile()) {
+    uint64_t Count = Profile->getCount(Callee);
+    uint64_t MaxCount = Profile->getMaxCount();
+    if (Count > MaxCount / 2)
+      BaseBenefit *= 4;
+    else if (Count > MaxCount / 8)
+      BaseBenefit *= 3;
+    else if (Count > MaxCount / 64)
+      BaseBenefit *= 2;
+  }
+
   CallerWeight.updateBenefit(Benefit, BaseBenefit);
 
   // Go through all blocks of the function, accumulate the cost and find
@@ -1477,6 +1562,10 @@ bool SILPerformanceInliner::inlineCallsIntoFunction(SILFunction *Caller) {
           Caller->size() << "] " << Callee->getName() << "\n";
     );
 
+    if (OptRemark::isEnabled())
+      OptRemark::emitPassed("inline", "Inlined", AI.getInstruction(),
+                            llvm::Twine("inlined ") + Callee->getName());
+
     SILOpenedArchetypesTracker OpenedArchetypesTracker(*Caller);
     Caller->getModule().registerDeleteNotificationHandler(&OpenedArchetypesTracker);
     // The callee only needs to know about opened archetypes used in
@@ -91,6 +91,8 @@ using namespace swift;
 
 STATISTIC(NumRetainsSunk, "Number of retains sunk");
 STATISTIC(NumReleasesHoisted, "Number of releases hoisted");
+STATISTIC(NumRetainReleasePairsEliminated,
+          "Number of retain/release pairs eliminated by code motion");
 
 llvm::cl::opt<bool> DisableRRCodeMotion("disable-rr-cm", llvm::cl::init(false));
 
@@ -457,16 +459,35 @@ void RetainCodeMotionContext::computeCodeMotionGenKillSet() {
 
 bool RetainCodeMotionContext::performCodeMotion() {
   bool Changed = false;
+  llvm::SmallVector<SILInstruction *, 8> NewRetains;
   // Create the new retain instructions.
   for (auto RC : RCRootVault) {
     auto Iter = InsertPoints.find(RC);
     if (Iter == InsertPoints.end())
       continue;
     for (auto IP : Iter->second) {
-      createIncrementBefore(Iter->first, IP);
+      NewRetains.push_back(createIncrementBefore(Iter->first, IP));
       Changed = true;
     }
   }
+  // A retain that was sunk right in front of a release of the same RC root
+  // forms a no-op pair; there is no point between the two instructions at
+  // which the lower refcount could be observed. Remove both instead of
+  // leaving the pair for another pass to find. This check must run after
+  // all the new retains are created, as the releases still serve as
+  // insertion points above.
+  for (auto *Retain : NewRetains) {
+    auto Next = std::next(SILBasicBlock::iterator(Retain));
+    if (Next == Retain->getParent()->end())
+      continue;
+    SILInstruction *Release = &*Next;
+    if (!isReleaseInstruction(Release) ||
+        getRCRoot(Retain) != getRCRoot(Release))
+      continue;
+    recursivelyDeleteTriviallyDeadInstructions(Retain, true);
+    recursivelyDeleteTriviallyDeadInstructions(Release, true);
+    ++NumRetainReleasePairsEliminated;
+  }
   // Remove the old retain instructions.
   for (auto R : RCInstructions) {
     ++NumRetainsSunk;
@@ -823,16 +844,33 @@ void ReleaseCodeMotionContext::mergeBBDataFlowStates(SILBasicBlock *BB) {
 
 bool ReleaseCodeMotionContext::performCodeMotion() {
   bool Changed = false;
+  llvm::SmallVector<SILInstruction *, 8> NewReleases;
   // Create the new releases at each anchor point.
   for (auto RC : RCRootVault) {
     auto Iter = InsertPoints.find(RC);
     if (Iter == InsertPoints.end())
       continue;
     for (auto IP : Iter->second) {
-      createDecrementBefore(Iter->first, IP);
+      NewReleases.push_back(createDecrementBefore(Iter->first, IP));
       Changed = true;
     }
   }
+  // A release that was hoisted to the point right behind a retain of the
+  // same RC root forms a no-op pair; remove both. As in the retain case,
+  // this must run after all the new releases are created, since the retain
+  // could still be an insertion point for another RC root.
+  for (auto *Release : NewReleases) {
+    auto Iter = SILBasicBlock::iterator(Release);
+    if (Iter == Release->getParent()->begin())
+      continue;
+    SILInstruction *Retain = &*std::prev(Iter);
+    if (!isRetainInstruction(Retain) ||
+        getRCRoot(Retain) != getRCRoot(Release))
+      continue;
+    recursivelyDeleteTriviallyDeadInstructions(Retain, true);
+    recursivelyDeleteTriviallyDeadInstructions(Release, true);
+    ++NumRetainReleasePairsEliminated;
+  }
   // Remove the old release instructions.
   for (auto R : RCInstructions) {
     ++NumReleasesHoisted;
@@ -44,6 +44,16 @@ using namespace swift;
 // speculative devirtualizer will try to predict.
 static const int MaxNumSpeculativeTargets = 6;
 
+// This is the limit used instead of MaxNumSpeculativeTargets if the class
+// hierarchy is known to be closed, i.e. if the default case handler can be
+// devirtualized as well. Covering all subclasses removes the fallback
+// virtual call entirely, which enables subsequent inlining of every case,
+// so a higher limit pays off.
+static llvm::cl::opt<int> MaxNumClosedHierarchySpeculativeTargets(
+    "sil-spec-devirt-closed-hierarchy-targets", llvm::cl::init(12),
+    llvm::cl::desc("Maximum number of speculative targets if the full class "
+                   "hierarchy is known"));
+
 STATISTIC(NumTargetsPredicted, "Number of monomorphic functions predicted");
 
 // A utility function for cloning the apply instruction.
@@ -394,16 +404,25 @@ static bool tryToSpeculateTarget(FullApplySite AI,
     Subs.erase(RemovedIt, Subs.end());
   }
 
+  // If the hierarchy rooted at this class is closed, a check for every
+  // subclass lets isDefaultCaseKnown remove the fallback virtual call below,
+  // so it is worth speculating on more targets than usual.
+  int SpeculativeTargetLimit = MaxNumSpeculativeTargets;
+  if ((int)Subs.size() > MaxNumSpeculativeTargets &&
+      (int)Subs.size() <= MaxNumClosedHierarchySpeculativeTargets &&
+      isDefaultCaseKnown(CHA, AI, CD, Subs))
+    SpeculativeTargetLimit = MaxNumClosedHierarchySpeculativeTargets;
+
   // Number of subclasses which cannot be handled by checked_cast_br checks.
   int NotHandledSubsNum = 0;
-  if (Subs.size() > MaxNumSpeculativeTargets) {
+  if ((int)Subs.size() > SpeculativeTargetLimit) {
     DEBUG(llvm::dbgs() << "Class " << CD->getName() << " has too many ("
                        << Subs.size() << ") subclasses. Performing speculative "
                          "devirtualization only for the first "
-                       << MaxNumSpeculativeTargets << " of them.\n");
+                       << SpeculativeTargetLimit << " of them.\n");
 
-    NotHandledSubsNum += (Subs.size() - MaxNumSpeculativeTargets);
-    Subs.erase(&Subs[MaxNumSpeculativeTargets], Subs.end());
+    NotHandledSubsNum += (Subs.size() - SpeculativeTargetLimit);
+    Subs.erase(&Subs[SpeculativeTargetLimit], Subs.end());
   }
 
   DEBUG(llvm::dbgs() << "Class " << CD->getName() << " is a superclass. "
@@ -15,6 +15,7 @@
 #include "swift/Strings.h"
 #include "swift/SILOptimizer/Utils/Generics.h"
 #include "swift/SILOptimizer/Utils/GenericCloner.h"
+#include "swift/SILOptimizer/Utils/OptimizationRemark.h"
 #include "swift/SIL/DebugUtils.h"
 
 using namespace swift;
@@ -26,6 +27,14 @@ using namespace swift;
 // a bound generic type with the depth higher than this threshold 
 static const unsigned BoundGenericDepthThreshold = 50;
 
+// Reuse pre-specializations emitted by already-compiled modules even when
+// optimizing, instead of cloning and re-optimizing the same generic bodies
+// in every compilation unit.
+static llvm::cl::opt<bool> UsePrespecializedAtOpt(
+    "sil-use-prespecialized-at-opt", llvm::cl::init(false),
+    llvm::cl::desc("Link whitelisted pre-specializations from other modules "
+                   "instead of re-specializing them at -O"));
+
 static unsigned getBoundGenericDepth(Type t) {
   unsigned Depth = 0;
   if (auto BGT = t->getAs<BoundGenericType>()) {
@@ -215,6 +224,23 @@ SILFunction *GenericFuncSpecializer::lookupSpecialization() {
                        << "\n");
     return SpecializedF;
   }
+  // If requested, reuse a pre-specialization emitted while compiling another
+  // module instead of cloning and re-optimizing the same generic body here.
+  // The mangled name keys the lookup, and the SIL linker provides an external
+  // declaration without deserializing the body. Such declarations cannot be
+  // inlined, so this trades some run-time performance of the caller for
+  // compile time.
+  if (UsePrespecializedAtOpt) {
+    if (SILFunction *ExternalF = lookupPrespecializedSymbol(M, ClonedName)) {
+      if (ExternalF->getLoweredFunctionType() == ReInfo.getSpecializedType() &&
+          ExternalF->isFragile() == Fragile) {
+        DEBUG(llvm::dbgs() << "Found a pre-specialization in another module: "
+                           << ClonedName << "\n");
+        return ExternalF;
+      }
+    }
+  }
+
   DEBUG(llvm::dbgs() << "Could not find an existing specialization for: "
                      << ClonedName << "\n");
   return nullptr;
@@ -467,8 +493,14 @@ void swift::trySpecializeApplyOfGeneric(
     Fragile = IsFragile;
 
   ReabstractionInfo ReInfo(RefF, Apply.getSubstitutions());
-  if (!ReInfo.getSpecializedType())
+  if (!ReInfo.getSpecializedType()) {
+    if (OptRemark::isEnabled())
+      OptRemark::emitMissed("generic-specializer", "NoSpecialization",
+                            Apply.getInstruction(),
+                            llvm::Twine("cannot specialize call to ") +
+                                RefF->getName());
     return;
+  }
 
   SILModule &M = F->getModule();
 
@@ -520,6 +552,12 @@ void swift::trySpecializeApplyOfGeneric(
     if (!SpecializedF)
       return;
 
+    if (OptRemark::isEnabled())
+      OptRemark::emitPassed("generic-specializer", "Specialized",
+                            Apply.getInstruction(),
+                            llvm::Twine("specialized call to ") +
+                                RefF->getName());
+
     NewFunctions.push_back(SpecializedF);
   }
 
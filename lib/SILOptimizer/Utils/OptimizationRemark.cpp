@@ -0,0 +1,89 @@
+//===--- OptimizationRemark.cpp - Remarks for SIL optimizations -----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-opt-remarks"
+#include "swift/SILOptimizer/Utils/OptimizationRemark.h"
+#include "swift/AST/ASTContext.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace swift;
+
+static llvm::cl::opt<std::string> RemarksPath(
+    "sil-opt-remarks-path", llvm::cl::init(""),
+    llvm::cl::desc("Emit a YAML record of the remarks produced by the SIL "
+                   "optimization passes to the given file ('-' for stdout)"));
+
+bool OptRemark::isEnabled() { return !RemarksPath.empty(); }
+
+/// Lazily open the requested remark stream. The stream stays open for the
+/// duration of the compilation so that all passes append to the same record.
+static llvm::raw_ostream *getRemarkStream() {
+  if (RemarksPath.empty())
+    return nullptr;
+
+  if (RemarksPath == "-")
+    return &llvm::outs();
+
+  static std::unique_ptr<llvm::raw_fd_ostream> Stream;
+  static bool Initialized = false;
+  if (!Initialized) {
+    Initialized = true;
+    std::error_code EC;
+    Stream.reset(new llvm::raw_fd_ostream(RemarksPath, EC,
+                                          llvm::sys::fs::F_Text));
+    if (EC) {
+      llvm::errs() << "warning: cannot open optimization remarks file "
+                   << RemarksPath << ": " << EC.message() << '\n';
+      Stream.reset();
+    }
+  }
+  return Stream.get();
+}
+
+static void emitRemark(llvm::StringRef Kind, llvm::StringRef PassName,
+                       llvm::StringRef RemarkName, SILInstruction *Where,
+                       const llvm::Twine &Message) {
+  llvm::raw_ostream *OS = getRemarkStream();
+  if (!OS)
+    return;
+
+  *OS << "--- !" << Kind << '\n';
+  *OS << "Pass:            " << PassName << '\n';
+  *OS << "Name:            " << RemarkName << '\n';
+  if (Where) {
+    SILFunction *F = Where->getFunction();
+    auto DbgLoc = Where->getLoc().decodeDebugLoc(
+        F->getModule().getSourceManager());
+    if (DbgLoc.Filename)
+      *OS << "DebugLoc:        { File: '" << DbgLoc.Filename
+          << "', Line: " << DbgLoc.Line << ", Column: " << DbgLoc.Column
+          << " }\n";
+    *OS << "Function:        '" << F->getName() << "'\n";
+  }
+  *OS << "Message:         '" << Message << "'\n";
+  *OS << "...\n";
+}
+
+void OptRemark::emitPassed(llvm::StringRef PassName, llvm::StringRef RemarkName,
+                           SILInstruction *Where, const llvm::Twine &Message) {
+  emitRemark("Passed", PassName, RemarkName, Where, Message);
+}
+
+void OptRemark::emitMissed(llvm::StringRef PassName, llvm::StringRef RemarkName,
+                           SILInstruction *Where, const llvm::Twine &Message) {
+  emitRemark("Missed", PassName, RemarkName, Where, Message);
+}
@@ -1379,19 +1379,43 @@ namespace {
       auto tv = CS.createTypeVariable(locator, TVO_CanBindToLValue);
       ArrayRef<ValueDecl*> decls = expr->getDecls();
       SmallVector<OverloadChoice, 4> choices;
-      
-      for (unsigned i = 0, n = decls.size(); i != n; ++i) {
-        // If the result is invalid, skip it.
-        // FIXME: Note this as invalid, in case we don't find a solution,
-        // so we don't let errors cascade further.
-        CS.getTypeChecker().validateDecl(decls[i], true);
-        if (decls[i]->isInvalid())
-          continue;
 
-        choices.push_back(OverloadChoice(Type(), decls[i],
-                                         expr->isSpecialized(),
-                                         expr->getFunctionRefKind()));
-      }
+      // If this reference is the function of a call with argument labels,
+      // use the labels to prune overloads whose parameter shape cannot
+      // possibly match before the disjunction is formed, mirroring what
+      // member lookup already does.
+      Optional<ConstraintSystem::ArgumentLabelState> argumentLabels;
+      auto knownLabels = CS.ArgumentLabels.find(locator);
+      if (knownLabels != CS.ArgumentLabels.end())
+        argumentLabels = knownLabels->second;
+
+      auto addChoices = [&](bool filterByLabels) {
+        for (unsigned i = 0, n = decls.size(); i != n; ++i) {
+          // If the result is invalid, skip it.
+          // FIXME: Note this as invalid, in case we don't find a solution,
+          // so we don't let errors cascade further.
+          CS.getTypeChecker().validateDecl(decls[i], true);
+          if (decls[i]->isInvalid())
+            continue;
+
+          if (filterByLabels &&
+              !areConservativelyCompatibleArgumentLabels(
+                 decls[i], /*parameterDepth=*/0, argumentLabels->Labels,
+                 argumentLabels->HasTrailingClosure))
+            continue;
+
+          choices.push_back(OverloadChoice(Type(), decls[i],
+                                           expr->isSpecialized(),
+                                           expr->getFunctionRefKind()));
+        }
+      };
+
+      addChoices(/*filterByLabels=*/argumentLabels.hasValue());
+
+      // If the shape filter pruned every candidate, fall back to the full
+      // set so that diagnostics still see all of them.
+      if (choices.empty() && argumentLabels)
+        addChoices(/*filterByLabels=*/false);
 
       // If there are no valid overloads, give up.
       if (choices.empty())
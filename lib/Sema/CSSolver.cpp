@@ -18,6 +18,7 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SaveAndRestore.h"
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include <stack>
@@ -1127,14 +1128,13 @@ static bool tryTypeVariableBindings(
   auto &tc = cs.getTypeChecker();
   ++cs.solverState->NumTypeVariablesBound;
   
-  // If the solver has allocated an excessive amount of memory when solving for
-  // this expression, short-circuit the binding operation and mark the parent
-  // expression as "too complex".
-  if (cs.TC.Context.getSolverMemory() >
-        cs.TC.Context.LangOpts.SolverMemoryThreshold) {
-    cs.setExpressionTooComplex(true);
+  // If the solver has allocated an excessive amount of memory or explored an
+  // excessive number of scopes when solving for this expression,
+  // short-circuit the binding operation and mark the parent expression as
+  // "too complex".  Any solutions already recorded are still ranked, so the
+  // best of them salvages the expression instead of a diagnostic.
+  if (cs.exceededSolverBudget())
     return true;
-  }
 
   for (unsigned tryCount = 0; !anySolved && !bindings.empty(); ++tryCount) {
     // Try each of the bindings in turn.
@@ -1335,7 +1335,125 @@ ConstraintSystem::solveSingle(FreeTypeVariableBinding allowFreeTypeVariables) {
   return std::move(solutions[0]);
 }
 
+namespace {
+  /// Flattens a candidate sub-expression into a canonical shape key for
+  /// TypeChecker::ShrinkShapeCache, collecting the overload sets it contains
+  /// in traversal order.
+  ///
+  /// Only expression kinds whose solving behavior is fully determined by the
+  /// key -- node kinds, referenced declarations, names and argument labels --
+  /// are admitted; anything else (closures, nodes carrying types, etc.) marks
+  /// the expression as not cacheable.
+  class ShapeKeyBuilder : public ASTWalker {
+    SmallVectorImpl<uintptr_t> &Key;
+    SmallVectorImpl<OverloadSetRefExpr *> &OverloadSets;
+    bool Cacheable = true;
+
+  public:
+    ShapeKeyBuilder(SmallVectorImpl<uintptr_t> &key,
+                    SmallVectorImpl<OverloadSetRefExpr *> &overloadSets)
+      : Key(key), OverloadSets(overloadSets) {}
+
+    bool isCacheable() const { return Cacheable; }
+
+    std::pair<bool, Expr *> walkToExprPre(Expr *expr) override {
+      if (!Cacheable)
+        return { false, expr };
+
+      Key.push_back(static_cast<uintptr_t>(expr->getKind()) + 1);
+
+      if (auto *OSR = dyn_cast<OverloadSetRefExpr>(expr)) {
+        OverloadSets.push_back(OSR);
+        for (auto *decl : OSR->getDecls())
+          Key.push_back(reinterpret_cast<uintptr_t>(decl));
+      } else if (auto *DRE = dyn_cast<DeclRefExpr>(expr)) {
+        Key.push_back(reinterpret_cast<uintptr_t>(DRE->getDecl()));
+      } else if (auto *UDE = dyn_cast<UnresolvedDotExpr>(expr)) {
+        Key.push_back(
+            reinterpret_cast<uintptr_t>(UDE->getName().getOpaqueValue()));
+      } else if (auto *tupleExpr = dyn_cast<TupleExpr>(expr)) {
+        for (auto name : tupleExpr->getElementNames())
+          Key.push_back(reinterpret_cast<uintptr_t>(name.get()));
+      } else if (isa<LiteralExpr>(expr) || isa<ApplyExpr>(expr) ||
+                 isa<IdentityExpr>(expr)) {
+        // The node kind alone identifies these.  Literal values don't
+        // affect overload domains, only the literal's kind does.
+      } else {
+        Cacheable = false;
+        return { false, expr };
+      }
+      return { true, expr };
+    }
+
+    Expr *walkToExprPost(Expr *expr) override {
+      // Mark the end of this node's children, so that the tree structure
+      // is part of the key.
+      Key.push_back(0);
+      return expr;
+    }
+  };
+} // end anonymous namespace
+
 bool ConstraintSystem::Candidate::solve() {
+  // See if an identically shaped candidate has already been solved in this
+  // module; generated code repeats the same call shapes many times, and
+  // equal shapes (including candidate overload sets and contextual type)
+  // reduce to equal overload domains.
+  SmallVector<uintptr_t, 32> shapeStorage;
+  SmallVector<OverloadSetRefExpr *, 2> overloadSets;
+  ShapeKeyBuilder keyBuilder(shapeStorage, overloadSets);
+  E->walk(keyBuilder);
+
+  bool cacheable = keyBuilder.isCacheable();
+  TypeChecker::ShrinkShapeKey shapeKey;
+  if (cacheable) {
+    // The contextual type is part of the shape.
+    shapeStorage.push_back(static_cast<uintptr_t>(CTP) + 1);
+    if (!CT.isNull())
+      shapeStorage.push_back(reinterpret_cast<uintptr_t>(
+          CT.getType()->getCanonicalType().getPointer()));
+    shapeKey.assign(shapeStorage.begin(), shapeStorage.end());
+
+    auto known = TC.ShrinkShapeCache.find(shapeKey);
+    if (known != TC.ShrinkShapeCache.end()) {
+      ++OverallNumShrinkShapeCacheHits;
+      auto &result = known->second;
+      if (!result)
+        return true;
+
+      assert(result->size() == overloadSets.size() &&
+             "shape key does not identify the overload sets?");
+      for (unsigned i = 0, n = overloadSets.size(); i != n; ++i) {
+        auto *OSR = overloadSets[i];
+        auto &choices = (*result)[i];
+        // Only rewrite domains that were actually reduced.
+        if (choices.size() == OSR->getDecls().size())
+          continue;
+        MutableArrayRef<ValueDecl *> decls =
+            TC.Context.AllocateUninitialized<ValueDecl *>(choices.size());
+        std::copy(choices.begin(), choices.end(), decls.begin());
+        OSR->setDecls(decls);
+      }
+      return false;
+    }
+    ++OverallNumShrinkShapeCacheMisses;
+  }
+
+  // Record the outcome for future identically shaped candidates.
+  auto recordResult = [&](bool failed) {
+    if (!cacheable)
+      return;
+    if (failed) {
+      TC.ShrinkShapeCache[std::move(shapeKey)] = None;
+      return;
+    }
+    std::vector<std::vector<ValueDecl *>> reduced;
+    reduced.reserve(overloadSets.size());
+    for (auto *OSR : overloadSets)
+      reduced.emplace_back(OSR->getDecls().begin(), OSR->getDecls().end());
+    TC.ShrinkShapeCache[std::move(shapeKey)] = std::move(reduced);
+  };
+
   // Cleanup after constraint system generation/solving,
   // because it would assign types to expressions, which
   // might interfere with solving higher-level expressions.
@@ -1385,11 +1503,14 @@ bool ConstraintSystem::Candidate::solve() {
 
   // No solutions for the sub-expression means that either main expression
   // needs salvaging or it's inconsistent (read: doesn't have solutions).
-  if (solutions.empty())
+  if (solutions.empty()) {
+    recordResult(/*failed=*/true);
     return true;
+  }
 
   // Record found solutions as suggestions.
   this->applySolutions(solutions);
+  recordResult(/*failed=*/false);
   return false;
 }
 
@@ -1773,11 +1894,28 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
     }
   };
 
+  // Visit the components in order of increasing size, so that small
+  // components are solved first.  The components are independent, so the
+  // order doesn't change the outcome, but a component with no solutions
+  // aborts the whole expression -- finding that out via a two-constraint
+  // component is much cheaper than first grinding through a large one.
+  // This shows up on multi-statement closure literals, which tend to
+  // produce many components of very different sizes.
+  SmallVector<unsigned, 4> componentOrder;
+  componentOrder.reserve(numComponents);
+  for (unsigned component = 0; component != numComponents; ++component)
+    componentOrder.push_back(component);
+  std::stable_sort(componentOrder.begin(), componentOrder.end(),
+                   [&](unsigned lhs, unsigned rhs) {
+                     return constraintBuckets[lhs].size() <
+                            constraintBuckets[rhs].size();
+                   });
+
   // Compute the partial solutions produced for each connected component.
-  std::unique_ptr<SmallVector<Solution, 4>[]> 
+  std::unique_ptr<SmallVector<Solution, 4>[]>
     partialSolutions(new SmallVector<Solution, 4>[numComponents]);
   Optional<Score> PreviousBestScore = solverState->BestScore;
-  for (unsigned component = 0; component != numComponents; ++component) {
+  for (unsigned component : componentOrder) {
     assert(InactiveConstraints.empty() && 
            "Some constraints were not transferred?");
     ++solverState->NumComponentsSplit;
@@ -2090,12 +2228,28 @@ bool ConstraintSystem::solveSimplified(
   auto afterDisjunction = InactiveConstraints.erase(disjunction);
   CG.removeConstraint(disjunction);
 
+  // Order the constraints within the disjunction so that favored terms come
+  // first.  If a favored term produces a solution, the short-circuit check
+  // below prunes every remaining non-favored term without exploring it,
+  // which matters a lot for operator-heavy expressions with large overload
+  // sets.  The original index is kept alongside each term because recorded
+  // disjunction choices are identified by position in the disjunction.
+  auto constraints = disjunction->getNestedConstraints();
+  SmallVector<std::pair<unsigned, Constraint *>, 4> orderedConstraints;
+  orderedConstraints.reserve(constraints.size());
+  for (auto index : indices(constraints))
+    if (constraints[index]->isFavored())
+      orderedConstraints.push_back({index, constraints[index]});
+  for (auto index : indices(constraints))
+    if (!constraints[index]->isFavored())
+      orderedConstraints.push_back({index, constraints[index]});
+
   // Try each of the constraints within the disjunction.
   Constraint *firstSolvedConstraint = nullptr;
   ++solverState->NumDisjunctions;
-  auto constraints = disjunction->getNestedConstraints();
-  for (auto index : indices(constraints)) {
-    auto constraint = constraints[index];
+  for (const auto &indexedConstraint : orderedConstraints) {
+    unsigned index = indexedConstraint.first;
+    auto constraint = indexedConstraint.second;
 
     // We already have a solution; check whether we should
     // short-circuit the disjunction.
@@ -2103,8 +2257,9 @@ bool ConstraintSystem::solveSimplified(
         shortCircuitDisjunctionAt(constraint, firstSolvedConstraint))
       break;
     
-    // If the expression was deemed "too complex", stop now and salvage.
-    if (getExpressionTooComplex())
+    // If the expression was deemed "too complex" or the solver budget has
+    // been exhausted, stop now and salvage what has been found so far.
+    if (exceededSolverBudget())
       break;
 
     // Try to solve the system with this option in the disjunction.
@@ -2178,6 +2178,27 @@ public:
     return expressionExceededThreshold;
   }
 
+  /// \brief Determine whether the solver has exceeded its per-expression
+  /// memory or solver-scope budget, marking the expression as too complex
+  /// the first time it does.
+  ///
+  /// Solutions found before the budget was exceeded remain eligible, so
+  /// callers that stop exploring still salvage the best of them.
+  bool exceededSolverBudget() {
+    if (expressionExceededThreshold)
+      return true;
+
+    auto &langOpts = TC.Context.LangOpts;
+    if (TC.Context.getSolverMemory() > langOpts.SolverMemoryThreshold ||
+        (langOpts.SolverScopeThreshold != 0 && solverState &&
+         solverState->NumStatesExplored > langOpts.SolverScopeThreshold)) {
+      expressionExceededThreshold = true;
+      return true;
+    }
+
+    return false;
+  }
+
   LLVM_ATTRIBUTE_DEPRECATED(
       void dump() LLVM_ATTRIBUTE_USED,
       "only for use within the debugger");
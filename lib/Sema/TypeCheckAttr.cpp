@@ -55,10 +55,12 @@ public:
   IGNORED_ATTR(Effects)
   IGNORED_ATTR(Exported)
   IGNORED_ATTR(FixedLayout)
+  IGNORED_ATTR(Hot)
   IGNORED_ATTR(Infix)
   IGNORED_ATTR(Inline)
   IGNORED_ATTR(NSApplicationMain)
   IGNORED_ATTR(NSCopying)
+  IGNORED_ATTR(NoReflectionMetadata)
   IGNORED_ATTR(NonObjC)
   IGNORED_ATTR(ObjC)
   IGNORED_ATTR(ObjCBridged)
@@ -711,6 +713,7 @@ public:
     IGNORED_ATTR(Exported)
     IGNORED_ATTR(Convenience)
     IGNORED_ATTR(GKInspectable)
+    IGNORED_ATTR(Hot)
     IGNORED_ATTR(IBDesignable)
     IGNORED_ATTR(IBInspectable)
     IGNORED_ATTR(IBOutlet) // checked early.
@@ -724,6 +727,7 @@ public:
     IGNORED_ATTR(NoEscape)
     IGNORED_ATTR(NonMutating)
     IGNORED_ATTR(NonObjC)
+    IGNORED_ATTR(NoReflectionMetadata)
     IGNORED_ATTR(NoReturn)
     IGNORED_ATTR(NSManaged) // checked early.
     IGNORED_ATTR(ObjC)
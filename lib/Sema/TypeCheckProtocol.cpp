@@ -4344,6 +4344,20 @@ void TypeChecker::checkConformance(NormalProtocolConformance *conformance) {
   checkConformsToProtocol(*this, conformance);
 }
 
+void TypeChecker::checkConformanceShape(
+       NormalProtocolConformance *conformance) {
+  if (!conformance->isIncomplete())
+    return;
+
+  // Resolve the type witnesses eagerly; later phases may query them without
+  // a resolver in hand.  Value witnesses stay unresolved --
+  // NormalProtocolConformance::getWitness() resolves them on demand through
+  // resolveWitness() -- and the conformance stays incomplete so that the
+  // full check still runs when the declaring file is type checked.
+  ConformanceChecker checker(*this, conformance);
+  checker.resolveTypeWitnesses();
+}
+
 /// Determine the score when trying to match two identifiers together.
 static unsigned scoreIdentifiers(Identifier lhs, Identifier rhs,
                                  unsigned limit) {
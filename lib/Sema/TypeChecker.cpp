@@ -390,7 +390,8 @@ static void bindExtensionDecl(ExtensionDecl *ED, TypeChecker &TC) {
   extendedNominal->addExtension(ED);
 }
 
-static void typeCheckFunctionsAndExternalDecls(TypeChecker &TC) {
+static void typeCheckFunctionsAndExternalDecls(SourceFile &SF,
+                                               TypeChecker &TC) {
   unsigned currentFunctionIdx = 0;
   unsigned currentExternalDef = TC.Context.LastCheckedExternalDefinition;
   do {
@@ -494,8 +495,23 @@ static void typeCheckFunctionsAndExternalDecls(TypeChecker &TC) {
     // Complete any conformances that we used.
     for (unsigned i = 0; i != TC.UsedConformances.size(); ++i) {
       auto conformance = TC.UsedConformances[i];
-      if (conformance->isIncomplete())
+      if (!conformance->isIncomplete())
+        continue;
+
+      // Conformances declared in this file must be checked in full; this is
+      // where they are diagnosed and their witness tables emitted.
+      auto *conformingFile =
+          conformance->getDeclContext()->getParentSourceFile();
+      if (!conformingFile || conformingFile == &SF) {
         TC.checkConformance(conformance);
+        continue;
+      }
+
+      // Conformances declared in other files of this module are merely used
+      // here; resolving every witness eagerly duplicates the work done when
+      // their own file is type checked.  Check just their shape, and let
+      // use sites resolve the value witnesses they actually touch.
+      TC.checkConformanceShape(conformance);
     }
     TC.UsedConformances.clear();
 
@@ -531,7 +547,7 @@ void swift::typeCheckExternalDefinitions(SourceFile &SF) {
   assert(SF.ASTStage == SourceFile::TypeChecked);
   auto &Ctx = SF.getASTContext();
   TypeChecker TC(Ctx);
-  typeCheckFunctionsAndExternalDecls(TC);
+  typeCheckFunctionsAndExternalDecls(SF, TC);
 }
 
 void swift::performTypeChecking(SourceFile &SF, TopLevelContext &TLC,
@@ -630,7 +646,7 @@ void swift::performTypeChecking(SourceFile &SF, TopLevelContext &TLC,
     if (SF.Kind == SourceFileKind::REPL && !TC.Context.hadError())
       TC.processREPLTopLevel(SF, TLC, StartElem);
 
-    typeCheckFunctionsAndExternalDecls(TC);
+    typeCheckFunctionsAndExternalDecls(SF, TC);
   }
 
   // Checking that benefits from having the whole module available.
@@ -850,6 +866,52 @@ bool swift::typeCheckAbstractFunctionBodyUntil(AbstractFunctionDecl *AFD,
   return !TC.typeCheckAbstractFunctionBodyUntil(AFD, EndTypeCheckLoc);
 }
 
+bool swift::typeCheckDeclForEditedRange(SourceFile &SF,
+                                        SourceRange EditedRange) {
+  auto &Ctx = SF.getASTContext();
+  auto &SM = Ctx.SourceMgr;
+
+  // Find the outermost function whose body encloses the edited range.  An
+  // edit confined to a body cannot change any other declaration's
+  // interface, so re-checking that body alone is sufficient.  Nested
+  // functions and closures are re-checked along with the enclosing body.
+  AbstractFunctionDecl *enclosingFunc = nullptr;
+  std::function<void(Decl *)> findEnclosingFunc = [&](Decl *D) {
+    if (enclosingFunc)
+      return;
+
+    if (auto *AFD = dyn_cast<AbstractFunctionDecl>(D)) {
+      SourceRange bodyRange = AFD->getBodySourceRange();
+      if (bodyRange.isValid() && SM.rangeContains(bodyRange, EditedRange)) {
+        enclosingFunc = AFD;
+        return;
+      }
+    }
+
+    if (auto *NTD = dyn_cast<NominalTypeDecl>(D)) {
+      for (auto *member : NTD->getMembers())
+        findEnclosingFunc(member);
+    } else if (auto *ED = dyn_cast<ExtensionDecl>(D)) {
+      for (auto *member : ED->getMembers())
+        findEnclosingFunc(member);
+    }
+  };
+  for (auto *D : SF.Decls) {
+    findEnclosingFunc(D);
+    if (enclosingFunc)
+      break;
+  }
+
+  // The edit isn't confined to a single body; it may have changed an
+  // interface that other declarations depend on, and the dependency
+  // information Sema records (ReferencedNameTracker) is per-file, not
+  // per-decl.  The caller has to re-check the whole file.
+  if (!enclosingFunc)
+    return false;
+
+  return typeCheckAbstractFunctionBodyUntil(enclosingFunc, SourceLoc());
+}
+
 bool swift::typeCheckTopLevelCodeDecl(TopLevelCodeDecl *TLCD) {
   auto &Ctx = static_cast<Decl *>(TLCD)->getASTContext();
 
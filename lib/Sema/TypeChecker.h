@@ -32,6 +32,7 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include <functional>
+#include <map>
 
 namespace swift {
 
@@ -492,8 +493,24 @@ public:
     TypeAccessScopeCache;
 
   // Caches whether a given declaration is "as specialized" as another.
-  llvm::DenseMap<std::pair<ValueDecl*, ValueDecl*>, bool> 
+  llvm::DenseMap<std::pair<ValueDecl*, ValueDecl*>, bool>
     specializedOverloadComparisonCache;
+
+  /// A canonicalized expression shape: node kinds, referenced declarations,
+  /// argument labels and the contextual type, flattened in traversal order.
+  using ShrinkShapeKey = std::vector<uintptr_t>;
+
+  /// A memoized shrink() result: for each overload set in the candidate
+  /// expression, in traversal order, the reduced set of viable choices.
+  /// \c None records that the candidate had no solutions at all.
+  using ShrinkShapeResult = Optional<std::vector<std::vector<ValueDecl *>>>;
+
+  /// Memoized results of the constraint solver's shrink() sub-expression
+  /// solving, keyed on expression shape.  Generated code repeats the same
+  /// call shapes many times per module; two occurrences with identical
+  /// shapes (including candidate overload sets) reduce to identical
+  /// domains, so each shape is solved once per module.
+  std::map<ShrinkShapeKey, ShrinkShapeResult> ShrinkShapeCache;
   
   // We delay validation of C and Objective-C type-bridging functions in the
   // standard library until we encounter a declaration that requires one. This
@@ -1583,6 +1600,16 @@ public:
   /// Completely check the given conformance.
   void checkConformance(NormalProtocolConformance *conformance);
 
+  /// Check just the "shape" of the given conformance, resolving its type
+  /// witnesses but leaving its value witnesses to be resolved on demand
+  /// via \c resolveWitness().
+  ///
+  /// This is used for conformances declared in other files of the module,
+  /// which are diagnosed and emitted when their own file is type checked;
+  /// the file merely using them only needs the witnesses its use sites
+  /// actually touch.
+  void checkConformanceShape(NormalProtocolConformance *conformance);
+
   /// Check all of the conformances in the given context.
   void checkConformancesInContext(DeclContext *dc,
                                   IterableDeclContext *idc);
@@ -19,8 +19,18 @@
 #include "swift/ClangImporter/ClangImporter.h"
 #include "swift/Parse/Parser.h"
 #include "swift/Serialization/BCReadingExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 
+#define DEBUG_TYPE "Serialization"
+
+STATISTIC(NumDeclsLoaded, "Number of decls deserialized");
+STATISTIC(NumTypesLoaded, "Number of types deserialized");
+STATISTIC(NumMemberListsLoaded,
+          "Number of nominal/extension member lists loaded");
+STATISTIC(NumNormalProtocolConformancesLoaded,
+          "Number of normal protocol conformances deserialized");
+
 using namespace swift;
 using namespace swift::serialization;
 
@@ -531,6 +541,8 @@ NormalProtocolConformance *ModuleFile::readNormalConformance(
     return conformanceEntry.get();
   }
 
+  ++NumNormalProtocolConformancesLoaded;
+
   using namespace decls_block;
 
   // Find the conformance record.
@@ -1415,7 +1427,7 @@ Identifier ModuleFile::getIdentifier(IdentifierID IID) {
 
   size_t rawID = IID - NUM_SPECIAL_MODULES;
   assert(rawID < Identifiers.size() && "invalid identifier ID");
-  auto identRecord = Identifiers[rawID];
+  auto &identRecord = Identifiers[rawID];
 
   if (identRecord.Offset == 0)
     return identRecord.Ident;
@@ -1427,7 +1439,14 @@ Identifier ModuleFile::getIdentifier(IdentifierID IID) {
   assert(terminatorOffset != StringRef::npos &&
          "unterminated identifier string data");
 
-  return getContext().getIdentifier(rawStrPtr.slice(0, terminatorOffset));
+  // The identifier data blob is a slice of the memory-mapped module buffer,
+  // so this hands the mapped bytes straight to the ASTContext without an
+  // intermediate copy. Cache the interned result so later references to the
+  // same ID don't rescan the blob or re-probe the identifier table.
+  identRecord.Ident =
+      getContext().getIdentifier(rawStrPtr.slice(0, terminatorOffset));
+  identRecord.Offset = 0;
+  return identRecord.Ident;
 }
 
 DeclContext *ModuleFile::getLocalDeclContext(DeclContextID DCID) {
@@ -1831,6 +1850,8 @@ Decl *ModuleFile::getDecl(DeclID DID, Optional<DeclContext *> ForcedContext) {
   if (declOrOffset.isComplete())
     return declOrOffset;
 
+  ++NumDeclsLoaded;
+
   BCOffsetRAII restoreOffset(DeclTypeCursor);
   DeclTypeCursor.JumpToBit(declOrOffset);
   auto entry = DeclTypeCursor.advance();
@@ -3393,6 +3414,8 @@ Type ModuleFile::getType(TypeID TID) {
   if (typeOrOffset.isComplete())
     return typeOrOffset;
 
+  ++NumTypesLoaded;
+
   BCOffsetRAII restoreOffset(DeclTypeCursor);
   DeclTypeCursor.JumpToBit(typeOrOffset);
   auto entry = DeclTypeCursor.advance();
@@ -4102,6 +4125,7 @@ Type ModuleFile::getType(TypeID TID) {
 
 void ModuleFile::loadAllMembers(Decl *D, uint64_t contextData) {
   PrettyStackTraceDecl trace("loading members for", D);
+  ++NumMemberListsLoaded;
 
   BCOffsetRAII restoreOffset(DeclTypeCursor);
   DeclTypeCursor.JumpToBit(contextData);
@@ -537,6 +537,9 @@ bool ModuleFile::readIndexBlock(llvm::BitstreamCursor &cursor) {
         assert(blobData.empty());
         NormalConformances.assign(scratch.begin(), scratch.end());
         break;
+      case index_block::TOP_LEVEL_FILTER:
+        TopLevelFilter = blobData;
+        break;
 
       default:
         // Unknown index kind, which this version of the compiler won't use.
@@ -833,7 +836,8 @@ ModuleFile::ModuleFile(
           bool exported;
           input_block::ImportedHeaderLayout::readRecord(scratch,
             exported, importedHeaderInfo.fileSize,
-            importedHeaderInfo.fileModTime);
+            importedHeaderInfo.fileModTime,
+            importedHeaderInfo.fileHash);
           Dependencies.push_back(Dependency::forHeader(blobData, exported));
           break;
         }
@@ -1065,6 +1069,7 @@ Status ModuleFile::associateWithFileContext(FileUnit *file,
                                         file->getParentModule(),
                                         importedHeaderInfo.fileSize,
                                         importedHeaderInfo.fileModTime,
+                                        importedHeaderInfo.fileHash,
                                         importedHeaderInfo.contents,
                                         diagLoc);
         if (hadError)
@@ -1137,16 +1142,52 @@ Status ModuleFile::associateWithFileContext(FileUnit *file,
 
 ModuleFile::~ModuleFile() = default;
 
+/// Folds \p hash away from the values DenseSet reserves for its empty and
+/// tombstone buckets, which HashString can legitimately produce for valid
+/// names. Colliding the two reserved values onto a third only makes the
+/// hash set's may-contain answer conservatively true more often.
+static uint32_t getTopLevelDeclHashSetKey(uint32_t hash) {
+  if (hash == uint32_t(-1) || hash == uint32_t(-2))
+    return uint32_t(-3);
+  return hash;
+}
+
 void ModuleFile::lookupValue(DeclName name,
                              SmallVectorImpl<ValueDecl*> &results) {
   PrettyModuleFileDeserialization stackEntry(*this);
 
   if (TopLevelDecls) {
+    // Unqualified lookup probes every loaded module for every name, so the
+    // common case here is a miss; reject misses before walking the on-disk
+    // table's buckets.
+    uint32_t nameHash = llvm::HashString(name.getBaseName().str());
+    bool mayContain;
+    if (!TopLevelFilter.empty()) {
+      // Check the Bloom filter serialized alongside the table.
+      uint64_t numBits = uint64_t(TopLevelFilter.size()) * 8;
+      auto bits = index_block::getTopLevelFilterBits(nameHash, numBits);
+      auto testBit = [this](uint32_t bit) {
+        return (TopLevelFilter[bit / 8] & (1 << (bit % 8))) != 0;
+      };
+      mayContain = testBit(bits.first) && testBit(bits.second);
+    } else {
+      // Older module without a serialized filter: build a key hash set on
+      // first use instead.
+      if (!TopLevelDeclHashes) {
+        TopLevelDeclHashes.reset(new llvm::DenseSet<uint32_t>());
+        for (auto key : TopLevelDecls->keys())
+          TopLevelDeclHashes->insert(
+              getTopLevelDeclHashSetKey(llvm::HashString(key)));
+      }
+      mayContain =
+          TopLevelDeclHashes->count(getTopLevelDeclHashSetKey(nameHash));
+    }
     // Find top-level declarations with the given name.
     // FIXME: As a bit of a hack, do lookup by the simple name, then filter
     // compound decls, to avoid having to completely redo how modules are
     // serialized.
-    auto iter = TopLevelDecls->find(name.getBaseName());
+    auto iter = mayContain ? TopLevelDecls->find(name.getBaseName())
+                           : TopLevelDecls->end();
     if (iter != TopLevelDecls->end()) {
       if (name.isSimpleName()) {
         for (auto item : *iter) {
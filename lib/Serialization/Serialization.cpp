@@ -44,6 +44,7 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/OnDiskHashTable.h"
 #include "llvm/Support/Path.h"
@@ -473,6 +474,7 @@ void Serializer::writeBlockInfoBlock() {
   BLOCK_RECORD(index_block, DECL_CONTEXT_OFFSETS);
   BLOCK_RECORD(index_block, LOCAL_TYPE_DECLS);
   BLOCK_RECORD(index_block, NORMAL_CONFORMANCE_OFFSETS);
+  BLOCK_RECORD(index_block, TOP_LEVEL_FILTER);
   BLOCK_RECORD(index_block, PRECEDENCE_GROUPS);
 
   BLOCK(SIL_BLOCK);
@@ -731,13 +733,15 @@ void Serializer::writeInputBlock(const SerializationOptions &options) {
     if (import.second == importedHeaderModule) {
       off_t importedHeaderSize = 0;
       time_t importedHeaderModTime = 0;
+      uint64_t importedHeaderHash = 0;
       std::string contents;
       if (!options.ImportedHeader.empty())
         contents = clangImporter->getBridgingHeaderContents(
-            options.ImportedHeader, importedHeaderSize, importedHeaderModTime);
+            options.ImportedHeader, importedHeaderSize, importedHeaderModTime,
+            importedHeaderHash);
       ImportedHeader.emit(ScratchRecord, publicImportSet.count(import),
                           importedHeaderSize, importedHeaderModTime,
-                          options.ImportedHeader);
+                          importedHeaderHash, options.ImportedHeader);
       if (!contents.empty()) {
         contents.push_back('\0');
         ImportedHeaderContents.emit(ScratchRecord, contents);
@@ -3358,6 +3362,31 @@ static void writeDeclTable(const index_block::DeclListLayout &DeclList,
   DeclList.emit(scratch, kind, tableOffset, hashTableBlob);
 }
 
+/// Writes a Bloom filter over the top-level decl names. Readers consult the
+/// filter before probing the on-disk hash table; most unqualified lookups
+/// miss in most loaded modules, so a cheap definite-miss check pays for
+/// itself quickly.
+static void
+writeTopLevelNameFilter(const index_block::TopLevelFilterLayout &Filter,
+                        const Serializer::DeclTable &table) {
+  if (table.empty())
+    return;
+
+  uint64_t numBits =
+      llvm::NextPowerOf2(table.size() * index_block::TopLevelFilterBitsPerName);
+  llvm::SmallString<512> bytes;
+  bytes.assign(numBits / 8, 0);
+  for (auto &entry : table) {
+    uint32_t hash = llvm::HashString(entry.first.str());
+    auto bits = index_block::getTopLevelFilterBits(hash, numBits);
+    bytes[bits.first / 8] |= 1 << (bits.first % 8);
+    bytes[bits.second / 8] |= 1 << (bits.second % 8);
+  }
+
+  SmallVector<uint64_t, 2> scratch;
+  Filter.emit(scratch, bytes);
+}
+
 static void writeLocalDeclTable(const index_block::DeclListLayout &DeclList,
                                 index_block::RecordKind kind,
                                 LocalTypeHashTableGenerator &generator) {
@@ -3984,6 +4013,9 @@ void Serializer::writeAST(ModuleOrSourceFile DC) {
       writeLocalDeclTable(DeclList, index_block::LOCAL_TYPE_DECLS,
                           localTypeGenerator);
 
+    index_block::TopLevelFilterLayout TopLevelFilter(Out);
+    writeTopLevelNameFilter(TopLevelFilter, topLevelDecls);
+
     index_block::ObjCMethodTableLayout ObjCMethodTable(Out);
     writeObjCMethodTable(ObjCMethodTable, objcMethods);
 
@@ -4002,6 +4034,11 @@ void Serializer::writeToStream(raw_ostream &os) {
 template <size_t N>
 Serializer::Serializer(const unsigned char (&signature)[N],
                        ModuleOrSourceFile DC) {
+  // Pre-size the output buffer. Serialized modules routinely run to several
+  // megabytes, and letting the buffer grow organically means repeatedly
+  // copying the partially-emitted bitstream on each doubling.
+  Buffer.reserve(1 << 20);
+
   for (unsigned char byte : signature)
     Out.Emit(byte, 8);
 
@@ -28,6 +28,47 @@ using namespace reflection;
 
 TypeRefBuilder::TypeRefBuilder() : TC(*this) {}
 
+const TypeRef *
+TypeRefBuilder::decodeTypeRef(const std::string &MangledTypeName) {
+  auto Found = DecodedTypeRefCache.find(MangledTypeName);
+  if (Found != DecodedTypeRefCache.end())
+    return Found->second;
+
+  auto Demangled = Demangle::demangleTypeAsNode(MangledTypeName);
+  auto TR = swift::remote::decodeMangledType(*this, Demangled);
+  DecodedTypeRefCache.insert({MangledTypeName, TR});
+  return TR;
+}
+
+void TypeRefBuilder::updateDescriptorIndexes() {
+  for (size_t i = NumIndexedReflectionInfos; i < ReflectionInfos.size(); ++i) {
+    auto &Info = ReflectionInfos[i];
+    for (auto &FD : Info.fieldmd) {
+      if (!FD.hasMangledTypeName())
+        continue;
+      // insert() keeps the first entry for a name, matching the order the
+      // old linear scans found descriptors in.
+      FieldDescriptorIndex.insert({FD.getMangledTypeName(), &FD});
+    }
+    for (auto &BuiltinTypeDescriptor : Info.builtin) {
+      assert(BuiltinTypeDescriptor.Size > 0);
+      assert(BuiltinTypeDescriptor.Alignment > 0);
+      assert(BuiltinTypeDescriptor.Stride > 0);
+      if (!BuiltinTypeDescriptor.hasMangledTypeName())
+        continue;
+      BuiltinTypeDescriptorIndex.insert(
+          {BuiltinTypeDescriptor.getMangledTypeName(), &BuiltinTypeDescriptor});
+    }
+    for (auto &CD : Info.capture) {
+      auto RemoteAddr = ((uintptr_t) &CD -
+                         Info.LocalStartAddress +
+                         Info.RemoteStartAddress);
+      CaptureDescriptorIndex.insert({RemoteAddr, &CD});
+    }
+  }
+  NumIndexedReflectionInfos = ReflectionInfos.size();
+}
+
 const AssociatedTypeDescriptor * TypeRefBuilder::
 lookupAssociatedTypes(const std::string &MangledTypeName,
                       const DependentMemberTypeRef *DependentMember) {
@@ -39,8 +80,7 @@ lookupAssociatedTypes(const std::string &MangledTypeName,
       if (ConformingTypeName.compare(MangledTypeName) != 0)
         continue;
       std::string ProtocolMangledName(AssocTyDescriptor.ProtocolTypeName);
-      auto DemangledProto = Demangle::demangleTypeAsNode(ProtocolMangledName);
-      auto TR = swift::remote::decodeMangledType(*this, DemangledProto);
+      auto TR = decodeTypeRef(ProtocolMangledName);
 
       auto &Conformance = *DependentMember->getProtocol();
       if (auto Protocol = dyn_cast<ProtocolTypeRef>(TR)) {
@@ -63,8 +103,7 @@ getDependentMemberTypeRef(const std::string &MangledTypeName,
         continue;
 
       auto SubstitutedTypeName = AssocTy.getMangledSubstitutedTypeName();
-      auto Demangled = Demangle::demangleTypeAsNode(SubstitutedTypeName);
-      return swift::remote::decodeMangledType(*this, Demangled);
+      return decodeTypeRef(SubstitutedTypeName);
     }
   }
   return nullptr;
@@ -82,17 +121,10 @@ TypeRefBuilder::getFieldTypeInfo(const TypeRef *TR) {
   else
     return {};
 
-  std::vector<std::pair<std::string, const TypeRef *>> Fields;
-  for (auto Info : ReflectionInfos) {
-    for (auto &FD : Info.fieldmd) {
-      if (!FD.hasMangledTypeName())
-        continue;
-      auto CandidateMangledName = FD.getMangledTypeName();
-      if (MangledName.compare(CandidateMangledName) != 0)
-        continue;
-      return &FD;
-    }
-  }
+  updateDescriptorIndexes();
+  auto Found = FieldDescriptorIndex.find(MangledName);
+  if (Found != FieldDescriptorIndex.end())
+    return Found->second;
 
   return nullptr;
 }
@@ -114,9 +146,7 @@ TypeRefBuilder::getFieldTypeRefs(const TypeRef *TR, const FieldDescriptor *FD) {
       continue;
     }
 
-    auto Demangled
-      = Demangle::demangleTypeAsNode(Field.getMangledTypeName());
-    auto Unsubstituted = swift::remote::decodeMangledType(*this, Demangled);
+    auto Unsubstituted = decodeTypeRef(Field.getMangledTypeName());
     if (!Unsubstituted)
       return {};
 
@@ -142,34 +172,20 @@ TypeRefBuilder::getBuiltinTypeInfo(const TypeRef *TR) {
   else
     return nullptr;
 
-  for (auto Info : ReflectionInfos) {
-    for (auto &BuiltinTypeDescriptor : Info.builtin) {
-      assert(BuiltinTypeDescriptor.Size > 0);
-      assert(BuiltinTypeDescriptor.Alignment > 0);
-      assert(BuiltinTypeDescriptor.Stride > 0);
-      if (!BuiltinTypeDescriptor.hasMangledTypeName())
-        continue;
-      auto CandidateMangledName = BuiltinTypeDescriptor.getMangledTypeName();
-      if (MangledName.compare(CandidateMangledName) != 0)
-        continue;
-      return &BuiltinTypeDescriptor;
-    }
-  }
+  updateDescriptorIndexes();
+  auto Found = BuiltinTypeDescriptorIndex.find(MangledName);
+  if (Found != BuiltinTypeDescriptorIndex.end())
+    return Found->second;
 
   return nullptr;
 }
 
 const CaptureDescriptor *
 TypeRefBuilder::getCaptureDescriptor(uintptr_t RemoteAddress) {
-  for (auto Info : ReflectionInfos) {
-    for (auto &CD : Info.capture) {
-      auto OtherAddr = ((uintptr_t) &CD -
-                        Info.LocalStartAddress +
-                        Info.RemoteStartAddress);
-      if (OtherAddr == RemoteAddress)
-        return &CD;
-    }
-  }
+  updateDescriptorIndexes();
+  auto Found = CaptureDescriptorIndex.find(RemoteAddress);
+  if (Found != CaptureDescriptorIndex.end())
+    return Found->second;
 
   return nullptr;
 }
@@ -183,8 +199,7 @@ TypeRefBuilder::getClosureContextInfo(const CaptureDescriptor &CD) {
     const TypeRef *TR = nullptr;
     if (i->hasMangledTypeName()) {
       auto MangledName = i->getMangledTypeName();
-      auto DemangleTree = Demangle::demangleTypeAsNode(MangledName);
-      TR = swift::remote::decodeMangledType(*this, DemangleTree);
+      TR = decodeTypeRef(MangledName);
     }
     Info.CaptureTypes.push_back(TR);
   }
@@ -193,8 +208,7 @@ TypeRefBuilder::getClosureContextInfo(const CaptureDescriptor &CD) {
     const TypeRef *TR = nullptr;
     if (i->hasMangledTypeName()) {
       auto MangledName = i->getMangledTypeName();
-      auto DemangleTree = Demangle::demangleTypeAsNode(MangledName);
-      TR = swift::remote::decodeMangledType(*this, DemangleTree);
+      TR = decodeTypeRef(MangledName);
     }
 
     const MetadataSource *MS = nullptr;
@@ -221,8 +235,7 @@ TypeRefBuilder::dumpTypeRef(const std::string &MangledName,
   auto TypeName = Demangle::demangleTypeAsString(MangledName);
   OS << TypeName << '\n';
 
-  auto DemangleTree = Demangle::demangleTypeAsNode(MangledName);
-  auto TR = swift::remote::decodeMangledType(*this, DemangleTree);
+  auto TR = decodeTypeRef(MangledName);
   if (!TR) {
     OS << "!!! Invalid typeref: " << MangledName << '\n';
     return;
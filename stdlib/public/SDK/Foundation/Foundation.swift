@@ -522,6 +522,32 @@ extension Array : _ObjectiveCBridgeable {
     _ source: NSArray,
     result: inout Array?
   ) -> Bool {
+    // If we have the appropriate native storage already, just adopt it.
+    if let native =
+        Array._bridgeFromObjectiveCAdoptingNativeStorageOf(source) {
+      result = native
+      return true
+    }
+
+    if _fastPath(_isBridgedVerbatimToObjectiveC(Element.self)) {
+      // Capture an immutable snapshot (O(1) when `source` is already
+      // immutable, since `-copy` returns the array itself), verify the
+      // element types against it, and let it back the result directly
+      // instead of copying the elements out.  Bridging an unmodified result
+      // back to Objective-C then returns the original array.
+      let immutable = unsafeBitCast(source.copy() as AnyObject, to: NSArray.self)
+      for i in 0..<immutable.count {
+        guard immutable.object(at: i) is Element else {
+          result = nil
+          return false
+        }
+      }
+      result = Array(
+        _immutableCocoaArray:
+          unsafeBitCast(immutable as AnyObject, to: _NSArrayCore.self))
+      return true
+    }
+
     // Construct the result array by conditionally bridging each element.
     let anyObjectArr = [AnyObject](_cocoaArray: source)
 
@@ -637,6 +663,14 @@ extension Dictionary : _ObjectiveCBridgeable {
     _ x: NSDictionary,
     result: inout Dictionary?
   ) -> Bool {
+    // If we have the appropriate native storage already, just adopt it; this
+    // makes a round trip through Objective-C and back O(1).
+    if let native = [Key : Value]._bridgeFromObjectiveCAdoptingNativeStorageOf(
+        x as AnyObject) {
+      result = native
+      return true
+    }
+
     let anyDict = x as [NSObject : AnyObject]
     if _isBridgedVerbatimToObjectiveC(Key.self) &&
        _isBridgedVerbatimToObjectiveC(Value.self) {
@@ -887,6 +921,15 @@ extension Set : _ObjectiveCBridgeable {
   public static func _conditionallyBridgeFromObjectiveC(
     _ x: NSSet, result: inout Set?
   ) -> Bool {
+    // If we have the appropriate native storage already, just adopt it; this
+    // makes a round trip through Objective-C and back O(1).
+    if let native =
+      Set<Element>._bridgeFromObjectiveCAdoptingNativeStorageOf(x as AnyObject) {
+
+      result = native
+      return true
+    }
+
     let anySet = x as Set<NSObject>
     if _isBridgedVerbatimToObjectiveC(Element.self) {
       result = Swift._setDownCastConditional(anySet)
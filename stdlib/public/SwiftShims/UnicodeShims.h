@@ -87,6 +87,12 @@ __attribute__((__pure__)) __swift_intptr_t
 _swift_stdlib_unicode_hash_ascii(const unsigned char *Str,
                                  __swift_int32_t Length);
 
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__attribute__((__pure__)) __swift_int32_t
+_swift_stdlib_unicode_equal_ascii(const unsigned char *Left,
+                                  const unsigned char *Right,
+                                  __swift_int32_t Length);
+
 SWIFT_RUNTIME_STDLIB_INTERFACE
 __swift_int32_t _swift_stdlib_unicode_strToUpper(
   __swift_uint16_t *Destination, __swift_int32_t DestinationCapacity,
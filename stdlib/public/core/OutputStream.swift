@@ -486,27 +486,57 @@ internal func _dumpPrint_unlocked<T, TargetStream : TextOutputStream>(
 //===----------------------------------------------------------------------===//
 
 internal struct _Stdout : TextOutputStream {
+  /// Pending UTF-8 output.  Writes are batched here while the stream is
+  /// locked, so a whole `print` call -- items, separators and terminator --
+  /// usually reaches libc as a single `fwrite`.
+  internal var _buffer: ContiguousArray<UInt8> = []
+
+  /// Flush the buffer once it grows past this size rather than letting a
+  /// pathologically large payload accumulate.
+  internal static var _flushThreshold: Int { return 4096 }
+
   mutating func _lock() {
     _swift_stdlib_flockfile_stdout()
   }
 
   mutating func _unlock() {
+    _flush()
     _swift_stdlib_funlockfile_stdout()
   }
 
+  mutating func _flush() {
+    if _buffer.isEmpty { return }
+    _buffer.withUnsafeBufferPointer {
+      _swift_stdlib_fwrite_stdout($0.baseAddress!, $0.count, 1)
+    }
+    _buffer.removeAll(keepingCapacity: true)
+  }
+
   mutating func write(_ string: String) {
     if string.isEmpty { return }
 
     if string._core.isASCII {
       defer { _fixLifetime(string) }
 
-      _swift_stdlib_fwrite_stdout(UnsafePointer(string._core.startASCII),
-                                  string._core.count, 1)
-      return
+      let base = UnsafePointer(string._core.startASCII)
+      let count = string._core.count
+
+      // Large payloads bypass the buffer and go straight from the string's
+      // own storage to libc.
+      if count >= _Stdout._flushThreshold {
+        _flush()
+        _swift_stdlib_fwrite_stdout(base, count, 1)
+        return
+      }
+
+      _buffer.append(contentsOf: UnsafeBufferPointer(start: base,
+                                                     count: count))
+    } else {
+      _buffer.append(contentsOf: string.utf8)
     }
 
-    for c in string.utf8 {
-      _swift_stdlib_putchar_unlocked(Int32(c))
+    if _buffer.count >= _Stdout._flushThreshold {
+      _flush()
     }
   }
 }
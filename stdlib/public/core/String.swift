@@ -517,13 +517,22 @@ public func _stdlib_compareNSStringDeterministicUnicodeCollationPointer(
 
 extension String : Equatable {
   public static func == (lhs: String, rhs: String) -> Bool {
+    // Identical storage of identical length holds identical text. Copies of
+    // a string share storage, so comparisons against a copy take this path
+    // without looking at the text at all — for non-ASCII content that avoids
+    // a trip through the collator.
+    if lhs._core._baseAddress != nil
+      && lhs._core._baseAddress == rhs._core._baseAddress
+      && lhs._core.count == rhs._core.count {
+      return true
+    }
     if lhs._core.isASCII && rhs._core.isASCII {
       if lhs._core.count != rhs._core.count {
         return false
       }
-      return _swift_stdlib_memcmp(
+      return _swift_stdlib_unicode_equal_ascii(
         lhs._core.startASCII, rhs._core.startASCII,
-        rhs._core.count) == 0
+        Int32(rhs._core.count)) != 0
     }
     return lhs._compareString(rhs) == 0
   }
@@ -252,14 +252,35 @@ extension String.CharacterView : BidirectionalCollection {
     }
     
     let startIndexUTF16 = start._position
+
+    let u0 = unicodeScalars[start].value
+    unicodeScalars.formIndex(after: &start)
+
+    // Fast path: all scalars below U+0300 are "CR", "LF", "Control" or
+    // "Other", and the only such pair without a boundary between them is CR
+    // followed by LF.  This covers runs of ASCII and Latin-1 text without
+    // touching the property trie at all.
+    if _fastPath(u0 < 0x300) {
+      if start == end {
+        return start._position - startIndexUTF16
+      }
+      let u1 = unicodeScalars[start].value
+      if _fastPath(u1 < 0x300) {
+        if u0 == 0x0d /* CR */ && u1 == 0x0a /* LF */ {
+          // CR and LF form one cluster, and LF always has a boundary after
+          // it.
+          unicodeScalars.formIndex(after: &start)
+        }
+        return start._position - startIndexUTF16
+      }
+    }
+
     let graphemeClusterBreakProperty =
       _UnicodeGraphemeClusterBreakPropertyTrie()
     let segmenter = _UnicodeExtendedGraphemeClusterSegmenter()
-    
-    var gcb0 = graphemeClusterBreakProperty.getPropertyRawValue(
-      unicodeScalars[start].value)
-    unicodeScalars.formIndex(after: &start)
-    
+
+    var gcb0 = graphemeClusterBreakProperty.getPropertyRawValue(u0)
+
     while start != end {
       // FIXME(performance): consider removing this "fast path".  A branch
       // that is hard to predict could be worse for performance than a few
@@ -294,16 +315,39 @@ extension String.CharacterView : BidirectionalCollection {
     }
     
     let endIndexUTF16 = end._position
+
+    var graphemeClusterStart = end
+
+    unicodeScalars.formIndex(before: &graphemeClusterStart)
+    let u0 = unicodeScalars[graphemeClusterStart].value
+
+    // Fast path: all scalars below U+0300 are "CR", "LF", "Control" or
+    // "Other", and the only such pair without a boundary between them is CR
+    // followed by LF.  This covers runs of ASCII and Latin-1 text without
+    // touching the property trie at all.
+    if _fastPath(u0 < 0x300) {
+      if graphemeClusterStart == start {
+        return endIndexUTF16 - graphemeClusterStart._position
+      }
+      var previous = graphemeClusterStart
+      unicodeScalars.formIndex(before: &previous)
+      let u1 = unicodeScalars[previous].value
+      if _fastPath(u1 < 0x300) {
+        if u1 == 0x0d /* CR */ && u0 == 0x0a /* LF */ {
+          // CR and LF form one cluster, and CR always has a boundary before
+          // it.
+          return endIndexUTF16 - previous._position
+        }
+        return endIndexUTF16 - graphemeClusterStart._position
+      }
+    }
+
     let graphemeClusterBreakProperty =
       _UnicodeGraphemeClusterBreakPropertyTrie()
     let segmenter = _UnicodeExtendedGraphemeClusterSegmenter()
-    
-    var graphemeClusterStart = end
-    
-    unicodeScalars.formIndex(before: &graphemeClusterStart)
-    var gcb0 = graphemeClusterBreakProperty.getPropertyRawValue(
-      unicodeScalars[graphemeClusterStart].value)
-    
+
+    var gcb0 = graphemeClusterBreakProperty.getPropertyRawValue(u0)
+
     var graphemeClusterStartUTF16 = graphemeClusterStart._position
     
     while graphemeClusterStart != start {
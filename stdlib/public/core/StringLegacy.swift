@@ -153,8 +153,9 @@ extension String {
         if prefixCount > selfCore.count {
           return false
         }
-        return Int(_swift_stdlib_memcmp(
-          selfCore.startASCII, prefixCore.startASCII, prefixCount)) == 0
+        return _swift_stdlib_unicode_equal_ascii(
+          selfCore.startASCII, prefixCore.startASCII,
+          Int32(prefixCount)) != 0
       }
       let lhsStr = _NSContiguousString(selfCore)
       let rhsStr = _NSContiguousString(prefixCore)
@@ -209,9 +210,9 @@ extension String {
         if suffixCount > selfCount {
           return false
         }
-        return Int(_swift_stdlib_memcmp(
-                   selfCore.startASCII + (selfCount - suffixCount),
-                   suffixCore.startASCII, suffixCount)) == 0
+        return _swift_stdlib_unicode_equal_ascii(
+          selfCore.startASCII + (selfCount - suffixCount),
+          suffixCore.startASCII, Int32(suffixCount)) != 0
       }
       let lhsStr = _NSContiguousString(selfCore)
       let rhsStr = _NSContiguousString(suffixCore)
@@ -0,0 +1,170 @@
+//===--- AllocationTrace.cpp ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// See AllocationTrace.h for a description of the tracing scheme.
+//
+//===----------------------------------------------------------------------===//
+
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+
+#include "AllocationTrace.h"
+#include "swift/Runtime/Mutex.h"
+#include <atomic>
+#include <cstring>
+
+using namespace swift;
+
+namespace {
+
+/// Number of entries per thread. A power of two so the ring indexes reduce
+/// to a mask; at 24 bytes per entry this is 96 KiB per thread.
+constexpr size_t RingCapacity = 4096;
+
+/// A single-producer (the owning thread) single-consumer (the draining
+/// tool) ring buffer. The producer only writes Head and the consumer only
+/// writes Tail, so neither needs a compare-and-swap; when the ring is full
+/// the producer drops the entry and bumps Dropped rather than contending
+/// with the consumer for Tail.
+struct ThreadRing {
+  swift_allocationTrace_entry Entries[RingCapacity];
+  std::atomic<size_t> Head;  // next slot the producer writes
+  std::atomic<size_t> Tail;  // next slot the consumer reads
+  std::atomic<size_t> Dropped;
+  // Running totals, written only by the owning thread with plain
+  // load/store pairs (no RMW), read with relaxed loads by the getters.
+  // They count every event, including ones whose entries were dropped.
+  std::atomic<size_t> AllocCount;
+  std::atomic<size_t> AllocBytes;
+  std::atomic<size_t> DeallocBytes;
+  ThreadRing *Next;
+
+  ThreadRing()
+      : Head(0), Tail(0), Dropped(0), AllocCount(0), AllocBytes(0),
+        DeallocBytes(0), Next(nullptr) {}
+};
+
+/// Head of the list of all threads' rings. Rings are registered on first
+/// allocation from a thread and deliberately never unregistered: a ring
+/// must stay drainable after its thread exits, and at 96 KiB per thread
+/// that has ever allocated, leaking them is the production-safe choice
+/// over synchronizing with thread teardown.
+ThreadRing *AllRings = nullptr;
+StaticMutex AllRingsLock;
+
+ThreadRing *createThreadRing() {
+  auto *ring = new ThreadRing();
+  StaticScopedLock lock(AllRingsLock);
+  ring->Next = AllRings;
+  AllRings = ring;
+  return ring;
+}
+
+ThreadRing *getThreadRing() {
+  static __thread ThreadRing *ring = nullptr;
+  if (!ring)
+    ring = createThreadRing();
+  return ring;
+}
+
+} // end anonymous namespace
+
+void swift_allocationTrace_record(const void *metadata, size_t size,
+                                  const void *callsite) {
+  ThreadRing *ring = getThreadRing();
+  ring->AllocCount.store(ring->AllocCount.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  ring->AllocBytes.store(
+      ring->AllocBytes.load(std::memory_order_relaxed) + size,
+      std::memory_order_relaxed);
+  size_t head = ring->Head.load(std::memory_order_relaxed);
+  size_t tail = ring->Tail.load(std::memory_order_acquire);
+  if (head - tail == RingCapacity) {
+    ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto &entry = ring->Entries[head % RingCapacity];
+  entry.Metadata = metadata;
+  entry.Size = size;
+  entry.Callsite = callsite;
+  // Publish the entry; the consumer's acquire load of Head pairs with this.
+  ring->Head.store(head + 1, std::memory_order_release);
+}
+
+size_t swift_allocationTrace_drain(swift_allocationTrace_entry *buffer,
+                                   size_t capacity) {
+  // Snapshot the ring list; rings are only ever prepended.
+  ThreadRing *rings;
+  {
+    StaticScopedLock lock(AllRingsLock);
+    rings = AllRings;
+  }
+
+  size_t written = 0;
+  for (ThreadRing *ring = rings; ring && written < capacity;
+       ring = ring->Next) {
+    size_t tail = ring->Tail.load(std::memory_order_relaxed);
+    size_t head = ring->Head.load(std::memory_order_acquire);
+    while (tail != head && written < capacity) {
+      buffer[written++] = ring->Entries[tail % RingCapacity];
+      ++tail;
+    }
+    ring->Tail.store(tail, std::memory_order_release);
+  }
+  return written;
+}
+
+void swift_allocationTrace_recordDealloc(size_t size) {
+  ThreadRing *ring = getThreadRing();
+  ring->DeallocBytes.store(
+      ring->DeallocBytes.load(std::memory_order_relaxed) + size,
+      std::memory_order_relaxed);
+}
+
+size_t swift_allocationTrace_totalAllocations(void) {
+  ThreadRing *rings;
+  {
+    StaticScopedLock lock(AllRingsLock);
+    rings = AllRings;
+  }
+  size_t count = 0;
+  for (ThreadRing *ring = rings; ring; ring = ring->Next)
+    count += ring->AllocCount.load(std::memory_order_relaxed);
+  return count;
+}
+
+size_t swift_allocationTrace_liveBytes(void) {
+  ThreadRing *rings;
+  {
+    StaticScopedLock lock(AllRingsLock);
+    rings = AllRings;
+  }
+  size_t allocated = 0, deallocated = 0;
+  for (ThreadRing *ring = rings; ring; ring = ring->Next) {
+    allocated += ring->AllocBytes.load(std::memory_order_relaxed);
+    deallocated += ring->DeallocBytes.load(std::memory_order_relaxed);
+  }
+  return allocated > deallocated ? allocated - deallocated : 0;
+}
+
+size_t swift_allocationTrace_dropped(void) {
+  ThreadRing *rings;
+  {
+    StaticScopedLock lock(AllRingsLock);
+    rings = AllRings;
+  }
+  size_t dropped = 0;
+  for (ThreadRing *ring = rings; ring; ring = ring->Next)
+    dropped += ring->Dropped.load(std::memory_order_relaxed);
+  return dropped;
+}
+
+#endif
@@ -0,0 +1,86 @@
+//===--- AllocationTrace.h --------------------------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Optional compiled-in allocation tracing. When the runtime is built with
+// SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE, every swift_allocObject records
+// (type metadata, size, callsite) into a per-thread ring buffer that a
+// profiling tool drains via swift_allocationTrace_drain. Recording is a few
+// stores into thread-local memory with no locks or atomics on the hot path,
+// so it is safe to leave enabled in production builds. When the flag is off
+// the hook compiles away entirely, like the Leaks.h entry points.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_STDLIB_RUNTIME_ALLOCATION_TRACE_H
+#define SWIFT_STDLIB_RUNTIME_ALLOCATION_TRACE_H
+
+#if SWIFT_RUNTIME_ENABLE_ALLOCATION_TRACE
+
+#include "../SwiftShims/Visibility.h"
+#include <cstddef>
+
+/// One recorded allocation. Metadata is null for untyped allocations.
+struct swift_allocationTrace_entry {
+  const void *Metadata;
+  size_t Size;
+  const void *Callsite;
+};
+
+/// Record one allocation on the calling thread's ring buffer. Called from
+/// the allocation entry points; not meant for use by tools.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_allocationTrace_record(const void *metadata,
+                                             size_t size,
+                                             const void *callsite);
+
+/// Copy up to \p capacity recorded entries from all threads' ring buffers
+/// into \p buffer, marking them consumed. Returns the number of entries
+/// written. Entries a thread records while its buffer is full are dropped;
+/// swift_allocationTrace_dropped returns the running count of drops so
+/// tools can size their drain interval.
+SWIFT_RUNTIME_EXPORT
+extern "C" size_t swift_allocationTrace_drain(
+    swift_allocationTrace_entry *buffer, size_t capacity);
+
+SWIFT_RUNTIME_EXPORT
+extern "C" size_t swift_allocationTrace_dropped(void);
+
+/// Record one deallocation on the calling thread's ring buffer. Only the
+/// running byte and count totals are updated; deallocations do not occupy
+/// ring entries.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_allocationTrace_recordDealloc(size_t size);
+
+/// The total number of allocations recorded since process start, summed
+/// over all threads. Monotonic, so a tool can subtract two readings to
+/// count the allocations in a region (the benchmark harness reports this
+/// per iteration).
+SWIFT_RUNTIME_EXPORT
+extern "C" size_t swift_allocationTrace_totalAllocations(void);
+
+/// The number of recorded bytes currently live (allocated minus
+/// deallocated), summed over all threads. Clamped to zero: with relaxed
+/// per-thread counters a cross-thread deallocation can transiently be
+/// observed before its allocation.
+SWIFT_RUNTIME_EXPORT
+extern "C" size_t swift_allocationTrace_liveBytes(void);
+
+#define SWIFT_TRACE_ALLOCATION(metadata, size)                                 \
+  swift_allocationTrace_record(metadata, size, __builtin_return_address(0))
+#define SWIFT_TRACE_DEALLOCATION(size)                                         \
+  swift_allocationTrace_recordDealloc(size)
+#else
+#define SWIFT_TRACE_ALLOCATION(metadata, size)
+#define SWIFT_TRACE_DEALLOCATION(size)
+#endif
+
+#endif
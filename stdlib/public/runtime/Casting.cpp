@@ -2509,6 +2509,12 @@ bool swift::swift_dynamicCast(OpaqueValue *dest,
   }
 #endif
 
+  // A cast from a type to itself always succeeds, and repeated casts at the
+  // same call site overwhelmingly see the same source type. Handle that with
+  // one comparison instead of dispatching on the kinds below.
+  if (srcType == targetType)
+    return _succeed(dest, src, srcType, flags);
+
   switch (targetType->getKind()) {
   // Handle wrapping an Optional target.
   case MetadataKind::Optional: {
@@ -21,7 +21,9 @@
 
 #if !SWIFT_OBJC_INTEROP
 
+#include <new>
 #include <stdio.h>
+#include <stdlib.h>
 #include "swift/Runtime/Debug.h"
 #include "ErrorObject.h"
 #include "Private.h"
@@ -64,6 +66,68 @@ static const FullMetadata<HeapMetadata> ErrorMetadata{
   Metadata{MetadataKind::ErrorObject},
 };
 
+/// The payload capacity of a pooled error box.  Boxes for POD error values
+/// no larger than this share a fixed geometry, which lets a caught-and-
+/// released box be handed directly to the next throw on the same thread.
+static const size_t ErrorPoolValueSize = 4 * sizeof(void*);
+static const size_t ErrorPoolBoxSize = sizeof(SwiftError) + ErrorPoolValueSize;
+static const size_t ErrorPoolBoxAlignMask = alignof(SwiftError) - 1;
+
+/// Can a value of the given type be boxed in a pooled error box?
+static bool _isPoolableErrorType(const ValueWitnessTable *vw) {
+  return vw->isPOD() && vw->getSize() <= ErrorPoolValueSize &&
+         vw->getAlignmentMask() <= ErrorPoolBoxAlignMask;
+}
+
+namespace {
+
+/// A small per-thread cache of dead error boxes.  Throw-heavy workloads
+/// (e.g. parsers fed malformed input) can allocate and free a box per
+/// throw; recycling the box on catch keeps that cycle close to the cost
+/// of a branchy return.
+struct ErrorBoxPool {
+  static const unsigned Depth = 8;
+  void *Boxes[Depth];
+  unsigned Count = 0;
+
+  void *pop() {
+    return Count ? Boxes[--Count] : nullptr;
+  }
+
+  bool push(void *box) {
+    if (Count == Depth)
+      return false;
+    Boxes[Count++] = box;
+    return true;
+  }
+
+  ~ErrorBoxPool() {
+    // The boxes were ultimately malloc'd by swift_slowAlloc.
+    while (Count)
+      free(Boxes[--Count]);
+  }
+};
+
+thread_local ErrorBoxPool ErrorPool;
+
+} // end anonymous namespace
+
+/// Destructor for a pooled Error box.  The boxed value is known to be POD,
+/// so only the box itself needs to be reclaimed.
+static void _destroyPooledErrorObject(HeapObject *obj) {
+  // Recycle the memory immediately unless unowned references are keeping
+  // the header alive; swift_deallocObject knows how to defer to them.
+  if (obj->weakRefCount.getCount() == 1 && ErrorPool.push(obj))
+    return;
+  swift_deallocObject(obj, ErrorPoolBoxSize, ErrorPoolBoxAlignMask);
+}
+
+/// Heap metadata for pooled Error boxes.
+static const FullMetadata<HeapMetadata> PooledErrorMetadata{
+  HeapMetadataHeader{{_destroyPooledErrorObject}, {&_TWVBo}},
+  Metadata{MetadataKind::ErrorObject},
+};
+
 SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
 extern "C"
 BoxPair::Return
@@ -71,11 +135,20 @@ swift::swift_allocError(const swift::Metadata *type,
                         const swift::WitnessTable *errorConformance,
                         OpaqueValue *initialValue,
                         bool isTake) {
-  auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
-  
-  auto allocated = swift_allocObject(&ErrorMetadata,
-                                     sizeAndAlign.first, sizeAndAlign.second);
-  
+  HeapObject *allocated;
+  if (_isPoolableErrorType(type->getValueWitnesses())) {
+    if (void *box = ErrorPool.pop()) {
+      allocated = new (box) HeapObject(&PooledErrorMetadata);
+    } else {
+      allocated = swift_allocObject(&PooledErrorMetadata,
+                                    ErrorPoolBoxSize, ErrorPoolBoxAlignMask);
+    }
+  } else {
+    auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
+    allocated = swift_allocObject(&ErrorMetadata,
+                                  sizeAndAlign.first, sizeAndAlign.second);
+  }
+
   auto error = reinterpret_cast<SwiftError*>(allocated);
   
   error->type = type;
@@ -95,6 +168,12 @@ swift::swift_allocError(const swift::Metadata *type,
 
 void
 swift::swift_deallocError(SwiftError *error, const Metadata *type) {
+  if (error->metadata == &PooledErrorMetadata) {
+    if (error->weakRefCount.getCount() == 1 && ErrorPool.push(error))
+      return;
+    swift_deallocObject(error, ErrorPoolBoxSize, ErrorPoolBoxAlignMask);
+    return;
+  }
   auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
   swift_deallocObject(error, sizeAndAlign.first, sizeAndAlign.second);
 }
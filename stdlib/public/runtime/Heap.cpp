@@ -22,9 +22,103 @@
 
 using namespace swift;
 
+namespace {
+
+/// A per-thread cache of recently freed small allocations, organized in
+/// size classes. The common small-object allocation path becomes a
+/// thread-local list pop with no atomics or locks; blocks only travel
+/// through malloc/free when a class's list is empty or full.
+///
+/// Alignment is ignored here for the same reason the malloc path below
+/// ignores it: every allocation currently relies on malloc's guaranteed
+/// alignment.
+class ThreadAllocationCache {
+  /// Size classes are multiples of Granularity bytes.
+  static const size_t Granularity = 16;
+  static const size_t NumSizeClasses = 16;
+  /// The most blocks a single class may hold; beyond that, frees go
+  /// straight back to malloc so an allocation spike on one thread does
+  /// not pin memory forever.
+  static const size_t MaxBlocksPerClass = 32;
+
+  struct FreeBlock {
+    FreeBlock *Next;
+  };
+
+  FreeBlock *Blocks[NumSizeClasses] = {};
+  size_t Counts[NumSizeClasses] = {};
+
+  /// Set once the destructor has run. Thread-local destructor order is
+  /// unspecified, so a later-running destructor that releases Swift objects
+  /// can re-enter the allocator on this thread; after teardown the cache
+  /// must neither hand out freed blocks nor re-cache new ones.
+  bool TornDown = false;
+
+  static size_t classIndex(size_t size) {
+    return (size - 1) / Granularity;
+  }
+
+public:
+  /// Can an allocation of this size be served from the cache?
+  static bool fits(size_t size) {
+    return size - 1 < Granularity * NumSizeClasses;
+  }
+
+  /// The size actually allocated for a request, so that a block freed with
+  /// the original request size can later serve any request in its class.
+  static size_t roundedSize(size_t size) {
+    return (classIndex(size) + 1) * Granularity;
+  }
+
+  void *pop(size_t size) {
+    size_t idx = classIndex(size);
+    FreeBlock *block = Blocks[idx];
+    if (!block)
+      return nullptr;
+    Blocks[idx] = block->Next;
+    --Counts[idx];
+    return block;
+  }
+
+  bool push(void *ptr, size_t size) {
+    size_t idx = classIndex(size);
+    if (TornDown || Counts[idx] >= MaxBlocksPerClass)
+      return false;
+    auto block = reinterpret_cast<FreeBlock *>(ptr);
+    block->Next = Blocks[idx];
+    Blocks[idx] = block;
+    ++Counts[idx];
+    return true;
+  }
+
+  ~ThreadAllocationCache() {
+    for (size_t idx = 0; idx < NumSizeClasses; ++idx) {
+      FreeBlock *block = Blocks[idx];
+      while (block) {
+        FreeBlock *next = block->Next;
+        free(block);
+        block = next;
+      }
+      Blocks[idx] = nullptr;
+      Counts[idx] = 0;
+    }
+    TornDown = true;
+  }
+};
+
+thread_local ThreadAllocationCache AllocationCache;
+
+} // end anonymous namespace
+
 SWIFT_RT_ENTRY_VISIBILITY
 void *swift::swift_slowAlloc(size_t size, size_t alignMask)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  if (ThreadAllocationCache::fits(size)) {
+    if (void *p = AllocationCache.pop(size))
+      return p;
+    // Allocate the whole size class so the block is reusable within it.
+    size = ThreadAllocationCache::roundedSize(size);
+  }
   // FIXME: use posix_memalign if alignMask is larger than the system guarantee.
   void *p = malloc(size);
   if (!p) swift::crash("Could not allocate memory.");
@@ -34,5 +128,8 @@ void *swift::swift_slowAlloc(size_t size, size_t alignMask)
 SWIFT_RT_ENTRY_VISIBILITY
 void swift::swift_slowDealloc(void *ptr, size_t bytes, size_t alignMask)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  if (ptr && ThreadAllocationCache::fits(bytes) &&
+      AllocationCache.push(ptr, bytes))
+    return;
   free(ptr);
 }
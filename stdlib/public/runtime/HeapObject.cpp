@@ -37,7 +37,9 @@
 # include <objc/objc.h>
 #include "swift/Runtime/ObjCBridge.h"
 #endif
+#include "AllocationTrace.h"
 #include "Leaks.h"
+#include "RefCountProfile.h"
 
 using namespace swift;
 
@@ -68,6 +70,9 @@ SWIFT_RT_ENTRY_IMPL(swift_allocObject)(HeapMetadata const *metadata,
   object->refCount.init();
   object->weakRefCount.init();
 
+  // If allocation tracing is enabled, record this allocation.
+  SWIFT_TRACE_ALLOCATION(metadata, requiredSize);
+
   // If leak tracking is enabled, start tracking this object.
   SWIFT_LEAKS_START_TRACKING_OBJECT(object);
 
@@ -234,12 +239,14 @@ SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 void swift::swift_retain(HeapObject *object)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  SWIFT_RC_PROFILE_RETAIN();
   SWIFT_RT_ENTRY_REF(swift_retain)(object);
 }
 
 SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 void swift::swift_nonatomic_retain(HeapObject *object) {
+  SWIFT_RC_PROFILE_RETAIN();
   SWIFT_RT_ENTRY_REF(swift_nonatomic_retain)(object);
 }
 
@@ -252,6 +259,7 @@ void SWIFT_RT_ENTRY_IMPL(swift_nonatomic_retain)(HeapObject *object) {
 SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 void swift::swift_nonatomic_release(HeapObject *object) {
+  SWIFT_RC_PROFILE_RELEASE();
   return SWIFT_RT_ENTRY_REF(swift_nonatomic_release)(object);
 }
 
@@ -275,6 +283,7 @@ SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 void swift::swift_retain_n(HeapObject *object, uint32_t n)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  SWIFT_RC_PROFILE_RETAIN();
   SWIFT_RT_ENTRY_REF(swift_retain_n)(object, n);
 }
 
@@ -291,6 +300,7 @@ SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 void swift::swift_nonatomic_retain_n(HeapObject *object, uint32_t n)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  SWIFT_RC_PROFILE_RETAIN();
   SWIFT_RT_ENTRY_REF(swift_nonatomic_retain_n)(object, n);
 }
 
@@ -307,6 +317,7 @@ SWIFT_RT_ENTRY_VISIBILITY
 extern "C"
 void swift::swift_release(HeapObject *object)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  SWIFT_RC_PROFILE_RELEASE();
   SWIFT_RT_ENTRY_REF(swift_release)(object);
 }
 
@@ -322,6 +333,7 @@ void SWIFT_RT_ENTRY_IMPL(swift_release)(HeapObject *object)
 SWIFT_RT_ENTRY_VISIBILITY
 void swift::swift_release_n(HeapObject *object, uint32_t n)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  SWIFT_RC_PROFILE_RELEASE();
   return SWIFT_RT_ENTRY_REF(swift_release_n)(object, n);
 }
 
@@ -334,6 +346,32 @@ void SWIFT_RT_ENTRY_IMPL(swift_release_n)(HeapObject *object, uint32_t n)
   }
 }
 
+/// How many elements ahead of the current one the bulk operations prefetch.
+/// Far enough ahead that a header miss has usually resolved by the time the
+/// reference-count update reaches the element, but close enough that the
+/// prefetched lines are still resident.
+static const size_t bulkPrefetchDistance = 8;
+
+void swift::swift_bulkRetain(HeapObject *const *objects, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (i + bulkPrefetchDistance < count)
+      __builtin_prefetch(objects[i + bulkPrefetchDistance], 1);
+    HeapObject *object = objects[i];
+    if (object)
+      object->refCount.increment();
+  }
+}
+
+void swift::swift_bulkRelease(HeapObject *const *objects, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (i + bulkPrefetchDistance < count)
+      __builtin_prefetch(objects[i + bulkPrefetchDistance], 1);
+    HeapObject *object = objects[i];
+    if (object && object->refCount.decrementShouldDeallocate())
+      _swift_release_dealloc(object);
+  }
+}
+
 void swift::swift_setDeallocating(HeapObject *object) {
   object->refCount.decrementFromOneAndDeallocateNonAtomic();
 }
@@ -341,6 +379,7 @@ void swift::swift_setDeallocating(HeapObject *object) {
 SWIFT_RT_ENTRY_VISIBILITY
 void swift::swift_nonatomic_release_n(HeapObject *object, uint32_t n)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  SWIFT_RC_PROFILE_RELEASE();
   return SWIFT_RT_ENTRY_REF(swift_nonatomic_release_n)(object, n);
 }
 
@@ -649,6 +688,9 @@ void swift::swift_deallocObject(HeapObject *object,
                   allocatedSize - sizeof(HeapObject));
 #endif
 
+  // If allocation tracing is enabled, record this deallocation.
+  SWIFT_TRACE_DEALLOCATION(allocatedSize);
+
   // If we are tracking leaks, stop tracking this object.
   SWIFT_LEAKS_STOP_TRACKING_OBJECT(object);
 
@@ -730,7 +772,15 @@ enum: uintptr_t {
   WR_NATIVE = 1<<(swift::heap_object_abi::ObjCReservedLowBits),
   WR_READING = 1<<(swift::heap_object_abi::ObjCReservedLowBits+1),
 
+  // Set when Value points at a shared WeakSideTableEntry rather than
+  // directly at the referenced object.
+  WR_SIDE = 1<<(swift::heap_object_abi::ObjCReservedLowBits+2),
+
   WR_NATIVEMASK = WR_NATIVE | swift::heap_object_abi::ObjCReservedBitsMask,
+
+  // Side-table entries are over-aligned so that WR_SIDE (and the bits
+  // below it) never collide with real bits of an entry's address.
+  WR_SIDE_ALIGNMASK = (WR_SIDE << 1) - 1,
 };
 
 static_assert(WR_READING < alignof(void*),
@@ -740,6 +790,44 @@ enum: short {
   WR_SPINLIMIT = 64,
 };
 
+namespace {
+  /// An out-of-line entry shared by native weak references to the same
+  /// object.
+  ///
+  /// A freshly formed weak reference points directly at its object and
+  /// holds an unowned retain on it, as before.  The first time such a
+  /// reference is *copied*, it is promoted to one of these entries; the
+  /// entry inherits the single unowned retain, and all of the references
+  /// sharing it merely adjust the entry's own count.  Heavily copied weak
+  /// references therefore stop contending on the object header, which
+  /// otherwise shares a cache line with the strong reference count.
+  ///
+  /// The entry's unowned retain keeps the object header valid, so readers
+  /// can still check the object's deallocating flag through Object.
+  struct WeakSideTableEntry {
+    HeapObject *Object;
+
+    /// The number of WeakReference cells pointing at this entry.
+    uint32_t RefCount;
+  };
+}
+
+static WeakSideTableEntry *getWeakSideTableEntry(uintptr_t value) {
+  return (WeakSideTableEntry *)(value & ~(uintptr_t)(WR_NATIVE | WR_SIDE));
+}
+
+static void retainWeakSideTableEntry(WeakSideTableEntry *entry) {
+  __atomic_fetch_add(&entry->RefCount, 1, __ATOMIC_RELAXED);
+}
+
+static void releaseWeakSideTableEntry(WeakSideTableEntry *entry) {
+  if (__atomic_fetch_sub(&entry->RefCount, 1, __ATOMIC_ACQ_REL) == 1) {
+    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(entry->Object);
+    SWIFT_RT_ENTRY_CALL(swift_slowDealloc)(entry, sizeof(WeakSideTableEntry),
+                                           WR_SIDE_ALIGNMASK);
+  }
+}
+
 bool swift::isNativeSwiftWeakReference(WeakReference *ref) {
   return (ref->Value & WR_NATIVEMASK) == WR_NATIVE;
 }
@@ -751,9 +839,14 @@ void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
 
 void swift::swift_weakAssign(WeakReference *ref, HeapObject *newValue) {
   SWIFT_RT_ENTRY_CALL(swift_unownedRetain)(newValue);
-  auto oldValue = (HeapObject*) (ref->Value & ~WR_NATIVE);
+  auto oldValue = ref->Value;
   ref->Value = (uintptr_t)newValue | WR_NATIVE;
-  SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(oldValue);
+  if (oldValue & WR_SIDE) {
+    releaseWeakSideTableEntry(getWeakSideTableEntry(oldValue));
+  } else {
+    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(
+        (HeapObject*) (oldValue & ~WR_NATIVE));
+  }
 }
 
 HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
@@ -774,14 +867,24 @@ HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
     ptr = __atomic_fetch_or(&ref->Value, WR_READING, __ATOMIC_RELAXED);
   }
 
-  auto object = (HeapObject*)(ptr & ~WR_NATIVE);
+  WeakSideTableEntry *entry = nullptr;
+  HeapObject *object;
+  if (ptr & WR_SIDE) {
+    entry = getWeakSideTableEntry(ptr);
+    object = entry->Object;
+  } else {
+    object = (HeapObject*)(ptr & ~WR_NATIVE);
+  }
   if (object == nullptr) {
     __atomic_store_n(&ref->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
     return nullptr;
   }
   if (object->refCount.isDeallocating()) {
     __atomic_store_n(&ref->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
+    if (entry)
+      releaseWeakSideTableEntry(entry);
+    else
+      SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
     return nullptr;
   }
   auto result = swift_tryRetain(object);
@@ -790,7 +893,15 @@ HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
 }
 
 HeapObject *swift::swift_weakTakeStrong(WeakReference *ref) {
-  auto object = (HeapObject*) (ref->Value & ~WR_NATIVE);
+  auto ptr = ref->Value;
+  if (ptr & WR_SIDE) {
+    auto entry = getWeakSideTableEntry(ptr);
+    ref->Value = (uintptr_t)nullptr;
+    auto result = swift_tryRetain(entry->Object);
+    releaseWeakSideTableEntry(entry);
+    return result;
+  }
+  auto object = (HeapObject*) (ptr & ~WR_NATIVE);
   if (object == nullptr) return nullptr;
   auto result = swift_tryRetain(object);
   ref->Value = (uintptr_t)nullptr;
@@ -799,8 +910,13 @@ HeapObject *swift::swift_weakTakeStrong(WeakReference *ref) {
 }
 
 void swift::swift_weakDestroy(WeakReference *ref) {
-  auto tmp = (HeapObject*) (ref->Value & ~WR_NATIVE);
+  auto ptr = ref->Value;
   ref->Value = (uintptr_t)nullptr;
+  if (ptr & WR_SIDE) {
+    releaseWeakSideTableEntry(getWeakSideTableEntry(ptr));
+    return;
+  }
+  auto tmp = (HeapObject*) (ptr & ~WR_NATIVE);
   SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(tmp);
 }
 
@@ -823,6 +939,20 @@ void swift::swift_weakCopyInit(WeakReference *dest, WeakReference *src) {
     ptr = __atomic_fetch_or(&src->Value, WR_READING, __ATOMIC_RELAXED);
   }
 
+  if (ptr & WR_SIDE) {
+    auto entry = getWeakSideTableEntry(ptr);
+    if (entry->Object->refCount.isDeallocating()) {
+      __atomic_store_n(&src->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
+      releaseWeakSideTableEntry(entry);
+      dest->Value = (uintptr_t)nullptr;
+    } else {
+      retainWeakSideTableEntry(entry);
+      __atomic_store_n(&src->Value, ptr, __ATOMIC_RELAXED);
+      dest->Value = ptr;
+    }
+    return;
+  }
+
   auto object = (HeapObject*)(ptr & ~WR_NATIVE);
   if (object == nullptr) {
     __atomic_store_n(&src->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
@@ -832,14 +962,36 @@ void swift::swift_weakCopyInit(WeakReference *dest, WeakReference *src) {
     SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
     dest->Value = (uintptr_t)nullptr;
   } else {
-    SWIFT_RT_ENTRY_CALL(swift_unownedRetain)(object);
-    __atomic_store_n(&src->Value, ptr, __ATOMIC_RELAXED);
-    dest->Value = (uintptr_t)object | WR_NATIVE;
+    // Promote the reference to a shared side-table entry.  The entry
+    // inherits src's unowned retain, so this copy leaves the object
+    // header untouched, as does every further copy or destruction of
+    // the references sharing the entry.
+    auto entry = (WeakSideTableEntry*)
+      SWIFT_RT_ENTRY_CALL(swift_slowAlloc)(sizeof(WeakSideTableEntry),
+                                           WR_SIDE_ALIGNMASK);
+    entry->Object = object;
+    entry->RefCount = 2;
+    auto tagged = (uintptr_t)entry | WR_NATIVE | WR_SIDE;
+    __atomic_store_n(&src->Value, tagged, __ATOMIC_RELAXED);
+    dest->Value = tagged;
   }
 }
 
 void swift::swift_weakTakeInit(WeakReference *dest, WeakReference *src) {
-  auto object = (HeapObject*) (src->Value & ~WR_NATIVE);
+  auto ptr = src->Value;
+  src->Value = (uintptr_t)nullptr;
+  if (ptr & WR_SIDE) {
+    auto entry = getWeakSideTableEntry(ptr);
+    if (entry->Object->refCount.isDeallocating()) {
+      dest->Value = (uintptr_t)nullptr;
+      releaseWeakSideTableEntry(entry);
+    } else {
+      dest->Value = ptr;
+    }
+    return;
+  }
+
+  auto object = (HeapObject*) (ptr & ~WR_NATIVE);
   if (object == nullptr) {
     dest->Value = (uintptr_t)nullptr;
   } else if (object->refCount.isDeallocating()) {
@@ -848,21 +1000,18 @@ void swift::swift_weakTakeInit(WeakReference *dest, WeakReference *src) {
   } else {
     dest->Value = (uintptr_t)object | WR_NATIVE;
   }
-  src->Value = (uintptr_t)nullptr;
 }
 
 void swift::swift_weakCopyAssign(WeakReference *dest, WeakReference *src) {
   if (dest->Value) {
-    auto object = (HeapObject*) (dest->Value & ~WR_NATIVE);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
+    swift_weakDestroy(dest);
   }
   swift_weakCopyInit(dest, src);
 }
 
 void swift::swift_weakTakeAssign(WeakReference *dest, WeakReference *src) {
   if (dest->Value) {
-    auto object = (HeapObject*) (dest->Value & ~WR_NATIVE);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
+    swift_weakDestroy(dest);
   }
   swift_weakTakeInit(dest, src);
 }
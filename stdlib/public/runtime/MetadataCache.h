@@ -277,6 +277,20 @@ template <class ValueTy> class MetadataCache {
   /// structure for the metadata cache.
   const ValueTy *Head;
 
+  /// The number of slots in the direct-mapped front cache. Must be a
+  /// power of two, and must be kept small: generic metadata caches live
+  /// inside GenericMetadata::PrivateData, which is only
+  /// NumGenericMetadataPrivateDataWords pointers; see the static_asserts
+  /// in Metadata.cpp.
+  enum : size_t { FastCacheSize = 8 };
+
+  /// A direct-mapped cache of fully-initialized entries, indexed by key
+  /// hash. Readers probe this before walking the concurrent tree, so the
+  /// common repeat-instantiation case costs one load and one key comparison
+  /// and writes no shared state. Slots are only ever published once the
+  /// entry's value is set, so a hit never has to wait.
+  std::atomic<Entry *> FastCache[FastCacheSize] = {};
+
   struct ConcurrencyControl {
     Mutex Lock;
     ConditionVariable Queue;
@@ -319,6 +333,17 @@ public:
            ValueTy::getName(), this, key.Hash);
 #endif
 
+    // Probe the direct-mapped front cache before touching the tree.
+    auto &fastSlot = FastCache[key.Hash & (FastCacheSize - 1)];
+    if (Entry *cached = fastSlot.load(std::memory_order_acquire)) {
+      if (cached->compareWithKey(key) == 0) {
+        // Slots are only published for initialized entries, but re-check
+        // under the same acquire we'd do on the slow path anyway.
+        if (auto value = cached->getValue())
+          return value;
+      }
+    }
+
     // Ensure the existence of a map entry.
     auto insertResult = Map.getOrInsert(key);
     Entry *entry = insertResult.first;
@@ -330,6 +355,7 @@ public:
       // If the entry is already initialized, great.
       auto value = entry->getValue();
       if (value) {
+        fastSlot.store(entry, std::memory_order_release);
         return value;
       }
 
@@ -355,6 +381,7 @@ public:
         return false; // don't have a value, continue waiting
       });
 
+      fastSlot.store(entry, std::memory_order_release);
       return value;
     }
 
@@ -376,6 +403,7 @@ public:
     concurrency->Lock.withLockThenNotifyAll(
         concurrency->Queue, [&entry, &value] { entry->setValue(value); });
 
+    fastSlot.store(entry, std::memory_order_release);
     return value;
   }
 };
@@ -266,6 +266,19 @@ struct SwiftRetainableBox :
   static void release(HeapObject *obj) {
     swift_release(obj);
   }
+
+  // Use the bulk entry points for the array operations so that the object
+  // headers can be prefetched ahead of the reference-count updates.
+  static void destroyArray(HeapObject **arr, size_t n) {
+    swift_bulkRelease(arr, n);
+  }
+
+  static HeapObject **initializeArrayWithCopy(HeapObject **dest,
+                                              HeapObject **src, size_t n) {
+    memcpy(dest, src, n * sizeof(HeapObject*));
+    swift_bulkRetain(dest, n);
+    return dest;
+  }
 };
 
 /// A box implementation class for Swift unowned object pointers.
@@ -481,8 +481,15 @@ recur_inside_cache_lock:
   {
     // Check if the type-protocol entry exists in the cache entry that we found.
     if (auto *Value = C.findCached(type, protocol)) {
-      if (Value->isSuccessful())
-        return std::make_pair(Value->getWitnessTable(), true);
+      if (Value->isSuccessful()) {
+        auto *witness = Value->getWitnessTable();
+        // If we found the conformance through a superclass, also cache it
+        // for the original type, so the next query for this type succeeds
+        // on its first probe instead of re-walking the class hierarchy.
+        if (type != origType)
+          C.cacheSuccess(origType, protocol, witness);
+        return std::make_pair(witness, true);
+      }
 
       // If we're still looking up for the original type, remember that
       // we found an exact match.
@@ -505,8 +512,14 @@ recur_inside_cache_lock:
 
     // Hash and lookup the type-protocol pair in the cache.
     if (auto *Value = C.findCached(description, protocol)) {
-      if (Value->isSuccessful())
-        return std::make_pair(Value->getWitnessTable(), true);
+      if (Value->isSuccessful()) {
+        auto *witness = Value->getWitnessTable();
+        // Nondependent witness tables are valid for every instantiation, so
+        // also cache the hit under the queried metadata to save the
+        // descriptor lookup next time.
+        C.cacheSuccess(origType, protocol, witness);
+        return std::make_pair(witness, true);
+      }
 
       // We don't try to cache negative responses for generic
       // patterns.
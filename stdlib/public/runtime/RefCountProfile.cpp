@@ -0,0 +1,152 @@
+//===--- RefCountProfile.cpp ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// See RefCountProfile.h for a description of the sampling scheme.
+//
+//===----------------------------------------------------------------------===//
+
+#if SWIFT_RUNTIME_ENABLE_RC_PROFILE
+
+#include "RefCountProfile.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__APPLE__) || defined(__ELF__)
+#include <dlfcn.h>
+#define SWIFT_RC_PROFILE_HAVE_DLADDR 1
+#endif
+
+using namespace swift;
+
+__thread unsigned swift::rcProfileCountdown = 1;
+
+namespace {
+
+/// The sites histogram: an open-addressed hash table keyed by return
+/// address. Slots are claimed by compare-and-swap and never freed, so
+/// recording needs no locks; a full table overflows into a single bucket
+/// rather than evicting, and the dump reports the overflow.
+constexpr size_t TableSize = 16384; // power of two; ~0.5 MiB
+
+struct Site {
+  std::atomic<const void *> Callsite;
+  std::atomic<uint64_t> Retains;
+  std::atomic<uint64_t> Releases;
+};
+
+Site Table[TableSize];
+std::atomic<uint64_t> OverflowRetains;
+std::atomic<uint64_t> OverflowReleases;
+std::atomic<bool> DumpRegistered;
+
+unsigned getSampleInterval() {
+  static unsigned interval = [] {
+    if (const char *env = getenv("SWIFT_RC_PROFILE_INTERVAL")) {
+      long value = atol(env);
+      if (value > 0)
+        return (unsigned)value;
+    }
+    return 64u;
+  }();
+  return interval;
+}
+
+Site *findSite(const void *callsite) {
+  size_t hash = (uintptr_t)callsite * 0x9E3779B97F4A7C15ULL;
+  for (size_t probe = 0; probe != 64; ++probe) {
+    Site &slot = Table[(hash + probe) & (TableSize - 1)];
+    const void *existing = slot.Callsite.load(std::memory_order_acquire);
+    if (existing == callsite)
+      return &slot;
+    if (existing == nullptr) {
+      const void *expected = nullptr;
+      if (slot.Callsite.compare_exchange_strong(expected, callsite,
+                                                std::memory_order_acq_rel))
+        return &slot;
+      if (expected == callsite)
+        return &slot;
+    }
+  }
+  return nullptr;
+}
+
+void dumpSite(const void *callsite, uint64_t retains, uint64_t releases) {
+#if SWIFT_RC_PROFILE_HAVE_DLADDR
+  Dl_info info;
+  if (dladdr(const_cast<void *>(callsite), &info) && info.dli_fname) {
+    const char *symbol = info.dli_sname ? info.dli_sname : "<unknown>";
+    uintptr_t offset =
+        (uintptr_t)callsite -
+        (uintptr_t)(info.dli_saddr ? info.dli_saddr : info.dli_fbase);
+    fprintf(stderr, "%16llu %16llu  %p  %s+%zu (%s)\n",
+            (unsigned long long)retains, (unsigned long long)releases,
+            callsite, symbol, (size_t)offset, info.dli_fname);
+    return;
+  }
+#endif
+  fprintf(stderr, "%16llu %16llu  %p\n", (unsigned long long)retains,
+          (unsigned long long)releases, callsite);
+}
+
+} // end anonymous namespace
+
+void swift_rcProfile_sample(bool isRetain, const void *callsite) {
+  rcProfileCountdown = getSampleInterval();
+
+  if (!DumpRegistered.exchange(true, std::memory_order_relaxed))
+    atexit(swift_rcProfile_dump);
+
+  Site *site = findSite(callsite);
+  auto &counter = site ? (isRetain ? site->Retains : site->Releases)
+                       : (isRetain ? OverflowRetains : OverflowReleases);
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void swift_rcProfile_dump(void) {
+  struct Row {
+    const void *Callsite;
+    uint64_t Retains;
+    uint64_t Releases;
+  };
+  std::vector<Row> rows;
+  for (size_t i = 0; i != TableSize; ++i) {
+    const void *callsite = Table[i].Callsite.load(std::memory_order_acquire);
+    if (!callsite)
+      continue;
+    rows.push_back({callsite, Table[i].Retains.load(std::memory_order_relaxed),
+                    Table[i].Releases.load(std::memory_order_relaxed)});
+  }
+  std::sort(rows.begin(), rows.end(), [](const Row &lhs, const Row &rhs) {
+    return lhs.Retains + lhs.Releases > rhs.Retains + rhs.Releases;
+  });
+
+  fprintf(stderr,
+          "=== Swift retain/release profile "
+          "(sampled 1 in %u, %zu sites) ===\n",
+          getSampleInterval(), rows.size());
+  fprintf(stderr, "%16s %16s  %s\n", "retains", "releases", "callsite");
+  for (const Row &row : rows)
+    dumpSite(row.Callsite, row.Retains, row.Releases);
+
+  uint64_t overflowRetains = OverflowRetains.load(std::memory_order_relaxed);
+  uint64_t overflowReleases = OverflowReleases.load(std::memory_order_relaxed);
+  if (overflowRetains || overflowReleases)
+    fprintf(stderr, "%16llu %16llu  <table full>\n",
+            (unsigned long long)overflowRetains,
+            (unsigned long long)overflowReleases);
+}
+
+#endif
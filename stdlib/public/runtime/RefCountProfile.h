@@ -0,0 +1,58 @@
+//===--- RefCountProfile.h --------------------------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Opt-in sampling profiler for retain/release traffic. When the runtime is
+// built with SWIFT_RUNTIME_ENABLE_RC_PROFILE, the retain and release entry
+// points attribute a sample of their calls to the caller's return address
+// in a compact lock-free histogram, which is dumped to stderr at process
+// exit. Sampling (1 in 64 operations per thread by default, tunable via
+// the SWIFT_RC_PROFILE_INTERVAL environment variable) keeps the cost to a
+// thread-local counter decrement on the unsampled path. When the flag is
+// off the hooks compile away, like Leaks.h and AllocationTrace.h.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_STDLIB_RUNTIME_REF_COUNT_PROFILE_H
+#define SWIFT_STDLIB_RUNTIME_REF_COUNT_PROFILE_H
+
+#if SWIFT_RUNTIME_ENABLE_RC_PROFILE
+
+#include "../SwiftShims/Visibility.h"
+
+/// Record one sampled retain (isRetain true) or release at \p callsite.
+/// Called from the refcounting entry points; not meant for use by tools.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_rcProfile_sample(bool isRetain, const void *callsite);
+
+/// Write the histogram to stderr. Registered with atexit on first sample;
+/// also callable directly from a debugger or test.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_rcProfile_dump(void);
+
+namespace swift {
+/// Per-thread countdown to the next sampled operation.
+extern __thread unsigned rcProfileCountdown;
+}
+
+#define SWIFT_RC_PROFILE(isRetain)                                             \
+  do {                                                                         \
+    if (__builtin_expect(--swift::rcProfileCountdown == 0, false))             \
+      swift_rcProfile_sample(isRetain, __builtin_return_address(0));           \
+  } while (0)
+#define SWIFT_RC_PROFILE_RETAIN() SWIFT_RC_PROFILE(true)
+#define SWIFT_RC_PROFILE_RELEASE() SWIFT_RC_PROFILE(false)
+#else
+#define SWIFT_RC_PROFILE_RETAIN()
+#define SWIFT_RC_PROFILE_RELEASE()
+#endif
+
+#endif
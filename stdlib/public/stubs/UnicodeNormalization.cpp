@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <mutex>
 #include <assert.h>
+#include <string.h>
 
 #include <unicode/ustring.h>
 #include <unicode/ucol.h>
@@ -289,6 +290,35 @@ intptr_t swift::_swift_stdlib_unicode_hash_ascii(const unsigned char *Str,
   return hashFinish(HashState);
 }
 
+namespace {
+typedef unsigned char CharVector __attribute__((vector_size(16)));
+}
+
+/// Check two ASCII strings of the same length for bytewise equality,
+/// 16 bytes at a time. Unlike memcmp this doesn't compute an ordering,
+/// so each block needs just one vector comparison; equality is by far
+/// the more common question, since it's the one Dictionary asks.
+int32_t swift::_swift_stdlib_unicode_equal_ascii(const unsigned char *Left,
+                                                 const unsigned char *Right,
+                                                 int32_t Length) {
+  int32_t Pos = 0;
+  for (; Pos + 16 <= Length; Pos += 16) {
+    CharVector L, R;
+    memcpy(&L, Left + Pos, sizeof(L));
+    memcpy(&R, Right + Pos, sizeof(R));
+    CharVector Diff = L ^ R;
+    uint64_t Words[2];
+    memcpy(Words, &Diff, sizeof(Words));
+    if (Words[0] | Words[1])
+      return 0;
+  }
+  for (; Pos < Length; ++Pos) {
+    if (Left[Pos] != Right[Pos])
+      return 0;
+  }
+  return 1;
+}
+
 /// Convert the unicode string to uppercase. This function will return the
 /// required buffer length as a result. If this length does not match the
 /// 'DestinationCapacity' this function must be called again with a buffer of
@@ -0,0 +1,19 @@
+; This is not really a Swift source file: -*- Text -*-
+
+; Bulk mode must produce the same output as the stdin pipeline, in input
+; order, regardless of the thread count.
+
+%t.input: "A ---> B" ==> "A"
+RUN: sed -ne '/--->/s/ *--->.*$//p' < %S/Inputs/manglings.txt > %t.input
+
+%t.check: "A ---> B" ==> "B"
+RUN: sed -ne '/--->/s/^.*---> *//p' < %S/Inputs/manglings.txt > %t.check
+
+RUN: swift-demangle -input-file %t.input > %t.output
+RUN: diff %t.check %t.output
+
+RUN: swift-demangle -input-file %t.input -num-threads 4 > %t.output.mt
+RUN: diff %t.check %t.output.mt
+
+RUN: swift-demangle -input-file %t.input -num-threads 1 > %t.output.st
+RUN: diff %t.check %t.output.st
@@ -0,0 +1,17 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: cp %s %t/main.swift
+// RUN: not %swift -parse -target %target-triple %t/main.swift -fixit-apply
+// RUN: diff %t/main.swift %s.result
+
+class Base {}
+class Derived : Base {}
+
+var b : Base
+b as Derived
+b as Derived
+
+var opti : Int?
+// Add bang.
+var i : Int = opti
+// But remove unnecessary bang.
+var i2 : Int = i!
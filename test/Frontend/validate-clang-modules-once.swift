@@ -0,0 +1,6 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: touch %t/session.timestamp
+// RUN: %target-swift-frontend -typecheck -validate-clang-modules-once -clang-build-session-file %t/session.timestamp %s
+// RUN: not %target-swift-frontend -typecheck -validate-clang-modules-once %s 2>&1 | %FileCheck %s
+
+// CHECK: option '-validate-clang-modules-once' is missing a required argument (-clang-build-session-file)
@@ -0,0 +1,25 @@
+// RUN: %target-swift-frontend -module-name test -emit-ir %s | %FileCheck %s
+
+// A trivial type stored at its natural alignment shares the matching builtin
+// integer type's value witness table exported by the runtime instead of
+// getting a table (and witness functions) of its own.
+
+// CHECK: @_TMfV4test8SmallPOD = internal constant {{.*}} @_TWVBi64_
+struct SmallPOD {
+  var x: Int64
+}
+
+// A layout with padding cannot use a common table and still gets its own.
+
+// CHECK: @_TMfV4test9OddLayout = internal constant {{.*}} @_TWVV4test9OddLayout
+struct OddLayout {
+  var x: Int64
+  var y: Int8
+}
+
+// Types with reference fields are not trivial and keep their own table.
+
+// CHECK: @_TMfV4test10NonTrivial = internal constant {{.*}} @_TWVV4test10NonTrivial
+struct NonTrivial {
+  var x: AnyObject
+}
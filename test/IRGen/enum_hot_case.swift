@@ -0,0 +1,23 @@
+// RUN: %target-swift-frontend -emit-ir %s | %FileCheck %s
+
+// The @_hot case is moved to the front of the layout group and gets the
+// cheapest tag value, regardless of its position in the declaration.
+
+enum Message {
+  case first
+  case second
+  @_hot case hottest
+  case last
+}
+
+// CHECK-LABEL: define{{.*}}hottestMessage
+// CHECK: ret i{{[0-9]+}} 0
+public func hottestMessage() -> Message {
+  return .hottest
+}
+
+// CHECK-LABEL: define{{.*}}firstMessage
+// CHECK: ret i{{[0-9]+}} 1
+public func firstMessage() -> Message {
+  return .first
+}
@@ -0,0 +1,33 @@
+// RUN: %target-swift-frontend -emit-ir %s | %FileCheck %s
+// RUN: %target-swift-frontend -emit-ir %s | %FileCheck -check-prefix=NEGATIVE %s
+
+// A private value type which is never used type-erased needs neither type
+// metadata nor a value witness table in the object file.
+
+private struct Unexposed {
+  var x = 0.0
+  var y = 0.0
+  var z = 0.0
+}
+
+public func useDirectly() -> Double {
+  let u = Unexposed()
+  return u.x + u.y + u.z
+}
+
+// A type-erased use triggers the lazy emission.
+
+private struct Erased {
+  var x = 0.0
+  var y = 0.0
+  var z = 0.0
+}
+
+public func erase() -> Any {
+  return Erased()
+}
+
+// CHECK: _TMV{{.*}}Erased
+
+// NEGATIVE-NOT: _TMV{{.*}}Unexposed
+// NEGATIVE-NOT: _TWV{{.*}}Unexposed
@@ -11,14 +11,14 @@ import local_types_helper
 // CHECK-DAG: @_TMVF18local_types_helper4testFT_T_L_1S = external hidden global %swift.type
 
 public func singleFunc() {
-  // CHECK-DAG: @_TWVVF11local_types10singleFuncFT_T_L_16SingleFuncStruct = hidden constant
+  // CHECK-DAG: @_TMnVF11local_types10singleFuncFT_T_L_16SingleFuncStruct = hidden constant
   struct SingleFuncStruct {
     let i: Int
   }
 }
 
 public let singleClosure: () -> () = {
-  // CHECK-DAG: @_TWVVFIv11local_types13singleClosureFT_T_iU_FT_T_L_19SingleClosureStruct = hidden constant
+  // CHECK-DAG: @_TMnVFIv11local_types13singleClosureFT_T_iU_FT_T_L_19SingleClosureStruct = hidden constant
   struct SingleClosureStruct {
     let i: Int
   }
@@ -26,7 +26,7 @@ public let singleClosure: () -> () = {
 
 public struct PatternStruct {
   public var singlePattern: Int = ({
-    // CHECK-DAG: @_TWVVFIvV11local_types13PatternStruct13singlePatternSiiU_FT_SiL_19SinglePatternStruct = hidden constant
+    // CHECK-DAG: @_TMnVFIvV11local_types13PatternStruct13singlePatternSiiU_FT_SiL_19SinglePatternStruct = hidden constant
     struct SinglePatternStruct {
       let i: Int
     }
@@ -35,7 +35,7 @@ public struct PatternStruct {
 }
 
 public func singleDefaultArgument(i i: Int = {
-  // CHECK-DAG: @_TWVVFIF11local_types21singleDefaultArgumentFT1iSi_T_A_U_FT_SiL_27SingleDefaultArgumentStruct = hidden constant
+  // CHECK-DAG: @_TMnVFIF11local_types21singleDefaultArgumentFT1iSi_T_A_U_FT_SiL_27SingleDefaultArgumentStruct = hidden constant
   struct SingleDefaultArgumentStruct {
     let i: Int
   }
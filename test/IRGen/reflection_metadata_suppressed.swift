@@ -0,0 +1,31 @@
+// RUN: %target-swift-frontend -emit-ir %s | %FileCheck %s
+
+// Reflection metadata is still emitted for types that don't opt out...
+// CHECK-DAG: private constant [8 x i8] c"visible\00", section "{{[^"]*}}swift3_reflstr{{[^"]*}}"
+
+// ...but @_no_reflection_metadata suppresses the field records and field
+// name strings of the annotated type.
+// CHECK-NOT: c"hiddenField\00"
+// CHECK-NOT: c"hiddenCase\00"
+
+public struct Reflected {
+  let visible: Int
+
+  public init() {
+    visible = 0
+  }
+}
+
+@_no_reflection_metadata
+public struct NotReflected {
+  let hiddenField: Int
+
+  public init() {
+    hiddenField = 0
+  }
+}
+
+@_no_reflection_metadata
+public enum NotReflectedEnum {
+  case hiddenCase(Int)
+}
@@ -0,0 +1,15 @@
+// RUN: %target-swift-frontend -emit-ir %s | %FileCheck %s
+
+// A field name which is a suffix of an already-emitted reflection string is
+// referenced by offset into the longer string instead of being emitted again.
+
+// CHECK: private constant [4 x i8] c"abc\00", section "{{[^"]*}}swift3_reflstr{{[^"]*}}"
+// CHECK-NOT: c"bc\00"
+
+public struct First {
+  public var abc: Int = 0
+}
+
+public struct Second {
+  public var bc: Int = 0
+}
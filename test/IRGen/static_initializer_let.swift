@@ -0,0 +1,12 @@
+// RUN: %target-swift-frontend -O -parse-as-library -module-name statics -emit-ir %s | %FileCheck %s
+
+// A 'let' global folded to a static initializer is emitted as a true LLVM
+// constant, so it lands in read-only memory.
+
+// CHECK: @_Tv7statics1xVs5Int32 = {{(protected )?}}constant %Vs5Int32 <{ i32 27 }>
+public let x: Int32 = 27
+
+// A 'var' global stays writable.
+
+// CHECK: @_Tv7statics1yVs5Int32 = {{(protected )?}}global %Vs5Int32 <{ i32 42 }>
+public var y: Int32 = 42
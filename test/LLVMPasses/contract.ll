@@ -17,6 +17,7 @@ declare void @swift_unknownRetain(%swift.refcounted* ) nounwind
 declare void @swift_fixLifetime(%swift.refcounted*)
 declare void @noread_user(%swift.refcounted*) readnone
 declare void @user(%swift.refcounted*)
+declare void @argmem_user(i8* nocapture) argmemonly nounwind
 declare void @noread_user_bridged(%swift.bridge*) readnone
 declare void @user_bridged(%swift.bridge*)
 
@@ -572,6 +573,44 @@ bb3:
   ret %swift.bridge* %A
 }
 
+; A call that only accesses memory through its arguments does not stop the
+; merge for a pointer that none of the arguments alias.
+; CHECK-LABEL: define{{( protected)?}} void @swift_contractRetainNAcrossArgMemOnly(%swift.refcounted* noalias %A, i8* noalias %B) {
+; CHECK: entry:
+; CHECK-NEXT: tail call void @rt_swift_retain_n(%swift.refcounted* %A, i32 2)
+; CHECK-NEXT: call void @argmem_user(i8* %B)
+; CHECK-NEXT: call void @argmem_user(i8* %B)
+; CHECK-NEXT: tail call void @rt_swift_release_n(%swift.refcounted* %A, i32 2)
+; CHECK-NEXT: ret void
+define void @swift_contractRetainNAcrossArgMemOnly(%swift.refcounted* noalias %A, i8* noalias %B) {
+entry:
+  tail call void @rt_swift_retain(%swift.refcounted* %A)
+  call void @argmem_user(i8* %B)
+  tail call void @rt_swift_retain(%swift.refcounted* %A)
+  tail call void @rt_swift_release(%swift.refcounted* %A)
+  call void @argmem_user(i8* %B)
+  tail call void @rt_swift_release(%swift.refcounted* %A)
+  ret void
+}
+
+; If an argument of the call may alias the tracked pointer, the call still
+; stops the merge.
+; CHECK-LABEL: define{{( protected)?}} void @swift_contractRetainNArgMemOnlyAliases(%swift.refcounted* %A) {
+; CHECK: entry:
+; CHECK-NEXT: tail call void @rt_swift_retain(%swift.refcounted* %A)
+; CHECK-NEXT: bitcast
+; CHECK-NEXT: call void @argmem_user(i8* %0)
+; CHECK-NEXT: tail call void @rt_swift_retain(%swift.refcounted* %A)
+; CHECK-NEXT: ret void
+define void @swift_contractRetainNArgMemOnlyAliases(%swift.refcounted* %A) {
+entry:
+  tail call void @rt_swift_retain(%swift.refcounted* %A)
+  %0 = bitcast %swift.refcounted* %A to i8*
+  call void @argmem_user(i8* %0)
+  tail call void @rt_swift_retain(%swift.refcounted* %A)
+  ret void
+}
+
 !llvm.dbg.cu = !{!1}
 !llvm.module.flags = !{!4}
 
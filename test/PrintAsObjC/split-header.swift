@@ -0,0 +1,54 @@
+// RUN: rm -rf %t
+// RUN: mkdir %t
+
+// FIXME: BEGIN -enable-source-import hackaround
+// RUN:  %target-swift-frontend(mock-sdk: -sdk %S/../Inputs/clang-importer-sdk -I %t) -emit-module -o %t  %S/../Inputs/clang-importer-sdk/swift-modules/ObjectiveC.swift
+// FIXME: END -enable-source-import hackaround
+
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk-nosource -I %t) -emit-module -o %t -module-name split %s
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk-nosource -I %t) -parse-as-library %t/split.swiftmodule -parse -emit-objc-header-path %t/split.h -emit-objc-header-split -disable-objc-attr-requires-foundation-module
+
+// The umbrella header imports the prologue and one sub-header per
+// top-level name.
+// RUN: %FileCheck -check-prefix=UMBRELLA %s < %t/split.h
+// UMBRELLA: #import "split-prologue.h"
+// UMBRELLA: #import "split-Base.h"
+// UMBRELLA: #import "split-Sub.h"
+
+// The prologue carries the shared boilerplate and forward declarations.
+// RUN: %FileCheck -check-prefix=PROLOGUE %s < %t/split-prologue.h
+// PROLOGUE: #ifndef SPLIT_PROLOGUE_H
+// PROLOGUE: SWIFT_CLASS
+// PROLOGUE: @class Base;
+// PROLOGUE: @class Sub;
+
+// Each class gets its own guarded sub-header; a subclass imports the
+// sub-header that defines its superclass.
+// RUN: %FileCheck -check-prefix=BASE %s < %t/split-Base.h
+// BASE: #ifndef SPLIT_BASE_H
+// BASE: #import "split-prologue.h"
+// BASE: @interface Base
+
+// RUN: %FileCheck -check-prefix=SUB %s < %t/split-Sub.h
+// SUB: #ifndef SPLIT_SUB_H
+// SUB: #import "split-prologue.h"
+// SUB: #import "split-Base.h"
+// SUB: @interface Sub : Base
+
+// Split emission is byte-stable: re-running must leave the sub-headers
+// untouched.
+// RUN: cp %t/split-Base.h %t/split-Base.h.orig
+// RUN: %target-swift-frontend(mock-sdk: %clang-importer-sdk-nosource -I %t) -parse-as-library %t/split.swiftmodule -parse -emit-objc-header-path %t/split.h -emit-objc-header-split -disable-objc-attr-requires-foundation-module
+// RUN: diff %t/split-Base.h %t/split-Base.h.orig
+
+// REQUIRES: objc_interop
+
+import ObjectiveC
+
+@objc class Base : NSObject {
+  func method() {}
+}
+
+@objc class Sub : Base {
+  func subMethod() {}
+}
@@ -32,6 +32,8 @@ class FuzzyStringMatcher {
   double maxScore; ///< The maximum possible raw score for this pattern.
   /// If (and only if) c is in pattern, charactersInPattern[c] == 1
   llvm::BitVector charactersInPattern;
+  /// The character-set key of the pattern; see computeCharacterSet().
+  uint64_t patternCharacterSet;
 
 public:
   bool normalize = false; ///< Whether to normalize scores to [0, 1].
@@ -39,6 +41,19 @@ public:
 public:
   FuzzyStringMatcher(StringRef pattern);
 
+  /// Computes a 64-bit character-set key for \p text, with one bit set per
+  /// (case-folded, bucketed) byte that occurs in it.  Candidate keys can be
+  /// precomputed once and reused across many patterns.
+  static uint64_t computeCharacterSet(StringRef text);
+
+  /// A conservative check of whether a candidate whose character-set key is
+  /// \p candidateCharacterSet can possibly match the pattern.  When this
+  /// returns false, matchesCandidate() is guaranteed to return false; it is
+  /// much cheaper than running the match itself.
+  bool canMatch(uint64_t candidateCharacterSet) const {
+    return (patternCharacterSet & ~candidateCharacterSet) == 0;
+  }
+
   /// Whether \p candidate matches the pattern.
   ///
   /// This operation is much simpler/faster than calculating
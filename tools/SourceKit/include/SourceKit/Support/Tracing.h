@@ -126,6 +126,72 @@ public:
 
 };
 
+//===----------------------------------------------------------------------===//
+// Request latency attribution
+//===----------------------------------------------------------------------===//
+
+/// Per-request latency tracing, dumped as chrome-tracing JSON.
+///
+/// Enabled by setting SOURCEKIT_TRACE_REQUESTS in the environment to a
+/// file path before sourcekitd starts.  Every serviced request becomes a
+/// complete event, and the stages that add up to its latency (queueing,
+/// ast-build, sema, serialize-response) become events tagged with the
+/// request's id, so a slow completion can be attributed to queue
+/// contention versus type checking at a glance.  Load the resulting file
+/// in chrome://tracing; the array is left unterminated, which the viewer
+/// accepts, so traces survive crashes.
+namespace latency {
+
+/// Whether request-latency tracing was enabled at process start.
+bool enabled();
+
+/// Microseconds since tracing started; the timebase of all events.
+uint64_t now();
+
+/// Returns a fresh id for a request about to be serviced.
+uint64_t nextRequestId();
+
+/// The id of the request the calling thread is servicing, or 0 if the
+/// current work is not attributed to a particular request.
+uint64_t currentRequest();
+
+/// Records one complete event covering [BeginUSec, EndUSec).
+void recordEvent(llvm::StringRef Name, llvm::StringRef Category,
+                 uint64_t RequestId, uint64_t BeginUSec, uint64_t EndUSec);
+
+/// Makes \p ReqId the calling thread's current request for the lifetime
+/// of the object, restoring the previous one on destruction.
+class ScopedRequest final {
+  uint64_t Saved;
+
+public:
+  explicit ScopedRequest(uint64_t ReqId);
+  ~ScopedRequest();
+
+  ScopedRequest(const ScopedRequest &) = delete;
+  ScopedRequest &operator=(const ScopedRequest &) = delete;
+};
+
+/// Records a named stage of the current thread's request, spanning the
+/// lifetime of the object.
+class ScopedStage final {
+  const char *Stage;
+  uint64_t Begin;
+
+public:
+  explicit ScopedStage(const char *Stage)
+      : Stage(Stage), Begin(enabled() ? now() : 0) {}
+  ~ScopedStage() {
+    if (enabled())
+      recordEvent(Stage, "stage", currentRequest(), Begin, now());
+  }
+
+  ScopedStage(const ScopedStage &) = delete;
+  ScopedStage &operator=(const ScopedStage &) = delete;
+};
+
+} // namespace latency
+
 } // namespace sourcekitd
 } // namespace trace
 
@@ -33,6 +33,7 @@ FuzzyStringMatcher::FuzzyStringMatcher(StringRef pattern_)
     charactersInPattern.set(static_cast<unsigned char>(toUppercase(c)));
   }
   assert(pattern.size() == lowercasePattern.size());
+  patternCharacterSet = computeCharacterSet(pattern);
 
   // FIXME: pull out the magic constants.
   // This depends on the inner details of the matching algorithm and will need
@@ -50,6 +51,13 @@ FuzzyStringMatcher::FuzzyStringMatcher(StringRef pattern_)
   }
 }
 
+uint64_t FuzzyStringMatcher::computeCharacterSet(StringRef text) {
+  uint64_t set = 0;
+  for (unsigned char c : text)
+    set |= uint64_t(1) << (static_cast<unsigned char>(toLowercase(c)) & 63);
+  return set;
+}
+
 bool FuzzyStringMatcher::matchesCandidate(StringRef candidate) const {
   unsigned patternLength = pattern.size();
   unsigned candidateLength = candidate.size();
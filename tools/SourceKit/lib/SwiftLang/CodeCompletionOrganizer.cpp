@@ -589,6 +589,12 @@ void CodeCompletionOrganizer::Impl::addCompletionsWithFilter(
         completion->getLiteralKind() != CodeCompletionLiteralKind::NilLiteral)
       continue;
 
+    // Reject candidates that lack a character from the filter text before
+    // running the full match; both the fuzzy match and the prefix match
+    // require every (case-folded) pattern character to occur in the name.
+    if (!pattern.canMatch(completion->getNameCharacterSet()))
+      continue;
+
     bool match = false;
     if (options.fuzzyMatching && filterText.size() >= options.minFuzzyLength) {
       match = pattern.matchesCandidate(completion->getName());
@@ -782,12 +782,18 @@ ASTUnitRef ASTProducer::createASTUnit(SwiftASTManager::Implementation &MgrImpl,
   for (auto &Content : Contents)
     Invocation.addInputBuffer(Content.Buffer.get());
 
+  uint64_t ASTBuildBegin =
+      trace::latency::enabled() ? trace::latency::now() : 0;
   if (CompIns.setup(Invocation)) {
     // FIXME: Report the diagnostic.
     LOG_WARN_FUNC("Compilation setup failed!!!");
     Error = "compilation setup failed";
     return nullptr;
   }
+  if (trace::latency::enabled())
+    trace::latency::recordEvent("ast-build", "stage",
+                                trace::latency::currentRequest(),
+                                ASTBuildBegin, trace::latency::now());
 
   trace::TracedOperation TracedOp;
   if (trace::enabled()) {
@@ -797,7 +803,12 @@ ASTUnitRef ASTProducer::createASTUnit(SwiftASTManager::Implementation &MgrImpl,
   CloseClangModuleFiles scopedCloseFiles(
       *CompIns.getASTContext().getClangModuleLoader());
   Consumer.setInputBufferIDs(ASTRef->getCompilerInstance().getInputBufferIDs());
+  uint64_t SemaBegin = trace::latency::enabled() ? trace::latency::now() : 0;
   CompIns.performSema();
+  if (trace::latency::enabled())
+    trace::latency::recordEvent("sema", "stage",
+                                trace::latency::currentRequest(), SemaBegin,
+                                trace::latency::now());
 
   llvm::SmallPtrSet<Module *, 16> Visited;
   SmallVector<std::string, 8> Filenames;
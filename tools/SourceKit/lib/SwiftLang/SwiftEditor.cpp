@@ -921,6 +921,7 @@ struct SwiftEditorDocument::Implementation {
   std::vector<DiagnosticEntryInfo> ParserDiagnostics;
   RefPtr<SwiftDocumentSemanticInfo> SemanticInfo;
   CodeFormatOptions FormatOptions;
+  ide::FormatCache FormatCache;
 
   std::shared_ptr<SwiftDocumentSyntaxInfo> SyntaxInfo;
 
@@ -1239,15 +1240,30 @@ public:
 
     ++NestingLevel;
     SourceLoc StartLoc = Node.Range.getStart();
+    unsigned Offset = SrcManager.getByteDistance(
+                           SrcManager.getLocForBufferStart(BufferID), StartLoc);
+    // Note that the length can span multiple lines.
+    unsigned Length = Node.Range.getByteLength();
+
+    if (EditedLineRange.isValid()) {
+      // Cheap offset-only early exits, so that tokens in the unedited prefix
+      // and suffix of the file do not pay for line/column lookups.  Tokens
+      // near the edit fall through to the line-based logic below.
+      if (Offset + Length < AffectedRange.first) {
+        // We're entirely before the edited range, no update needed.
+        return true;
+      }
+      if (Offset > AffectedRange.first + AffectedRange.second) {
+        // We're passed the affected range and already synced up, just return.
+        return true;
+      }
+    }
+
     auto StartLineAndColumn = SrcManager.getLineAndColumn(StartLoc);
     auto EndLineAndColumn = SrcManager.getLineAndColumn(Node.Range.getEnd());
     unsigned StartLine = StartLineAndColumn.first;
     unsigned EndLine = EndLineAndColumn.second > 1 ? EndLineAndColumn.first
                                                    : EndLineAndColumn.first - 1;
-    unsigned Offset = SrcManager.getByteDistance(
-                           SrcManager.getLocForBufferStart(BufferID), StartLoc);
-    // Note that the length can span multiple lines.
-    unsigned Length = Node.Range.getByteLength();
 
     SwiftSyntaxToken Token(StartLineAndColumn.second, Length,
                            Node.Kind);
@@ -1845,7 +1861,7 @@ void SwiftEditorDocument::formatText(unsigned Line, unsigned Length,
 
   LineRange inputRange = LineRange(Line, Length);
   CodeFormatOptions Options = getFormatOptions();
-  auto indented = reformat(inputRange, Options, SM, SF);
+  auto indented = reformat(inputRange, Options, SM, SF, Impl.FormatCache);
 
   LineRange LineRange = indented.first;
   StringRef ModifiedText = indented.second;
@@ -23,6 +23,7 @@
 #include "swift/IDE/Utils.h"
 #include "swift/Strings.h"
 
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ConvertUTF.h"
 
@@ -77,6 +78,14 @@ public:
   CompilerInstance Instance;
   Module *Mod = nullptr;
   SourceTextInfo Info;
+  /// The printing options the interface was generated with, and the
+  /// modification times of the module files it was printed from.  Together
+  /// they decide whether a later request for the same module can replay this
+  /// interface instead of re-printing the AST.
+  Optional<std::string> FilterGroup;
+  bool SynthesizedExtensions = false;
+  Optional<std::string> InterestedUSR;
+  std::vector<std::pair<std::string, llvm::sys::TimeValue>> ModuleFileStamps;
   // This is the non-typechecked AST for the generated interface source.
   CompilerInstance TextCI;
   // Synchronize access to the embedded compiler instance (if we don't have an
@@ -392,6 +401,11 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
   IFaceGenCtx->Impl.IsModule = IsModule;
   IFaceGenCtx->Impl.ModuleOrHeaderName = ModuleOrHeaderName;
   IFaceGenCtx->Impl.Invocation = Invocation;
+  if (Group.hasValue())
+    IFaceGenCtx->Impl.FilterGroup = Group.getValue().str();
+  IFaceGenCtx->Impl.SynthesizedExtensions = SynthesizedExtensions;
+  if (InterestedUSR.hasValue())
+    IFaceGenCtx->Impl.InterestedUSR = InterestedUSR.getValue().str();
   CompilerInstance &CI = IFaceGenCtx->Impl.Instance;
 
   // Display diagnostics to stderr.
@@ -417,6 +431,20 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
     if (getModuleInterfaceInfo(Ctx, ModuleOrHeaderName, Group, IFaceGenCtx->Impl,
                                ErrMsg, SynthesizedExtensions, InterestedUSR))
       return nullptr;
+
+    // Remember the modification times of the module files the interface was
+    // printed from, so that later requests can tell whether it is still
+    // current.
+    for (auto *FU : IFaceGenCtx->Impl.Mod->getFiles()) {
+      auto *LF = dyn_cast<LoadedFile>(FU);
+      if (!LF || LF->getFilename().empty())
+        continue;
+      llvm::sys::fs::file_status Status;
+      if (llvm::sys::fs::status(LF->getFilename(), Status))
+        continue;
+      IFaceGenCtx->Impl.ModuleFileStamps.emplace_back(
+          LF->getFilename().str(), Status.getLastModificationTime());
+    }
   } else {
     auto &FEOpts = Invocation.getFrontendOptions();
     if (FEOpts.ImplicitObjCHeaderPath.empty()) {
@@ -541,6 +569,32 @@ bool SwiftInterfaceGenContext::matches(StringRef ModuleName,
   return true;
 }
 
+bool SwiftInterfaceGenContext::canReuseFor(Optional<StringRef> Group,
+                                           bool SynthesizedExtensions,
+                                      Optional<StringRef> InterestedUSR) const {
+  if (Group.hasValue() != Impl.FilterGroup.hasValue() ||
+      (Group.hasValue() && Group.getValue() != Impl.FilterGroup.getValue()))
+    return false;
+  if (SynthesizedExtensions != Impl.SynthesizedExtensions)
+    return false;
+  if (InterestedUSR.hasValue() != Impl.InterestedUSR.hasValue() ||
+      (InterestedUSR.hasValue() &&
+       InterestedUSR.getValue() != Impl.InterestedUSR.getValue()))
+    return false;
+
+  // The interface is only reusable while the module files it was printed from
+  // are untouched on disk.
+  for (auto &Stamp : Impl.ModuleFileStamps) {
+    llvm::sys::fs::file_status Status;
+    if (llvm::sys::fs::status(Stamp.first, Status))
+      return false;
+    if (Status.getLastModificationTime() != Stamp.second)
+      return false;
+  }
+
+  return true;
+}
+
 void SwiftInterfaceGenContext::reportEditorInfo(EditorConsumer &Consumer) const {
   Consumer.handleSourceText(Impl.Info.Text);
   reportSyntacticAnnotations(Impl.TextCI, Consumer);
@@ -557,6 +611,11 @@ void SwiftInterfaceGenContext::accessASTAsync(std::function<void()> Fn) {
   }
 }
 
+void SwiftInterfaceGenContext::accessASTSync(std::function<void()> Fn) {
+  assert(!Impl.AstUnit && "not supported for interfaces with an ASTUnit");
+  Impl.Queue.dispatchSync(std::move(Fn));
+}
+
 SwiftInterfaceGenContext::ResolvedEntity
 SwiftInterfaceGenContext::resolveEntityForOffset(unsigned Offset) const {
   // Search among the references.
@@ -712,6 +771,19 @@ void SwiftLangSupport::editorOpenInterface(EditorConsumer &Consumer,
 
   Invocation.getClangImporterOptions().ImportForwardDeclarations = true;
 
+  // If an up-to-date interface for this module was already generated with the
+  // same invocation and printing options, replay it instead of loading the
+  // module and printing its AST again.
+  if (auto IFaceGenRef = IFaceGenContexts.find(ModuleName, Invocation)) {
+    if (IFaceGenRef->canReuseFor(Group, SynthesizedExtensions,
+                                 InterestedUSR)) {
+      IFaceGenRef->accessASTSync(
+          [&] { IFaceGenRef->reportEditorInfo(Consumer); });
+      IFaceGenContexts.set(Name, IFaceGenRef);
+      return;
+    }
+  }
+
   std::string ErrMsg;
   auto IFaceGenRef = SwiftInterfaceGenContext::create(Name,
                                                       /*IsModule=*/true,
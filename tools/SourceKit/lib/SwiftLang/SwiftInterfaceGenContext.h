@@ -60,6 +60,13 @@ public:
 
   bool matches(StringRef ModuleName, const swift::CompilerInvocation &Invok);
 
+  /// Returns true if a new interface request with the given printing options
+  /// can be satisfied by replaying this already-generated interface: the
+  /// options match the ones the interface was generated with and the module
+  /// files it was printed from are unchanged on disk.
+  bool canReuseFor(Optional<StringRef> Group, bool SynthesizedExtensions,
+                   Optional<StringRef> InterestedUSR) const;
+
   /// Note: requires exclusive access to the underlying AST.
   void reportEditorInfo(EditorConsumer &Consumer) const;
 
@@ -80,6 +87,11 @@ public:
   /// Provides exclusive access to the underlying AST.
   void accessASTAsync(std::function<void()> Fn);
 
+  /// Runs \p Fn with exclusive access to the underlying AST, blocking until
+  /// it finishes.  Only supported for interfaces that do not hang off an
+  /// ASTUnit.
+  void accessASTSync(std::function<void()> Fn);
+
   /// Returns the resolved entity along with a boolean indicating if it is a
   /// reference or not.
   /// Note: requires exclusive access to the underlying AST. See accessASTAsync.
@@ -625,7 +625,12 @@ static bool passCursorInfoForDecl(const ValueDecl *VD,
   SmallString<64> SS;
   auto BaseType = findBaseTypeForReplacingArchetype(VD, Ty);
   bool InSynthesizedExtension = false;
-  if (BaseType) {
+  // Only a member whose innermost type context is an extension can be in a
+  // synthesized extension; checking that up front avoids running the
+  // (expensive) extension merge analysis over the base type for every other
+  // cursor-info request.
+  if (BaseType && dyn_cast_or_null<ExtensionDecl>(
+                      VD->getDeclContext()->getInnermostTypeContext())) {
     if (auto Target = BaseType->getAnyNominal()) {
       SynthesizedExtensionAnalyzer Analyzer(Target,
                                             PrintOptions::printInterface());
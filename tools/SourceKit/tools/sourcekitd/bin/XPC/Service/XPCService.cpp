@@ -18,6 +18,7 @@
 #include "SourceKit/Support/Concurrency.h"
 #include "SourceKit/Support/UIdent.h"
 #include "SourceKit/Support/Logging.h"
+#include "SourceKit/Support/Tracing.h"
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -177,6 +178,7 @@ public:
       return;
     }
 
+    trace::latency::ScopedStage Stage("serialize-response");
     xpc_object_t reply = xpc_dictionary_create_reply(Event);
     xpc_dictionary_set_value(reply, xpc::KeyMsgResponse, response);
     xpc_release(response);
@@ -20,6 +20,7 @@
 #include "SourceKit/Core/NotificationCenter.h"
 #include "SourceKit/Support/Concurrency.h"
 #include "SourceKit/Support/Logging.h"
+#include "SourceKit/Support/Tracing.h"
 #include "SourceKit/Support/UIdent.h"
 #include "SourceKit/SwiftLang/Factory.h"
 
@@ -313,6 +314,27 @@ void handleRequestImpl(sourcekitd_object_t ReqObj, ResponseReceiver Rec) {
   if (!ReqUID)
     return Rec(createErrorRequestInvalid("missing 'key.request' with UID value"));
 
+  // When latency tracing is on, give the request an id, record a complete
+  // event spanning its whole lifetime when the response is delivered, and
+  // make it the current request so synchronously executed stages attribute
+  // themselves to it.
+  uint64_t TraceReqId = 0;
+  if (trace::latency::enabled()) {
+    TraceReqId = trace::latency::nextRequestId();
+    uint64_t TraceStart = trace::latency::now();
+    std::string TraceName = UIdentFromSKDUID(ReqUID).getName().str();
+    ResponseReceiver OrigRec = Rec;
+    Rec = [TraceReqId, TraceStart, TraceName,
+           OrigRec](sourcekitd_response_t Resp) {
+      // Deliver first so the request event covers serialization too.
+      trace::latency::ScopedRequest CurrentTraceReq(TraceReqId);
+      OrigRec(Resp);
+      trace::latency::recordEvent(TraceName, "request", TraceReqId,
+                                  TraceStart, trace::latency::now());
+    };
+  }
+  trace::latency::ScopedRequest CurrentTraceReq(TraceReqId);
+
   if (ReqUID == RequestProtocolVersion) {
     ResponseBuilder RB;
     auto dict = RB.getDictionary();
@@ -648,8 +670,15 @@ void handleRequestImpl(sourcekitd_object_t ReqObj, ResponseReceiver Rec) {
   static WorkQueue SemaQueue{ WorkQueue::Dequeuing::Concurrent,
                               "sourcekit.request.semantic" };
   sourcekitd_request_retain(ReqObj);
+  uint64_t TraceEnqueuedAt =
+      trace::latency::enabled() ? trace::latency::now() : 0;
   SemaQueue.dispatch(
-    [ReqObj, Rec, ReqUID, SourceFile, SourceText, Args] {
+    [ReqObj, Rec, ReqUID, SourceFile, SourceText, Args, TraceReqId,
+     TraceEnqueuedAt] {
+      if (trace::latency::enabled())
+        trace::latency::recordEvent("queueing", "stage", TraceReqId,
+                                    TraceEnqueuedAt, trace::latency::now());
+      trace::latency::ScopedRequest CurrentTraceReq(TraceReqId);
       RequestDict Req(ReqObj);
       handleSemanticRequest(Req, Rec, ReqUID, SourceFile, SourceText, Args);
       sourcekitd_request_release(ReqObj);
@@ -108,6 +108,17 @@ static bool shouldRunAsSubcommand(StringRef ExecName,
 
 extern int apinotes_main(ArrayRef<const char *> Args);
 
+/// The path of the running executable, for use by runFrontendInProcess.
+static std::string MainExecutablePath;
+
+/// Runs a '-frontend' job in this process on behalf of the driver.
+///
+/// \sa Compilation::setInProcessFrontendFn
+static int runFrontendInProcess(ArrayRef<const char *> Args) {
+  return performFrontend(Args, MainExecutablePath.c_str(),
+                         (void *)(intptr_t)getExecutablePath);
+}
+
 int main(int argc_, const char **argv_) {
   INITIALIZE_LLVM(argc_, argv_);
 
@@ -200,6 +211,8 @@ int main(int argc_, const char **argv_) {
     return 1;
 
   if (C) {
+    MainExecutablePath = Path;
+    C->setInProcessFrontendFn(runFrontendInProcess);
     return C->performJobs();
   }
 
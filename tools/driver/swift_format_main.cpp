@@ -41,6 +41,7 @@ private:
   unsigned BufferID;
   CompilerInvocation CompInv;
   std::unique_ptr<ParserUnit> Parser;
+  FormatCache Cache;
   class FormatterDiagConsumer : public swift::DiagnosticConsumer {
     void handleDiagnostic(SourceManager &SM, SourceLoc Loc, DiagnosticKind Kind,
                           StringRef Text,
@@ -67,7 +68,7 @@ public:
 
   std::pair<LineRange, std::string> reformat(LineRange Range,
                                              CodeFormatOptions Options) {
-    return ::reformat(Range, Options, SM, Parser->getSourceFile());
+    return ::reformat(Range, Options, SM, Parser->getSourceFile(), Cache);
   }
 
   const llvm::MemoryBuffer &memBuffer() const {
@@ -32,11 +32,14 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include <chrono>
 #include <cstdio>
 using namespace swift;
 
@@ -157,16 +160,172 @@ static llvm::cl::opt<unsigned>
 ASTVerifierProcessId("ast-verifier-process-id", llvm::cl::Hidden,
                      llvm::cl::init(1));
 
+static llvm::cl::opt<unsigned>
+ASTVerifierSamplePeriod("ast-verifier-sample-period", llvm::cl::Hidden,
+                        llvm::cl::init(0));
+
 static llvm::cl::opt<bool>
 PerformWMO("wmo", llvm::cl::desc("Enable whole-module optimizations"));
 
-static void runCommandLineSelectedPasses(SILModule *Module) {
-  SILPassManager PM(Module);
+static llvm::cl::opt<bool>
+SILTimePasses("sil-time-passes",
+              llvm::cl::desc("Print wall time and instruction count delta "
+                             "for each pass on the command line. Runs the "
+                             "passes one at a time, so analyses are not "
+                             "shared between them."));
+
+static llvm::cl::opt<bool>
+SILPrintPassHashes("sil-print-pass-hashes",
+                   llvm::cl::desc("Print a hash of the module's SIL after "
+                                  "each pass on the command line (to stderr, "
+                                  "for use as a -sil-bisect-baseline file)."));
+
+static llvm::cl::opt<std::string>
+SILBisectBaseline("sil-bisect-baseline",
+                  llvm::cl::desc("Binary search the command line pass list "
+                                 "for the first pass whose output diverges "
+                                 "from the given baseline file (produced by "
+                                 "a previous run's -sil-print-pass-hashes "
+                                 "stderr output)."));
+
+static StringRef getPassName(PassKind Kind) {
+  switch (Kind) {
+#define PASS(ID, NAME, DESCRIPTION)                                            \
+  case PassKind::ID:                                                           \
+    return NAME;
+#include "swift/SILOptimizer/PassManager/Passes.def"
+  case PassKind::invalidPassKind:
+    break;
+  }
+  llvm_unreachable("invalid pass kind");
+}
+
+static unsigned countModuleInstructions(SILModule *Module) {
+  unsigned Count = 0;
+  for (auto &F : *Module)
+    for (auto &BB : F)
+      Count += std::distance(BB.begin(), BB.end());
+  return Count;
+}
+
+/// Hash the module's printed SIL in sorted order, so the hash is stable
+/// across runs and diffable against a baseline.
+static std::string hashModule(SILModule *Module, swift::Module *MainModule) {
+  std::string Str;
+  llvm::raw_string_ostream OS(Str);
+  Module->print(OS, /*Verbose=*/false, MainModule, /*SortedSIL=*/true,
+                /*PrintASTDecls=*/false);
+  OS.flush();
+
+  llvm::MD5 Hash;
+  Hash.update(Str);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  llvm::SmallString<32> Hex;
+  llvm::MD5::stringifyResult(Result, Hex);
+  return Hex.str().str();
+}
+
+/// Read the hashes out of a file produced by -sil-print-pass-hashes: the
+/// hash is the last token on each non-empty line.
+static bool readBaselineHashes(StringRef Path,
+                               std::vector<std::string> &Hashes) {
+  auto FileBufOrErr = llvm::MemoryBuffer::getFile(Path);
+  if (!FileBufOrErr)
+    return false;
+  llvm::SmallVector<StringRef, 64> Lines;
+  FileBufOrErr.get()->getBuffer().split(Lines, '\n');
+  for (StringRef Line : Lines) {
+    Line = Line.trim();
+    if (Line.empty())
+      continue;
+    Hashes.push_back(Line.rsplit(' ').second.str());
+  }
+  return true;
+}
 
+static bool runCommandLineSelectedPasses(SILModule *Module,
+                                         swift::Module *MainModule) {
+  bool RunOneAtATime =
+      SILTimePasses || SILPrintPassHashes || !SILBisectBaseline.empty();
+  if (!RunOneAtATime) {
+    SILPassManager PM(Module);
+    for (auto Pass : Passes) {
+      PM.addPass(Pass);
+    }
+    PM.run();
+    return false;
+  }
+
+  std::vector<std::string> Hashes;
+  unsigned InstCount = countModuleInstructions(Module);
+  unsigned Idx = 0;
   for (auto Pass : Passes) {
-    PM.addPass(Pass);
+    auto StartTime = std::chrono::steady_clock::now();
+    {
+      SILPassManager PM(Module);
+      PM.addPass(Pass);
+      PM.run();
+    }
+    auto EndTime = std::chrono::steady_clock::now();
+
+    if (SILTimePasses) {
+      unsigned NewInstCount = countModuleInstructions(Module);
+      double Millis = std::chrono::duration_cast<std::chrono::microseconds>(
+                          EndTime - StartTime).count() / 1000.0;
+      llvm::errs() << llvm::format("%4u %-40s %10.3f ms  %8u -> %8u (%+d)\n",
+                                   Idx, getPassName(Pass).str().c_str(),
+                                   Millis, InstCount, NewInstCount,
+                                   int(NewInstCount) - int(InstCount));
+      InstCount = NewInstCount;
+    }
+
+    if (SILPrintPassHashes || !SILBisectBaseline.empty()) {
+      Hashes.push_back(hashModule(Module, MainModule));
+      if (SILPrintPassHashes)
+        llvm::errs() << Idx << " " << getPassName(Pass) << " "
+                     << Hashes.back() << "\n";
+    }
+    ++Idx;
+  }
+
+  if (SILBisectBaseline.empty())
+    return false;
+
+  std::vector<std::string> Baseline;
+  if (!readBaselineHashes(SILBisectBaseline, Baseline)) {
+    llvm::errs() << "sil-opt: cannot read bisect baseline '"
+                 << SILBisectBaseline << "'\n";
+    return true;
+  }
+  unsigned N = std::min(Hashes.size(), Baseline.size());
+
+  // Once a pass's output diverges, every later hash differs too, so the
+  // first divergence is found with a binary search over the recorded
+  // hashes.
+  unsigned Lo = 0, Hi = N;
+  while (Lo < Hi) {
+    unsigned Mid = Lo + (Hi - Lo) / 2;
+    if (Hashes[Mid] != Baseline[Mid])
+      Hi = Mid;
+    else
+      Lo = Mid + 1;
   }
-  PM.run();
+
+  if (Lo == N) {
+    if (Hashes.size() != Baseline.size()) {
+      llvm::errs() << "sil-opt: bisect: baseline has " << Baseline.size()
+                   << " hashes but " << Hashes.size()
+                   << " passes were run\n";
+      return true;
+    }
+    llvm::errs() << "sil-opt: bisect: no divergence from baseline\n";
+    return false;
+  }
+
+  llvm::errs() << "sil-opt: bisect: first divergence after pass " << Lo
+               << " '" << getPassName(Passes[Lo]) << "'\n";
+  return true;
 }
 
 // This function isn't referenced outside its translation unit, but it
@@ -218,6 +377,8 @@ int main(int argc, char **argv) {
       ASTVerifierProcessCount;
   Invocation.getLangOptions().ASTVerifierProcessId =
       ASTVerifierProcessId;
+  Invocation.getLangOptions().ASTVerifierSamplePeriod =
+      ASTVerifierSamplePeriod;
 
   // Setup the SIL Options.
   SILOptions &SILOpts = Invocation.getSILOptions();
@@ -308,7 +469,10 @@ int main(int argc, char **argv) {
   } else if (OptimizationGroup == OptGroup::Performance) {
     runSILOptimizationPasses(*CI.getSILModule());
   } else {
-    runCommandLineSelectedPasses(CI.getSILModule());
+    // A found bisect divergence (or a bisect setup error) exits nonzero so
+    // triage scripts can branch on it.
+    if (runCommandLineSelectedPasses(CI.getSILModule(), CI.getMainModule()))
+      return 1;
   }
 
   if (EmitSIB) {
@@ -19,12 +19,14 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
-#include "llvm/Support/Regex.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <string>
+#include <thread>
+#include <vector>
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
 #else
@@ -55,20 +57,23 @@ static llvm::cl::opt<bool>
 Simplified("simplified",
            llvm::cl::desc("Don't display module names or implicit self types"));
 
+static llvm::cl::opt<std::string>
+BulkFilename("input-file",
+           llvm::cl::desc("Demangle the newline-separated symbols in a file "
+                          "instead of stdin; the file is memory-mapped and "
+                          "demangled on multiple threads"),
+           llvm::cl::value_desc("filename"));
+
+static llvm::cl::opt<unsigned>
+NumThreads("num-threads",
+           llvm::cl::desc("Number of threads to use with -input-file "
+                          "(0 means one per hardware thread)"),
+           llvm::cl::init(0));
+
 static llvm::cl::list<std::string>
 InputNames(llvm::cl::Positional, llvm::cl::desc("[mangled name...]"),
                llvm::cl::ZeroOrMore);
 
-static llvm::StringRef substrBefore(llvm::StringRef whole,
-                                    llvm::StringRef part) {
-  return whole.slice(0, part.data() - whole.data());
-}
-
-static llvm::StringRef substrAfter(llvm::StringRef whole,
-                                   llvm::StringRef part) {
-  return whole.substr((part.data() - whole.data()) + part.size());
-}
-
 static void demangle(llvm::raw_ostream &os, llvm::StringRef name,
                      const swift::Demangle::DemangleOptions &options) {
   bool hadLeadingUnderscore = false;
@@ -76,36 +81,71 @@ static void demangle(llvm::raw_ostream &os, llvm::StringRef name,
     hadLeadingUnderscore = true;
     name = name.substr(1);
   }
-  swift::Demangle::NodePointer pointer =
-      swift::demangle_wrappers::demangleSymbolAsNode(name);
   if (ExpandMode || TreeOnly) {
-    llvm::outs() << "Demangling for " << name << '\n';
-    swift::demangle_wrappers::NodeDumper(pointer).print(llvm::outs());
+    swift::Demangle::NodePointer pointer =
+        swift::demangle_wrappers::demangleSymbolAsNode(name);
+    os << "Demangling for " << name << '\n';
+    swift::demangle_wrappers::NodeDumper(pointer).print(os);
+    if (TreeOnly)
+      return;
   }
   if (RemangleMode) {
-    if (hadLeadingUnderscore) llvm::outs() << '_';
+    swift::Demangle::NodePointer pointer =
+        swift::demangle_wrappers::demangleSymbolAsNode(name);
+    if (hadLeadingUnderscore) os << '_';
     // Just reprint the original mangled name if it didn't demangle.
     // This makes it easier to share the same database between the
     // mangling and demangling tests.
     if (!pointer) {
-      llvm::outs() << name;
+      os << name;
     } else {
-      llvm::outs() << swift::Demangle::mangleNode(pointer);
+      os << swift::Demangle::mangleNode(pointer);
     }
     return;
   }
-  if (!TreeOnly) {
-    std::string string = swift::Demangle::nodeToString(pointer, options);
-    if (!CompactMode)
-      llvm::outs() << name << " ---> ";
-    llvm::outs() << (string.empty() ? name : llvm::StringRef(string));
+  if (!CompactMode)
+    os << name << " ---> ";
+  // Stream the demangling; a name that does not demangle is echoed.
+  swift::Demangle::demangleSymbolAsString(name, os, options);
+}
+
+/// Finds the first plausible mangled symbol in \p text, equivalent to the
+/// regular expression "_T[_a-zA-Z0-9$]+".  This doesn't handle Unicode
+/// symbols, but maybe that's okay.
+static bool findMaybeSymbol(llvm::StringRef text, size_t &begin, size_t &end) {
+  auto isSymbolChar = [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' || c == '$';
+  };
+  size_t pos = 0;
+  while ((pos = text.find("_T", pos)) != llvm::StringRef::npos) {
+    size_t symbolEnd = pos + 2;
+    while (symbolEnd < text.size() && isSymbolChar(text[symbolEnd]))
+      ++symbolEnd;
+    if (symbolEnd > pos + 2) {
+      begin = pos;
+      end = symbolEnd;
+      return true;
+    }
+    pos += 2;
+  }
+  return false;
+}
+
+/// Demangles every plausible symbol in \p text, echoing the surrounding
+/// text.
+static void demangleLine(llvm::raw_ostream &os, llvm::StringRef text,
+                         const swift::Demangle::DemangleOptions &options) {
+  size_t begin, end;
+  while (findMaybeSymbol(text, begin, end)) {
+    os << text.slice(0, begin);
+    demangle(os, text.slice(begin, end), options);
+    text = text.substr(end);
   }
+  os << text;
 }
 
 static int demangleSTDIN(const swift::Demangle::DemangleOptions &options) {
-  // This doesn't handle Unicode symbols, but maybe that's okay.
-  llvm::Regex maybeSymbol("_T[_a-zA-Z0-9$]+");
-
   while (true) {
     char *inputLine = NULL;
     size_t size;
@@ -117,21 +157,74 @@ static int demangleSTDIN(const swift::Demangle::DemangleOptions &options) {
       return EXIT_FAILURE;
     }
 
-    llvm::StringRef inputContents(inputLine);
-    llvm::SmallVector<llvm::StringRef, 1> matches;
-    while (maybeSymbol.match(inputContents, &matches)) {
-      llvm::outs() << substrBefore(inputContents, matches.front());
-      demangle(llvm::outs(), matches.front(), options);
-      inputContents = substrAfter(inputContents, matches.front());
-    }
-
-    llvm::outs() << inputContents;
+    demangleLine(llvm::outs(), inputLine, options);
     free(inputLine);
   }
 
   return EXIT_SUCCESS;
 }
 
+static int demangleBulkFile(const swift::Demangle::DemangleOptions &options) {
+  // getFile memory-maps any input large enough for it to matter.
+  auto bufferOrError = llvm::MemoryBuffer::getFile(BulkFilename);
+  if (std::error_code errorCode = bufferOrError.getError()) {
+    llvm::errs() << "swift-demangle: cannot open " << BulkFilename << ": "
+                 << errorCode.message() << '\n';
+    return EXIT_FAILURE;
+  }
+  llvm::StringRef contents = bufferOrError.get()->getBuffer();
+
+  unsigned threadCount = NumThreads;
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  // Carve the input into one chunk per thread, rounding each boundary up to
+  // the next line break so no symbol is split.
+  std::vector<llvm::StringRef> chunks;
+  size_t chunkTarget = std::max<size_t>(contents.size() / threadCount, 1);
+  size_t pos = 0;
+  while (pos < contents.size()) {
+    size_t chunkEnd = std::min(pos + chunkTarget, contents.size());
+    chunkEnd = contents.find('\n', chunkEnd);
+    chunkEnd = (chunkEnd == llvm::StringRef::npos) ? contents.size()
+                                                   : chunkEnd + 1;
+    chunks.push_back(contents.slice(pos, chunkEnd));
+    pos = chunkEnd;
+  }
+
+  // Each worker demangles its chunk into a private buffer; the buffers are
+  // written out in input order afterwards, so the only synchronization is
+  // the joins.
+  std::vector<std::string> results(chunks.size());
+  auto demangleChunk = [&](unsigned index) {
+    results[index].reserve(chunks[index].size() * 2);
+    llvm::raw_string_ostream os(results[index]);
+    llvm::StringRef rest = chunks[index];
+    while (!rest.empty()) {
+      size_t eol = rest.find('\n');
+      demangleLine(os, rest.substr(0, eol), options);
+      if (eol == llvm::StringRef::npos)
+        break;
+      os << '\n';
+      rest = rest.substr(eol + 1);
+    }
+    os.flush();
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < chunks.size(); ++i)
+    workers.emplace_back(demangleChunk, i);
+  if (!chunks.empty())
+    demangleChunk(0);
+  for (auto &worker : workers)
+    worker.join();
+
+  for (auto &result : results)
+    llvm::outs() << result;
+
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv) {
 #if defined(__CYGWIN__)
   // Cygwin clang 3.5.2 with '-O3' generates CRASHING BINARY,
@@ -145,6 +238,11 @@ int main(int argc, char **argv) {
   if (Simplified)
     options = swift::Demangle::DemangleOptions::SimplifiedUIDemangleOptions();
 
+  if (!BulkFilename.empty()) {
+    CompactMode = true;
+    return demangleBulkFile(options);
+  }
+
   if (InputNames.empty()) {
     CompactMode = true;
     return demangleSTDIN(options);
@@ -321,9 +321,11 @@ DebugForbidTypecheckPrefix("debug-forbid-typecheck-prefix",
 
 // '-code-completion' options.
 
-static llvm::cl::opt<std::string>
+static llvm::cl::list<std::string>
 CodeCompletionToken("code-completion-token",
-                    llvm::cl::desc("Code completion token name"));
+                    llvm::cl::desc("Code completion token name.  May be given "
+                                   "several times to complete at each token "
+                                   "in one run, sharing cached results"));
 
 static llvm::cl::opt<bool>
 CodeCompletionDiagnostics("code-completion-diagnostics",
@@ -554,7 +556,7 @@ removeCodeCompletionTokens(llvm::MemoryBuffer *Input,
 static int doCodeCompletion(const CompilerInvocation &InitInvok,
                             StringRef SourceFilename,
                             StringRef SecondSourceFileName,
-                            StringRef CodeCompletionToken,
+                            ArrayRef<std::string> CodeCompletionTokens,
                             bool CodeCompletionDiagnostics,
                             bool CodeCompletionKeywords) {
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> FileBufOrErr =
@@ -565,59 +567,53 @@ static int doCodeCompletion(const CompilerInvocation &InitInvok,
     return 1;
   }
 
-  unsigned CodeCompletionOffset;
-
-  std::unique_ptr<llvm::MemoryBuffer> CleanFile(
-      removeCodeCompletionTokens(FileBufOrErr.get().get(), CodeCompletionToken,
-                                 &CodeCompletionOffset));
-
-  if (CodeCompletionOffset == ~0U) {
-    llvm::errs() << "could not find code completion token \""
-                 << CodeCompletionToken << "\"\n";
-    return 1;
-  }
-  llvm::outs() << "found code completion token " << CodeCompletionToken
-               << " at offset " << CodeCompletionOffset << "\n";
-  llvm::errs() << "found code completion token " << CodeCompletionToken
-               << " at offset " << CodeCompletionOffset << "\n";
-
-  CompilerInvocation Invocation(InitInvok);
-  Invocation.setCodeCompletionPoint(CleanFile.get(), CodeCompletionOffset);
-
-
+  // The completion cache, and through it the per-module completion results,
+  // are shared by all the requested completion points.
   std::unique_ptr<ide::OnDiskCodeCompletionCache> OnDiskCache;
   if (!options::CompletionCachePath.empty()) {
     OnDiskCache = llvm::make_unique<ide::OnDiskCodeCompletionCache>(
         options::CompletionCachePath);
   }
   ide::CodeCompletionCache CompletionCache(OnDiskCache.get());
-  ide::CodeCompletionContext CompletionContext(CompletionCache);
 
   // Create a CodeCompletionConsumer.
   std::unique_ptr<ide::CodeCompletionConsumer> Consumer(
       new ide::PrintingCodeCompletionConsumer(
           llvm::outs(), CodeCompletionKeywords));
 
-  // Create a factory for code completion callbacks that will feed the
-  // Consumer.
-  std::unique_ptr<CodeCompletionCallbacksFactory> CompletionCallbacksFactory(
-      ide::makeCodeCompletionCallbacksFactory(CompletionContext,
-                                              *Consumer.get()));
+  PrintingDiagnosticConsumer PrintDiags;
 
-  Invocation.setCodeCompletionFactory(CompletionCallbacksFactory.get());
-  if (!SecondSourceFileName.empty()) {
-    Invocation.addInputFilename(SecondSourceFileName);
-  }
-  CompilerInstance CI;
+  for (const std::string &Token : CodeCompletionTokens) {
+    unsigned CodeCompletionOffset;
 
-  PrintingDiagnosticConsumer PrintDiags;
-  if (CodeCompletionDiagnostics) {
-    // Display diagnostics to stderr.
-    CI.addDiagnosticConsumer(&PrintDiags);
+    std::unique_ptr<llvm::MemoryBuffer> CleanFile(
+        removeCodeCompletionTokens(FileBufOrErr.get().get(), Token,
+                                   &CodeCompletionOffset));
+
+    if (CodeCompletionOffset == ~0U) {
+      llvm::errs() << "could not find code completion token \""
+                   << Token << "\"\n";
+      return 1;
+    }
+    llvm::outs() << "found code completion token " << Token
+                 << " at offset " << CodeCompletionOffset << "\n";
+    llvm::errs() << "found code completion token " << Token
+                 << " at offset " << CodeCompletionOffset << "\n";
+
+    CompilerInvocation Invocation(InitInvok);
+    Invocation.setCodeCompletionPoint(CleanFile.get(), CodeCompletionOffset);
+    if (!SecondSourceFileName.empty()) {
+      Invocation.addInputFilename(SecondSourceFileName);
+    }
+
+    // The context holds per-request state, so build a fresh one around the
+    // shared cache for each completion point.
+    ide::CodeCompletionContext CompletionContext(CompletionCache);
+    if (ide::performCodeCompletion(
+            Invocation, CompletionContext, *Consumer,
+            CodeCompletionDiagnostics ? &PrintDiags : nullptr))
+      return 1;
   }
-  if (CI.setup(Invocation))
-    return 1;
-  CI.performSema();
   return 0;
 }
 
@@ -2876,13 +2872,15 @@ int main(int argc, char *argv[]) {
 
   case ActionType::CodeCompletion:
     if (options::CodeCompletionToken.empty()) {
-      llvm::errs() << "code completion token name required\n";
+      llvm::errs() << "at least one code completion token name required\n";
       return 1;
     }
     ExitCode = doCodeCompletion(InitInvok,
                                 options::SourceFilename,
                                 options::SecondSourceFilename,
-                                options::CodeCompletionToken,
+                                std::vector<std::string>(
+                                    options::CodeCompletionToken.begin(),
+                                    options::CodeCompletionToken.end()),
                                 options::CodeCompletionDiagnostics,
                                 options::CodeCompletionKeywords);
     break;
@@ -1,4 +1,5 @@
 #include "swift/Basic/ClusteredBitVector.h"
+#include "llvm/ADT/APInt.h"
 #include "gtest/gtest.h"
 
 using namespace swift;
@@ -173,6 +174,82 @@ TEST(ClusteredBitVector, SetClearBit) {
   EXPECT_EQ(false, vec[63]);
 }
 
+TEST(ClusteredBitVector, SetClearRange) {
+  ClusteredBitVector vec;
+  vec.appendClearBits(200);
+  vec.setRange(3, 135);
+  EXPECT_EQ(132u, vec.count());
+  EXPECT_EQ(false, vec[2]);
+  EXPECT_EQ(true, vec[3]);
+  EXPECT_EQ(true, vec[64]);
+  EXPECT_EQ(true, vec[134]);
+  EXPECT_EQ(false, vec[135]);
+
+  vec.clearRange(64, 128);
+  EXPECT_EQ(68u, vec.count());
+  EXPECT_EQ(true, vec[63]);
+  EXPECT_EQ(false, vec[64]);
+  EXPECT_EQ(false, vec[127]);
+  EXPECT_EQ(true, vec[128]);
+
+  vec.setRange(10, 10);
+  EXPECT_EQ(68u, vec.count());
+  EXPECT_EQ(false, vec[10]);
+}
+
+TEST(ClusteredBitVector, Slice) {
+  ClusteredBitVector vec;
+  vec.add(64, 0xC000000000000F00ULL);
+  vec.add(64, 0x0000000000000071ULL);
+
+  auto aligned = vec.slice(64, 64);
+  EXPECT_EQ(64u, aligned.size());
+  EXPECT_EQ(4u, aligned.count());
+  EXPECT_EQ(true, aligned[0]);
+  EXPECT_EQ(true, aligned[4]);
+
+  auto unaligned = vec.slice(8, 60);
+  EXPECT_EQ(60u, unaligned.size());
+  EXPECT_EQ(true, unaligned[0]);
+  EXPECT_EQ(true, unaligned[3]);
+  EXPECT_EQ(false, unaligned[4]);
+  EXPECT_EQ(true, unaligned[54]);
+  EXPECT_EQ(true, unaligned[55]);
+  EXPECT_EQ(true, unaligned[56]);
+  EXPECT_EQ(7u, unaligned.count());
+
+  ClusteredBitVector clear;
+  clear.appendClearBits(170);
+  auto clearSlice = clear.slice(20, 100);
+  EXPECT_EQ(100u, clearSlice.size());
+  EXPECT_EQ(0u, clearSlice.count());
+}
+
+TEST(ClusteredBitVector, APIntRoundTrip) {
+  llvm::APInt bits(161, 0);
+  bits.setBit(0);
+  bits.setBit(63);
+  bits.setBit(64);
+  bits.setBit(130);
+  bits.setBit(160);
+
+  auto vec = ClusteredBitVector::fromAPInt(bits);
+  EXPECT_EQ(161u, vec.size());
+  EXPECT_EQ(5u, vec.count());
+  EXPECT_EQ(true, vec[0]);
+  EXPECT_EQ(true, vec[63]);
+  EXPECT_EQ(true, vec[64]);
+  EXPECT_EQ(true, vec[130]);
+  EXPECT_EQ(true, vec[160]);
+  EXPECT_EQ(false, vec[1]);
+  EXPECT_EQ(false, vec[129]);
+  EXPECT_EQ(bits, vec.asAPInt());
+
+  auto zeros = ClusteredBitVector::fromAPInt(llvm::APInt(100, 0));
+  EXPECT_EQ(100u, zeros.size());
+  EXPECT_EQ(0u, zeros.count());
+}
+
 TEST(ClusteredBitVector, FlipAllSmall) {
   ClusteredBitVector vec;
   vec.appendClearBits(48);
@@ -0,0 +1,108 @@
+//===--- PrefixMapBenchmark.cpp - PrefixMap lookup throughput -------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Microbenchmark measuring insertions/sec and lookups/sec of PrefixMap over
+// a corpus of file paths shaped like a large project's driver output map.
+// This is not a pass/fail performance test; it prints its throughput so
+// layout changes to the trie can be compared against tracked baselines.
+// The assertions only check that every lookup actually hit.
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/PrefixMap.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using namespace swift;
+
+static double secondsSince(llvm::sys::TimeValue Start) {
+  return (llvm::sys::TimeValue::now().nanoseconds() - Start.nanoseconds()) *
+         1e-9;
+}
+
+static ArrayRef<char> asArray(const std::string &str) {
+  return ArrayRef<char>(str.data(), str.size());
+}
+
+/// Build a corpus of \p NumPaths file paths with the long shared prefixes
+/// and clustered directory structure of a real build's output map.
+static std::vector<std::string> buildCorpus(unsigned NumPaths) {
+  static const char *const Dirs[] = {
+    "Sources/Core", "Sources/UI/Views", "Sources/UI/Controllers",
+    "Sources/Networking", "Tests/CoreTests", "Tests/UITests",
+  };
+  static const char *const Stems[] = {
+    "Model", "View", "Controller", "Manager", "Helper", "Formatter",
+    "Coordinator", "Adapter",
+  };
+  std::vector<std::string> Paths;
+  Paths.reserve(NumPaths);
+  for (unsigned i = 0; i != NumPaths; ++i) {
+    std::string Path;
+    llvm::raw_string_ostream OS(Path);
+    OS << "/home/user/project/build/Intermediates/MyApp.build/"
+       << Dirs[i % (sizeof(Dirs) / sizeof(Dirs[0]))] << '/'
+       << Stems[(i / 7) % (sizeof(Stems) / sizeof(Stems[0]))] << i << ".o";
+    OS.flush();
+    Paths.push_back(std::move(Path));
+  }
+  return Paths;
+}
+
+TEST(PrefixMapBenchmark, lookupsPerSecond) {
+  const unsigned NumPaths = 8000;
+  const unsigned NumLookupReps = 100;
+  auto Paths = buildCorpus(NumPaths);
+
+  PrefixMap<char, unsigned> Map;
+
+  auto InsertStart = llvm::sys::TimeValue::now();
+  for (unsigned i = 0; i != NumPaths; ++i) {
+    Map.insert(asArray(Paths[i]), i);
+  }
+  double InsertElapsed = secondsSince(InsertStart);
+  ASSERT_EQ(size_t(NumPaths), Map.size());
+
+  // Time exact-key lookups, best of 3 runs to reduce scheduling noise.
+  double BestElapsed = 0;
+  unsigned Hits = 0;
+  for (unsigned Run = 0; Run != 3; ++Run) {
+    Hits = 0;
+    auto Start = llvm::sys::TimeValue::now();
+    for (unsigned Rep = 0; Rep != NumLookupReps; ++Rep) {
+      for (unsigned i = 0; i != NumPaths; ++i) {
+        auto Result = Map.findPrefix(asArray(Paths[i]));
+        if (Result.first && *Result.first == i)
+          ++Hits;
+      }
+    }
+    double Elapsed = secondsSince(Start);
+    if (Run == 0 || Elapsed < BestElapsed)
+      BestElapsed = Elapsed;
+  }
+  ASSERT_EQ(NumPaths * NumLookupReps, Hits);
+
+  uint64_t NumLookups = uint64_t(NumPaths) * NumLookupReps;
+  llvm::outs() << "PrefixMap: inserted " << NumPaths << " paths in "
+               << llvm::format("%.3f", InsertElapsed * 1000) << " ms ("
+               << llvm::format("%.0f", NumPaths / InsertElapsed)
+               << " inserts/sec)\n";
+  llvm::outs() << "PrefixMap: " << NumLookups << " lookups in "
+               << llvm::format("%.3f", BestElapsed * 1000) << " ms ("
+               << llvm::format("%.0f", NumLookups / BestElapsed)
+               << " lookups/sec)\n";
+}
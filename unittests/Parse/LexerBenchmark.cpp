@@ -0,0 +1,129 @@
+//===--- LexerBenchmark.cpp - Lexer and parser throughput baselines -------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Microbenchmarks measuring tokens/sec of Lexer::lex and decls/sec of
+// top-level parsing on a synthetic corpus. These are not pass/fail
+// performance tests; they print their throughput so lexer and parser
+// changes can be compared against tracked baselines per target. The
+// assertions only check that the corpus was actually consumed.
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/AST/ASTContext.h"
+#include "swift/AST/DiagnosticEngine.h"
+#include "swift/AST/Module.h"
+#include "swift/AST/SearchPathOptions.h"
+#include "swift/Basic/LangOptions.h"
+#include "swift/Basic/SourceManager.h"
+#include "swift/Parse/Lexer.h"
+#include "swift/Subsystems.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace swift;
+
+static double secondsSince(llvm::sys::TimeValue Start) {
+  return (llvm::sys::TimeValue::now().nanoseconds() - Start.nanoseconds()) *
+         1e-9;
+}
+
+/// Build a corpus of \p NumDecls function declarations mixing identifiers,
+/// operators, literals, string interpolations and comments in roughly the
+/// proportions of ordinary Swift source.
+static std::string buildCorpus(unsigned NumDecls) {
+  std::string Corpus;
+  llvm::raw_string_ostream OS(Corpus);
+  for (unsigned i = 0; i != NumDecls; ++i) {
+    OS << "/// Doc comment for function number " << i << ".\n"
+       << "func function" << i << "(x: Int, y: [String]) -> Int {\n"
+       << "  let message = \"item \\(x) of " << i << "\"\n"
+       << "  var total = x &+ " << i << "\n"
+       << "  for element in y {\n"
+       << "    total += element.utf8.count // count the bytes\n"
+       << "  }\n"
+       << "  if total > 0x100 { total = total % 257 }\n"
+       << "  _ = message\n"
+       << "  return total\n"
+       << "}\n\n";
+  }
+  return OS.str();
+}
+
+TEST(LexerBenchmark, tokensPerSecond) {
+  const unsigned NumDecls = 2000;
+  const unsigned NumReps = 3;
+
+  LangOptions LangOpts;
+  SourceManager SourceMgr;
+  unsigned BufferID = SourceMgr.addMemBufferCopy(buildCorpus(NumDecls));
+
+  uint64_t NumTokens = 0;
+  double Best = 1e9;
+  for (unsigned rep = 0; rep != NumReps; ++rep) {
+    NumTokens = 0;
+    auto Start = llvm::sys::TimeValue::now();
+    Lexer L(LangOpts, SourceMgr, BufferID, /*Diags=*/nullptr,
+            /*InSILMode=*/false);
+    Token Tok;
+    do {
+      L.lex(Tok);
+      ++NumTokens;
+    } while (Tok.isNot(tok::eof));
+    Best = std::min(Best, secondsSince(Start));
+  }
+
+  ASSERT_GT(NumTokens, NumDecls * 10u);
+  llvm::outs() << "LexerBenchmark: " << NumTokens << " tokens, best of "
+               << NumReps << ": " << llvm::format("%.6f", Best) << " sec, "
+               << llvm::format("%.0f", NumTokens / Best) << " tokens/sec\n";
+}
+
+TEST(LexerBenchmark, declsPerSecond) {
+  const unsigned NumDecls = 2000;
+  const unsigned NumReps = 3;
+
+  LangOptions LangOpts;
+  LangOpts.Target = llvm::Triple(llvm::sys::getProcessTriple());
+  SearchPathOptions SearchPathOpts;
+  SourceManager SourceMgr;
+  DiagnosticEngine Diags(SourceMgr);
+  ASTContext Ctx(LangOpts, SearchPathOpts, SourceMgr, Diags);
+
+  unsigned BufferID = SourceMgr.addMemBufferCopy(buildCorpus(NumDecls));
+  auto *M = ModuleDecl::create(Ctx.getIdentifier("benchmark"), Ctx);
+
+  size_t ParsedDecls = 0;
+  double Best = 1e9;
+  for (unsigned rep = 0; rep != NumReps; ++rep) {
+    // Parse into a fresh file each repetition; a SourceFile accumulates the
+    // declarations parsed into it.
+    auto *SF = new (Ctx) SourceFile(*M, SourceFileKind::Library, BufferID,
+                                    SourceFile::ImplicitModuleImportKind::None);
+    M->addFile(*SF);
+    auto Start = llvm::sys::TimeValue::now();
+    bool Done = false;
+    while (!Done)
+      parseIntoSourceFile(*SF, BufferID, &Done);
+    Best = std::min(Best, secondsSince(Start));
+    ParsedDecls = SF->Decls.size();
+    M->removeFile(*SF);
+  }
+
+  ASSERT_EQ(ParsedDecls, size_t(NumDecls));
+  llvm::outs() << "ParserBenchmark: " << ParsedDecls << " decls, best of "
+               << NumReps << ": " << llvm::format("%.6f", Best) << " sec, "
+               << llvm::format("%.0f", ParsedDecls / Best) << " decls/sec\n";
+}
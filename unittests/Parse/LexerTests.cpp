@@ -352,3 +352,126 @@ TEST_F(LexerTest, NestedPlaceholder) {
   std::vector<Token> Toks = checkLex(Source, ExpectedTokens);
   EXPECT_EQ("<#aa#>", Toks[2].getText());
 }
+
+TEST_F(LexerTest, TokenStreamCacheRoundTrip) {
+  const char *Source =
+      "// header\n"
+      "func foo(n: Int) -> Int { return n }\n";
+  unsigned BufID = SourceMgr.addMemBufferCopy(Source);
+
+  std::string CacheStorage;
+  {
+    llvm::raw_string_ostream OS(CacheStorage);
+    Lexer::writeTokenStreamCache(LangOpts, SourceMgr, BufID,
+                                 /*InSILMode=*/false,
+                                 CommentRetentionMode::None, OS);
+  }
+  auto CacheBuf = llvm::MemoryBuffer::getMemBuffer(CacheStorage);
+
+  std::vector<Token> Expected = tokenizeAndKeepEOF(BufID);
+
+  Lexer L(LangOpts, SourceMgr, BufID, /*Diags=*/nullptr, /*InSILMode=*/false);
+  ASSERT_TRUE(L.readTokenStreamCache(*CacheBuf));
+
+  std::vector<Token> Replayed;
+  do {
+    Replayed.emplace_back();
+    L.lex(Replayed.back());
+  } while (Replayed.back().isNot(tok::eof));
+
+  ASSERT_EQ(Expected.size(), Replayed.size());
+  for (unsigned i = 0, e = Expected.size(); i != e; ++i) {
+    EXPECT_EQ(Expected[i].getKind(), Replayed[i].getKind()) << "i = " << i;
+    EXPECT_EQ(Expected[i].getRawText(), Replayed[i].getRawText())
+        << "i = " << i;
+    EXPECT_EQ(Expected[i].isAtStartOfLine(), Replayed[i].isAtStartOfLine())
+        << "i = " << i;
+  }
+}
+
+TEST_F(LexerTest, TokenStreamCacheRestoreState) {
+  const char *Source = "let x = 1\nlet y = 2\n";
+  unsigned BufID = SourceMgr.addMemBufferCopy(Source);
+
+  std::string CacheStorage;
+  {
+    llvm::raw_string_ostream OS(CacheStorage);
+    Lexer::writeTokenStreamCache(LangOpts, SourceMgr, BufID,
+                                 /*InSILMode=*/false,
+                                 CommentRetentionMode::None, OS);
+  }
+  auto CacheBuf = llvm::MemoryBuffer::getMemBuffer(CacheStorage);
+
+  Lexer L(LangOpts, SourceMgr, BufID, /*Diags=*/nullptr, /*InSILMode=*/false);
+  ASSERT_TRUE(L.readTokenStreamCache(*CacheBuf));
+
+  Token Tok;
+  L.lex(Tok); // let
+  L.lex(Tok); // x
+  ASSERT_EQ(tok::identifier, Tok.getKind());
+  Lexer::State S = L.getStateForBeginningOfToken(Tok);
+  L.lex(Tok); // =
+  L.lex(Tok); // 1
+  L.restoreState(S);
+  L.lex(Tok);
+  EXPECT_EQ(tok::identifier, Tok.getKind());
+  EXPECT_EQ("x", Tok.getText());
+}
+
+TEST_F(LexerTest, TokenStreamCacheRejectsMismatchedSource) {
+  unsigned BufID = SourceMgr.addMemBufferCopy("let x = 1\n");
+
+  std::string CacheStorage;
+  {
+    llvm::raw_string_ostream OS(CacheStorage);
+    Lexer::writeTokenStreamCache(LangOpts, SourceMgr, BufID,
+                                 /*InSILMode=*/false,
+                                 CommentRetentionMode::None, OS);
+  }
+  auto CacheBuf = llvm::MemoryBuffer::getMemBuffer(CacheStorage);
+
+  unsigned OtherBufID = SourceMgr.addMemBufferCopy("let y = 2\n");
+  Lexer L(LangOpts, SourceMgr, OtherBufID, /*Diags=*/nullptr,
+          /*InSILMode=*/false);
+  EXPECT_FALSE(L.readTokenStreamCache(*CacheBuf));
+}
+
+TEST_F(LexerTest, PackedTokenRoundTrip) {
+  const char *Source = "// comment\nfunc `foo`(x: Int) -> Int {\n"
+                       "  return x + 1 // trailing\n}\n";
+  unsigned BufID = SourceMgr.addMemBufferCopy(Source);
+  StringRef Buffer = SourceMgr.extractText(SourceMgr.getRangeForBuffer(BufID));
+
+  std::vector<Token> Expected = tokenizeAndKeepEOF(BufID);
+  std::vector<PackedToken> Packed =
+      Lexer::tokenizePacked(LangOpts, SourceMgr, BufID);
+
+  ASSERT_EQ(Expected.size(), Packed.size());
+  ASSERT_EQ(tok::eof, Packed.back().getKind());
+  for (unsigned i = 0, e = Expected.size(); i != e; ++i) {
+    Token Unpacked = Packed[i].unpack(Buffer);
+    EXPECT_EQ(Expected[i].getKind(), Unpacked.getKind()) << "i = " << i;
+    EXPECT_EQ(Expected[i].getRawText(), Unpacked.getRawText()) << "i = " << i;
+    EXPECT_EQ(Expected[i].getText(), Unpacked.getText()) << "i = " << i;
+    EXPECT_EQ(Expected[i].isAtStartOfLine(), Unpacked.isAtStartOfLine())
+        << "i = " << i;
+    EXPECT_EQ(Expected[i].isEscapedIdentifier(),
+              Unpacked.isEscapedIdentifier()) << "i = " << i;
+  }
+}
+
+TEST_F(LexerTest, StringLiteralContainsInterpolation) {
+  const char *Source = "\"plain\" \"esc\\naped\" \"\\\\(x)\" \"a\\(x)b\"";
+  unsigned BufID = SourceMgr.addMemBufferCopy(Source);
+  std::vector<Token> Toks = tokenizeAndKeepEOF(BufID);
+  ASSERT_EQ(5u, Toks.size());
+
+  // "plain" -- no backslash at all.
+  EXPECT_FALSE(Lexer::stringLiteralContainsInterpolation(Toks[0]));
+  // "esc\naped" -- escapes, but no interpolation.
+  EXPECT_FALSE(Lexer::stringLiteralContainsInterpolation(Toks[1]));
+  // "\\(x)" -- the backslash is escaped, so the paren is literal.
+  EXPECT_FALSE(Lexer::stringLiteralContainsInterpolation(Toks[2]));
+  // "a\(x)b" -- a genuine interpolation.
+  EXPECT_TRUE(Lexer::stringLiteralContainsInterpolation(Toks[3]));
+}
@@ -0,0 +1,62 @@
+#include "swift/Basic/LangOptions.h"
+#include "swift/Basic/SourceManager.h"
+#include "swift/Parse/StructureScanner.h"
+#include "gtest/gtest.h"
+
+using namespace swift;
+
+class StructureScannerTest : public ::testing::Test {
+public:
+  LangOptions LangOpts;
+  SourceManager SourceMgr;
+
+  std::vector<TopLevelChunk> scan(StringRef Source) {
+    unsigned BufID = SourceMgr.addMemBufferCopy(Source);
+    return scanTopLevelChunks(LangOpts, SourceMgr, BufID);
+  }
+};
+
+TEST_F(StructureScannerTest, SplitsAtTopLevelDecls) {
+  StringRef Source = "func a() {\n  return\n}\n"
+                     "struct S {\n  func b() {}\n}\n"
+                     "extension S {}\n";
+  auto Chunks = scan(Source);
+  ASSERT_EQ(3u, Chunks.size());
+
+  // Chunks tile the buffer in source order.
+  EXPECT_EQ(0u, Chunks[0].Offset);
+  for (unsigned i = 1, e = Chunks.size(); i != e; ++i)
+    EXPECT_EQ(Chunks[i - 1].getEndOffset(), Chunks[i].Offset);
+  EXPECT_EQ(Source.size(), Chunks.back().getEndOffset());
+
+  EXPECT_TRUE(Source.substr(Chunks[1].Offset).startswith("struct S"));
+  EXPECT_TRUE(Source.substr(Chunks[2].Offset).startswith("extension S"));
+}
+
+TEST_F(StructureScannerTest, BracesInStringsAndCommentsIgnored) {
+  StringRef Source = "func a() {\n  let s = \"}\"\n  // }\n}\n"
+                     "func b() {}\n";
+  auto Chunks = scan(Source);
+  ASSERT_EQ(2u, Chunks.size());
+  EXPECT_TRUE(Source.substr(Chunks[1].Offset).startswith("func b"));
+}
+
+TEST_F(StructureScannerTest, NoSplitInsidePoundIf) {
+  StringRef Source = "#if FOO\nfunc a() {}\nfunc b() {}\n#endif\n";
+  auto Chunks = scan(Source);
+  ASSERT_EQ(1u, Chunks.size());
+  EXPECT_TRUE(Chunks[0].HasConditionalDirectives);
+}
+
+TEST_F(StructureScannerTest, FindEnclosingChunk) {
+  StringRef Source = "func a() {\n}\n"
+                     "func b() {\n}\n";
+  auto Chunks = scan(Source);
+  ASSERT_EQ(2u, Chunks.size());
+
+  EXPECT_EQ(&Chunks[0], findEnclosingTopLevelChunk(Chunks, 0));
+  EXPECT_EQ(&Chunks[1],
+            findEnclosingTopLevelChunk(Chunks, Chunks[1].Offset + 1));
+  // Offset at the very end of the buffer maps to the last chunk.
+  EXPECT_EQ(&Chunks[1], findEnclosingTopLevelChunk(Chunks, Source.size()));
+}
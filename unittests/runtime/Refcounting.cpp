@@ -117,6 +117,25 @@ TEST(RefcountingTest, retain_release_n) {
   EXPECT_EQ(1u, swift_retainCount(object));
 }
 
+TEST(RefcountingTest, bulk_retain_release) {
+  size_t value1 = 0;
+  size_t value2 = 0;
+  auto object1 = allocTestObject(&value1, 1);
+  auto object2 = allocTestObject(&value2, 2);
+  HeapObject *objects[] = { object1, nullptr, object2 };
+  swift_bulkRetain(objects, 3);
+  EXPECT_EQ(2u, swift_retainCount(object1));
+  EXPECT_EQ(2u, swift_retainCount(object2));
+  swift_bulkRelease(objects, 3);
+  EXPECT_EQ(1u, swift_retainCount(object1));
+  EXPECT_EQ(1u, swift_retainCount(object2));
+  EXPECT_EQ(0u, value1);
+  EXPECT_EQ(0u, value2);
+  swift_bulkRelease(objects, 3);
+  EXPECT_EQ(1u, value1);
+  EXPECT_EQ(2u, value2);
+}
+
 TEST(RefcountingTest, unknown_retain_release_n) {
   size_t value = 0;
   auto object = allocTestObject(&value, 1);
@@ -153,6 +172,74 @@ TEST(RefcountingTest, unowned_retain_release_n) {
   EXPECT_EQ(1u, value);
 }
 
+//////////////////////////
+// Weak reference tests //
+//////////////////////////
+
+TEST(RefcountingTest, weak_load_strong) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  WeakReference ref;
+  swift_weakInit(&ref, object);
+  auto loaded = swift_weakLoadStrong(&ref);
+  EXPECT_EQ(object, loaded);
+  swift_release(loaded);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref));
+  swift_weakDestroy(&ref);
+}
+
+TEST(RefcountingTest, weak_copy_shares_side_entry) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  WeakReference ref1;
+  swift_weakInit(&ref1, object);
+  EXPECT_EQ(2u, swift_unownedRetainCount(object));
+
+  // Copying promotes the reference to a shared side-table entry, so the
+  // object's own unowned count stays at the single retain the entry holds.
+  WeakReference ref2, ref3;
+  swift_weakCopyInit(&ref2, &ref1);
+  swift_weakCopyInit(&ref3, &ref2);
+  EXPECT_EQ(2u, swift_unownedRetainCount(object));
+
+  auto loaded = swift_weakLoadStrong(&ref3);
+  EXPECT_EQ(object, loaded);
+  swift_release(loaded);
+
+  swift_weakDestroy(&ref1);
+  swift_weakDestroy(&ref2);
+  EXPECT_EQ(2u, swift_unownedRetainCount(object));
+
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+
+  // The surviving reference reads nil and drops the entry.
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref3));
+  swift_weakDestroy(&ref3);
+}
+
+TEST(RefcountingTest, weak_take_copied) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  WeakReference ref1;
+  swift_weakInit(&ref1, object);
+
+  WeakReference ref2, ref3;
+  swift_weakCopyInit(&ref2, &ref1);
+  swift_weakTakeInit(&ref3, &ref2);
+  EXPECT_EQ(2u, swift_unownedRetainCount(object));
+
+  auto taken = swift_weakTakeStrong(&ref3);
+  EXPECT_EQ(object, taken);
+  swift_release(taken);
+
+  swift_weakDestroy(&ref1);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+}
+
 /////////////////////////////////////////
 // Non-atomic reference counting tests //
 /////////////////////////////////////////